@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal microbenchmark harness. Benchmarks register themselves with GG_BENCHMARK and
+// time their hot loops with Bench::Measure; main runs the ones matching the filter.
+
+namespace Bench {
+
+    struct Result
+    {
+        double Avg = 0.0, Min = 0.0, P50 = 0.0, Max = 0.0; // Milliseconds per iteration
+    };
+
+    // Runs fn a few times untimed, then iterations times, and logs the timings
+    Result Measure(const std::string& name, uint32_t iterations, const std::function<void()>& fn);
+
+    using BenchmarkFunction = void (*)();
+
+    struct Registration
+    {
+        Registration(const char* name, BenchmarkFunction function);
+    };
+
+    struct Entry
+    {
+        const char* Name;
+        BenchmarkFunction Function;
+    };
+    std::vector<Entry>& GetRegistry();
+
+    // Keeps the optimizer from discarding a result: the value has to exist in memory
+    template<typename T>
+    void DoNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        (void)*reinterpret_cast<const volatile char*>(&value);
+#endif
+    }
+
+}
+
+#define GG_BENCHMARK(name) \
+    static void name(); \
+    static Bench::Registration s_##name##Registration(#name, name); \
+    static void name()
@@ -0,0 +1,88 @@
+#include "Benchmark.h"
+
+#include "GGEngine/Log.h"
+#include "GGEngine/Timer.h"
+#include "GGEngine/ECS/World.h"
+#include "GGEngine/Math/Math.h"
+
+using namespace GGEngine;
+
+// Component ids are keyed by type name, so these stay out of an anonymous namespace
+namespace ECSBenchmark {
+
+    struct Position { GGEngine::Vec3 Value; };
+    struct Velocity { GGEngine::Vec3 Value; };
+    struct Lifetime { float Seconds; };
+    struct Spawned {};
+
+}
+
+using namespace ECSBenchmark;
+
+namespace {
+
+    const uint32_t s_EntityCount = 1000000;
+    const uint32_t s_SpawnCount = 10000;
+    const uint32_t s_Iterations = 50;
+    const float s_DeltaTime = 1.0f / 60.0f;
+
+    void Integrate(Position& position, const Velocity& velocity, Lifetime& lifetime)
+    {
+        position.Value += velocity.Value * s_DeltaTime;
+        lifetime.Seconds -= s_DeltaTime;
+    }
+
+}
+
+GG_BENCHMARK(ECSIteration1M)
+{
+    World world;
+    Timer timer;
+    for (uint32_t i = 0; i < s_EntityCount; i++)
+    {
+        const float f = (float)i;
+        world.Create(Position{ Vec3(f, 0.0f, 0.0f) }, Velocity{ Vec3(1.0f, f * 1.0e-6f, 0.0f) }, Lifetime{ 10.0f });
+    }
+    GG_INFO("  {0:<48} {1:8.3f} ms", "Create 1M entities with 3 components", timer.ElapsedMillis());
+
+    auto query = world.CreateQuery<Position, const Velocity, Lifetime>();
+    GG_INFO("    {0} entities match", query.Count());
+
+    Bench::Measure("ForEach, 3 components", s_Iterations, [&]()
+    {
+        query.ForEach(Integrate);
+    });
+
+    Bench::Measure("ParallelForEach, 3 components", s_Iterations, [&]()
+    {
+        query.ParallelForEach(Integrate);
+    });
+
+    // Spawns through a buffer, then despawns from inside a query, as gameplay systems do
+    CommandBuffer commands;
+    auto spawned = world.CreateQuery<const Spawned>();
+    Bench::Measure("CommandBuffer: create + destroy 10k", s_Iterations, [&]()
+    {
+        for (uint32_t i = 0; i < s_SpawnCount; i++)
+            commands.Create(Position{}, Velocity{ Vec3(0.0f, 1.0f, 0.0f) }, Lifetime{ 1.0f }, Spawned{});
+        world.Flush(commands);
+
+        spawned.ForEachEntity([&](Entity entity, const Spawned&) { commands.Destroy(entity); });
+        world.Flush(commands);
+    });
+
+    Bench::Measure("CommandBuffer: add + remove a component on 10k", s_Iterations, [&]()
+    {
+        uint32_t tagged = 0;
+        query.ForEachChunk([&](uint32_t count, const Entity* entities, Position*, const Velocity*, Lifetime*)
+        {
+            for (uint32_t i = 0; i < count && tagged < s_SpawnCount; i++, tagged++)
+                commands.Add(entities[i], Spawned{});
+        });
+        world.Flush(commands);
+
+        spawned.ForEachEntity([&](Entity entity, const Spawned&) { commands.Remove<Spawned>(entity); });
+        world.Flush(commands);
+    });
+    GG_INFO("    {0} entities after", world.GetEntityCount());
+}
@@ -0,0 +1,139 @@
+#include "Benchmark.h"
+
+#include "GGEngine/Log.h"
+#include "GGEngine/CpuFeatures.h"
+#include "GGEngine/Math/MathKernels.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace GGEngine;
+
+namespace {
+
+    const uint32_t s_PointCount = 1000000;
+    const uint32_t s_CachedPointCount = 16384;  // Fits in L2, so compute rather than bandwidth bound
+    const uint32_t s_MatrixCount = 100000;
+    const uint32_t s_BoxCount = 100000;
+    const uint32_t s_Iterations = 100;
+
+    std::vector<const MathKernels*> GetAvailableKernels()
+    {
+        std::vector<const MathKernels*> kernels;
+        for (uint32_t level = 0; level < (uint32_t)SimdLevel::Count; level++)
+        {
+            if (const MathKernels* k = SimdMath::Get((SimdLevel)level))
+                kernels.push_back(k);
+        }
+        return kernels;
+    }
+
+    std::string Label(const MathKernels& kernels, const char* what)
+    {
+        std::string label = std::string(what) + " " + SimdMath::GetLevelName(kernels.Level);
+        if (&kernels == &SimdMath::Get())
+            label += " (selected)";
+        return label;
+    }
+
+    Mat4 RandomAffine(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        const Quat rotation = Quat::FromAxisAngle(Normalize(Vec3(unit(rng), unit(rng), unit(rng) + 2.0f)), unit(rng) * Pi);
+        return Mat4::FromTRS(Vec3(unit(rng), unit(rng), unit(rng)) * 100.0f, rotation, Vec3(1.0f + unit(rng) * 0.5f));
+    }
+
+    // Largest difference from the scalar kernels' output, relative to the value's magnitude
+    float MaxError(const float* reference, const float* values, size_t count)
+    {
+        float error = 0.0f;
+        for (size_t i = 0; i < count; i++)
+            error = std::max(error, std::fabs(reference[i] - values[i]) / std::max(1.0f, std::fabs(reference[i])));
+        return error;
+    }
+
+}
+
+GG_BENCHMARK(SimdMathKernels)
+{
+    const CpuFeatures& cpu = CpuFeatures::Get();
+    GG_INFO("  CPU: SSE4.1 {0}, AVX {1}, AVX2 {2}, FMA {3}, NEON {4}", cpu.SSE41, cpu.AVX, cpu.AVX2, cpu.FMA, cpu.NEON);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> coordinate(-1000.0f, 1000.0f);
+    const std::vector<const MathKernels*> kernels = GetAvailableKernels();
+    const MathKernels& scalar = *SimdMath::Get(SimdLevel::Scalar);
+
+    // Transform SoA points by one matrix: 1M streams from memory, 16k stays in cache
+    {
+        std::vector<float> x(s_PointCount), y(s_PointCount), z(s_PointCount);
+        for (uint32_t i = 0; i < s_PointCount; i++)
+        {
+            x[i] = coordinate(rng);
+            y[i] = coordinate(rng);
+            z[i] = coordinate(rng);
+        }
+        const Mat4 m = RandomAffine(rng);
+        std::vector<float> referenceX(s_PointCount), outX(s_PointCount), outY(s_PointCount), outZ(s_PointCount);
+        scalar.TransformPoints(m, x.data(), y.data(), z.data(), referenceX.data(), outY.data(), outZ.data(), s_PointCount);
+
+        for (const MathKernels* k : kernels)
+        {
+            Bench::Measure(Label(*k, "TransformPoints 1M"), s_Iterations, [&]()
+            {
+                k->TransformPoints(m, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), s_PointCount);
+            });
+            GG_INFO("    max relative error {0:.2e}", MaxError(referenceX.data(), outX.data(), s_PointCount));
+        }
+        for (const MathKernels* k : kernels)
+        {
+            Bench::Measure(Label(*k, "TransformPoints 16k"), s_Iterations * 10, [&]()
+            {
+                k->TransformPoints(m, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), s_CachedPointCount);
+            });
+        }
+    }
+
+    // 100k independent matrix products
+    {
+        std::vector<Mat4> a(s_MatrixCount), b(s_MatrixCount), reference(s_MatrixCount), out(s_MatrixCount);
+        for (uint32_t i = 0; i < s_MatrixCount; i++)
+        {
+            a[i] = RandomAffine(rng);
+            b[i] = RandomAffine(rng);
+        }
+        scalar.MultiplyMat4(a.data(), b.data(), reference.data(), s_MatrixCount);
+
+        for (const MathKernels* k : kernels)
+        {
+            Bench::Measure(Label(*k, "MultiplyMat4 100k"), s_Iterations, [&]()
+            {
+                k->MultiplyMat4(a.data(), b.data(), out.data(), s_MatrixCount);
+            });
+            GG_INFO("    max relative error {0:.2e}", MaxError(reference[0].Data, out[0].Data, (size_t)s_MatrixCount * 16));
+        }
+    }
+
+    // 100k boxes, each under its own matrix, as culling does
+    {
+        std::vector<Mat4> matrices(s_BoxCount);
+        std::vector<AABB> boxes(s_BoxCount), reference(s_BoxCount), out(s_BoxCount);
+        for (uint32_t i = 0; i < s_BoxCount; i++)
+        {
+            matrices[i] = RandomAffine(rng);
+            const Vec3 center(coordinate(rng), coordinate(rng), coordinate(rng));
+            const Vec3 extents(std::fabs(coordinate(rng)) * 0.01f + 0.1f);
+            boxes[i] = AABB(center - extents, center + extents);
+        }
+        scalar.TransformAABBs(matrices.data(), boxes.data(), reference.data(), s_BoxCount);
+
+        for (const MathKernels* k : kernels)
+        {
+            Bench::Measure(Label(*k, "TransformAABBs 100k"), s_Iterations, [&]()
+            {
+                k->TransformAABBs(matrices.data(), boxes.data(), out.data(), s_BoxCount);
+            });
+            GG_INFO("    max relative error {0:.2e}", MaxError(&reference[0].Min.x, &out[0].Min.x, (size_t)s_BoxCount * 6));
+        }
+    }
+}
@@ -0,0 +1,196 @@
+#include "Benchmark.h"
+
+#include "GGEngine/Log.h"
+#include "GGEngine/Timer.h"
+#include "GGEngine/Spatial/DynamicAABBTree.h"
+#include "GGEngine/Spatial/UniformGrid.h"
+
+#include <random>
+
+using namespace GGEngine;
+
+namespace {
+
+    const uint32_t s_ObjectCounts[] = { 10000, 100000, 1000000 };
+    const uint32_t s_QueryCount = 1000;
+    const uint32_t s_FrustumCount = 4; // E.g. a camera plus three shadow cascades
+    const float s_QuerySize = 8.0f;
+    const float s_CellSize = 2.0f;
+
+    // Objects about one unit across at a fixed density, so the world grows with the count
+    // and every query sees about the same number of neighbours
+    struct Scene
+    {
+        float Extent = 0.0f;
+        std::vector<AABB> Boxes;
+        std::vector<Vec3> Velocities;
+        std::vector<AABB> Queries;
+        std::vector<Ray> Rays;
+        std::vector<Frustum> Frustums;
+    };
+
+    Scene MakeScene(uint32_t objectCount)
+    {
+        std::mt19937 rng(7);
+        Scene scene;
+        scene.Extent = 4.0f * std::cbrt((float)objectCount);
+        std::uniform_real_distribution<float> position(0.0f, scene.Extent);
+        std::uniform_real_distribution<float> size(0.5f, 1.5f);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        for (uint32_t i = 0; i < objectCount; i++)
+        {
+            const Vec3 min(position(rng), position(rng), position(rng));
+            scene.Boxes.push_back(AABB(min, min + Vec3(size(rng), size(rng), size(rng))));
+            scene.Velocities.push_back(Vec3(unit(rng), unit(rng), unit(rng)) * 0.05f);
+        }
+        for (uint32_t i = 0; i < s_QueryCount; i++)
+        {
+            const Vec3 min(position(rng), position(rng), position(rng));
+            scene.Queries.push_back(AABB(min, min + Vec3(s_QuerySize)));
+
+            Ray ray;
+            ray.Origin = Vec3(position(rng), position(rng), position(rng));
+            ray.Direction = Normalize(Vec3(unit(rng), unit(rng), unit(rng)));
+            ray.MaxDistance = scene.Extent;
+            scene.Rays.push_back(ray);
+        }
+
+        // Views from the middle of one face, each reaching a quarter of the way in
+        const float extent = scene.Extent;
+        const Vec3 eye(extent * 0.5f, extent * 0.5f, -1.0f);
+        for (uint32_t i = 0; i < s_FrustumCount; i++)
+        {
+            const Vec3 target(extent * (0.3f + 0.1f * i), extent * 0.5f, extent);
+            const Mat4 viewProjection = Mat4::Perspective(Radians(60.0f), 16.0f / 9.0f, 0.1f, extent * 0.25f) * Mat4::LookAt(eye, target, Vec3(0.0f, 1.0f, 0.0f));
+            scene.Frustums.push_back(Frustum::FromMatrix(viewProjection));
+        }
+        return scene;
+    }
+
+    uint32_t Iterations(uint32_t objectCount)
+    {
+        return objectCount >= 1000000 ? 10 : (objectCount >= 100000 ? 50 : 200);
+    }
+
+    void LogBuild(const char* what, double milliseconds)
+    {
+        GG_INFO("  {0:<48} {1:8.3f} ms", what, milliseconds);
+    }
+
+    // Moves a tenth of the objects by their velocity, a different tenth each frame
+    template<typename MoveFn>
+    void MoveTenth(Scene& scene, uint32_t& frame, const MoveFn& move)
+    {
+        const uint32_t count = (uint32_t)scene.Boxes.size();
+        for (uint32_t i = frame % 10; i < count; i += 10)
+        {
+            scene.Boxes[i] = AABB(scene.Boxes[i].Min + scene.Velocities[i], scene.Boxes[i].Max + scene.Velocities[i]);
+            move(i);
+        }
+        frame++;
+    }
+
+    template<typename Index>
+    void MeasureQueries(Index& index, const Scene& scene, uint32_t iterations)
+    {
+        QueryResults results;
+        Bench::Measure("1000 box queries", iterations, [&]()
+        {
+            index.QueryOverlaps(scene.Queries.data(), s_QueryCount, results);
+        });
+        GG_INFO("    {0:.1f} hits per query", (double)results.IDs.size() / s_QueryCount);
+
+        std::vector<RayHit> hits(s_QueryCount);
+        Bench::Measure("1000 raycasts", iterations, [&]()
+        {
+            index.Raycast(scene.Rays.data(), s_QueryCount, hits.data());
+        });
+        uint32_t hitCount = 0;
+        for (const RayHit& hit : hits)
+            hitCount += hit.ID != NullSpatialID ? 1 : 0;
+        GG_INFO("    {0} rays hit", hitCount);
+
+        Bench::Measure("4 frustums", iterations, [&]()
+        {
+            index.QueryFrustums(scene.Frustums.data(), s_FrustumCount, results);
+        });
+        GG_INFO("    {0} visible in the first", results.GetHitCount(0));
+    }
+
+}
+
+GG_BENCHMARK(SpatialAABBTree)
+{
+    for (uint32_t objectCount : s_ObjectCounts)
+    {
+        GG_INFO("  {0} objects", objectCount);
+        Scene scene = MakeScene(objectCount);
+
+        Timer timer;
+        DynamicAABBTree tree;
+        std::vector<SpatialID> proxies(objectCount);
+        for (uint32_t i = 0; i < objectCount; i++)
+            proxies[i] = tree.CreateProxy(scene.Boxes[i], i);
+        LogBuild("Build", timer.ElapsedMillis());
+        GG_INFO("    height {0}, area ratio {1:.1f}", tree.GetHeight(), tree.GetAreaRatio());
+
+        uint32_t frame = 0;
+        Bench::Measure("Move 10%", Iterations(objectCount), [&]()
+        {
+            MoveTenth(scene, frame, [&](uint32_t i) { tree.MoveProxy(proxies[i], scene.Boxes[i], scene.Velocities[i]); });
+        });
+        GG_INFO("    height {0}, area ratio {1:.1f} after moving", tree.GetHeight(), tree.GetAreaRatio());
+
+        MeasureQueries(tree, scene, Iterations(objectCount));
+    }
+}
+
+GG_BENCHMARK(SpatialUniformGrid)
+{
+    for (uint32_t objectCount : s_ObjectCounts)
+    {
+        GG_INFO("  {0} objects", objectCount);
+        Scene scene = MakeScene(objectCount);
+
+        Timer timer;
+        UniformGrid grid(s_CellSize);
+        std::vector<SpatialID> ids(objectCount);
+        for (uint32_t i = 0; i < objectCount; i++)
+            ids[i] = grid.Insert(scene.Boxes[i], i);
+        grid.Update();
+        LogBuild("Build", timer.ElapsedMillis());
+
+        uint32_t frame = 0;
+        Bench::Measure("Move 10%", Iterations(objectCount), [&]()
+        {
+            MoveTenth(scene, frame, [&](uint32_t i) { grid.Move(ids[i], scene.Boxes[i]); });
+            grid.Update();
+        });
+
+        MeasureQueries(grid, scene, Iterations(objectCount));
+    }
+}
+
+// The O(N) scan the spatial indices replace
+GG_BENCHMARK(SpatialBruteForce)
+{
+    for (uint32_t objectCount : s_ObjectCounts)
+    {
+        if (objectCount > 100000)
+            continue;
+
+        GG_INFO("  {0} objects", objectCount);
+        const Scene scene = MakeScene(objectCount);
+        uint64_t hits = 0;
+        Bench::Measure("1000 box queries", Iterations(objectCount) / 10, [&]()
+        {
+            for (const AABB& query : scene.Queries)
+            {
+                for (const AABB& box : scene.Boxes)
+                    hits += box.Overlaps(query) ? 1 : 0;
+            }
+        });
+        Bench::DoNotOptimize(hits);
+    }
+}
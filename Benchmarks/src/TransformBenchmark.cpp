@@ -0,0 +1,147 @@
+#include "Benchmark.h"
+
+#include "GGEngine/Log.h"
+#include "GGEngine/Scene/TransformHierarchy.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+using namespace GGEngine;
+
+namespace {
+
+    const uint32_t s_NodeCount = 100000;
+    const uint32_t s_RootCount = 100;
+    const uint32_t s_ChangedPerFrame = s_NodeCount / 100;
+    const uint32_t s_Frames = 200;
+
+    // Random tree: every node after the roots hangs off an earlier node, which gives a
+    // depth of a dozen or so levels with uneven fan-out
+    std::vector<uint32_t> MakeParents(std::mt19937& rng)
+    {
+        std::vector<uint32_t> parents(s_NodeCount, UINT32_MAX);
+        for (uint32_t i = s_RootCount; i < s_NodeCount; i++)
+            parents[i] = rng() % i;
+        return parents;
+    }
+
+    // The pointer-per-node scene graph the hierarchy replaces, for comparison: nodes are
+    // separate allocations and the update walks the whole tree to find what changed
+    struct PointerNode
+    {
+        Vec3 Position;
+        Quat Rotation;
+        Vec3 Scale{ 1.0f };
+        Mat4 Local = Mat4::Identity();
+        Mat4 World = Mat4::Identity();
+        bool Dirty = true;
+        std::vector<PointerNode*> Children;
+    };
+
+    void UpdatePointerNode(PointerNode& node, const Mat4& parentWorld, bool parentChanged, uint32_t& updated)
+    {
+        const bool changed = node.Dirty || parentChanged;
+        if (node.Dirty)
+            node.Local = Mat4::FromTRS(node.Position, node.Rotation, node.Scale);
+        if (changed)
+        {
+            node.World = parentWorld * node.Local;
+            updated++;
+        }
+        node.Dirty = false;
+        for (PointerNode* child : node.Children)
+            UpdatePointerNode(*child, node.World, changed, updated);
+    }
+
+}
+
+GG_BENCHMARK(TransformHierarchy100k)
+{
+    std::mt19937 rng(42);
+    const std::vector<uint32_t> parents = MakeParents(rng);
+
+    TransformHierarchy hierarchy;
+    std::vector<TransformID> ids(s_NodeCount);
+    for (uint32_t i = 0; i < s_NodeCount; i++)
+        ids[i] = hierarchy.Create(parents[i] == UINT32_MAX ? NullTransform : ids[parents[i]]);
+
+    hierarchy.Update();
+    GG_INFO("  {0} nodes, {1} levels", hierarchy.GetCount(), hierarchy.GetDepth());
+
+    Bench::Measure("Full update (every root moved)", s_Frames, [&]()
+    {
+        for (uint32_t i = 0; i < s_RootCount; i++)
+            hierarchy.SetPosition(ids[i], Vec3((float)(rng() % 100), 0.0f, 0.0f));
+        hierarchy.Update();
+    });
+
+    uint64_t updated = 0, frames = 0;
+    Bench::Measure("1% of nodes moved", s_Frames, [&]()
+    {
+        for (uint32_t i = 0; i < s_ChangedPerFrame; i++)
+            hierarchy.SetPosition(ids[rng() % s_NodeCount], Vec3((float)(rng() % 100), 1.0f, 2.0f));
+        hierarchy.Update();
+        updated += hierarchy.GetLastUpdateCount();
+        frames++;
+    });
+    GG_INFO("  {0} world matrices recomputed per frame on average", updated / frames);
+
+    Bench::Measure("Reparent 1% then update", s_Frames / 4, [&]()
+    {
+        for (uint32_t i = 0; i < s_ChangedPerFrame; i++)
+        {
+            // Parents always precede their children in creation order, so this never cycles
+            const uint32_t node = s_RootCount + rng() % (s_NodeCount - s_RootCount);
+            hierarchy.SetParent(ids[node], ids[rng() % node]);
+        }
+        hierarchy.Update();
+    });
+}
+
+GG_BENCHMARK(TransformPointerTree100k)
+{
+    std::mt19937 rng(42);
+    const std::vector<uint32_t> parents = MakeParents(rng);
+
+    // Allocated in shuffled order, as a long-running scene would leave them
+    std::vector<uint32_t> order(s_NodeCount);
+    for (uint32_t i = 0; i < s_NodeCount; i++)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+    std::vector<std::unique_ptr<PointerNode>> nodes(s_NodeCount);
+    for (uint32_t i : order)
+        nodes[i] = std::make_unique<PointerNode>();
+    for (uint32_t i = s_RootCount; i < s_NodeCount; i++)
+        nodes[parents[i]]->Children.push_back(nodes[i].get());
+
+    const Mat4 identity = Mat4::Identity();
+    uint32_t updated = 0;
+    auto update = [&]()
+    {
+        for (uint32_t i = 0; i < s_RootCount; i++)
+            UpdatePointerNode(*nodes[i], identity, false, updated);
+    };
+
+    Bench::Measure("Full update (every root moved)", s_Frames, [&]()
+    {
+        for (uint32_t i = 0; i < s_RootCount; i++)
+        {
+            nodes[i]->Position = Vec3((float)(rng() % 100), 0.0f, 0.0f);
+            nodes[i]->Dirty = true;
+        }
+        update();
+    });
+
+    Bench::Measure("1% of nodes moved", s_Frames, [&]()
+    {
+        for (uint32_t i = 0; i < s_ChangedPerFrame; i++)
+        {
+            PointerNode& node = *nodes[rng() % s_NodeCount];
+            node.Position = Vec3((float)(rng() % 100), 1.0f, 2.0f);
+            node.Dirty = true;
+        }
+        update();
+    });
+    Bench::DoNotOptimize(updated);
+}
@@ -0,0 +1,85 @@
+#include "Benchmark.h"
+
+#include "GGEngine/Log.h"
+#include "GGEngine/JobSystem.h"
+#include "GGEngine/Timer.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Engine microbenchmarks.
+//
+//   Benchmarks [filter]   runs every benchmark whose name contains filter
+
+using namespace GGEngine;
+
+namespace Bench {
+
+    static const uint32_t s_WarmupIterations = 3;
+
+    Result Measure(const std::string& name, uint32_t iterations, const std::function<void()>& fn)
+    {
+        for (uint32_t i = 0; i < s_WarmupIterations; i++)
+            fn();
+
+        std::vector<double> times;
+        times.reserve(iterations);
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            Timer timer;
+            fn();
+            times.push_back(timer.ElapsedMillis());
+        }
+        std::sort(times.begin(), times.end());
+
+        Result result;
+        for (double time : times)
+            result.Avg += time;
+        result.Avg /= (double)times.size();
+        result.Min = times.front();
+        result.P50 = times[times.size() / 2];
+        result.Max = times.back();
+        GG_INFO("  {0:<48} avg {1:8.3f}  min {2:8.3f}  p50 {3:8.3f}  max {4:8.3f} ms",
+            name, result.Avg, result.Min, result.P50, result.Max);
+        return result;
+    }
+
+    Registration::Registration(const char* name, BenchmarkFunction function)
+    {
+        GetRegistry().push_back({ name, function });
+    }
+
+    std::vector<Entry>& GetRegistry()
+    {
+        static std::vector<Entry> s_Registry;
+        return s_Registry;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    Log::Init();
+    JobSystem::Init();
+
+    const char* filter = argc > 1 ? argv[1] : "";
+    std::vector<Bench::Entry> entries = Bench::GetRegistry();
+    std::sort(entries.begin(), entries.end(),
+        [](const Bench::Entry& a, const Bench::Entry& b) { return strcmp(a.Name, b.Name) < 0; });
+
+    GG_INFO("Benchmarks: {0} threads", JobSystem::GetThreadCount());
+    uint32_t ran = 0;
+    for (const Bench::Entry& entry : entries)
+    {
+        if (!strstr(entry.Name, filter))
+            continue;
+        GG_INFO("{0}", entry.Name);
+        entry.Function();
+        ran++;
+    }
+    if (ran == 0)
+        GG_WARN("No benchmark matches '{0}'", filter);
+
+    JobSystem::Shutdown();
+    return 0;
+}
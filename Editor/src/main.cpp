@@ -1,5 +1,7 @@
 #include "GGEngine.h"
 
+#include <imgui.h>
+
 class EditorLayer : public GGEngine::Layer
 {
 public:
@@ -7,24 +9,40 @@ public:
     {
     }
 
+    void OnAttach() override
+    {
+        m_SceneViewport = GGEngine::SceneViewport::Create();
+    }
+
     void OnUpdate() override
     {
     }
 
     void OnImGuiRender() override
     {
-        // Empty for now to test basic ImGui
+        ImGui::DockSpaceOverViewport(0, ImGui::GetMainViewport(), ImGuiDockNodeFlags_PassthruCentralNode);
+
+        // The scene is only rendered while this panel is on screen
+        ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
+        if (ImGui::Begin("Viewport"))
+            m_SceneViewport->Draw();
+        ImGui::End();
+        ImGui::PopStyleVar();
     }
 
     void OnEvent(GGEngine::Event& event) override
     {
     }
+
+private:
+    std::shared_ptr<GGEngine::SceneViewport> m_SceneViewport;
 };
 
 class Editor : public GGEngine::Application 
 {
 public:
-    Editor() 
+    Editor(const GGEngine::ApplicationSpecification& specification)
+        : GGEngine::Application(specification)
     {
         PushLayer(new EditorLayer());
     }
@@ -33,6 +51,10 @@ public:
     }
 };
 
-GGEngine::Application* GGEngine::CreateApplication() {
-    return new Editor();
+GGEngine::Application* GGEngine::CreateApplication(GGEngine::ApplicationCommandLineArgs args) {
+    GGEngine::ApplicationSpecification spec;
+    spec.Name = "Editor";
+    spec.PowerSaving = true; // An idle editor should not redraw identical frames
+    spec.CommandLineArgs = args;
+    return new Editor(spec);
 }
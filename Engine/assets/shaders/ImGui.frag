@@ -0,0 +1,13 @@
+#version 450
+
+// Set 0 is the descriptor set behind an ImTextureID, created by the ImGui Vulkan backend
+
+layout(set = 0, binding = 0) uniform sampler2D sTexture;
+
+layout(location = 0) in struct { vec4 Color; vec2 UV; } In;
+layout(location = 0) out vec4 fColor;
+
+void main()
+{
+    fColor = In.Color * texture(sTexture, In.UV.st);
+}
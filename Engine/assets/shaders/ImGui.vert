@@ -0,0 +1,24 @@
+#version 450
+
+// ImGui geometry for VulkanImGuiRenderer. Matches the vendored backend's shader, so both
+// paths render identically. Positions are in ImGui display space.
+
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec2 aUV;
+layout(location = 2) in vec4 aColor;
+
+layout(push_constant) uniform PushConstants
+{
+    vec2 Scale;
+    vec2 Translate;
+} pc;
+
+out gl_PerVertex { vec4 gl_Position; };
+layout(location = 0) out struct { vec4 Color; vec2 UV; } Out;
+
+void main()
+{
+    Out.Color = aColor;
+    Out.UV = aUV;
+    gl_Position = vec4(aPos * pc.Scale + pc.Translate, 0.0, 1.0);
+}
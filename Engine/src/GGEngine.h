@@ -5,6 +5,23 @@
 #include "GGEngine/Application.h"
 #include "GGEngine/Layer.h"
 #include "GGEngine/Log.h"
+#include "GGEngine/JobSystem.h"
+#include "GGEngine/Timer.h"
+#include "GGEngine/FrameStats.h"
+#include "GGEngine/FrameCapture.h"
+#include "GGEngine/Profiler.h"
+#include "GGEngine/CpuFeatures.h"
+#include "GGEngine/Texture.h"
+#include "GGEngine/SceneViewport.h"
+#include "GGEngine/GPUCulling.h"
+#include "GGEngine/ECS/World.h"
+#include "GGEngine/ECS/SystemScheduler.h"
+#include "GGEngine/Math/Math.h"
+#include "GGEngine/Math/MathKernels.h"
+#include "GGEngine/Math/Geometry.h"
+#include "GGEngine/Scene/TransformHierarchy.h"
+#include "GGEngine/Spatial/DynamicAABBTree.h"
+#include "GGEngine/Spatial/UniformGrid.h"
 
 #include "GGEngine/ImGui/ImGuiLayer.h"
 
@@ -3,7 +3,14 @@
 #include "GGEngine/Events/ApplicationEvent.h"
 #include "GGEngine/Window.h"
 #include "GGEngine/Log.h"
+#include "GGEngine/JobSystem.h"
+#include "GGEngine/FrameStats.h"
+#include "GGEngine/FrameCapture.h"
+#include "GGEngine/Profiler.h"
+#include "GGEngine/Math/MathKernels.h"
+#include "GGEngine/Timer.h"
 #include "GGEngine/ImGui/ImGuiLayer.h"
+#include "GGEngine/ECS/SystemScheduler.h"
 
 namespace GGEngine {
 
@@ -11,20 +18,119 @@ namespace GGEngine {
 
     Application* Application::s_Instance = nullptr;
 
-    Application::Application() 
+    // Frames that must come out unchanged in a row before the loop starts sleeping
+    static const uint32_t s_IdleSettleFrames = 2;
+
+    const char* ApplicationCommandLineArgs::Find(const char* name) const
+    {
+        const size_t nameLength = strlen(name);
+        for (int i = 1; i < Count; i++)
+        {
+            const char* arg = Args[i];
+            if (strncmp(arg, name, nameLength) != 0)
+                continue;
+            if (arg[nameLength] == '\0')
+                return arg + nameLength;
+            if (arg[nameLength] == '=')
+                return arg + nameLength + 1;
+        }
+        return nullptr;
+    }
+
+    static void ApplyCommandLine(ApplicationSpecification& spec)
+    {
+        const ApplicationCommandLineArgs& args = spec.CommandLineArgs;
+
+        const char* headlessEnv = std::getenv("GG_HEADLESS");
+        if (args.Find("--headless") || (headlessEnv && strcmp(headlessEnv, "0") != 0))
+            spec.Headless = true;
+
+        if (const char* value = args.Find("--headless-images"))
+            spec.HeadlessImageCount = std::max(2u, (uint32_t)std::strtoul(value, nullptr, 10));
+        if (const char* value = args.Find("--frames"))
+            spec.FrameLimit = (uint32_t)std::strtoul(value, nullptr, 10);
+        if (const char* value = args.Find("--warmup"))
+            spec.WarmupFrames = (uint32_t)std::strtoul(value, nullptr, 10);
+        if (const char* value = args.Find("--frame-stats"))
+            spec.FrameStatsPath = value;
+        if (const char* value = args.Find("--capture"))
+            spec.CaptureDirectory = value;
+        if (const char* value = args.Find("--screenshot"))
+            spec.ScreenshotPath = value;
+        const char* trackDriverMemoryEnv = std::getenv("GG_TRACK_DRIVER_MEMORY");
+        if (args.Find("--track-driver-memory") || (trackDriverMemoryEnv && strcmp(trackDriverMemoryEnv, "0") != 0))
+            spec.TrackDriverMemory = true;
+        const char* powerSavingEnv = std::getenv("GG_POWER_SAVING");
+        if (args.Find("--power-saving") || (powerSavingEnv && strcmp(powerSavingEnv, "0") != 0))
+            spec.PowerSaving = true;
+        if (args.Find("--no-power-saving"))
+            spec.PowerSaving = false;
+        if (const char* value = args.Find("--idle-refresh"))
+            spec.IdleRefreshMs = std::max(1u, (uint32_t)std::strtoul(value, nullptr, 10));
+        const char* lowLatencyEnv = std::getenv("GG_LOW_LATENCY");
+        if (args.Find("--low-latency") || (lowLatencyEnv && strcmp(lowLatencyEnv, "0") != 0))
+            spec.LowLatency = true;
+        if (const char* value = std::getenv("GG_GPU"))
+            spec.GPU = value;
+        if (const char* value = args.Find("--gpu"))
+            spec.GPU = value;
+        if (const char* value = args.Find("--resolution"))
+        {
+            unsigned int width = 0, height = 0;
+            if (sscanf(value, "%ux%u", &width, &height) == 2 && width > 0 && height > 0)
+            {
+                spec.Width = width;
+                spec.Height = height;
+            }
+        }
+    }
+
+    Application::Application(const ApplicationSpecification& specification) 
+        : m_Specification(specification)
     {
         GG_CORE_ASSERT(!s_Instance, "Application already exists!");
         s_Instance = this;
 
-        m_Window = std::unique_ptr<Window>(Window::Create());
+        ApplyCommandLine(m_Specification);
+
+        JobSystem::Init();
+        GG_CORE_INFO("Math kernels: {0}", SimdMath::GetLevelName(SimdMath::GetLevel()));
+
+        m_World = std::make_unique<World>();
+        m_Systems = std::make_unique<SystemScheduler>(*m_World);
+
+        // Benchmark sessions keep every measured frame for the final report
+        if (m_Specification.FrameLimit != 0)
+            FrameStats::SetHistorySize(m_Specification.FrameLimit);
+
+        if (m_Specification.Headless)
+            GG_CORE_INFO("Running headless ({0} offscreen images)", m_Specification.HeadlessImageCount);
+
+        // Benchmark and headless runs measure every frame
+        m_PowerSaving = m_Specification.PowerSaving && !m_Specification.Headless && m_Specification.FrameLimit == 0;
+
+        m_Window = std::unique_ptr<Window>(Window::Create(WindowProps(m_Specification.Name, m_Specification.Width, m_Specification.Height, m_Specification.Headless)));
         m_Window->SetEventCallback(BIND_EVENT_FN(OnEvent));
 
         m_ImGuiLayer = new ImGuiLayer();
         PushOverlay(m_ImGuiLayer);
+
+        FrameCapture::Init();
+        if (!m_Specification.CaptureDirectory.empty())
+            FrameCapture::BeginSequence(m_Specification.CaptureDirectory);
+        if (!m_Specification.ScreenshotPath.empty() && m_Specification.FrameLimit == 0)
+            FrameCapture::Screenshot(m_Specification.ScreenshotPath);
     }
 
     Application::~Application() 
     {
+        m_Systems.reset();
+        m_World.reset();
+        FrameCapture::Shutdown();
+        // Layers detach while the job system is still up: the ImGui layer owns the Vulkan context,
+        // whose shutdown waits on pipeline compiles, saves the pipeline cache and joins its threads
+        m_LayerStack.Clear();
+        JobSystem::Shutdown();
     }
 
     void Application::PushLayer(Layer* layer)
@@ -39,8 +145,18 @@ namespace GGEngine {
         layer->OnAttach();
     }
 
+    void Application::RequestRedraw()
+    {
+        if (!m_RedrawRequested.exchange(true) && m_PowerSaving)
+            m_Window->PostEmptyEvent();
+    }
+
     void Application::OnEvent(Event& e)
     {
+        m_EventReceived = true;
+        if (e.IsInCategory(EventCategoryInput) && (m_PendingInputTime == 0.0 || e.GetTimestamp() < m_PendingInputTime))
+            m_PendingInputTime = e.GetTimestamp();
+
         EventDispatcher dispatcher(e);
         dispatcher.Dispatch<WindowCloseEvent>(BIND_EVENT_FN(OnWindowClose));
 
@@ -56,13 +172,46 @@ namespace GGEngine {
 
     void Application::Run() 
     {
+        Timer frameTimer;
+        double lastFrameStart = 0.0;
+        uint32_t warmupFrames = m_Specification.WarmupFrames;
         while (m_Running) 
         {
+            // Power saving: once frames stop changing, block until input or a redraw request.
+            // The idle refresh still wakes the loop now and then, so ImGui's own timers
+            // (tooltip delays, caret blink) advance.
+            if (m_PowerSaving && m_IdleFrames >= s_IdleSettleFrames)
+                m_Window->WaitEvents(m_Specification.IdleRefreshMs / 1000.0);
+
+            // Low latency: hold the frame until it can just make the next refresh, then
+            // poll again so it sees the freshest input
+            if (m_Specification.LowLatency)
+            {
+                m_ImGuiLayer->WaitForFrameStart();
+                m_Window->OnUpdate();
+            }
+
+            frameTimer.Reset();
+            // Input is carried to the present of the frame that consumes it
+            FrameStats::BeginFrame(m_PendingInputTime);
+            Profiler::BeginFrame();
+            m_PendingInputTime = 0.0;
+
+            // Golden-image runs capture the last measured frame
+            const bool lastFrame = warmupFrames == 0 && m_Specification.FrameLimit != 0
+                && FrameStats::GetFrameCount() + 1 == m_Specification.FrameLimit;
+            if (lastFrame && !m_Specification.ScreenshotPath.empty())
+                FrameCapture::Screenshot(m_Specification.ScreenshotPath);
+
             for (Layer* layer : m_LayerStack)
             {
                 layer->OnUpdate();
             }
 
+            const double frameStart = FrameStats::GetFrameStartTime();
+            m_Systems->Run(lastFrameStart > 0.0 ? (float)(frameStart - lastFrameStart) : 0.0f);
+            lastFrameStart = frameStart;
+
             m_ImGuiLayer->Begin();
             if (m_ImGuiLayer->IsFrameStarted())
             {
@@ -74,6 +223,30 @@ namespace GGEngine {
             m_ImGuiLayer->End();
             
             m_Window->OnUpdate();
+
+            const bool redrawRequested = m_RedrawRequested.exchange(false);
+            if (m_ImGuiLayer->IsFrameIdle() && !redrawRequested && !m_EventReceived)
+                m_IdleFrames++;
+            else
+                m_IdleFrames = 0;
+            m_EventReceived = false;
+
+            FrameStats::RecordFrame(frameTimer.ElapsedMillis());
+            if (warmupFrames > 0 && --warmupFrames == 0)
+            {
+                FrameStats::Reset();
+                Profiler::Reset();
+            }
+            else if (warmupFrames == 0 && m_Specification.FrameLimit != 0 && FrameStats::GetFrameCount() >= m_Specification.FrameLimit)
+                m_Running = false;
+        }
+
+        // Low latency sessions always report, for their present latencies
+        if (m_Specification.FrameLimit != 0 || m_Specification.LowLatency)
+        {
+            FrameStats::Report(m_Specification.FrameStatsPath);
+            Profiler::Report();
+            m_Systems->Report();
         }
     }
 
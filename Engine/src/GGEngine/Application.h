@@ -7,14 +7,51 @@
 #include "Events/Event.h"
 #include "Events/ApplicationEvent.h"
 
+#include <atomic>
+
 namespace GGEngine {
 
     class ImGuiLayer;
+    class World;
+    class SystemScheduler;
+
+    struct ApplicationCommandLineArgs
+    {
+        int Count = 0;
+        char** Args = nullptr;
+
+        const char* operator[](int index) const { return Args[index]; }
+
+        // Value of "--name=value", "" for a bare "--name", nullptr when absent
+        const char* Find(const char* name) const;
+    };
+
+    struct ApplicationSpecification
+    {
+        std::string Name = "GGEngine";
+        unsigned int Width = 1280;
+        unsigned int Height = 720;
+        ApplicationCommandLineArgs CommandLineArgs;
+
+        // The options below can also be set from the command line (see Application.cpp)
+        bool Headless = false;              // --headless, or GG_HEADLESS=1
+        uint32_t HeadlessImageCount = 3;    // --headless-images=N, size of the offscreen ring
+        uint32_t FrameLimit = 0;            // --frames=N, exit after N measured frames (0 = run until closed)
+        uint32_t WarmupFrames = 0;          // --warmup=N, frames excluded from the statistics
+        std::string FrameStatsPath;         // --frame-stats=path, per-frame CSV written on exit
+        std::string CaptureDirectory;       // --capture=dir, write every rendered frame as PNG
+        std::string ScreenshotPath;         // --screenshot=path, PNG of the last frame of a --frames run
+        std::string GPU;                    // --gpu=index|name, or GG_GPU, overrides device scoring
+        bool TrackDriverMemory = false;     // --track-driver-memory, or GG_TRACK_DRIVER_MEMORY=1
+        bool PowerSaving = false;           // --power-saving (--no-power-saving), or GG_POWER_SAVING=1, sleep while nothing changes
+        uint32_t IdleRefreshMs = 500;       // --idle-refresh=ms, longest sleep in power saving mode
+        bool LowLatency = false;            // --low-latency, or GG_LOW_LATENCY=1, start frames just in time for the next refresh (needs VK_KHR_present_wait)
+    };
 
     class GG_API Application 
     {
     public:
-        Application();
+        Application(const ApplicationSpecification& specification = ApplicationSpecification());
         virtual ~Application();
 
         void Run();
@@ -24,24 +61,46 @@ namespace GGEngine {
         void PushLayer(Layer* layer);
         void PushOverlay(Layer* layer);
 
-        void Close() { m_Running = false; }
+        // exitCode is returned from main
+        void Close(int exitCode = 0) { m_ExitCode = exitCode; m_Running = false; }
+        int GetExitCode() const { return m_ExitCode; }
+
+        // Keeps power saving from idling: the next frame renders even when nothing changed.
+        // Layers that animate call this every frame. Callable from any thread.
+        void RequestRedraw();
 
         inline Window& GetWindow() { return *m_Window; }
+        const ApplicationSpecification& GetSpecification() const { return m_Specification; }
 
         inline static Application& Get() { return *s_Instance; }
 
         ImGuiLayer* GetImGuiLayer() { return m_ImGuiLayer; }
 
+        // The application's entity world; its systems run every frame after the layers update
+        World& GetWorld() { return *m_World; }
+        SystemScheduler& GetSystems() { return *m_Systems; }
+
     private:
         bool OnWindowClose(WindowCloseEvent& e);
         
+        ApplicationSpecification m_Specification;
         std::unique_ptr<Window> m_Window;
         ImGuiLayer* m_ImGuiLayer;
         bool m_Running = true;
+        int m_ExitCode = 0;
         LayerStack m_LayerStack;
+        std::unique_ptr<World> m_World;
+        std::unique_ptr<SystemScheduler> m_Systems;
+
+        bool m_PowerSaving = false;
+        std::atomic<bool> m_RedrawRequested{ false };
+        bool m_EventReceived = false;
+        uint32_t m_IdleFrames = 0; // Consecutive frames that changed nothing
+        double m_PendingInputTime = 0.0; // Earliest input event not yet consumed by a frame
 
         static Application* s_Instance;
     };
 
-    Application* CreateApplication();
+    // To be defined in CLIENT
+    Application* CreateApplication(ApplicationCommandLineArgs args);
 }
\ No newline at end of file
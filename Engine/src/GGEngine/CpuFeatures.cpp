@@ -0,0 +1,77 @@
+#include "CpuFeatures.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+    #define GG_CPU_X86
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+namespace GGEngine {
+
+    namespace {
+
+#if defined(GG_CPU_X86)
+        void Cpuid(uint32_t leaf, uint32_t subleaf, uint32_t registers[4])
+        {
+#if defined(_MSC_VER)
+            int values[4];
+            __cpuidex(values, (int)leaf, (int)subleaf);
+            for (int i = 0; i < 4; i++)
+                registers[i] = (uint32_t)values[i];
+#else
+            __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+        }
+
+        uint64_t ReadXCR0()
+        {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            uint32_t eax, edx;
+            __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return ((uint64_t)edx << 32) | eax;
+#endif
+        }
+#endif
+
+        CpuFeatures Detect()
+        {
+            CpuFeatures features;
+#if defined(GG_CPU_X86)
+            uint32_t registers[4];
+            Cpuid(0, 0, registers);
+            const uint32_t maxLeaf = registers[0];
+
+            Cpuid(1, 0, registers);
+            const uint32_t ecx = registers[2];
+            features.SSE41 = (ecx & (1u << 19)) != 0;
+
+            // AVX state must be enabled by the OS (XCR0 bits 1 and 2), not just present
+            const bool osSavesYmm = (ecx & (1u << 27)) && (ReadXCR0() & 0x6) == 0x6;
+            features.AVX = osSavesYmm && (ecx & (1u << 28));
+            features.FMA = features.AVX && (ecx & (1u << 12));
+            if (features.AVX && maxLeaf >= 7)
+            {
+                Cpuid(7, 0, registers);
+                features.AVX2 = (registers[1] & (1u << 5)) != 0;
+            }
+#elif defined(_M_ARM64) || defined(__aarch64__)
+            // Advanced SIMD is mandatory on AArch64
+            features.NEON = true;
+#endif
+            return features;
+        }
+
+    }
+
+    const CpuFeatures& CpuFeatures::Get()
+    {
+        static const CpuFeatures s_Features = Detect();
+        return s_Features;
+    }
+
+}
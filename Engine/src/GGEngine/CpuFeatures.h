@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Core.h"
+
+namespace GGEngine {
+
+    // Instruction sets the running CPU and OS support, detected once on first use. The
+    // x86 AVX flags also require the OS to save the YMM registers.
+    struct GG_API CpuFeatures
+    {
+        bool SSE41 = false;
+        bool AVX = false;
+        bool AVX2 = false;
+        bool FMA = false;
+        bool NEON = false;
+
+        static const CpuFeatures& Get();
+    };
+
+}
@@ -0,0 +1,52 @@
+#include "Archetype.h"
+
+#include "GGEngine/Log.h"
+
+namespace GGEngine {
+
+    static uint32_t AlignUp(uint32_t value, uint32_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    Archetype::Archetype(const ComponentMask& mask, std::vector<ComponentID> types)
+        : m_Mask(mask), m_Types(std::move(types))
+    {
+        m_ColumnOf.fill(-1);
+        m_Sizes.push_back((uint32_t)sizeof(Entity));
+        m_Infos.push_back(nullptr);
+        uint32_t bytesPerEntity = (uint32_t)sizeof(Entity);
+        for (size_t i = 0; i < m_Types.size(); i++)
+        {
+            const ComponentInfo& info = ComponentRegistry::Get(m_Types[i]);
+            GG_CORE_ASSERT(info.Alignment <= ChunkColumnAlignment, "Component alignment exceeds the chunk column alignment");
+            m_ColumnOf[m_Types[i]] = (int16_t)(i + 1);
+            m_Sizes.push_back(info.Size);
+            m_Infos.push_back(&info);
+            bytesPerEntity += info.Size;
+            m_Trivial &= info.Trivial;
+        }
+
+        // As many rows as fit once every column is padded to its alignment
+        auto layoutSize = [this](uint32_t capacity)
+        {
+            uint32_t offset = 0;
+            for (uint32_t size : m_Sizes)
+                offset = AlignUp(offset, ChunkColumnAlignment) + size * capacity;
+            return offset;
+        };
+        m_ChunkCapacity = ChunkSize / bytesPerEntity;
+        while (m_ChunkCapacity > 1 && layoutSize(m_ChunkCapacity) > ChunkSize)
+            m_ChunkCapacity--;
+        GG_CORE_ASSERT(layoutSize(m_ChunkCapacity) <= ChunkSize, "Archetype does not fit a single entity into a chunk");
+
+        uint32_t offset = 0;
+        for (uint32_t size : m_Sizes)
+        {
+            offset = AlignUp(offset, ChunkColumnAlignment);
+            m_Offsets.push_back(offset);
+            offset += size * m_ChunkCapacity;
+        }
+    }
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Component.h"
+#include "Entity.h"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+namespace GGEngine {
+
+    constexpr uint32_t ChunkSize = 16 * 1024;
+    constexpr uint32_t ChunkColumnAlignment = 64; // Every column starts on a cache line
+
+    // One block of an archetype's entities: the entity column, then one array per component
+    // type (SoA). Only the last chunk of an archetype is ever partly filled.
+    struct Chunk
+    {
+        uint8_t* Data = nullptr;
+        uint32_t Count = 0;
+    };
+
+    // Every entity with exactly one set of component types. Removing an entity moves the
+    // archetype's last entity into the hole, so chunks stay densely packed and queries walk
+    // them linearly.
+    class Archetype
+    {
+    public:
+        Archetype(const ComponentMask& mask, std::vector<ComponentID> types);
+
+        const ComponentMask& GetMask() const { return m_Mask; }
+        // Sorted by id
+        const std::vector<ComponentID>& GetTypes() const { return m_Types; }
+        uint32_t GetChunkCapacity() const { return m_ChunkCapacity; }
+        uint32_t GetEntityCount() const { return m_EntityCount; }
+
+        std::vector<Chunk>& GetChunks() { return m_Chunks; }
+        const std::vector<Chunk>& GetChunks() const { return m_Chunks; }
+
+        // Column 0 holds the entities; -1 when the archetype lacks the component
+        int32_t GetColumn(ComponentID id) const { return m_ColumnOf[id]; }
+        uint32_t GetColumnOffset(uint32_t column) const { return m_Offsets[column]; }
+        uint32_t GetColumnSize(uint32_t column) const { return m_Sizes[column]; }
+        const ComponentInfo& GetColumnInfo(uint32_t column) const { return *m_Infos[column]; }
+
+        static Entity* GetEntities(const Chunk& chunk) { return reinterpret_cast<Entity*>(chunk.Data); }
+        void* GetComponent(const Chunk& chunk, uint32_t column, uint32_t row) const { return chunk.Data + m_Offsets[column] + (size_t)m_Sizes[column] * row; }
+
+    private:
+        friend class World;
+
+        ComponentMask m_Mask;
+        std::vector<ComponentID> m_Types;
+        std::array<int16_t, MaxComponentTypes> m_ColumnOf;
+        std::vector<uint32_t> m_Offsets; // Per column, from the start of a chunk
+        std::vector<uint32_t> m_Sizes;
+        std::vector<const ComponentInfo*> m_Infos; // nullptr for the entity column
+        uint32_t m_ChunkCapacity = 0;
+        uint32_t m_EntityCount = 0;
+        bool m_Trivial = true; // No component needs relocation or destruction calls
+
+        std::vector<Chunk> m_Chunks;
+        // Archetypes one component away, filled as entities gain and lose components
+        std::unordered_map<ComponentID, Archetype*> m_AddEdges;
+        std::unordered_map<ComponentID, Archetype*> m_RemoveEdges;
+    };
+
+}
@@ -0,0 +1,71 @@
+#include "CommandBuffer.h"
+
+#include <algorithm>
+
+namespace GGEngine {
+
+    static const uint32_t s_BlockSize = 16 * 1024;
+    static const uint32_t s_BlockAlignment = 64;
+
+    CommandBuffer::~CommandBuffer()
+    {
+        Clear();
+        for (const Block& block : m_Blocks)
+            ::operator delete(block.Data, std::align_val_t(s_BlockAlignment));
+    }
+
+    Entity CommandBuffer::Create()
+    {
+        Entity placeholder{ m_PlaceholderCount++, PlaceholderGeneration };
+        m_Commands.push_back({ Op::Create, 0, placeholder, nullptr });
+        return placeholder;
+    }
+
+    void CommandBuffer::Destroy(Entity entity)
+    {
+        m_Commands.push_back({ Op::Destroy, 0, entity, nullptr });
+    }
+
+    void CommandBuffer::Clear()
+    {
+        for (const Command& command : m_Commands)
+        {
+            if (command.Type == Op::Add)
+                ComponentRegistry::Get(command.Component).Destruct(command.Payload, 1);
+        }
+        Reset();
+    }
+
+    void CommandBuffer::Reset()
+    {
+        m_Commands.clear();
+        m_BlockIndex = 0;
+        m_BlockOffset = 0;
+        m_PlaceholderCount = 0;
+    }
+
+    void* CommandBuffer::Allocate(uint32_t size, uint32_t alignment)
+    {
+        while (m_BlockIndex < m_Blocks.size())
+        {
+            const Block& block = m_Blocks[m_BlockIndex];
+            const uint32_t offset = (m_BlockOffset + alignment - 1) & ~(alignment - 1);
+            if (offset + size <= block.Size)
+            {
+                m_BlockOffset = offset + size;
+                return block.Data + offset;
+            }
+            m_BlockIndex++;
+            m_BlockOffset = 0;
+        }
+
+        Block block;
+        block.Size = std::max(s_BlockSize, size);
+        block.Data = static_cast<uint8_t*>(::operator new(block.Size, std::align_val_t(s_BlockAlignment)));
+        m_Blocks.push_back(block);
+        m_BlockIndex = (uint32_t)m_Blocks.size() - 1;
+        m_BlockOffset = size;
+        return block.Data;
+    }
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Component.h"
+#include "Entity.h"
+
+#include <utility>
+#include <vector>
+
+namespace GGEngine {
+
+    // Records structural changes for World::Flush, so systems can create, destroy and
+    // restructure entities while a query runs. A buffer is not thread-safe: parallel
+    // systems keep one per thread, indexed by JobSystem::GetThreadIndex().
+    class GG_API CommandBuffer
+    {
+    public:
+        // Entities created through a buffer carry this generation until it is flushed
+        static constexpr uint32_t PlaceholderGeneration = UINT32_MAX;
+
+        CommandBuffer() = default;
+        ~CommandBuffer();
+
+        CommandBuffer(const CommandBuffer&) = delete;
+        CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+        // The returned placeholder is only valid as a target for later commands in this buffer
+        Entity Create();
+        template<typename... Ts>
+        Entity Create(Ts&&... components)
+        {
+            Entity entity = Create();
+            (Add(entity, std::forward<Ts>(components)), ...);
+            return entity;
+        }
+
+        void Destroy(Entity entity);
+
+        template<typename T>
+        void Add(Entity entity, T&& component)
+        {
+            using Type = std::decay_t<T>;
+            void* payload = Allocate((uint32_t)sizeof(Type), (uint32_t)alignof(Type));
+            new (payload) Type(std::forward<T>(component));
+            m_Commands.push_back({ Op::Add, GetComponentID<Type>(), entity, payload });
+        }
+
+        template<typename T>
+        void Remove(Entity entity)
+        {
+            m_Commands.push_back({ Op::Remove, GetComponentID<T>(), entity, nullptr });
+        }
+
+        static bool IsPlaceholder(Entity entity) { return entity.Generation == PlaceholderGeneration; }
+        bool IsEmpty() const { return m_Commands.empty(); }
+
+        // Drops everything recorded since the last flush
+        void Clear();
+
+    private:
+        friend class World;
+
+        enum class Op : uint8_t { Create, Destroy, Add, Remove };
+
+        struct Command
+        {
+            Op Type;
+            ComponentID Component;
+            Entity Target;
+            void* Payload; // Constructed component for Add, consumed by the flush
+        };
+
+        struct Block
+        {
+            uint8_t* Data = nullptr;
+            uint32_t Size = 0;
+        };
+
+        // Payloads live in blocks that never move, so they need no relocation while recording
+        void* Allocate(uint32_t size, uint32_t alignment);
+        // Forgets the commands, keeping the blocks for the next frame
+        void Reset();
+
+        std::vector<Command> m_Commands;
+        std::vector<Block> m_Blocks;
+        uint32_t m_BlockIndex = 0;
+        uint32_t m_BlockOffset = 0;
+        uint32_t m_PlaceholderCount = 0;
+    };
+
+}
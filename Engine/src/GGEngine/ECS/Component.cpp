@@ -0,0 +1,48 @@
+#include "Component.h"
+
+#include "GGEngine/Log.h"
+
+namespace GGEngine {
+
+    // Infos live in a deque so references handed out by Get stay valid while other
+    // threads register new types
+    static std::mutex s_RegistryMutex;
+    static std::deque<ComponentInfo> s_Components;
+    static std::unordered_map<std::string, ComponentID> s_ComponentsByName;
+
+    ComponentID ComponentRegistry::Register(const ComponentInfo& info)
+    {
+        std::lock_guard<std::mutex> lock(s_RegistryMutex);
+        auto it = s_ComponentsByName.find(info.Name);
+        if (it != s_ComponentsByName.end())
+        {
+            // Two types sharing a name, e.g. same-named structs in anonymous namespaces of
+            // different files under MSVC, would share chunk columns
+            const ComponentInfo& existing = s_Components[it->second];
+            if (existing.Size != info.Size || existing.Alignment != info.Alignment || existing.Trivial != info.Trivial)
+            {
+                GG_CORE_CRITICAL("Component '{0}' registered twice with different layouts; component type names must be unique", info.Name);
+                abort();
+            }
+            return it->second;
+        }
+
+        // Masks and archetype column tables are sized for MaxComponentTypes
+        if (s_Components.size() >= MaxComponentTypes)
+        {
+            GG_CORE_CRITICAL("Too many component types registering '{0}' (max {1})", info.Name, MaxComponentTypes);
+            abort();
+        }
+        const ComponentID id = (ComponentID)s_Components.size();
+        s_Components.push_back(info);
+        s_ComponentsByName.emplace(info.Name, id);
+        return id;
+    }
+
+    const ComponentInfo& ComponentRegistry::Get(ComponentID id)
+    {
+        std::lock_guard<std::mutex> lock(s_RegistryMutex);
+        return s_Components[id];
+    }
+
+}
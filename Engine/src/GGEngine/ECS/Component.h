@@ -0,0 +1,76 @@
+#pragma once
+
+#include "GGEngine/Core.h"
+
+#include <bitset>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+
+namespace GGEngine {
+
+    using ComponentID = uint16_t;
+    constexpr uint32_t MaxComponentTypes = 256;
+    using ComponentMask = std::bitset<MaxComponentTypes>;
+
+    // How chunk storage handles a component type it only knows by size
+    struct ComponentInfo
+    {
+        const char* Name = nullptr;
+        uint32_t Size = 0;
+        uint32_t Alignment = 0;
+        bool Trivial = false; // Relocated with memcpy and never destroyed
+        // Move-constructs count elements at destination from source, then destroys the sources
+        void (*Relocate)(void* destination, void* source, uint32_t count) = nullptr;
+        void (*Destruct)(void* data, uint32_t count) = nullptr;
+    };
+
+    // Component ids are handed out on first use and keyed by type name, so the engine and
+    // applications agree on them even when the engine is a DLL. Ids are process-wide, and
+    // component type names must be unique across the program: avoid same-named components
+    // in anonymous namespaces, which MSVC names alike.
+    class GG_API ComponentRegistry
+    {
+    public:
+        static ComponentID Register(const ComponentInfo& info);
+        static const ComponentInfo& Get(ComponentID id);
+    };
+
+    template<typename T>
+    ComponentInfo MakeComponentInfo()
+    {
+        static_assert(std::is_move_constructible_v<T>, "Components must be move constructible");
+
+        ComponentInfo info;
+        info.Name = typeid(T).name();
+        info.Size = (uint32_t)sizeof(T);
+        info.Alignment = (uint32_t)alignof(T);
+        info.Trivial = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>;
+        info.Relocate = [](void* destination, void* source, uint32_t count)
+        {
+            T* to = static_cast<T*>(destination);
+            T* from = static_cast<T*>(source);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                new (to + i) T(std::move(from[i]));
+                from[i].~T();
+            }
+        };
+        info.Destruct = [](void* data, uint32_t count)
+        {
+            T* values = static_cast<T*>(data);
+            for (uint32_t i = 0; i < count; i++)
+                values[i].~T();
+        };
+        return info;
+    }
+
+    template<typename T>
+    ComponentID GetComponentID()
+    {
+        using Type = std::remove_cv_t<std::remove_reference_t<T>>;
+        static const ComponentID id = ComponentRegistry::Register(MakeComponentInfo<Type>());
+        return id;
+    }
+
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+namespace GGEngine {
+
+    // Handle to an entity in a World. The generation changes whenever the index is reused,
+    // so handles to destroyed entities stop resolving instead of aliasing new ones.
+    struct Entity
+    {
+        uint32_t Index = 0;
+        uint32_t Generation = 0; // 0 is never a live entity
+
+        bool IsNull() const { return Generation == 0; }
+        explicit operator bool() const { return !IsNull(); }
+
+        bool operator==(const Entity& other) const { return Index == other.Index && Generation == other.Generation; }
+        bool operator!=(const Entity& other) const { return !(*this == other); }
+    };
+
+}
@@ -0,0 +1,197 @@
+#include "SystemScheduler.h"
+
+#include "GGEngine/Profiler.h"
+#include "GGEngine/Timer.h"
+
+namespace GGEngine {
+
+    struct SystemScheduler::System
+    {
+        std::string Name;
+        SystemAccess Access;
+        SystemFunction Function;
+        CommandBuffer Commands;
+
+        std::vector<uint32_t> Predecessors;
+        std::vector<uint32_t> Successors;
+        std::atomic<uint32_t> Remaining{ 0 }; // Predecessors still running this frame
+
+        double LastMs = 0.0;
+        double TotalMs = 0.0;
+        uint64_t Runs = 0;
+    };
+
+    SystemScheduler::SystemScheduler(World& world)
+        : m_World(world)
+    {
+    }
+
+    SystemScheduler::~SystemScheduler() = default;
+
+    void SystemScheduler::AddSystem(const std::string& name, const SystemAccess& access, SystemFunction function)
+    {
+        auto system = std::make_unique<System>();
+        system->Name = name;
+        system->Access = access;
+        system->Function = std::move(function);
+        m_Systems.push_back(std::move(system));
+        m_Dirty = true;
+    }
+
+    void SystemScheduler::RemoveSystem(const std::string& name)
+    {
+        auto it = std::find_if(m_Systems.begin(), m_Systems.end(),
+            [&name](const std::unique_ptr<System>& system) { return system->Name == name; });
+        if (it == m_Systems.end())
+            return;
+        m_Systems.erase(it);
+        m_CriticalPath.clear();
+        m_Dirty = true;
+    }
+
+    void SystemScheduler::Build()
+    {
+        // Registration order is the topological order. Each system depends on the latest
+        // earlier systems it conflicts with; an earlier conflict that is already an
+        // ancestor through those needs no edge of its own.
+        const uint32_t count = (uint32_t)m_Systems.size();
+        std::vector<std::vector<bool>> ancestors(count, std::vector<bool>(count, false));
+        uint32_t edges = 0;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            System& system = *m_Systems[i];
+            system.Predecessors.clear();
+            system.Successors.clear();
+            for (uint32_t j = i; j-- > 0;)
+            {
+                if (ancestors[i][j] || !m_Systems[j]->Access.ConflictsWith(system.Access))
+                    continue;
+
+                system.Predecessors.push_back(j);
+                m_Systems[j]->Successors.push_back(i);
+                ancestors[i][j] = true;
+                for (uint32_t k = 0; k < j; k++)
+                {
+                    if (ancestors[j][k])
+                        ancestors[i][k] = true;
+                }
+                edges++;
+            }
+        }
+        m_Dirty = false;
+        GG_CORE_TRACE("System schedule rebuilt: {0} systems, {1} dependencies", count, edges);
+    }
+
+    void SystemScheduler::Run(float deltaTime)
+    {
+        if (m_Systems.empty())
+            return;
+        if (m_Dirty)
+            Build();
+
+        m_DeltaTime = deltaTime;
+        for (const auto& system : m_Systems)
+            system->Remaining.store((uint32_t)system->Predecessors.size(), std::memory_order_relaxed);
+
+        // Successors are launched from inside their last predecessor's job, before that job
+        // releases the counter, so the counter only drains once every system has run
+        JobCounter counter{ 0 };
+        for (uint32_t i = 0; i < m_Systems.size(); i++)
+        {
+            if (m_Systems[i]->Predecessors.empty())
+                Launch(i, counter);
+        }
+        JobSystem::Wait(counter);
+
+        // Registration order keeps structural changes deterministic regardless of timing
+        for (const auto& system : m_Systems)
+            m_World.Flush(system->Commands);
+
+        m_RunCount++;
+        UpdateCriticalPath();
+    }
+
+    void SystemScheduler::Launch(uint32_t index, JobCounter& counter)
+    {
+        JobSystem::Execute(counter, [this, index, &counter]()
+        {
+            System& system = *m_Systems[index];
+            SystemContext context{ m_World, system.Commands, m_DeltaTime };
+
+            const double start = Timer::Now();
+            system.Function(context);
+            const double end = Timer::Now();
+            Profiler::Record(system.Name, start, end);
+            system.LastMs = (end - start) * 1000.0;
+            system.TotalMs += system.LastMs;
+            system.Runs++;
+
+            for (uint32_t successor : system.Successors)
+            {
+                if (m_Systems[successor]->Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    Launch(successor, counter);
+            }
+        });
+    }
+
+    void SystemScheduler::UpdateCriticalPath()
+    {
+        const uint32_t count = (uint32_t)m_Systems.size();
+        std::vector<double> finish(count, 0.0);
+        std::vector<uint32_t> via(count, UINT32_MAX);
+        uint32_t last = 0;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const System& system = *m_Systems[i];
+            for (uint32_t predecessor : system.Predecessors)
+            {
+                if (finish[predecessor] > finish[i])
+                {
+                    finish[i] = finish[predecessor];
+                    via[i] = predecessor;
+                }
+            }
+            finish[i] += system.LastMs;
+            if (finish[i] > finish[last])
+                last = i;
+        }
+
+        m_CriticalPath.clear();
+        for (uint32_t i = last; i != UINT32_MAX; i = via[i])
+            m_CriticalPath.push_back(i);
+        std::reverse(m_CriticalPath.begin(), m_CriticalPath.end());
+        m_CriticalPathMs = finish[last];
+    }
+
+    std::vector<std::string> SystemScheduler::GetCriticalPath() const
+    {
+        std::vector<std::string> names;
+        for (uint32_t index : m_CriticalPath)
+            names.push_back(m_Systems[index]->Name);
+        return names;
+    }
+
+    void SystemScheduler::Report() const
+    {
+        if (m_RunCount == 0)
+            return;
+
+        GG_CORE_INFO("Systems over {0} runs (avg ms)", m_RunCount);
+        for (const auto& system : m_Systems)
+        {
+            if (system->Runs > 0)
+                GG_CORE_INFO("  {0}: {1:.3f}", system->Name, system->TotalMs / (double)system->Runs);
+        }
+
+        std::string path;
+        for (uint32_t index : m_CriticalPath)
+        {
+            if (!path.empty())
+                path += " -> ";
+            path += m_Systems[index]->Name;
+        }
+        if (!path.empty())
+            GG_CORE_INFO("  Critical path ({0:.3f} ms last run): {1}", m_CriticalPathMs, path);
+    }
+
+}
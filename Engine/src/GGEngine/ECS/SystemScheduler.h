@@ -0,0 +1,81 @@
+#pragma once
+
+#include "World.h"
+
+#include <functional>
+#include <string>
+
+namespace GGEngine {
+
+    // Components a system touches. Systems whose access conflicts (one writes what the
+    // other reads or writes) run in registration order; all others may run concurrently.
+    struct SystemAccess
+    {
+        ComponentMask Reads;
+        ComponentMask Writes;
+        bool IsExclusive = false; // Conflicts with every system, for work outside the declared components
+
+        template<typename... Ts>
+        SystemAccess& Read() { (Reads.set(GetComponentID<Ts>()), ...); return *this; }
+        template<typename... Ts>
+        SystemAccess& Write() { (Writes.set(GetComponentID<Ts>()), ...); return *this; }
+        SystemAccess& Exclusive() { IsExclusive = true; return *this; }
+
+        bool ConflictsWith(const SystemAccess& other) const
+        {
+            return IsExclusive || other.IsExclusive
+                || (Writes & (other.Reads | other.Writes)).any()
+                || (other.Writes & Reads).any();
+        }
+    };
+
+    struct SystemContext
+    {
+        World& Entities;
+        CommandBuffer& Commands; // The system's own buffer, flushed once every system has run
+        float DeltaTime;
+    };
+
+    using SystemFunction = std::function<void(SystemContext&)>;
+
+    // Runs systems over the job system. The dependency graph is rebuilt only when systems
+    // are added or removed; each run launches a system as soon as the systems it conflicts
+    // with have finished. Per-system timings go to the Profiler.
+    class GG_API SystemScheduler
+    {
+    public:
+        explicit SystemScheduler(World& world);
+        ~SystemScheduler();
+
+        SystemScheduler(const SystemScheduler&) = delete;
+        SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+        void AddSystem(const std::string& name, const SystemAccess& access, SystemFunction function);
+        void RemoveSystem(const std::string& name);
+        bool IsEmpty() const { return m_Systems.empty(); }
+
+        // Main thread. Returns once every system has run and the command buffers are flushed.
+        void Run(float deltaTime);
+
+        // Longest chain of dependent systems in the last run, by measured time
+        std::vector<std::string> GetCriticalPath() const;
+        // Logs average time per system and the critical path of the last run
+        void Report() const;
+
+    private:
+        struct System;
+
+        void Build();
+        void Launch(uint32_t index, JobCounter& counter);
+        void UpdateCriticalPath();
+
+        World& m_World;
+        std::vector<std::unique_ptr<System>> m_Systems;
+        bool m_Dirty = false;
+        float m_DeltaTime = 0.0f;
+        uint64_t m_RunCount = 0;
+        std::vector<uint32_t> m_CriticalPath;
+        double m_CriticalPathMs = 0.0;
+    };
+
+}
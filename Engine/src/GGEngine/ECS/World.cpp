@@ -0,0 +1,363 @@
+#include "World.h"
+
+#include <cstring>
+
+namespace GGEngine {
+
+    static void RelocateComponent(const ComponentInfo& info, void* destination, void* source)
+    {
+        if (info.Trivial)
+            std::memcpy(destination, source, info.Size);
+        else
+            info.Relocate(destination, source, 1);
+    }
+
+    World::World()
+    {
+        m_EmptyArchetype = GetArchetype(ComponentMask());
+    }
+
+    World::~World()
+    {
+        for (const auto& archetype : m_Archetypes)
+        {
+            for (const Chunk& chunk : archetype->m_Chunks)
+            {
+                if (!archetype->m_Trivial)
+                {
+                    for (uint32_t column = 1; column < archetype->m_Infos.size(); column++)
+                    {
+                        const ComponentInfo& info = *archetype->m_Infos[column];
+                        if (!info.Trivial)
+                            info.Destruct(archetype->GetComponent(chunk, column, 0), chunk.Count);
+                    }
+                }
+                FreeChunk(chunk.Data);
+            }
+        }
+        for (uint8_t* data : m_FreeChunks)
+            ::operator delete(data, std::align_val_t(ChunkColumnAlignment));
+    }
+
+    Entity World::Create()
+    {
+        GG_CORE_ASSERT(m_IterationDepth == 0, "Structural changes are not allowed while a query runs");
+        return CreateIn(m_EmptyArchetype);
+    }
+
+    Entity World::CreateIn(Archetype* archetype)
+    {
+        uint32_t index;
+        if (!m_FreeIndices.empty())
+        {
+            index = m_FreeIndices.back();
+            m_FreeIndices.pop_back();
+        }
+        else
+        {
+            index = (uint32_t)m_Records.size();
+            m_Records.emplace_back();
+        }
+
+        EntityRecord& record = m_Records[index];
+        const Entity entity{ index, record.Generation };
+        PushRow(archetype, entity, record);
+        m_EntityCount++;
+        return entity;
+    }
+
+    void World::Destroy(Entity entity)
+    {
+        GG_CORE_ASSERT(m_IterationDepth == 0, "Structural changes are not allowed while a query runs");
+        if (!IsAlive(entity))
+            return;
+
+        EntityRecord& record = m_Records[entity.Index];
+        Archetype* archetype = record.Owner;
+        if (!archetype->m_Trivial)
+        {
+            const Chunk& chunk = archetype->m_Chunks[record.ChunkIndex];
+            for (uint32_t column = 1; column < archetype->m_Infos.size(); column++)
+                archetype->m_Infos[column]->Destruct(archetype->GetComponent(chunk, column, record.Row), 1);
+        }
+        PopRow(archetype, record.ChunkIndex, record.Row);
+
+        record.Owner = nullptr;
+        if (++record.Generation == CommandBuffer::PlaceholderGeneration)
+            record.Generation = 1;
+        m_FreeIndices.push_back(entity.Index);
+        m_EntityCount--;
+    }
+
+    bool World::IsAlive(Entity entity) const
+    {
+        return entity.Index < m_Records.size()
+            && m_Records[entity.Index].Generation == entity.Generation
+            && m_Records[entity.Index].Owner != nullptr;
+    }
+
+    void World::RemoveComponent(Entity entity, ComponentID id)
+    {
+        GG_CORE_ASSERT(m_IterationDepth == 0, "Structural changes are not allowed while a query runs");
+        if (!IsAlive(entity))
+            return;
+
+        Archetype* source = m_Records[entity.Index].Owner;
+        if (source->GetColumn(id) >= 0)
+            MoveEntity(entity, GetArchetypeWithout(source, id));
+    }
+
+    void* World::GetComponentData(Entity entity, ComponentID id) const
+    {
+        return IsAlive(entity) ? GetComponentData(m_Records[entity.Index], id) : nullptr;
+    }
+
+    void* World::GetComponentData(const EntityRecord& record, ComponentID id) const
+    {
+        const int32_t column = record.Owner->GetColumn(id);
+        if (column < 0)
+            return nullptr;
+        return record.Owner->GetComponent(record.Owner->m_Chunks[record.ChunkIndex], (uint32_t)column, record.Row);
+    }
+
+    Archetype* World::GetArchetype(const ComponentMask& mask)
+    {
+        auto it = m_ArchetypesByMask.find(mask);
+        if (it != m_ArchetypesByMask.end())
+            return it->second;
+
+        std::vector<ComponentID> types;
+        for (uint32_t id = 0; id < MaxComponentTypes; id++)
+        {
+            if (mask.test(id))
+                types.push_back((ComponentID)id);
+        }
+
+        Archetype* archetype = m_Archetypes.emplace_back(std::make_unique<Archetype>(mask, std::move(types))).get();
+        m_ArchetypesByMask.emplace(mask, archetype);
+        return archetype;
+    }
+
+    Archetype* World::GetArchetypeWith(Archetype* source, ComponentID id)
+    {
+        auto it = source->m_AddEdges.find(id);
+        if (it != source->m_AddEdges.end())
+            return it->second;
+
+        ComponentMask mask = source->m_Mask;
+        mask.set(id);
+        Archetype* destination = GetArchetype(mask);
+        source->m_AddEdges.emplace(id, destination);
+        destination->m_RemoveEdges.emplace(id, source);
+        return destination;
+    }
+
+    Archetype* World::GetArchetypeWithout(Archetype* source, ComponentID id)
+    {
+        auto it = source->m_RemoveEdges.find(id);
+        if (it != source->m_RemoveEdges.end())
+            return it->second;
+
+        ComponentMask mask = source->m_Mask;
+        mask.reset(id);
+        Archetype* destination = GetArchetype(mask);
+        source->m_RemoveEdges.emplace(id, destination);
+        destination->m_AddEdges.emplace(id, source);
+        return destination;
+    }
+
+    void World::MoveEntity(Entity entity, Archetype* destination)
+    {
+        EntityRecord& record = m_Records[entity.Index];
+        Archetype* source = record.Owner;
+        const uint32_t sourceChunk = record.ChunkIndex;
+        const uint32_t sourceRow = record.Row;
+
+        PushRow(destination, entity, record);
+        const Chunk& from = source->m_Chunks[sourceChunk];
+        const Chunk& to = destination->m_Chunks[record.ChunkIndex];
+        for (uint32_t column = 1; column < source->m_Infos.size(); column++)
+        {
+            const ComponentInfo& info = *source->m_Infos[column];
+            void* data = source->GetComponent(from, column, sourceRow);
+            const int32_t destinationColumn = destination->GetColumn(source->m_Types[column - 1]);
+            if (destinationColumn >= 0)
+                RelocateComponent(info, destination->GetComponent(to, (uint32_t)destinationColumn, record.Row), data);
+            else if (!info.Trivial)
+                info.Destruct(data, 1);
+        }
+        PopRow(source, sourceChunk, sourceRow);
+    }
+
+    void World::PushRow(Archetype* archetype, Entity entity, EntityRecord& record)
+    {
+        std::vector<Chunk>& chunks = archetype->m_Chunks;
+        if (chunks.empty() || chunks.back().Count == archetype->m_ChunkCapacity)
+            chunks.push_back({ AllocateChunk(), 0 });
+
+        Chunk& chunk = chunks.back();
+        record.Owner = archetype;
+        record.ChunkIndex = (uint32_t)chunks.size() - 1;
+        record.Row = chunk.Count++;
+        Archetype::GetEntities(chunk)[record.Row] = entity;
+        archetype->m_EntityCount++;
+    }
+
+    void World::PopRow(Archetype* archetype, uint32_t chunkIndex, uint32_t row)
+    {
+        std::vector<Chunk>& chunks = archetype->m_Chunks;
+        Chunk& last = chunks.back();
+        const uint32_t lastChunk = (uint32_t)chunks.size() - 1;
+        const uint32_t lastRow = last.Count - 1;
+        if (chunkIndex != lastChunk || row != lastRow)
+        {
+            const Chunk& hole = chunks[chunkIndex];
+            const Entity moved = Archetype::GetEntities(last)[lastRow];
+            Archetype::GetEntities(hole)[row] = moved;
+            for (uint32_t column = 1; column < archetype->m_Infos.size(); column++)
+                RelocateComponent(*archetype->m_Infos[column], archetype->GetComponent(hole, column, row), archetype->GetComponent(last, column, lastRow));
+
+            EntityRecord& movedRecord = m_Records[moved.Index];
+            movedRecord.ChunkIndex = chunkIndex;
+            movedRecord.Row = row;
+        }
+
+        archetype->m_EntityCount--;
+        if (--last.Count == 0)
+        {
+            FreeChunk(last.Data);
+            chunks.pop_back();
+        }
+    }
+
+    void World::Flush(CommandBuffer& commands)
+    {
+        GG_CORE_ASSERT(m_IterationDepth == 0, "Structural changes are not allowed while a query runs");
+        using Op = CommandBuffer::Op;
+
+        m_FlushPlaceholders.assign(commands.m_PlaceholderCount, Entity());
+        auto resolve = [this](Entity entity)
+        {
+            return CommandBuffer::IsPlaceholder(entity) ? m_FlushPlaceholders[entity.Index] : entity;
+        };
+
+        const std::vector<CommandBuffer::Command>& list = commands.m_Commands;
+        size_t i = 0;
+        while (i < list.size())
+        {
+            const CommandBuffer::Command& command = list[i];
+            if (command.Type == Op::Create)
+            {
+                m_FlushPlaceholders[command.Target.Index] = Create();
+                i++;
+            }
+            else if (command.Type == Op::Destroy)
+            {
+                Destroy(resolve(command.Target));
+                i++;
+            }
+            else
+            {
+                size_t end = i + 1;
+                while (end < list.size() && (list[end].Type == Op::Add || list[end].Type == Op::Remove) && list[end].Target == command.Target)
+                    end++;
+                ApplyCommands(resolve(command.Target), list.data() + i, list.data() + end);
+                i = end;
+            }
+        }
+        commands.Reset();
+    }
+
+    void World::ApplyCommands(Entity entity, const CommandBuffer::Command* begin, const CommandBuffer::Command* end)
+    {
+        using Op = CommandBuffer::Op;
+
+        // Walking backwards, the first command seen for a component decides its fate; the
+        // payloads of earlier adds are overwritten before anyone could see them
+        m_FlushAdds.clear();
+        ComponentMask decided;
+        const bool alive = IsAlive(entity);
+        ComponentMask mask = alive ? m_Records[entity.Index].Owner->m_Mask : ComponentMask();
+        for (const CommandBuffer::Command* command = end; command-- != begin;)
+        {
+            const bool latest = !decided.test(command->Component);
+            decided.set(command->Component);
+            if (command->Type == Op::Remove)
+            {
+                if (latest)
+                    mask.reset(command->Component);
+            }
+            else if (latest && alive)
+            {
+                mask.set(command->Component);
+                m_FlushAdds.push_back(command);
+            }
+            else
+            {
+                ComponentRegistry::Get(command->Component).Destruct(command->Payload, 1);
+            }
+        }
+        if (!alive)
+            return;
+
+        EntityRecord& record = m_Records[entity.Index];
+        const ComponentMask previous = record.Owner->m_Mask;
+        if (mask != previous)
+            MoveEntity(entity, GetArchetype(mask));
+
+        for (const CommandBuffer::Command* command : m_FlushAdds)
+        {
+            const ComponentInfo& info = ComponentRegistry::Get(command->Component);
+            void* data = GetComponentData(record, command->Component);
+            if (previous.test(command->Component) && !info.Trivial)
+                info.Destruct(data, 1);
+            RelocateComponent(info, data, command->Payload);
+        }
+    }
+
+    uint8_t* World::AllocateChunk()
+    {
+        if (!m_FreeChunks.empty())
+        {
+            uint8_t* data = m_FreeChunks.back();
+            m_FreeChunks.pop_back();
+            return data;
+        }
+        return static_cast<uint8_t*>(::operator new(ChunkSize, std::align_val_t(ChunkColumnAlignment)));
+    }
+
+    void World::FreeChunk(uint8_t* data)
+    {
+        m_FreeChunks.push_back(data);
+    }
+
+    QueryState* World::GetQueryState(const ComponentMask& all, const ComponentMask& none)
+    {
+        std::lock_guard<std::mutex> lock(m_QueryMutex);
+        for (const auto& state : m_Queries)
+        {
+            if (state->All == all && state->None == none)
+                return state.get();
+        }
+
+        QueryState* state = m_Queries.emplace_back(std::make_unique<QueryState>()).get();
+        state->All = all;
+        state->None = none;
+        return state;
+    }
+
+    // Archetypes only appear during structural changes, so once a query is up to date no
+    // concurrent caller appends to the matches another thread is iterating
+    void World::UpdateQuery(QueryState& state)
+    {
+        std::lock_guard<std::mutex> lock(m_QueryMutex);
+        for (; state.CheckedArchetypes < m_Archetypes.size(); state.CheckedArchetypes++)
+        {
+            Archetype* archetype = m_Archetypes[state.CheckedArchetypes].get();
+            const ComponentMask& mask = archetype->m_Mask;
+            if ((mask & state.All) == state.All && (mask & state.None).none())
+                state.Matches.push_back(archetype);
+        }
+    }
+
+}
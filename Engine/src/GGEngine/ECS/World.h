@@ -0,0 +1,284 @@
+#pragma once
+
+#include "Archetype.h"
+#include "CommandBuffer.h"
+#include "GGEngine/JobSystem.h"
+#include "GGEngine/Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace GGEngine {
+
+    template<typename... Ts> class Query;
+
+    // Archetypes matching one query, extended as the world creates new archetypes
+    struct QueryState
+    {
+        ComponentMask All;
+        ComponentMask None;
+        std::vector<Archetype*> Matches;
+        size_t CheckedArchetypes = 0;
+    };
+
+    // Entity storage grouped by archetype. Structural changes (create, destroy, add, remove)
+    // are made from one thread and never while a query runs; systems that need them
+    // mid-iteration record them into a CommandBuffer and flush afterwards. Queries and
+    // component access may run on several threads at once between structural changes.
+    class GG_API World
+    {
+    public:
+        World();
+        ~World();
+
+        World(const World&) = delete;
+        World& operator=(const World&) = delete;
+
+        Entity Create();
+        template<typename... Ts>
+        Entity Create(Ts&&... components);
+        void Destroy(Entity entity);
+        bool IsAlive(Entity entity) const;
+        uint32_t GetEntityCount() const { return m_EntityCount; }
+
+        // Constructs the component, or assigns it when the entity already has one
+        template<typename T, typename... Args>
+        T& Add(Entity entity, Args&&... args);
+        template<typename T>
+        void Remove(Entity entity) { RemoveComponent(entity, GetComponentID<T>()); }
+        template<typename T>
+        bool Has(Entity entity) const { return GetComponentData(entity, GetComponentID<T>()) != nullptr; }
+        // nullptr when the entity is dead or lacks the component. Invalidated by structural changes.
+        template<typename T>
+        T* Get(Entity entity) { return static_cast<T*>(GetComponentData(entity, GetComponentID<T>())); }
+
+        // Queries are cached, so creating one every frame costs a lookup
+        template<typename... Ts>
+        Query<Ts...> CreateQuery();
+
+        // Applies the recorded commands in order. Consecutive adds and removes on one entity
+        // move it between archetypes once.
+        void Flush(CommandBuffer& commands);
+
+    private:
+        template<typename... Ts> friend class Query;
+
+        struct EntityRecord
+        {
+            Archetype* Owner = nullptr;
+            uint32_t ChunkIndex = 0;
+            uint32_t Row = 0;
+            uint32_t Generation = 1;
+        };
+
+        struct IterationScope
+        {
+            World& Target;
+            explicit IterationScope(World& world) : Target(world) { Target.m_IterationDepth.fetch_add(1, std::memory_order_relaxed); }
+            ~IterationScope() { Target.m_IterationDepth.fetch_sub(1, std::memory_order_relaxed); }
+        };
+
+        Entity CreateIn(Archetype* archetype);
+        void RemoveComponent(Entity entity, ComponentID id);
+        void* GetComponentData(Entity entity, ComponentID id) const;
+        void* GetComponentData(const EntityRecord& record, ComponentID id) const;
+
+        Archetype* GetArchetype(const ComponentMask& mask);
+        Archetype* GetArchetypeWith(Archetype* source, ComponentID id);
+        Archetype* GetArchetypeWithout(Archetype* source, ComponentID id);
+
+        // Relocates shared components and destroys the ones the destination lacks. Components
+        // only the destination has are left for the caller to construct.
+        void MoveEntity(Entity entity, Archetype* destination);
+        void PushRow(Archetype* archetype, Entity entity, EntityRecord& record);
+        // Fills the vacated row with the archetype's last entity
+        void PopRow(Archetype* archetype, uint32_t chunkIndex, uint32_t row);
+        void ApplyCommands(Entity entity, const CommandBuffer::Command* begin, const CommandBuffer::Command* end);
+
+        uint8_t* AllocateChunk();
+        void FreeChunk(uint8_t* data);
+
+        QueryState* GetQueryState(const ComponentMask& all, const ComponentMask& none);
+        void UpdateQuery(QueryState& state);
+
+        std::vector<EntityRecord> m_Records;
+        std::vector<uint32_t> m_FreeIndices;
+        uint32_t m_EntityCount = 0;
+
+        std::vector<std::unique_ptr<Archetype>> m_Archetypes;
+        std::unordered_map<ComponentMask, Archetype*> m_ArchetypesByMask;
+        Archetype* m_EmptyArchetype = nullptr;
+        std::vector<uint8_t*> m_FreeChunks;
+
+        std::vector<std::unique_ptr<QueryState>> m_Queries;
+        std::mutex m_QueryMutex;
+        std::atomic<uint32_t> m_IterationDepth{ 0 };
+
+        // Flush scratch, kept to avoid allocating every frame
+        std::vector<Entity> m_FlushPlaceholders;
+        std::vector<const CommandBuffer::Command*> m_FlushAdds;
+    };
+
+    // Iterates every entity that has all of Ts (and none of the excluded types), walking the
+    // SoA columns of each matching chunk linearly. Ts may be const-qualified.
+    template<typename... Ts>
+    class Query
+    {
+    public:
+        Query(World& world, QueryState* state)
+            : m_World(&world), m_State(state) {}
+
+        template<typename... Excluded>
+        Query& Without()
+        {
+            ComponentMask none = m_State->None;
+            (none.set(GetComponentID<Excluded>()), ...);
+            m_State = m_World->GetQueryState(m_State->All, none);
+            return *this;
+        }
+
+        // fn(uint32_t count, const Entity* entities, Ts*... columns)
+        template<typename Fn>
+        void ForEachChunk(Fn&& fn)
+        {
+            World::IterationScope scope(*m_World);
+            m_World->UpdateQuery(*m_State);
+            for (const Archetype* archetype : m_State->Matches)
+            {
+                const ColumnOffsets offsets = GetOffsets(*archetype);
+                for (const Chunk& chunk : archetype->GetChunks())
+                    InvokeChunk(fn, chunk, offsets, std::index_sequence_for<Ts...>());
+            }
+        }
+
+        // fn(Ts&...)
+        template<typename Fn>
+        void ForEach(Fn&& fn)
+        {
+            ForEachChunk([&fn](uint32_t count, const Entity*, Ts*... columns)
+            {
+                for (uint32_t i = 0; i < count; i++)
+                    fn(columns[i]...);
+            });
+        }
+
+        // fn(Entity, Ts&...)
+        template<typename Fn>
+        void ForEachEntity(Fn&& fn)
+        {
+            ForEachChunk([&fn](uint32_t count, const Entity* entities, Ts*... columns)
+            {
+                for (uint32_t i = 0; i < count; i++)
+                    fn(entities[i], columns[i]...);
+            });
+        }
+
+        // Spreads the chunks over the job system and waits for them. fn runs concurrently
+        // and must not make structural changes directly.
+        template<typename Fn>
+        void ParallelForEachChunk(Fn&& fn)
+        {
+            World::IterationScope scope(*m_World);
+            m_World->UpdateQuery(*m_State);
+
+            std::vector<std::pair<const Archetype*, const Chunk*>> chunks;
+            for (const Archetype* archetype : m_State->Matches)
+            {
+                for (const Chunk& chunk : archetype->GetChunks())
+                    chunks.emplace_back(archetype, &chunk);
+            }
+            if (chunks.empty())
+                return;
+
+            // A few groups per thread keeps workers busy when chunks finish unevenly
+            const uint32_t chunkCount = (uint32_t)chunks.size();
+            const uint32_t groupSize = std::max(1u, chunkCount / (JobSystem::GetThreadCount() * 4));
+            JobCounter counter{ 0 };
+            JobSystem::Dispatch(counter, chunkCount, groupSize, [&](JobDispatchArgs args)
+            {
+                const auto& [archetype, chunk] = chunks[args.JobIndex];
+                InvokeChunk(fn, *chunk, GetOffsets(*archetype), std::index_sequence_for<Ts...>());
+            });
+            JobSystem::Wait(counter);
+        }
+
+        // fn(Ts&...), called concurrently
+        template<typename Fn>
+        void ParallelForEach(Fn&& fn)
+        {
+            ParallelForEachChunk([&fn](uint32_t count, const Entity*, Ts*... columns)
+            {
+                for (uint32_t i = 0; i < count; i++)
+                    fn(columns[i]...);
+            });
+        }
+
+        uint32_t Count()
+        {
+            m_World->UpdateQuery(*m_State);
+            uint32_t count = 0;
+            for (const Archetype* archetype : m_State->Matches)
+                count += archetype->GetEntityCount();
+            return count;
+        }
+
+    private:
+        using ColumnOffsets = std::array<uint32_t, sizeof...(Ts)>;
+
+        static ColumnOffsets GetOffsets(const Archetype& archetype)
+        {
+            return { archetype.GetColumnOffset((uint32_t)archetype.GetColumn(GetComponentID<Ts>()))... };
+        }
+
+        template<typename Fn, size_t... Is>
+        static void InvokeChunk(Fn& fn, const Chunk& chunk, const ColumnOffsets& offsets, std::index_sequence<Is...>)
+        {
+            fn(chunk.Count, Archetype::GetEntities(chunk), reinterpret_cast<Ts*>(chunk.Data + offsets[Is])...);
+        }
+
+        World* m_World;
+        QueryState* m_State;
+    };
+
+    template<typename... Ts>
+    Entity World::Create(Ts&&... components)
+    {
+        GG_CORE_ASSERT(m_IterationDepth == 0, "Structural changes are not allowed while a query runs");
+        ComponentMask mask;
+        (mask.set(GetComponentID<Ts>()), ...);
+        GG_CORE_ASSERT(mask.count() == sizeof...(Ts), "Entity created with duplicate component types");
+
+        const Entity entity = CreateIn(GetArchetype(mask));
+        const EntityRecord& record = m_Records[entity.Index];
+        (new (GetComponentData(record, GetComponentID<Ts>())) std::decay_t<Ts>(std::forward<Ts>(components)), ...);
+        return entity;
+    }
+
+    template<typename T, typename... Args>
+    T& World::Add(Entity entity, Args&&... args)
+    {
+        GG_CORE_ASSERT(m_IterationDepth == 0, "Structural changes are not allowed while a query runs");
+        GG_CORE_ASSERT(IsAlive(entity), "Adding a component to a dead entity");
+        const ComponentID id = GetComponentID<T>();
+        EntityRecord& record = m_Records[entity.Index];
+        if (void* existing = GetComponentData(record, id))
+            return *static_cast<T*>(existing) = T{ std::forward<Args>(args)... };
+
+        // Built before the move, which may relocate anything the arguments refer to
+        T component{ std::forward<Args>(args)... };
+        MoveEntity(entity, GetArchetypeWith(record.Owner, id));
+        return *new (GetComponentData(record, id)) T(std::move(component));
+    }
+
+    template<typename... Ts>
+    Query<Ts...> World::CreateQuery()
+    {
+        ComponentMask all;
+        (all.set(GetComponentID<Ts>()), ...);
+        return Query<Ts...>(*this, GetQueryState(all, ComponentMask()));
+    }
+
+}
@@ -2,17 +2,18 @@
 
 #ifdef GG_PLATFORM_WINDOWS
 
-extern GGEngine::Application* GGEngine::CreateApplication();
+extern GGEngine::Application* GGEngine::CreateApplication(GGEngine::ApplicationCommandLineArgs args);
 
 int main(int argc, char** argv) 
 {
     GGEngine::Log::Init();
     GG_CORE_TRACE("Initialized Log!");
 
-    auto app = GGEngine::CreateApplication();
+    auto app = GGEngine::CreateApplication({ argc, argv });
     app->Run();
+    const int exitCode = app->GetExitCode();
     delete app;
-    return 0;
+    return exitCode;
 }
 
 #endif
\ No newline at end of file
@@ -30,6 +30,53 @@ namespace GGEngine {
         unsigned int m_Width, m_Height;
     };
 
+    // Size in pixels, which differs from the window size on high-DPI displays. This is
+    // what the swapchain has to match.
+    class GG_API FramebufferResizeEvent : public Event
+    {
+    public:
+        FramebufferResizeEvent(unsigned int width, unsigned int height)
+        : m_Width(width), m_Height(height) {}
+
+        unsigned int GetWidth() const { return m_Width; }
+        unsigned int GetHeight() const { return m_Height; }
+
+        std::string ToString() const override
+        {
+            std::stringstream ss;
+            ss << "FramebufferResizeEvent: " << m_Width << ", " << m_Height;
+            return ss.str();
+        }
+
+        EVENT_CLASS_TYPE(FramebufferResize)
+        EVENT_CLASS_CATEGORY(EventCategoryApplication)
+
+    private:
+        unsigned int m_Width, m_Height;
+    };
+
+    class GG_API WindowIconifyEvent : public Event
+    {
+    public:
+        WindowIconifyEvent(bool iconified)
+        : m_Iconified(iconified) {}
+
+        bool IsIconified() const { return m_Iconified; }
+
+        std::string ToString() const override
+        {
+            std::stringstream ss;
+            ss << "WindowIconifyEvent: " << (m_Iconified ? "iconified" : "restored");
+            return ss.str();
+        }
+
+        EVENT_CLASS_TYPE(WindowIconify)
+        EVENT_CLASS_CATEGORY(EventCategoryApplication)
+
+    private:
+        bool m_Iconified;
+    };
+
     class GG_API WindowCloseEvent : public Event
     {
     public:
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GGEngine/Core.h"
+#include "GGEngine/Timer.h"
 
 #include <string>
 #include <functional>
@@ -11,7 +12,7 @@ namespace GGEngine {
     
     enum class EventType {
         None = 0,
-        WindowClose, WindowResize, WindowFocus, WindowLostFocus, WindowMoved,
+        WindowClose, WindowResize, WindowFocus, WindowLostFocus, WindowMoved, FramebufferResize, WindowIconify,
         AppTick, AppUpdate, AppRender,
         KeyPressed, KeyReleased,
         MouseButtonPressed, MouseButtonReleased, MouseMoved, MouseScrolled
@@ -43,6 +44,9 @@ namespace GGEngine {
         virtual int GetCategoryFlags() const = 0;
         virtual std::string ToString() const { return GetName(); }
 
+        // Engine clock (Timer::Now) when the window system delivered the event
+        double GetTimestamp() const { return m_Timestamp; }
+
         inline bool IsInCategory(EventCategory category)
         {
             return GetCategoryFlags() & category;
@@ -54,6 +58,7 @@ namespace GGEngine {
         }
 
         bool m_Handled = false;
+        double m_Timestamp = Timer::Now();
     };
 
     class EventDispatcher
@@ -0,0 +1,194 @@
+#include "FrameCapture.h"
+
+#include "GGEngine/Image/ImageWriter.h"
+#include "Platform/Vulkan/VulkanContext.h"
+
+#include <future>
+
+namespace GGEngine {
+
+    namespace {
+
+        struct CaptureJob
+        {
+            std::future<ReadbackImage> Image;
+            std::string Path;
+        };
+
+        struct FrameCaptureData
+        {
+            std::thread Writer;
+            std::deque<CaptureJob> Queue;
+            std::mutex QueueMutex;
+            std::condition_variable QueueCondition;
+            std::atomic<uint32_t> Pending{ 0 };
+            bool Running = false;
+
+            // Main thread only
+            std::vector<std::string> Screenshots;
+            std::string SequenceDirectory;
+            uint32_t SequenceRemaining = 0;
+            uint32_t SequenceIndex = 0;
+            bool Sequence = false;
+        };
+
+        FrameCaptureData s_Data;
+
+        // Converts whatever the color target holds to opaque RGBA8 in place
+        bool ToRGBA8(ReadbackImage& image)
+        {
+            bool swapRB = false;
+            switch (image.Format)
+            {
+                case VK_FORMAT_R8G8B8A8_UNORM:
+                case VK_FORMAT_R8G8B8A8_SRGB:
+                    break;
+                case VK_FORMAT_B8G8R8A8_UNORM:
+                case VK_FORMAT_B8G8R8A8_SRGB:
+                    swapRB = true;
+                    break;
+                default:
+                    return false;
+            }
+
+            uint8_t* pixel = image.Pixels.data();
+            const size_t pixelCount = (size_t)image.Width * image.Height;
+            for (size_t i = 0; i < pixelCount; i++, pixel += 4)
+            {
+                if (swapRB)
+                    std::swap(pixel[0], pixel[2]);
+                pixel[3] = 255;
+            }
+            return true;
+        }
+
+        void WriterLoop()
+        {
+            while (true)
+            {
+                CaptureJob job;
+                {
+                    std::unique_lock<std::mutex> lock(s_Data.QueueMutex);
+                    s_Data.QueueCondition.wait(lock, [] { return !s_Data.Queue.empty() || !s_Data.Running; });
+                    if (s_Data.Queue.empty())
+                        return;
+                    job = std::move(s_Data.Queue.front());
+                    s_Data.Queue.pop_front();
+                }
+
+                // Resolves on the main thread once the GPU copy has executed
+                ReadbackImage image = job.Image.get();
+                if (image.Pixels.empty())
+                    GG_CORE_WARN("Frame capture {0} was dropped: no pixels were read back", job.Path);
+                else if (!ToRGBA8(image))
+                    GG_CORE_ERROR("Frame capture {0}: unsupported color format {1}", job.Path, (int)image.Format);
+                else
+                    ImageWriter::WritePNG(job.Path, image.Width, image.Height, image.Pixels.data());
+
+                s_Data.Pending--;
+            }
+        }
+
+        void Enqueue(const std::string& path)
+        {
+            CaptureJob job;
+            job.Image = VulkanContext::Get().ReadbackNextFrame();
+            job.Path = path;
+            s_Data.Pending++;
+            {
+                std::lock_guard<std::mutex> lock(s_Data.QueueMutex);
+                s_Data.Queue.push_back(std::move(job));
+            }
+            s_Data.QueueCondition.notify_one();
+        }
+
+    }
+
+    void FrameCapture::Init()
+    {
+        if (s_Data.Running)
+            return;
+        s_Data.Running = true;
+        s_Data.Writer = std::thread(WriterLoop);
+    }
+
+    void FrameCapture::Shutdown()
+    {
+        if (!s_Data.Running)
+            return;
+
+        // Frames still in flight on the GPU have to resolve before the writer can finish them
+        if (s_Data.Pending > 0)
+            VulkanContext::Get().FlushReadbacks();
+
+        {
+            std::lock_guard<std::mutex> lock(s_Data.QueueMutex);
+            s_Data.Running = false;
+        }
+        s_Data.QueueCondition.notify_all();
+        s_Data.Writer.join();
+
+        s_Data.Screenshots.clear();
+        s_Data.Sequence = false;
+    }
+
+    void FrameCapture::Screenshot(const std::string& path)
+    {
+        s_Data.Screenshots.push_back(path);
+    }
+
+    void FrameCapture::BeginSequence(const std::string& directory, uint32_t frameCount)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error)
+        {
+            GG_CORE_ERROR("Frame capture: could not create {0}: {1}", directory, error.message());
+            return;
+        }
+
+        s_Data.SequenceDirectory = directory;
+        s_Data.SequenceRemaining = frameCount;
+        s_Data.SequenceIndex = 0;
+        s_Data.Sequence = true;
+        GG_CORE_INFO("Capturing frames to {0}", directory);
+    }
+
+    void FrameCapture::EndSequence()
+    {
+        if (s_Data.Sequence)
+            GG_CORE_INFO("Captured {0} frames to {1}", s_Data.SequenceIndex, s_Data.SequenceDirectory);
+        s_Data.Sequence = false;
+    }
+
+    bool FrameCapture::IsCapturing()
+    {
+        return s_Data.Sequence || !s_Data.Screenshots.empty();
+    }
+
+    void FrameCapture::OnFrameRender()
+    {
+        if (!s_Data.Running || !IsCapturing())
+            return;
+
+        for (const std::string& path : s_Data.Screenshots)
+            Enqueue(path);
+        s_Data.Screenshots.clear();
+
+        if (s_Data.Sequence)
+        {
+            char name[32];
+            snprintf(name, sizeof(name), "frame_%05u.png", s_Data.SequenceIndex++);
+            Enqueue((std::filesystem::path(s_Data.SequenceDirectory) / name).string());
+
+            if (s_Data.SequenceRemaining > 0 && --s_Data.SequenceRemaining == 0)
+                EndSequence();
+        }
+    }
+
+    uint32_t FrameCapture::GetPendingFrames()
+    {
+        return s_Data.Pending.load();
+    }
+
+}
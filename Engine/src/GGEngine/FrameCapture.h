@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Core.h"
+
+namespace GGEngine {
+
+    // Writes rendered frames to disk without stalling the frame loop. Pixels come back
+    // through GPU readback a few frames after rendering and are converted and encoded
+    // on a background writer thread, so every requested frame is kept.
+    class GG_API FrameCapture
+    {
+    public:
+        static void Init();
+        // Blocks until every captured frame has been written
+        static void Shutdown();
+
+        // Captures the next rendered frame to a PNG file
+        static void Screenshot(const std::string& path);
+
+        // Captures every rendered frame to <directory>/frame_00000.png, ... until EndSequence
+        // or until frameCount frames were taken (0 = no limit)
+        static void BeginSequence(const std::string& directory, uint32_t frameCount = 0);
+        static void EndSequence();
+        static bool IsCapturing();
+
+        // Called by the renderer right before each frame is recorded
+        static void OnFrameRender();
+
+        // Frames captured on the GPU but not yet written to disk
+        static uint32_t GetPendingFrames();
+    };
+
+}
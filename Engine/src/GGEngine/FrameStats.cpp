@@ -0,0 +1,242 @@
+#include "FrameStats.h"
+
+#include "Timer.h"
+
+#include <algorithm>
+
+namespace GGEngine {
+
+    namespace {
+
+        struct FrameStatsData
+        {
+            std::vector<FrameSample> History;
+            size_t HistorySize = 1024;
+            size_t Next = 0;          // Ring position once History is full
+            uint64_t FrameCount = 0;
+            double PendingSubmitMs = 0.0;
+            uint32_t PendingDriverAllocations = 0;
+            FrameSample Last;
+            std::string DeviceDescription;
+
+            double FrameStartTime = 0.0;
+            double FrameInputTime = 0.0;
+            // Present latencies arrive frames late and only input frames have the second,
+            // so they keep their own rings of HistorySize entries
+            std::vector<double> StartToPresent;
+            std::vector<double> InputToPresent;
+            size_t NextStartToPresent = 0;
+            size_t NextInputToPresent = 0;
+        };
+
+        FrameStatsData s_Data;
+
+        struct Summary
+        {
+            double Avg = 0.0, P50 = 0.0, P95 = 0.0, P99 = 0.0, Max = 0.0;
+        };
+
+        Summary Summarize(std::vector<double> values)
+        {
+            Summary summary;
+            if (values.empty())
+                return summary;
+
+            std::sort(values.begin(), values.end());
+            double total = 0.0;
+            for (double v : values)
+                total += v;
+
+            auto percentile = [&values](double p)
+            {
+                size_t index = (size_t)(p * (double)(values.size() - 1) + 0.5);
+                return values[std::min(index, values.size() - 1)];
+            };
+
+            summary.Avg = total / (double)values.size();
+            summary.P50 = percentile(0.50);
+            summary.P95 = percentile(0.95);
+            summary.P99 = percentile(0.99);
+            summary.Max = values.back();
+            return summary;
+        }
+
+        // Samples in the order they were recorded
+        void PushLatency(std::vector<double>& ring, size_t& next, double value)
+        {
+            if (ring.size() < s_Data.HistorySize)
+            {
+                ring.push_back(value);
+            }
+            else
+            {
+                ring[next] = value;
+                next = (next + 1) % s_Data.HistorySize;
+            }
+        }
+
+        std::vector<FrameSample> OrderedHistory()
+        {
+            std::vector<FrameSample> ordered;
+            ordered.reserve(s_Data.History.size());
+            ordered.insert(ordered.end(), s_Data.History.begin() + s_Data.Next, s_Data.History.end());
+            ordered.insert(ordered.end(), s_Data.History.begin(), s_Data.History.begin() + s_Data.Next);
+            return ordered;
+        }
+
+    }
+
+    void FrameStats::SetHistorySize(uint32_t frames)
+    {
+        s_Data.HistorySize = std::max<size_t>(frames, 1);
+        Reset();
+        s_Data.History.reserve(s_Data.HistorySize);
+    }
+
+    void FrameStats::Reset()
+    {
+        s_Data.History.clear();
+        s_Data.Next = 0;
+        s_Data.FrameCount = 0;
+        s_Data.PendingSubmitMs = 0.0;
+        s_Data.PendingDriverAllocations = 0;
+        s_Data.Last = FrameSample();
+        s_Data.StartToPresent.clear();
+        s_Data.InputToPresent.clear();
+        s_Data.NextStartToPresent = 0;
+        s_Data.NextInputToPresent = 0;
+    }
+
+    void FrameStats::BeginFrame(double inputTime)
+    {
+        s_Data.FrameStartTime = Timer::Now();
+        s_Data.FrameInputTime = inputTime;
+    }
+
+    double FrameStats::GetFrameStartTime()
+    {
+        return s_Data.FrameStartTime;
+    }
+
+    double FrameStats::GetFrameInputTime()
+    {
+        return s_Data.FrameInputTime;
+    }
+
+    void FrameStats::AddSubmitTime(double milliseconds)
+    {
+        s_Data.PendingSubmitMs += milliseconds;
+    }
+
+    void FrameStats::AddDriverAllocations(uint32_t count)
+    {
+        s_Data.PendingDriverAllocations += count;
+    }
+
+    void FrameStats::RecordFrame(double cpuMilliseconds)
+    {
+        FrameSample sample;
+        sample.CpuMs = cpuMilliseconds;
+        sample.SubmitMs = s_Data.PendingSubmitMs;
+        sample.DriverAllocations = s_Data.PendingDriverAllocations;
+        s_Data.PendingSubmitMs = 0.0;
+        s_Data.PendingDriverAllocations = 0;
+
+        if (s_Data.History.size() < s_Data.HistorySize)
+        {
+            s_Data.History.push_back(sample);
+        }
+        else
+        {
+            s_Data.History[s_Data.Next] = sample;
+            s_Data.Next = (s_Data.Next + 1) % s_Data.HistorySize;
+        }
+
+        s_Data.Last = sample;
+        s_Data.FrameCount++;
+    }
+
+    void FrameStats::RecordPresent(double startToPresentMilliseconds, double inputToPresentMilliseconds)
+    {
+        PushLatency(s_Data.StartToPresent, s_Data.NextStartToPresent, startToPresentMilliseconds);
+        if (inputToPresentMilliseconds >= 0.0)
+            PushLatency(s_Data.InputToPresent, s_Data.NextInputToPresent, inputToPresentMilliseconds);
+    }
+
+    uint64_t FrameStats::GetFrameCount()
+    {
+        return s_Data.FrameCount;
+    }
+
+    FrameSample FrameStats::GetLastFrame()
+    {
+        return s_Data.Last;
+    }
+
+    void FrameStats::SetDeviceDescription(const std::string& description)
+    {
+        s_Data.DeviceDescription = description;
+    }
+
+    void FrameStats::Report(const std::string& csvPath)
+    {
+        std::vector<FrameSample> samples = OrderedHistory();
+
+        std::vector<double> cpu, submit, driverAllocations;
+        cpu.reserve(samples.size());
+        submit.reserve(samples.size());
+        driverAllocations.reserve(samples.size());
+        uint32_t allocatingFrames = 0;
+        for (const FrameSample& sample : samples)
+        {
+            cpu.push_back(sample.CpuMs);
+            submit.push_back(sample.SubmitMs);
+            driverAllocations.push_back((double)sample.DriverAllocations);
+            if (sample.DriverAllocations > 0)
+                allocatingFrames++;
+        }
+
+        const Summary cpuSummary = Summarize(cpu);
+        const Summary submitSummary = Summarize(submit);
+        GG_CORE_INFO("Frame stats over {0} frames (ms)", samples.size());
+        if (!s_Data.DeviceDescription.empty())
+            GG_CORE_INFO("  Device:    {0}", s_Data.DeviceDescription);
+        GG_CORE_INFO("  CPU frame: avg {0:.3f}  p50 {1:.3f}  p95 {2:.3f}  p99 {3:.3f}  max {4:.3f}",
+            cpuSummary.Avg, cpuSummary.P50, cpuSummary.P95, cpuSummary.P99, cpuSummary.Max);
+        GG_CORE_INFO("  Submit:    avg {0:.3f}  p50 {1:.3f}  p95 {2:.3f}  p99 {3:.3f}  max {4:.3f}",
+            submitSummary.Avg, submitSummary.P50, submitSummary.P95, submitSummary.P99, submitSummary.Max);
+        if (allocatingFrames > 0)
+        {
+            const Summary allocationSummary = Summarize(driverAllocations);
+            GG_CORE_WARN("  Driver allocations in {0} of {1} frames: avg {2:.1f}  p95 {3:.0f}  max {4:.0f}",
+                allocatingFrames, samples.size(), allocationSummary.Avg, allocationSummary.P95, allocationSummary.Max);
+        }
+        if (!s_Data.StartToPresent.empty())
+        {
+            const Summary presentSummary = Summarize(s_Data.StartToPresent);
+            GG_CORE_INFO("  Present:   avg {0:.3f}  p50 {1:.3f}  p95 {2:.3f}  p99 {3:.3f}  max {4:.3f}  (frame start to display, {5} frames)",
+                presentSummary.Avg, presentSummary.P50, presentSummary.P95, presentSummary.P99, presentSummary.Max, s_Data.StartToPresent.size());
+        }
+        if (!s_Data.InputToPresent.empty())
+        {
+            const Summary inputSummary = Summarize(s_Data.InputToPresent);
+            GG_CORE_INFO("  Input:     avg {0:.3f}  p50 {1:.3f}  p95 {2:.3f}  p99 {3:.3f}  max {4:.3f}  (input to display, {5} frames)",
+                inputSummary.Avg, inputSummary.P50, inputSummary.P95, inputSummary.P99, inputSummary.Max, s_Data.InputToPresent.size());
+        }
+
+        if (csvPath.empty())
+            return;
+
+        std::ofstream out(csvPath, std::ios::out | std::ios::trunc);
+        if (!out)
+        {
+            GG_CORE_ERROR("Could not write frame stats to {0}", csvPath);
+            return;
+        }
+        out << "frame,cpu_ms,submit_ms,driver_allocs\n";
+        for (size_t i = 0; i < samples.size(); i++)
+            out << i << ',' << samples[i].CpuMs << ',' << samples[i].SubmitMs << ',' << samples[i].DriverAllocations << '\n';
+        GG_CORE_INFO("Frame stats written to {0}", csvPath);
+    }
+
+}
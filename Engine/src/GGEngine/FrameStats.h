@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Core.h"
+
+namespace GGEngine {
+
+    struct FrameSample
+    {
+        double CpuMs = 0.0;     // Whole main-loop iteration
+        double SubmitMs = 0.0;  // Time spent inside vkQueueSubmit / vkQueuePresentKHR
+        uint32_t DriverAllocations = 0; // Vulkan driver host allocations, with --track-driver-memory
+    };
+
+    // Per-frame CPU timings. Keeps a rolling window of recent frames; benchmark runs
+    // size the window to hold the whole session so the report covers every frame.
+    class GG_API FrameStats
+    {
+    public:
+        static void SetHistorySize(uint32_t frames);
+        static void Reset();
+
+        // Main thread only. Frames start once input has been polled for them; inputTime is
+        // the engine clock (Timer::Now) of the earliest input event the frame consumes, 0 without.
+        static void BeginFrame(double inputTime);
+        static double GetFrameStartTime();
+        static double GetFrameInputTime();
+
+        // Submission time accumulates until the frame is recorded.
+        static void AddSubmitTime(double milliseconds);
+        static void AddDriverAllocations(uint32_t count);
+        static void RecordFrame(double cpuMilliseconds);
+        // A frame reached the display, reported some frames later. inputToPresent is
+        // negative for frames without input.
+        static void RecordPresent(double startToPresentMilliseconds, double inputToPresentMilliseconds);
+
+        static uint64_t GetFrameCount();
+        static FrameSample GetLastFrame();
+
+        // Named in the report header, so numbers stay attributable to the hardware
+        static void SetDeviceDescription(const std::string& description);
+
+        // Logs avg/p50/p95/p99/max for the recorded window, present latencies included when measured, and optionally writes one CSV row per frame
+        static void Report(const std::string& csvPath = std::string());
+    };
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Core.h"
+#include "Math/Math.h"
+
+namespace GGEngine {
+
+    // One GPU-culled draw: an indexed range of the vertex and index buffers the caller
+    // binds, bounded by a world-space sphere
+    struct GPUCullObject
+    {
+        Vec3 Center;
+        float Radius = 0.0f;
+        uint32_t IndexCount = 0; // 0 disables the object
+        uint32_t FirstIndex = 0;
+        int32_t VertexOffset = 0;
+    };
+
+    // Objects for the renderer's GPU-driven culling, which tests them against the view
+    // frustum in a compute pass every frame and draws the visible ones indirectly.
+    // Main thread only.
+    class GG_API GPUCulling
+    {
+    public:
+        // Returns the object's handle, or UINT32_MAX when it could not be added
+        static uint32_t AddObject(const GPUCullObject& object);
+        static void UpdateObject(uint32_t handle, const GPUCullObject& object);
+        static void RemoveObject(uint32_t handle);
+
+        // Vulkan clip space, as built by Mat4::Perspective
+        static void SetViewProjection(const Mat4& viewProjection);
+
+        // Visible objects as counted by the GPU, a few frames after the cull that produced
+        // the count. False until a count has come back, and always without draw indirect count.
+        static bool GetVisibleCount(uint32_t& count);
+    };
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace GGEngine {
+
+    // 64-bit FNV-1a. Stable across runs and platforms, so the results can key on-disk caches.
+    class Hash
+    {
+    public:
+        static constexpr uint64_t FNV1aBasis = 14695981039346656037ull;
+        static constexpr uint64_t FNV1aPrime = 1099511628211ull;
+
+        static uint64_t FNV1a64(const void* data, size_t size, uint64_t seed = FNV1aBasis)
+        {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            uint64_t hash = seed;
+            for (size_t i = 0; i < size; i++)
+            {
+                hash ^= bytes[i];
+                hash *= FNV1aPrime;
+            }
+            return hash;
+        }
+
+        static uint64_t FNV1a64(std::string_view text, uint64_t seed = FNV1aBasis)
+        {
+            return FNV1a64(text.data(), text.size(), seed);
+        }
+
+        template<typename T>
+        static uint64_t Value(const T& value, uint64_t seed = FNV1aBasis)
+        {
+            return FNV1a64(&value, sizeof(T), seed);
+        }
+
+        // Change detection over large in-memory buffers (vertex data, draw lists): four
+        // independent 64-bit lanes, so it runs at memory speed where FNV-1a is bound by one
+        // multiply per byte. Results depend on byte order; never persist them.
+        static uint64_t Fast64(const void* data, size_t size, uint64_t seed = FNV1aBasis)
+        {
+            constexpr uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            uint64_t lanes[4] = { seed, seed ^ multiplier, seed + size, ~seed };
+
+            size_t offset = 0;
+            for (; offset + 32 <= size; offset += 32)
+            {
+                uint64_t words[4];
+                memcpy(words, bytes + offset, sizeof(words));
+                for (int i = 0; i < 4; i++)
+                {
+                    lanes[i] ^= words[i];
+                    lanes[i] *= multiplier;
+                    lanes[i] ^= lanes[i] >> 29;
+                }
+            }
+
+            uint64_t hash = FNV1a64(bytes + offset, size - offset, seed ^ size);
+            for (int i = 0; i < 4; i++)
+            {
+                hash ^= lanes[i];
+                hash *= multiplier;
+                hash ^= hash >> 32;
+            }
+            return hash;
+        }
+    };
+
+}
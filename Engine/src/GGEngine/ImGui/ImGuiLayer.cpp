@@ -4,6 +4,9 @@
 #include <glad/vulkan.h>
 
 #include "GGEngine/Application.h"
+#include "GGEngine/Events/ApplicationEvent.h"
+#include "GGEngine/FrameCapture.h"
+#include "GGEngine/Hash.h"
 #include "Platform/Vulkan/VulkanContext.h"
 
 #include "imgui.h"
@@ -74,9 +77,25 @@ namespace GGEngine {
     void ImGuiLayer::OnAttach()
     {
         // Create Vulkan context
-        GLFWwindow* window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
-        m_VulkanContext = new VulkanContext(window);
+        Application& app = Application::Get();
+        m_Headless = app.GetSpecification().Headless;
+        GLFWwindow* window = static_cast<GLFWwindow*>(app.GetWindow().GetNativeWindow());
+        if (m_Headless)
+        {
+            VulkanHeadlessSpec headlessSpec;
+            headlessSpec.Width = app.GetWindow().GetWidth();
+            headlessSpec.Height = app.GetWindow().GetHeight();
+            headlessSpec.ImageCount = app.GetSpecification().HeadlessImageCount;
+            m_VulkanContext = new VulkanContext(headlessSpec);
+        }
+        else
+        {
+            m_VulkanContext = new VulkanContext(window);
+        }
+        m_VulkanContext->SetDevicePreference(app.GetSpecification().GPU);
+        m_VulkanContext->SetHostAllocationTracking(app.GetSpecification().TrackDriverMemory);
         m_VulkanContext->Init();
+        m_VulkanContext->GetPresentTracker().SetPacing(app.GetSpecification().LowLatency);
 
         // Setup Dear ImGui context
         IMGUI_CHECKVERSION();
@@ -85,7 +104,16 @@ namespace GGEngine {
         io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
         io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;
         io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
-        io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+        if (m_Headless)
+        {
+            // No platform windows to spawn and no layout to persist between runs
+            io.IniFilename = nullptr;
+            io.DisplaySize = ImVec2((float)app.GetWindow().GetWidth(), (float)app.GetWindow().GetHeight());
+        }
+        else
+        {
+            io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+        }
 
         // Setup Dear ImGui style
         ImGui::StyleColorsDark();
@@ -99,23 +127,26 @@ namespace GGEngine {
         }
 
         // Setup Platform/Renderer backends
-        ImGui_ImplGlfw_InitForVulkan(window, true);
+        if (!m_Headless)
+            ImGui_ImplGlfw_InitForVulkan(window, true);
 
-        // Load Vulkan functions for ImGui using GLFW's Vulkan loader
+        // Load Vulkan functions for ImGui through the glad loader, which works with or without a window
         VkInstance instance = m_VulkanContext->GetInstance();
-        ImGui_ImplVulkan_LoadFunctions(VK_API_VERSION_1_0, [](const char* functionName, void* userData) {
+        ImGui_ImplVulkan_LoadFunctions(m_VulkanContext->GetApiVersion(), [](const char* functionName, void* userData) {
             VkInstance inst = (VkInstance)userData;
-            PFN_vkVoidFunction fn = glfwGetInstanceProcAddress(inst, functionName);
+            PFN_vkVoidFunction fn = vkGetInstanceProcAddr(inst, functionName);
             return fn;
         }, (void*)instance);
 
         ImGui_ImplVulkan_InitInfo initInfo = {};
+        initInfo.ApiVersion = m_VulkanContext->GetApiVersion();
         initInfo.Instance = m_VulkanContext->GetInstance();
         initInfo.PhysicalDevice = m_VulkanContext->GetPhysicalDevice();
         initInfo.Device = m_VulkanContext->GetDevice();
         initInfo.QueueFamily = m_VulkanContext->GetQueueFamily();
         initInfo.Queue = m_VulkanContext->GetQueue();
         initInfo.DescriptorPool = m_VulkanContext->GetDescriptorPool();
+        initInfo.PipelineCache = m_VulkanContext->GetPipelineCache().GetHandle();
         initInfo.MinImageCount = m_VulkanContext->GetMinImageCount();
         initInfo.ImageCount = m_VulkanContext->GetImageCount();
         initInfo.CheckVkResultFn = CheckVkResult;
@@ -124,6 +155,16 @@ namespace GGEngine {
         initInfo.PipelineInfoMain.RenderPass = m_VulkanContext->GetRenderPass();
         initInfo.PipelineInfoMain.Subpass = 0;
         initInfo.PipelineInfoMain.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
+
+        // With dynamic rendering the pipeline only needs to know the attachment formats
+        const VkFormat* colorFormat = &m_VulkanContext->GetColorFormat();
+        if (m_VulkanContext->UsesDynamicRendering())
+        {
+            initInfo.UseDynamicRendering = true;
+            initInfo.PipelineInfoMain.PipelineRenderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+            initInfo.PipelineInfoMain.PipelineRenderingCreateInfo.colorAttachmentCount = 1;
+            initInfo.PipelineInfoMain.PipelineRenderingCreateInfo.pColorAttachmentFormats = colorFormat;
+        }
         
         // Secondary viewports pipeline (for multi-viewport support)
         initInfo.PipelineInfoForViewports.Subpass = 0;
@@ -137,7 +178,8 @@ namespace GGEngine {
     void ImGuiLayer::OnDetach()
     {
         ImGui_ImplVulkan_Shutdown();
-        ImGui_ImplGlfw_Shutdown();
+        if (!m_Headless)
+            ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
 
         if (m_VulkanContext)
@@ -147,16 +189,60 @@ namespace GGEngine {
         }
     }
 
+    void ImGuiLayer::WaitForFrameStart()
+    {
+        if (m_VulkanContext)
+            m_VulkanContext->GetPresentTracker().WaitForFrameStart();
+    }
+
+    // Corner overlay with the driver's host memory, per allocation scope. Frames where the
+    // driver allocated are highlighted, since they point at hot-path allocations.
+    static void DrawDriverMemoryOverlay(const VulkanHostAllocationStats& stats)
+    {
+        const ImGuiViewport* viewport = ImGui::GetMainViewport();
+        ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + viewport->WorkSize.x - 10.0f, viewport->WorkPos.y + 10.0f), ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+        ImGui::SetNextWindowViewport(viewport->ID);
+        ImGui::SetNextWindowBgAlpha(0.6f);
+        const ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings
+            | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove;
+        if (ImGui::Begin("Driver host memory", nullptr, flags))
+        {
+            ImGui::Text("Driver host memory: %.1f KiB live, %.1f KiB internal", stats.GetLiveBytes() / 1024.0, stats.InternalBytes / 1024.0);
+            for (uint32_t scope = 0; scope < VulkanHostAllocationStats::ScopeCount; scope++)
+            {
+                ImGui::Text("  %-8s %8.1f KiB in %llu blocks", VulkanHostAllocationStats::GetScopeName(scope),
+                    stats.LiveBytes[scope] / 1024.0, (unsigned long long)stats.LiveAllocations[scope]);
+            }
+
+            const uint64_t allocations = stats.GetFrameAllocations();
+            const ImVec4 color = allocations > 0 ? ImVec4(1.0f, 0.6f, 0.2f, 1.0f) : ImVec4(0.6f, 0.9f, 0.6f, 1.0f);
+            ImGui::TextColored(color, "Last frame: %llu allocations (%llu bytes), %llu frees",
+                (unsigned long long)allocations, (unsigned long long)stats.GetFrameBytes(), (unsigned long long)stats.FrameFrees);
+        }
+        ImGui::End();
+    }
+
     void ImGuiLayer::OnImGuiRender()
     {
         // Demo window for testing (can be removed later)
         static bool showDemoWindow = true;
         if (showDemoWindow)
             ImGui::ShowDemoWindow(&showDemoWindow);
+
+        if (m_VulkanContext->IsTrackingHostAllocations())
+            DrawDriverMemoryOverlay(m_VulkanContext->GetHostAllocationStats());
     }
 
     void ImGuiLayer::OnEvent(Event& event)
     {
+        // Not marked handled: layers below may track the framebuffer size as well
+        EventDispatcher dispatcher(event);
+        dispatcher.Dispatch<FramebufferResizeEvent>([this](FramebufferResizeEvent& e)
+        {
+            m_VulkanContext->OnFramebufferResize(e.GetWidth(), e.GetHeight());
+            return false;
+        });
+
         if (m_BlockEvents)
         {
             ImGuiIO& io = ImGui::GetIO();
@@ -170,8 +256,18 @@ namespace GGEngine {
         // Handle swapchain rebuild on resize
         m_VulkanContext->BeginFrame();
 
-        GLFWwindow* window = static_cast<GLFWwindow*>(Application::Get().GetWindow().GetNativeWindow());
-        if (glfwGetWindowAttrib(window, GLFW_ICONIFIED) != 0)
+        if (m_Headless)
+        {
+            // Fixed timestep keeps benchmark runs deterministic
+            ImGuiIO& io = ImGui::GetIO();
+            io.DeltaTime = 1.0f / 60.0f;
+            ImGui_ImplVulkan_NewFrame();
+            ImGui::NewFrame();
+            m_FrameStarted = true;
+            return;
+        }
+
+        if (Application::Get().GetWindow().IsIconified())
         {
             ImGui_ImplGlfw_Sleep(10);
             m_FrameStarted = false;
@@ -187,117 +283,98 @@ namespace GGEngine {
     void ImGuiLayer::End()
     {
         if (!m_FrameStarted)
+        {
+            m_FrameIdle = true;
             return;
+        }
 
+        // DisplaySize (window units) and DisplayFramebufferScale come from the platform
+        // backend, or stay fixed when headless; the draw data is scaled to framebuffer pixels
         ImGuiIO& io = ImGui::GetIO();
-        Application& app = Application::Get();
-        io.DisplaySize = ImVec2((float)app.GetWindow().GetWidth(), (float)app.GetWindow().GetHeight());
 
         // Rendering
         ImGui::Render();
         ImDrawData* mainDrawData = ImGui::GetDrawData();
         const bool mainIsMinimized = (mainDrawData->DisplaySize.x <= 0.0f || mainDrawData->DisplaySize.y <= 0.0f);
 
-        ImGui_ImplVulkanH_Window* wd = m_VulkanContext->GetWindowData();
-        wd->ClearValue.color.float32[0] = 0.1f;
-        wd->ClearValue.color.float32[1] = 0.1f;
-        wd->ClearValue.color.float32[2] = 0.1f;
-        wd->ClearValue.color.float32[3] = 1.0f;
+        m_VulkanContext->SetClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 
         if (!mainIsMinimized)
-            FrameRender(mainDrawData);
+        {
+            FrameCapture::OnFrameRender();
+            m_VulkanContext->FrameRender(mainDrawData);
+        }
 
-        // Update and Render additional Platform Windows
+        // Additional platform windows are recorded one after the other and submitted as one batch
         if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
         {
             ImGui::UpdatePlatformWindows();
-            ImGui::RenderPlatformWindowsDefault();
+            m_VulkanContext->RenderViewports();
         }
 
-        // Present Main Platform Window
-        if (!mainIsMinimized)
-            FramePresent();
+        // Main window and platform windows go out in a single present
+        m_VulkanContext->FramePresent();
+
+        // Every main window draw list re-executed last frame's recording. Lists with user
+        // callbacks are re-recorded each frame, so they count as animating.
+        const ImGuiRendererStats& stats = m_VulkanContext->GetImGuiRendererStats();
+        const bool unchanged = mainIsMinimized || (stats.Active && stats.ReusedLists == stats.Lists);
+        // Input into floating windows reaches ImGui through the backend, not Application::OnEvent
+        const bool interacting = ImGui::IsAnyItemActive() || io.MouseDelta.x != 0.0f || io.MouseDelta.y != 0.0f
+            || io.MouseWheel != 0.0f || io.MouseWheelH != 0.0f;
+        const bool viewportsChanged = ViewportsChanged();
+        m_FrameIdle = unchanged && !interacting && !viewportsChanged && !m_VulkanContext->HasPendingWork();
     }
 
-    // Private helper - forward to VulkanContext
-    void ImGuiLayer::FrameRender(ImDrawData* drawData)
+    bool ImGuiLayer::ViewportsChanged()
     {
-        ImGui_ImplVulkanH_Window* wd = m_VulkanContext->GetWindowData();
-        VkDevice device = m_VulkanContext->GetDevice();
-        VkQueue queue = m_VulkanContext->GetQueue();
-
-        VkSemaphore imageAcquiredSemaphore = wd->FrameSemaphores[wd->SemaphoreIndex].ImageAcquiredSemaphore;
-        VkSemaphore renderCompleteSemaphore = wd->FrameSemaphores[wd->SemaphoreIndex].RenderCompleteSemaphore;
-        VkResult err = vkAcquireNextImageKHR(device, wd->Swapchain, UINT64_MAX, imageAcquiredSemaphore, VK_NULL_HANDLE, &wd->FrameIndex);
-        if (err == VK_ERROR_OUT_OF_DATE_KHR || err == VK_SUBOPTIMAL_KHR)
-            m_VulkanContext->SetSwapchainRebuild(true);
-        if (err == VK_ERROR_OUT_OF_DATE_KHR)
-            return;
-
-        ImGui_ImplVulkanH_Frame* fd = &wd->Frames[wd->FrameIndex];
-        {
-            err = vkWaitForFences(device, 1, &fd->Fence, VK_TRUE, UINT64_MAX);
-            err = vkResetFences(device, 1, &fd->Fence);
-        }
+        ImGuiPlatformIO& platformIO = ImGui::GetPlatformIO();
+        bool changed = false;
+        for (int i = 1; i < platformIO.Viewports.Size; i++)
         {
-            err = vkResetCommandPool(device, fd->CommandPool, 0);
-            VkCommandBufferBeginInfo info = {};
-            info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-            info.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-            err = vkBeginCommandBuffer(fd->CommandBuffer, &info);
+            const ImGuiViewport* viewport = platformIO.Viewports[i];
+            const ImDrawData* drawData = viewport->DrawData;
+            if ((viewport->Flags & ImGuiViewportFlags_IsMinimized) || drawData == nullptr)
+                continue;
+
+            uint64_t hash = Hash::Value(drawData->DisplayPos);
+            hash = Hash::Value(drawData->DisplaySize, hash);
+            for (const ImDrawList* list : drawData->CmdLists)
+            {
+                hash = Hash::Fast64(list->VtxBuffer.Data, (size_t)list->VtxBuffer.Size * sizeof(ImDrawVert), hash);
+                hash = Hash::Fast64(list->IdxBuffer.Data, (size_t)list->IdxBuffer.Size * sizeof(ImDrawIdx), hash);
+                for (const ImDrawCmd& cmd : list->CmdBuffer)
+                {
+                    // Callbacks may draw something different every frame
+                    if (cmd.UserCallback != nullptr && cmd.UserCallback != ImDrawCallback_ResetRenderState)
+                        changed = true;
+                    hash = Hash::Value(cmd.ClipRect, hash);
+                    hash = Hash::Value(cmd.UserCallback != nullptr ? ImTextureID_Invalid : cmd.GetTexID(), hash);
+                    hash = Hash::Value(cmd.ElemCount, hash);
+                }
+            }
+
+            auto [it, inserted] = m_ViewportHashes.try_emplace(viewport->ID, hash);
+            if (inserted || it->second != hash)
+                changed = true;
+            it->second = hash;
         }
-        {
-            VkRenderPassBeginInfo info = {};
-            info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-            info.renderPass = wd->RenderPass;
-            info.framebuffer = fd->Framebuffer;
-            info.renderArea.extent.width = wd->Width;
-            info.renderArea.extent.height = wd->Height;
-            info.clearValueCount = 1;
-            info.pClearValues = &wd->ClearValue;
-            vkCmdBeginRenderPass(fd->CommandBuffer, &info, VK_SUBPASS_CONTENTS_INLINE);
-        }
-
-        ImGui_ImplVulkan_RenderDrawData(drawData, fd->CommandBuffer);
 
-        vkCmdEndRenderPass(fd->CommandBuffer);
+        // Closed windows drop out; closing one was a change in itself
+        if (m_ViewportHashes.size() > (size_t)std::max(platformIO.Viewports.Size - 1, 0))
         {
-            VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            VkSubmitInfo info = {};
-            info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            info.waitSemaphoreCount = 1;
-            info.pWaitSemaphores = &imageAcquiredSemaphore;
-            info.pWaitDstStageMask = &waitStage;
-            info.commandBufferCount = 1;
-            info.pCommandBuffers = &fd->CommandBuffer;
-            info.signalSemaphoreCount = 1;
-            info.pSignalSemaphores = &renderCompleteSemaphore;
-
-            err = vkEndCommandBuffer(fd->CommandBuffer);
-            err = vkQueueSubmit(queue, 1, &info, fd->Fence);
+            for (auto it = m_ViewportHashes.begin(); it != m_ViewportHashes.end(); )
+            {
+                if (ImGui::FindViewportByID(it->first) == nullptr)
+                {
+                    it = m_ViewportHashes.erase(it);
+                    changed = true;
+                }
+                else
+                    ++it;
+            }
         }
-    }
-
-    void ImGuiLayer::FramePresent()
-    {
-        if (m_VulkanContext->NeedsSwapchainRebuild())
-            return;
-
-        ImGui_ImplVulkanH_Window* wd = m_VulkanContext->GetWindowData();
-        VkQueue queue = m_VulkanContext->GetQueue();
-
-        VkSemaphore renderCompleteSemaphore = wd->FrameSemaphores[wd->SemaphoreIndex].RenderCompleteSemaphore;
-        VkPresentInfoKHR info = {};
-        info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        info.waitSemaphoreCount = 1;
-        info.pWaitSemaphores = &renderCompleteSemaphore;
-        info.swapchainCount = 1;
-        info.pSwapchains = &wd->Swapchain;
-        info.pImageIndices = &wd->FrameIndex;
-        VkResult err = vkQueuePresentKHR(queue, &info);
-        if (err == VK_ERROR_OUT_OF_DATE_KHR || err == VK_SUBOPTIMAL_KHR)
-            m_VulkanContext->SetSwapchainRebuild(true);
-        wd->SemaphoreIndex = (wd->SemaphoreIndex + 1) % wd->SemaphoreCount;
+        return changed;
     }
 
 }
@@ -2,7 +2,7 @@
 
 #include "GGEngine/Layer.h"
 
-struct ImDrawData;
+#include <unordered_map>
 
 namespace GGEngine {
 
@@ -24,16 +24,26 @@ namespace GGEngine {
 
         void SetBlockEvents(bool block) { m_BlockEvents = block; }
         bool IsFrameStarted() const { return m_FrameStarted; }
+        // The last frame drew exactly what the one before it did (or nothing, minimized) in
+        // every platform window, no ImGui input was in flight, and no GPU work that could
+        // change the next one is still landing
+        bool IsFrameIdle() const { return m_FrameIdle; }
+        // Low-latency pacing: blocks until the previous frame is on screen plus the learned
+        // delay. Returns at once when present timing is unavailable.
+        void WaitForFrameStart();
 
     private:
-        void FrameRender(ImDrawData* drawData);
-        void FramePresent();
+        // Platform windows other than the main one drew something new, or draw through callbacks
+        bool ViewportsChanged();
 
     private:
         bool m_BlockEvents = true;
         bool m_FrameStarted = false;
+        bool m_FrameIdle = false;
+        bool m_Headless = false;
         float m_Time = 0.0f;
         VulkanContext* m_VulkanContext = nullptr;
+        std::unordered_map<uint32_t, uint64_t> m_ViewportHashes; // Draw data hash by ImGuiID, last frame
     };
 
 }
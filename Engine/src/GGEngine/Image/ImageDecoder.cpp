@@ -0,0 +1,737 @@
+#include "ImageDecoder.h"
+
+namespace GGEngine {
+
+    namespace {
+
+        constexpr uint32_t MaxDimension = 32768;
+        constexpr size_t MaxPixels = (size_t)1 << 28;
+
+        uint32_t ReadU32BE(const uint8_t* p)
+        {
+            return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+        }
+
+        bool ValidDimensions(uint32_t width, uint32_t height)
+        {
+            return width > 0 && height > 0 && width <= MaxDimension && height <= MaxDimension
+                && (size_t)width * height <= MaxPixels;
+        }
+
+        bool Fail(std::string* error, const char* message)
+        {
+            if (error)
+                *error = message;
+            return false;
+        }
+
+        // ---- Inflate (RFC 1950 / 1951) ------------------------------------------------
+
+        class BitReader
+        {
+        public:
+            BitReader(const uint8_t* data, size_t size) : m_Data(data), m_Size(size) {}
+
+            void Refill()
+            {
+                while (m_Count <= 56)
+                {
+                    const uint64_t byte = m_Pos < m_Size ? m_Data[m_Pos] : 0;
+                    m_Pos++;
+                    m_Buffer |= byte << m_Count;
+                    m_Count += 8;
+                }
+            }
+
+            uint32_t Peek(int bits) const { return (uint32_t)(m_Buffer & ((1ull << bits) - 1)); }
+            void Consume(int bits) { m_Buffer >>= bits; m_Count -= bits; }
+
+            uint32_t Read(int bits)
+            {
+                if (m_Count < bits)
+                    Refill();
+                const uint32_t value = Peek(bits);
+                Consume(bits);
+                return value;
+            }
+
+            // Drops the partial byte and rewinds the look-ahead so bytes can be copied directly
+            void AlignToByte()
+            {
+                Consume(m_Count % 8);
+                m_Pos -= m_Count / 8;
+                m_Buffer = 0;
+                m_Count = 0;
+            }
+
+            size_t GetBytePosition() const { return m_Pos; }
+            void SkipBytes(size_t count) { m_Pos += count; }
+            const uint8_t* GetData() const { return m_Data; }
+            size_t GetSize() const { return m_Size; }
+
+            // True once more bits were consumed than the stream holds
+            bool IsOverrun() const { return m_Pos * 8 - m_Count > m_Size * 8; }
+
+        private:
+            const uint8_t* m_Data;
+            size_t m_Size;
+            size_t m_Pos = 0;
+            uint64_t m_Buffer = 0;
+            int m_Count = 0;
+        };
+
+        constexpr int FastBits = 10;
+
+        struct Huffman
+        {
+            uint16_t Count[16];
+            uint16_t Symbol[288];
+            uint16_t Fast[1 << FastBits]; // (length << 9) | symbol, 0 when the code is longer
+        };
+
+        bool BuildHuffman(Huffman& huffman, const uint8_t* lengths, int count)
+        {
+            memset(huffman.Count, 0, sizeof(huffman.Count));
+            memset(huffman.Fast, 0, sizeof(huffman.Fast));
+            for (int i = 0; i < count; i++)
+                huffman.Count[lengths[i]]++;
+            huffman.Count[0] = 0;
+
+            int left = 1;
+            for (int len = 1; len < 16; len++)
+            {
+                left = (left << 1) - huffman.Count[len];
+                if (left < 0)
+                    return false; // Over-subscribed
+            }
+
+            uint16_t offsets[16];
+            uint32_t nextCode[16];
+            offsets[1] = 0;
+            nextCode[1] = 0;
+            for (int len = 1; len < 15; len++)
+            {
+                offsets[len + 1] = offsets[len] + huffman.Count[len];
+                nextCode[len + 1] = (nextCode[len] + huffman.Count[len]) << 1;
+            }
+
+            for (int symbol = 0; symbol < count; symbol++)
+            {
+                const int len = lengths[symbol];
+                if (len == 0)
+                    continue;
+                huffman.Symbol[offsets[len]++] = (uint16_t)symbol;
+
+                const uint32_t code = nextCode[len]++;
+                if (len > FastBits)
+                    continue;
+                // Codes are stored MSB first, the bit reader hands out LSB first
+                uint32_t reversed = 0;
+                for (int bit = 0; bit < len; bit++)
+                    reversed |= ((code >> bit) & 1) << (len - 1 - bit);
+                for (uint32_t i = reversed; i < (1u << FastBits); i += 1u << len)
+                    huffman.Fast[i] = (uint16_t)((len << 9) | symbol);
+            }
+            return true;
+        }
+
+        int DecodeSymbol(const Huffman& huffman, BitReader& reader)
+        {
+            reader.Refill();
+            const uint16_t entry = huffman.Fast[reader.Peek(FastBits)];
+            if (entry != 0)
+            {
+                reader.Consume(entry >> 9);
+                return entry & 511;
+            }
+
+            // Canonical decode one bit at a time for long codes
+            int code = 0, first = 0, index = 0;
+            for (int len = 1; len < 16; len++)
+            {
+                code |= (int)reader.Read(1);
+                const int count = huffman.Count[len];
+                if (code - first < count)
+                    return huffman.Symbol[index + code - first];
+                index += count;
+                first = (first + count) << 1;
+                code <<= 1;
+            }
+            return -1;
+        }
+
+        const uint16_t LengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        const uint8_t LengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        const uint16_t DistBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+        const uint8_t DistExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+        bool InflateCodes(BitReader& reader, const Huffman& lit, const Huffman& dist, std::vector<uint8_t>& out, size_t maxSize)
+        {
+            for (;;)
+            {
+                const int symbol = DecodeSymbol(lit, reader);
+                if (symbol < 0 || reader.IsOverrun())
+                    return false;
+                if (symbol < 256)
+                {
+                    if (out.size() >= maxSize)
+                        return false;
+                    out.push_back((uint8_t)symbol);
+                    continue;
+                }
+                if (symbol == 256)
+                    return true;
+
+                const int lengthIndex = symbol - 257;
+                if (lengthIndex >= 29)
+                    return false;
+                const size_t length = LengthBase[lengthIndex] + reader.Read(LengthExtra[lengthIndex]);
+
+                const int distSymbol = DecodeSymbol(dist, reader);
+                if (distSymbol < 0 || distSymbol >= 30)
+                    return false;
+                const size_t distance = DistBase[distSymbol] + reader.Read(DistExtra[distSymbol]);
+                if (distance > out.size() || out.size() + length > maxSize)
+                    return false;
+
+                // Byte by byte: source and destination may overlap
+                size_t from = out.size() - distance;
+                for (size_t i = 0; i < length; i++)
+                    out.push_back(out[from + i]);
+            }
+        }
+
+        const std::pair<Huffman, Huffman>& GetFixedHuffman()
+        {
+            static const std::pair<Huffman, Huffman> fixed = []()
+            {
+                std::pair<Huffman, Huffman> result;
+                uint8_t lengths[288];
+                for (int i = 0; i < 144; i++) lengths[i] = 8;
+                for (int i = 144; i < 256; i++) lengths[i] = 9;
+                for (int i = 256; i < 280; i++) lengths[i] = 7;
+                for (int i = 280; i < 288; i++) lengths[i] = 8;
+                BuildHuffman(result.first, lengths, 288);
+                for (int i = 0; i < 30; i++) lengths[i] = 5;
+                BuildHuffman(result.second, lengths, 30);
+                return result;
+            }();
+            return fixed;
+        }
+
+        bool InflateDynamic(BitReader& reader, std::vector<uint8_t>& out, size_t maxSize)
+        {
+            static const uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+            const int litCount = (int)reader.Read(5) + 257;
+            const int distCount = (int)reader.Read(5) + 1;
+            const int codeCount = (int)reader.Read(4) + 4;
+            if (litCount > 286 || distCount > 30)
+                return false;
+
+            uint8_t codeLengths[19] = {};
+            for (int i = 0; i < codeCount; i++)
+                codeLengths[order[i]] = (uint8_t)reader.Read(3);
+            Huffman codeHuffman;
+            if (!BuildHuffman(codeHuffman, codeLengths, 19))
+                return false;
+
+            uint8_t lengths[286 + 30] = {};
+            int index = 0;
+            while (index < litCount + distCount)
+            {
+                const int symbol = DecodeSymbol(codeHuffman, reader);
+                if (symbol < 0 || reader.IsOverrun())
+                    return false;
+                if (symbol < 16)
+                {
+                    lengths[index++] = (uint8_t)symbol;
+                    continue;
+                }
+
+                uint8_t value = 0;
+                int repeat = 0;
+                if (symbol == 16)
+                {
+                    if (index == 0)
+                        return false;
+                    value = lengths[index - 1];
+                    repeat = 3 + (int)reader.Read(2);
+                }
+                else if (symbol == 17)
+                    repeat = 3 + (int)reader.Read(3);
+                else
+                    repeat = 11 + (int)reader.Read(7);
+
+                if (index + repeat > litCount + distCount)
+                    return false;
+                while (repeat-- > 0)
+                    lengths[index++] = value;
+            }
+            if (lengths[256] == 0)
+                return false; // No end-of-block code
+
+            Huffman lit, dist;
+            if (!BuildHuffman(lit, lengths, litCount) || !BuildHuffman(dist, lengths + litCount, distCount))
+                return false;
+            return InflateCodes(reader, lit, dist, out, maxSize);
+        }
+
+        // Decompresses a zlib stream. maxSize bounds the output so corrupt data cannot balloon it.
+        bool ZlibInflate(const uint8_t* data, size_t size, std::vector<uint8_t>& out, size_t maxSize)
+        {
+            if (size < 2 || (data[0] & 0x0F) != 8 || ((data[0] << 8) | data[1]) % 31 != 0 || (data[1] & 0x20) != 0)
+                return false;
+
+            BitReader reader(data + 2, size - 2);
+            bool last = false;
+            while (!last)
+            {
+                last = reader.Read(1) != 0;
+                const uint32_t type = reader.Read(2);
+                if (type == 0)
+                {
+                    reader.AlignToByte();
+                    const size_t pos = reader.GetBytePosition();
+                    if (pos + 4 > reader.GetSize())
+                        return false;
+                    const uint8_t* header = reader.GetData() + pos;
+                    const uint32_t length = header[0] | (header[1] << 8);
+                    const uint32_t inverse = header[2] | (header[3] << 8);
+                    if ((length ^ 0xFFFF) != inverse || pos + 4 + length > reader.GetSize() || out.size() + length > maxSize)
+                        return false;
+                    out.insert(out.end(), header + 4, header + 4 + length);
+                    reader.SkipBytes(4 + length);
+                }
+                else if (type == 1)
+                {
+                    const auto& fixed = GetFixedHuffman();
+                    if (!InflateCodes(reader, fixed.first, fixed.second, out, maxSize))
+                        return false;
+                }
+                else if (type == 2)
+                {
+                    if (!InflateDynamic(reader, out, maxSize))
+                        return false;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // ---- PNG ----------------------------------------------------------------------
+
+        const uint8_t PngSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+        bool IsPng(const uint8_t* data, size_t size)
+        {
+            return size >= 8 + 25 && memcmp(data, PngSignature, 8) == 0;
+        }
+
+        struct PngHeader
+        {
+            uint32_t Width = 0;
+            uint32_t Height = 0;
+            uint8_t BitDepth = 0;
+            uint8_t ColorType = 0;
+            uint8_t Interlace = 0;
+            uint32_t Channels = 0;
+        };
+
+        bool ReadPngHeader(const uint8_t* data, size_t size, PngHeader& header)
+        {
+            if (!IsPng(data, size) || ReadU32BE(data + 8) != 13 || memcmp(data + 12, "IHDR", 4) != 0)
+                return false;
+
+            const uint8_t* ihdr = data + 16;
+            header.Width = ReadU32BE(ihdr);
+            header.Height = ReadU32BE(ihdr + 4);
+            header.BitDepth = ihdr[8];
+            header.ColorType = ihdr[9];
+            header.Interlace = ihdr[12];
+            if (ihdr[10] != 0 || ihdr[11] != 0 || header.Interlace > 1 || !ValidDimensions(header.Width, header.Height))
+                return false;
+
+            const uint8_t depth = header.BitDepth;
+            switch (header.ColorType)
+            {
+            case 0: header.Channels = 1; return depth == 1 || depth == 2 || depth == 4 || depth == 8 || depth == 16;
+            case 2: header.Channels = 3; return depth == 8 || depth == 16;
+            case 3: header.Channels = 1; return depth == 1 || depth == 2 || depth == 4 || depth == 8;
+            case 4: header.Channels = 2; return depth == 8 || depth == 16;
+            case 6: header.Channels = 4; return depth == 8 || depth == 16;
+            default: return false;
+            }
+        }
+
+        uint8_t Paeth(int a, int b, int c)
+        {
+            const int p = a + b - c;
+            const int pa = std::abs(p - a);
+            const int pb = std::abs(p - b);
+            const int pc = std::abs(p - c);
+            if (pa <= pb && pa <= pc)
+                return (uint8_t)a;
+            return (uint8_t)(pb <= pc ? b : c);
+        }
+
+        // Reverses the per-scanline filters in place. rows points at filter byte + rowBytes per line.
+        bool Unfilter(uint8_t* rows, uint32_t height, size_t rowBytes, uint32_t bpp)
+        {
+            const uint8_t* previous = nullptr;
+            for (uint32_t y = 0; y < height; y++)
+            {
+                uint8_t* line = rows + y * (rowBytes + 1);
+                const uint8_t filter = line[0];
+                uint8_t* row = line + 1;
+                switch (filter)
+                {
+                case 0:
+                    break;
+                case 1:
+                    for (size_t i = bpp; i < rowBytes; i++)
+                        row[i] = (uint8_t)(row[i] + row[i - bpp]);
+                    break;
+                case 2:
+                    if (previous)
+                        for (size_t i = 0; i < rowBytes; i++)
+                            row[i] = (uint8_t)(row[i] + previous[i]);
+                    break;
+                case 3:
+                    for (size_t i = 0; i < rowBytes; i++)
+                    {
+                        const int left = i >= bpp ? row[i - bpp] : 0;
+                        const int up = previous ? previous[i] : 0;
+                        row[i] = (uint8_t)(row[i] + ((left + up) >> 1));
+                    }
+                    break;
+                case 4:
+                    for (size_t i = 0; i < rowBytes; i++)
+                    {
+                        const int left = i >= bpp ? row[i - bpp] : 0;
+                        const int up = previous ? previous[i] : 0;
+                        const int upLeft = (previous && i >= bpp) ? previous[i - bpp] : 0;
+                        row[i] = (uint8_t)(row[i] + Paeth(left, up, upLeft));
+                    }
+                    break;
+                default:
+                    return false;
+                }
+                previous = row;
+            }
+            return true;
+        }
+
+        struct PngPalette
+        {
+            uint8_t Colors[256][4];
+            uint32_t Count = 0;
+            bool HasKey = false;
+            uint16_t Key[3] = {}; // tRNS color key for gray / RGB images, at the image bit depth
+        };
+
+        // Converts one unfiltered scanline to RGBA, writing pixel i to dst + i * dstStep
+        void ExpandRow(const PngHeader& header, const PngPalette& palette, const uint8_t* row, uint32_t width, uint8_t* dst, size_t dstStep)
+        {
+            const uint32_t depth = header.BitDepth;
+            const uint32_t channels = header.Channels;
+            const uint32_t maxValue = (1u << depth) - 1;
+
+            auto sample = [&](uint32_t index) -> uint32_t
+            {
+                if (depth == 8)
+                    return row[index];
+                if (depth == 16)
+                    return ((uint32_t)row[index * 2] << 8) | row[index * 2 + 1];
+                const uint32_t bit = index * depth;
+                return (row[bit >> 3] >> (8 - depth - (bit & 7))) & maxValue;
+            };
+            auto scale = [&](uint32_t value) -> uint8_t
+            {
+                if (depth == 8)
+                    return (uint8_t)value;
+                if (depth == 16)
+                    return (uint8_t)(value >> 8);
+                return (uint8_t)(value * 255 / maxValue);
+            };
+
+            for (uint32_t x = 0; x < width; x++, dst += dstStep)
+            {
+                const uint32_t base = x * channels;
+                switch (header.ColorType)
+                {
+                case 0:
+                {
+                    const uint32_t gray = sample(base);
+                    dst[0] = dst[1] = dst[2] = scale(gray);
+                    dst[3] = (palette.HasKey && gray == palette.Key[0]) ? 0 : 255;
+                    break;
+                }
+                case 2:
+                {
+                    const uint32_t r = sample(base), g = sample(base + 1), b = sample(base + 2);
+                    dst[0] = scale(r);
+                    dst[1] = scale(g);
+                    dst[2] = scale(b);
+                    dst[3] = (palette.HasKey && r == palette.Key[0] && g == palette.Key[1] && b == palette.Key[2]) ? 0 : 255;
+                    break;
+                }
+                case 3:
+                {
+                    const uint32_t index = sample(base);
+                    if (index < palette.Count)
+                        memcpy(dst, palette.Colors[index], 4);
+                    else
+                        dst[0] = dst[1] = dst[2] = 0, dst[3] = 255;
+                    break;
+                }
+                case 4:
+                    dst[0] = dst[1] = dst[2] = scale(sample(base));
+                    dst[3] = scale(sample(base + 1));
+                    break;
+                case 6:
+                    dst[0] = scale(sample(base));
+                    dst[1] = scale(sample(base + 1));
+                    dst[2] = scale(sample(base + 2));
+                    dst[3] = scale(sample(base + 3));
+                    break;
+                }
+            }
+        }
+
+        bool DecodePng(const uint8_t* data, size_t size, uint8_t* dst, std::string* error)
+        {
+            PngHeader header;
+            if (!ReadPngHeader(data, size, header))
+                return Fail(error, "Unsupported or corrupt PNG header");
+
+            PngPalette palette;
+            std::vector<uint8_t> compressed;
+            size_t offset = 8;
+            bool ended = false;
+            while (!ended && offset + 12 <= size)
+            {
+                const uint32_t length = ReadU32BE(data + offset);
+                const uint8_t* type = data + offset + 4;
+                const uint8_t* chunk = data + offset + 8;
+                if (length > size - offset - 12)
+                    return Fail(error, "Truncated PNG chunk");
+
+                if (memcmp(type, "IDAT", 4) == 0)
+                {
+                    compressed.insert(compressed.end(), chunk, chunk + length);
+                }
+                else if (memcmp(type, "PLTE", 4) == 0)
+                {
+                    if (length % 3 != 0 || length / 3 > 256)
+                        return Fail(error, "Invalid PNG palette");
+                    palette.Count = length / 3;
+                    for (uint32_t i = 0; i < palette.Count; i++)
+                    {
+                        palette.Colors[i][0] = chunk[i * 3];
+                        palette.Colors[i][1] = chunk[i * 3 + 1];
+                        palette.Colors[i][2] = chunk[i * 3 + 2];
+                        palette.Colors[i][3] = 255;
+                    }
+                }
+                else if (memcmp(type, "tRNS", 4) == 0)
+                {
+                    if (header.ColorType == 3)
+                    {
+                        for (uint32_t i = 0; i < length && i < 256; i++)
+                            palette.Colors[i][3] = chunk[i];
+                    }
+                    else if (header.ColorType == 0 && length >= 2)
+                    {
+                        palette.HasKey = true;
+                        palette.Key[0] = (uint16_t)((chunk[0] << 8) | chunk[1]);
+                    }
+                    else if (header.ColorType == 2 && length >= 6)
+                    {
+                        palette.HasKey = true;
+                        for (int i = 0; i < 3; i++)
+                            palette.Key[i] = (uint16_t)((chunk[i * 2] << 8) | chunk[i * 2 + 1]);
+                    }
+                }
+                else if (memcmp(type, "IEND", 4) == 0)
+                {
+                    ended = true;
+                }
+                else if ((type[0] & 0x20) == 0 && memcmp(type, "IHDR", 4) != 0)
+                {
+                    return Fail(error, "PNG uses an unknown critical chunk");
+                }
+                offset += 12 + (size_t)length;
+            }
+            if (header.ColorType == 3 && palette.Count == 0)
+                return Fail(error, "Palette PNG without PLTE chunk");
+
+            // Adam7 passes: x start, y start, x step, y step. A plain image is a single pass.
+            static const uint32_t adam7[7][4] = { { 0, 0, 8, 8 }, { 4, 0, 8, 8 }, { 0, 4, 4, 8 }, { 2, 0, 4, 4 }, { 0, 2, 2, 4 }, { 1, 0, 2, 2 }, { 0, 1, 1, 2 } };
+            static const uint32_t single[1][4] = { { 0, 0, 1, 1 } };
+            const uint32_t (*passes)[4] = header.Interlace ? adam7 : single;
+            const uint32_t passCount = header.Interlace ? 7 : 1;
+
+            const uint32_t bitsPerPixel = header.Channels * header.BitDepth;
+            const uint32_t bpp = std::max(1u, bitsPerPixel / 8);
+            size_t expected = 0;
+            for (uint32_t pass = 0; pass < passCount; pass++)
+            {
+                const uint32_t width = (header.Width - passes[pass][0] + passes[pass][2] - 1) / passes[pass][2];
+                const uint32_t height = (header.Height - passes[pass][1] + passes[pass][3] - 1) / passes[pass][3];
+                if (header.Width > passes[pass][0] && header.Height > passes[pass][1])
+                    expected += (((size_t)width * bitsPerPixel + 7) / 8 + 1) * height;
+            }
+
+            std::vector<uint8_t> raw;
+            raw.reserve(expected);
+            if (!ZlibInflate(compressed.data(), compressed.size(), raw, expected) || raw.size() != expected)
+                return Fail(error, "Corrupt PNG image data");
+
+            uint8_t* cursor = raw.data();
+            for (uint32_t pass = 0; pass < passCount; pass++)
+            {
+                const uint32_t xStart = passes[pass][0], yStart = passes[pass][1];
+                const uint32_t xStep = passes[pass][2], yStep = passes[pass][3];
+                if (header.Width <= xStart || header.Height <= yStart)
+                    continue;
+                const uint32_t width = (header.Width - xStart + xStep - 1) / xStep;
+                const uint32_t height = (header.Height - yStart + yStep - 1) / yStep;
+                const size_t rowBytes = ((size_t)width * bitsPerPixel + 7) / 8;
+
+                if (!Unfilter(cursor, height, rowBytes, bpp))
+                    return Fail(error, "Invalid PNG filter type");
+                for (uint32_t y = 0; y < height; y++)
+                {
+                    uint8_t* out = dst + (((size_t)(yStart + y * yStep) * header.Width) + xStart) * 4;
+                    ExpandRow(header, palette, cursor + y * (rowBytes + 1) + 1, width, out, (size_t)xStep * 4);
+                }
+                cursor += (rowBytes + 1) * height;
+            }
+            return true;
+        }
+
+        // ---- QOI ----------------------------------------------------------------------
+
+        bool IsQoi(const uint8_t* data, size_t size)
+        {
+            return size >= 14 + 8 && memcmp(data, "qoif", 4) == 0;
+        }
+
+        bool DecodeQoi(const uint8_t* data, size_t size, uint8_t* dst, std::string* error)
+        {
+            const uint32_t width = ReadU32BE(data + 4);
+            const uint32_t height = ReadU32BE(data + 8);
+            if (!ValidDimensions(width, height))
+                return Fail(error, "Invalid QOI dimensions");
+
+            uint8_t index[64][4] = {};
+            uint8_t pixel[4] = { 0, 0, 0, 255 };
+            const size_t pixelCount = (size_t)width * height;
+            const size_t end = size - 8; // Stream is terminated by 7 zero bytes and a 1
+            size_t pos = 14;
+            uint32_t run = 0;
+
+            for (size_t i = 0; i < pixelCount; i++, dst += 4)
+            {
+                if (run > 0)
+                {
+                    run--;
+                }
+                else
+                {
+                    if (pos >= end)
+                        return Fail(error, "Truncated QOI data");
+                    const uint8_t op = data[pos++];
+                    if (op == 0xFE)
+                    {
+                        if (pos + 3 > end)
+                            return Fail(error, "Truncated QOI data");
+                        pixel[0] = data[pos]; pixel[1] = data[pos + 1]; pixel[2] = data[pos + 2];
+                        pos += 3;
+                    }
+                    else if (op == 0xFF)
+                    {
+                        if (pos + 4 > end)
+                            return Fail(error, "Truncated QOI data");
+                        memcpy(pixel, data + pos, 4);
+                        pos += 4;
+                    }
+                    else
+                    {
+                        switch (op >> 6)
+                        {
+                        case 0: // Index
+                            memcpy(pixel, index[op & 0x3F], 4);
+                            break;
+                        case 1: // Diff
+                            pixel[0] = (uint8_t)(pixel[0] + ((op >> 4) & 3) - 2);
+                            pixel[1] = (uint8_t)(pixel[1] + ((op >> 2) & 3) - 2);
+                            pixel[2] = (uint8_t)(pixel[2] + (op & 3) - 2);
+                            break;
+                        case 2: // Luma
+                        {
+                            if (pos >= end)
+                                return Fail(error, "Truncated QOI data");
+                            const uint8_t next = data[pos++];
+                            const int dg = (op & 0x3F) - 32;
+                            pixel[0] = (uint8_t)(pixel[0] + dg - 8 + ((next >> 4) & 0x0F));
+                            pixel[1] = (uint8_t)(pixel[1] + dg);
+                            pixel[2] = (uint8_t)(pixel[2] + dg - 8 + (next & 0x0F));
+                            break;
+                        }
+                        case 3: // Run
+                            run = op & 0x3F;
+                            break;
+                        }
+                    }
+                    memcpy(index[(pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + pixel[3] * 11) % 64], pixel, 4);
+                }
+                memcpy(dst, pixel, 4);
+            }
+            return true;
+        }
+
+    }
+
+    bool ImageDecoder::GetInfo(const uint8_t* data, size_t size, ImageInfo& info)
+    {
+        if (IsPng(data, size))
+        {
+            PngHeader header;
+            if (!ReadPngHeader(data, size, header))
+                return false;
+            info.Width = header.Width;
+            info.Height = header.Height;
+            return true;
+        }
+        if (IsQoi(data, size))
+        {
+            info.Width = ReadU32BE(data + 4);
+            info.Height = ReadU32BE(data + 8);
+            return ValidDimensions(info.Width, info.Height);
+        }
+        return false;
+    }
+
+    bool ImageDecoder::Decode(const uint8_t* data, size_t size, uint8_t* dst, std::string* error)
+    {
+        if (IsPng(data, size))
+            return DecodePng(data, size, dst, error);
+        if (IsQoi(data, size))
+            return DecodeQoi(data, size, dst, error);
+        return Fail(error, "Unrecognized image format (expected PNG or QOI)");
+    }
+
+    bool ImageDecoder::Decode(const uint8_t* data, size_t size, ImageInfo& info, std::vector<uint8_t>& rgba, std::string* error)
+    {
+        if (!GetInfo(data, size, info))
+            return Fail(error, "Unrecognized or corrupt image header");
+        rgba.resize(info.GetRGBASize());
+        return Decode(data, size, rgba.data(), error);
+    }
+
+}
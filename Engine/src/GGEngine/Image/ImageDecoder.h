@@ -0,0 +1,29 @@
+#pragma once
+
+#include "GGEngine/Core.h"
+
+namespace GGEngine {
+
+    struct ImageInfo
+    {
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+
+        size_t GetRGBASize() const { return (size_t)Width * Height * 4; }
+    };
+
+    // PNG and QOI decoding to 8-bit RGBA. Stateless and safe to call from any thread.
+    // PNG covers every color type, bit depth and Adam7 interlacing; 16-bit samples are
+    // truncated to 8 bits and ancillary chunks (gamma, color profiles) are ignored.
+    class GG_API ImageDecoder
+    {
+    public:
+        // Reads the dimensions from the header, so callers can size the destination first
+        static bool GetInfo(const uint8_t* data, size_t size, ImageInfo& info);
+
+        // dst must hold info.GetRGBASize() bytes; rows are tightly packed
+        static bool Decode(const uint8_t* data, size_t size, uint8_t* dst, std::string* error = nullptr);
+        static bool Decode(const uint8_t* data, size_t size, ImageInfo& info, std::vector<uint8_t>& rgba, std::string* error = nullptr);
+    };
+
+}
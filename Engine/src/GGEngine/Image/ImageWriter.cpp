@@ -0,0 +1,129 @@
+#include "ImageWriter.h"
+
+namespace GGEngine {
+
+    namespace {
+
+        uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t size)
+        {
+            static const std::array<uint32_t, 256> table = []()
+            {
+                std::array<uint32_t, 256> result;
+                for (uint32_t i = 0; i < 256; i++)
+                {
+                    uint32_t c = i;
+                    for (int k = 0; k < 8; k++)
+                        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    result[i] = c;
+                }
+                return result;
+            }();
+
+            crc = ~crc;
+            for (size_t i = 0; i < size; i++)
+                crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            return ~crc;
+        }
+
+        void AppendU32(std::vector<uint8_t>& out, uint32_t value)
+        {
+            out.push_back((uint8_t)(value >> 24));
+            out.push_back((uint8_t)(value >> 16));
+            out.push_back((uint8_t)(value >> 8));
+            out.push_back((uint8_t)value);
+        }
+
+        void AppendChunk(std::vector<uint8_t>& out, const char type[4], const uint8_t* data, size_t size)
+        {
+            AppendU32(out, (uint32_t)size);
+            const size_t typeOffset = out.size();
+            out.insert(out.end(), type, type + 4);
+            out.insert(out.end(), data, data + size);
+            AppendU32(out, Crc32(0, out.data() + typeOffset, size + 4));
+        }
+
+        // zlib stream made of stored (uncompressed) deflate blocks
+        std::vector<uint8_t> ZlibStore(const std::vector<uint8_t>& raw)
+        {
+            constexpr size_t maxBlock = 65535;
+            std::vector<uint8_t> out;
+            out.reserve(raw.size() + raw.size() / maxBlock * 5 + 16);
+            out.push_back(0x78);
+            out.push_back(0x01);
+
+            size_t offset = 0;
+            do
+            {
+                const size_t blockSize = std::min(maxBlock, raw.size() - offset);
+                const bool last = offset + blockSize == raw.size();
+                out.push_back(last ? 1 : 0);
+                out.push_back((uint8_t)(blockSize & 0xFF));
+                out.push_back((uint8_t)(blockSize >> 8));
+                out.push_back((uint8_t)(~blockSize & 0xFF));
+                out.push_back((uint8_t)((~blockSize >> 8) & 0xFF));
+                out.insert(out.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+                offset += blockSize;
+            } while (offset < raw.size());
+
+            // Adler-32 of the uncompressed data
+            uint32_t a = 1, b = 0;
+            for (size_t i = 0; i < raw.size(); )
+            {
+                const size_t end = std::min(raw.size(), i + 5552);
+                for (; i < end; i++)
+                {
+                    a += raw[i];
+                    b += a;
+                }
+                a %= 65521;
+                b %= 65521;
+            }
+            AppendU32(out, (b << 16) | a);
+            return out;
+        }
+
+    }
+
+    bool ImageWriter::WritePNG(const std::string& path, uint32_t width, uint32_t height, const uint8_t* rgba, uint32_t stride)
+    {
+        const size_t rowSize = (size_t)width * 4;
+        if (stride == 0)
+            stride = (uint32_t)rowSize;
+
+        // Every scanline is prefixed with filter type 0 (none)
+        std::vector<uint8_t> raw;
+        raw.reserve((rowSize + 1) * height);
+        for (uint32_t y = 0; y < height; y++)
+        {
+            raw.push_back(0);
+            const uint8_t* row = rgba + (size_t)y * stride;
+            raw.insert(raw.end(), row, row + rowSize);
+        }
+
+        uint8_t header[13];
+        header[0] = (uint8_t)(width >> 24); header[1] = (uint8_t)(width >> 16); header[2] = (uint8_t)(width >> 8); header[3] = (uint8_t)width;
+        header[4] = (uint8_t)(height >> 24); header[5] = (uint8_t)(height >> 16); header[6] = (uint8_t)(height >> 8); header[7] = (uint8_t)height;
+        header[8] = 8;  // Bit depth
+        header[9] = 6;  // Color type: RGBA
+        header[10] = 0; // Compression
+        header[11] = 0; // Filter
+        header[12] = 0; // Interlace
+
+        static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        std::vector<uint8_t> png(signature, signature + 8);
+        AppendChunk(png, "IHDR", header, sizeof(header));
+        const std::vector<uint8_t> compressed = ZlibStore(raw);
+        AppendChunk(png, "IDAT", compressed.data(), compressed.size());
+        AppendChunk(png, "IEND", nullptr, 0);
+
+        std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            GG_CORE_ERROR("Could not open {0} for writing", path);
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(png.data()), (std::streamsize)png.size());
+        return (bool)out;
+    }
+
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "GGEngine/Core.h"
+
+namespace GGEngine {
+
+    class GG_API ImageWriter
+    {
+    public:
+        // Writes 8-bit RGBA pixels as a PNG. Rows are stride bytes apart (0 = tightly packed).
+        // The image data is stored uncompressed, which keeps encoding cheap enough to run per frame.
+        static bool WritePNG(const std::string& path, uint32_t width, uint32_t height, const uint8_t* rgba, uint32_t stride = 0);
+    };
+
+}
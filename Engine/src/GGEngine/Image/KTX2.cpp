@@ -0,0 +1,288 @@
+#include "KTX2.h"
+
+#include <glad/vulkan.h>
+
+namespace GGEngine {
+
+    namespace {
+
+        const uint8_t Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+        constexpr size_t HeaderSize = 80; // Identifier, header and index
+        constexpr size_t LevelIndexEntrySize = 24;
+
+        // Khronos Data Format color models and channel ids used by the DFD
+        constexpr uint32_t ModelRGBSDA = 1;
+        constexpr uint32_t ModelBC1A = 128;
+        constexpr uint32_t ModelBC3 = 130;
+        constexpr uint32_t ModelBC4 = 131;
+        constexpr uint32_t ModelBC5 = 132;
+        constexpr uint32_t ModelBC7 = 134;
+        constexpr uint32_t ChannelAlpha = 15;
+
+        uint32_t ReadU32(const uint8_t* p)
+        {
+            uint32_t value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        uint64_t ReadU64(const uint8_t* p)
+        {
+            uint64_t value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        void AppendU32(std::vector<uint8_t>& out, uint32_t value)
+        {
+            const size_t offset = out.size();
+            out.resize(offset + 4);
+            memcpy(out.data() + offset, &value, 4);
+        }
+
+        void AppendU64(std::vector<uint8_t>& out, uint64_t value)
+        {
+            const size_t offset = out.size();
+            out.resize(offset + 8);
+            memcpy(out.data() + offset, &value, 8);
+        }
+
+        bool IsSRGB(uint32_t format)
+        {
+            return format == VK_FORMAT_BC1_RGB_SRGB_BLOCK || format == VK_FORMAT_BC1_RGBA_SRGB_BLOCK || format == VK_FORMAT_BC3_SRGB_BLOCK
+                || format == VK_FORMAT_BC7_SRGB_BLOCK || format == VK_FORMAT_R8G8B8A8_SRGB;
+        }
+
+        struct DfdSample
+        {
+            uint32_t Channel;
+            uint32_t BitOffset;
+            uint32_t BitLength;
+            uint32_t Upper;
+        };
+
+        // Basic data format descriptor block (KDF 1.3, section 5)
+        std::vector<uint8_t> BuildDfd(uint32_t format)
+        {
+            uint32_t model = 0;
+            std::vector<DfdSample> samples;
+            switch (format)
+            {
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+                model = ModelBC1A;
+                samples = { { 0, 0, 64, UINT32_MAX } };
+                break;
+            case VK_FORMAT_BC3_UNORM_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+                model = ModelBC3;
+                samples = { { ChannelAlpha, 0, 64, UINT32_MAX }, { 0, 64, 64, UINT32_MAX } };
+                break;
+            case VK_FORMAT_BC4_UNORM_BLOCK:
+                model = ModelBC4;
+                samples = { { 0, 0, 64, UINT32_MAX } };
+                break;
+            case VK_FORMAT_BC5_UNORM_BLOCK:
+                model = ModelBC5;
+                samples = { { 0, 0, 64, UINT32_MAX }, { 1, 64, 64, UINT32_MAX } };
+                break;
+            case VK_FORMAT_BC7_UNORM_BLOCK:
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+                model = ModelBC7;
+                samples = { { 0, 0, 128, UINT32_MAX } };
+                break;
+            default: // RGBA8
+                model = ModelRGBSDA;
+                samples = { { 0, 0, 8, 255 }, { 1, 8, 8, 255 }, { 2, 16, 8, 255 }, { ChannelAlpha, 24, 8, 255 } };
+                break;
+            }
+
+            const bool block = model != ModelRGBSDA;
+            const uint32_t blockSize = 24 + 16 * (uint32_t)samples.size();
+            std::vector<uint8_t> dfd;
+            AppendU32(dfd, 4 + blockSize);                                                  // dfdTotalSize
+            AppendU32(dfd, 0);                                                              // vendorId, descriptorType
+            AppendU32(dfd, 2 | (blockSize << 16));                                          // versionNumber, descriptorBlockSize
+            AppendU32(dfd, model | (1u << 8) | ((IsSRGB(format) ? 2u : 1u) << 16));        // BT.709 primaries, linear or sRGB transfer
+            AppendU32(dfd, block ? 0x00000303u : 0u);                                       // texelBlockDimension - 1
+            AppendU32(dfd, KTX2::GetBlockSize(format));                                     // bytesPlane0
+            AppendU32(dfd, 0);                                                              // bytesPlane4..7
+            for (const DfdSample& sample : samples)
+            {
+                const uint32_t linearAlpha = (sample.Channel == ChannelAlpha && IsSRGB(format)) ? 0x10u : 0u;
+                AppendU32(dfd, sample.BitOffset | ((sample.BitLength - 1) << 16) | ((sample.Channel | linearAlpha) << 24));
+                AppendU32(dfd, 0); // samplePosition
+                AppendU32(dfd, 0); // sampleLower
+                AppendU32(dfd, sample.Upper);
+            }
+            return dfd;
+        }
+
+        bool Fail(std::string* error, const char* message)
+        {
+            if (error)
+                *error = message;
+            return false;
+        }
+
+    }
+
+    uint32_t KTX2::GetBlockSize(uint32_t format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+            return 8;
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            return 16;
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            return 4;
+        default:
+            return 0;
+        }
+    }
+
+    uint32_t KTX2::GetBlockDimension(uint32_t format)
+    {
+        return (format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB) ? 1 : 4;
+    }
+
+    uint64_t KTX2::GetLevelSize(uint32_t format, uint32_t width, uint32_t height)
+    {
+        const uint32_t dimension = GetBlockDimension(format);
+        const uint64_t blocksX = (width + dimension - 1) / dimension;
+        const uint64_t blocksY = (height + dimension - 1) / dimension;
+        return blocksX * blocksY * GetBlockSize(format);
+    }
+
+    bool KTX2::IsKTX2(const uint8_t* data, size_t size)
+    {
+        return size >= HeaderSize && memcmp(data, Identifier, sizeof(Identifier)) == 0;
+    }
+
+    bool KTX2::Parse(const uint8_t* data, size_t size, KTX2Image& image, std::string* error)
+    {
+        if (!IsKTX2(data, size))
+            return Fail(error, "Not a KTX2 file");
+
+        image.Format = ReadU32(data + 12);
+        image.Width = ReadU32(data + 20);
+        image.Height = ReadU32(data + 24);
+        const uint32_t depth = ReadU32(data + 28);
+        const uint32_t layers = ReadU32(data + 32);
+        const uint32_t faces = ReadU32(data + 36);
+        const uint32_t levelCount = ReadU32(data + 40);
+        const uint32_t supercompression = ReadU32(data + 44);
+
+        if (GetBlockSize(image.Format) == 0)
+            return Fail(error, "Unsupported KTX2 format");
+        if (image.Width == 0 || image.Height == 0 || depth != 0 || layers > 1 || faces != 1)
+            return Fail(error, "Only single 2D KTX2 images are supported");
+        if (supercompression != 0)
+            return Fail(error, "Supercompressed KTX2 files are not supported");
+        if (levelCount == 0 || levelCount > 32 || ((image.Width >> (levelCount - 1)) == 0 && (image.Height >> (levelCount - 1)) == 0))
+            return Fail(error, "Invalid KTX2 level count");
+        if (HeaderSize + (size_t)levelCount * LevelIndexEntrySize > size)
+            return Fail(error, "Truncated KTX2 level index");
+
+        image.Levels.resize(levelCount);
+        for (uint32_t i = 0; i < levelCount; i++)
+        {
+            const uint8_t* entry = data + HeaderSize + i * LevelIndexEntrySize;
+            KTX2Level& level = image.Levels[i];
+            level.Offset = ReadU64(entry);
+            level.Size = ReadU64(entry + 8);
+            level.Width = std::max(1u, image.Width >> i);
+            level.Height = std::max(1u, image.Height >> i);
+            if (level.Offset > size || level.Size > size - level.Offset || level.Size < GetLevelSize(image.Format, level.Width, level.Height))
+                return Fail(error, "KTX2 level data is out of bounds");
+        }
+        return true;
+    }
+
+    bool KTX2::Write(const std::string& path, uint32_t format, uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& levels)
+    {
+        if (GetBlockSize(format) == 0 || levels.empty())
+        {
+            GG_CORE_ERROR("KTX2: nothing to write to {0}", path);
+            return false;
+        }
+
+        const std::vector<uint8_t> dfd = BuildDfd(format);
+        const uint32_t levelCount = (uint32_t)levels.size();
+        const uint32_t dfdOffset = (uint32_t)(HeaderSize + levelCount * LevelIndexEntrySize);
+
+        // Level data goes smallest first, each level aligned to lcm(block size, 4)
+        const uint64_t alignment = std::max<uint64_t>(GetBlockSize(format), 4);
+        std::vector<uint64_t> offsets(levelCount);
+        uint64_t offset = dfdOffset + dfd.size();
+        for (uint32_t i = levelCount; i-- > 0; )
+        {
+            offset = (offset + alignment - 1) / alignment * alignment;
+            offsets[i] = offset;
+            offset += levels[i].size();
+        }
+
+        std::vector<uint8_t> out(Identifier, Identifier + sizeof(Identifier));
+        AppendU32(out, format);
+        AppendU32(out, 1); // typeSize
+        AppendU32(out, width);
+        AppendU32(out, height);
+        AppendU32(out, 0); // pixelDepth
+        AppendU32(out, 0); // layerCount
+        AppendU32(out, 1); // faceCount
+        AppendU32(out, levelCount);
+        AppendU32(out, 0); // supercompressionScheme
+        AppendU32(out, dfdOffset);
+        AppendU32(out, (uint32_t)dfd.size());
+        AppendU32(out, 0); // kvdByteOffset
+        AppendU32(out, 0); // kvdByteLength
+        AppendU64(out, 0); // sgdByteOffset
+        AppendU64(out, 0); // sgdByteLength
+        for (uint32_t i = 0; i < levelCount; i++)
+        {
+            AppendU64(out, offsets[i]);
+            AppendU64(out, levels[i].size());
+            AppendU64(out, levels[i].size());
+        }
+        out.insert(out.end(), dfd.begin(), dfd.end());
+        for (uint32_t i = levelCount; i-- > 0; )
+        {
+            out.resize(offsets[i], 0);
+            out.insert(out.end(), levels[i].begin(), levels[i].end());
+        }
+
+        // Write to a temporary and rename, so a crashed cook never leaves a truncated file behind
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                GG_CORE_ERROR("KTX2: could not open {0} for writing", tempPath);
+                return false;
+            }
+            file.write(reinterpret_cast<const char*>(out.data()), (std::streamsize)out.size());
+            if (!file)
+                return false;
+        }
+        std::error_code errorCode;
+        std::filesystem::rename(tempPath, path, errorCode);
+        if (errorCode)
+        {
+            GG_CORE_ERROR("KTX2: could not replace {0}: {1}", path, errorCode.message());
+            return false;
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "GGEngine/Core.h"
+
+namespace GGEngine {
+
+    struct KTX2Level
+    {
+        uint64_t Offset = 0; // From the start of the file
+        uint64_t Size = 0;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+    };
+
+    // A parsed KTX2 file: a 2D texture with its mip chain, Levels[0] being the full size.
+    // Formats are VkFormat values, kept as integers so this header stays free of Vulkan.
+    struct KTX2Image
+    {
+        uint32_t Format = 0;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        std::vector<KTX2Level> Levels;
+    };
+
+    // Reader and writer for the subset of KTX 2.0 the texture pipeline produces: single
+    // 2D images (no arrays, cube maps or supercompression) in block-compressed or RGBA8
+    // formats. Level data is stored exactly as the GPU consumes it, so loading is a copy.
+    class GG_API KTX2
+    {
+    public:
+        static bool IsKTX2(const uint8_t* data, size_t size);
+
+        // Validates the header and level index against size; no level data is touched
+        static bool Parse(const uint8_t* data, size_t size, KTX2Image& image, std::string* error = nullptr);
+
+        // levels[0] is the full-size image, each level holding tightly packed blocks
+        static bool Write(const std::string& path, uint32_t format, uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& levels);
+
+        // Bytes per 4x4 block for BC formats, per texel for RGBA8 (block size 1), 0 when unsupported
+        static uint32_t GetBlockSize(uint32_t format);
+        static uint32_t GetBlockDimension(uint32_t format);
+        static uint64_t GetLevelSize(uint32_t format, uint32_t width, uint32_t height);
+    };
+
+}
@@ -0,0 +1,160 @@
+#include "JobSystem.h"
+
+#include "GGEngine/Log.h"
+
+namespace GGEngine {
+
+    namespace {
+
+        struct JobSystemData
+        {
+            std::vector<std::thread> Workers;
+            std::deque<std::function<void()>> Queue;
+            std::mutex QueueMutex;
+            std::condition_variable WakeCondition;
+            std::atomic<bool> Running{ false };
+        };
+
+        JobSystemData s_Data;
+        thread_local uint32_t t_ThreadIndex = JobSystem::ForeignThreadIndex;
+
+        void Push(std::function<void()> job)
+        {
+            {
+                std::lock_guard<std::mutex> lock(s_Data.QueueMutex);
+                s_Data.Queue.push_back(std::move(job));
+            }
+            s_Data.WakeCondition.notify_one();
+        }
+
+        bool TryRunOne()
+        {
+            std::function<void()> job;
+            {
+                std::lock_guard<std::mutex> lock(s_Data.QueueMutex);
+                if (s_Data.Queue.empty())
+                    return false;
+                job = std::move(s_Data.Queue.front());
+                s_Data.Queue.pop_front();
+            }
+            job();
+            return true;
+        }
+
+        void WorkerMain(uint32_t threadIndex)
+        {
+            t_ThreadIndex = threadIndex;
+            while (true)
+            {
+                std::function<void()> job;
+                {
+                    std::unique_lock<std::mutex> lock(s_Data.QueueMutex);
+                    s_Data.WakeCondition.wait(lock, [] { return !s_Data.Queue.empty() || !s_Data.Running.load(); });
+                    if (s_Data.Queue.empty())
+                        return;
+                    job = std::move(s_Data.Queue.front());
+                    s_Data.Queue.pop_front();
+                }
+                job();
+            }
+        }
+
+    }
+
+    void JobSystem::Init(uint32_t workerCount)
+    {
+        if (s_Data.Running.load())
+            return;
+
+        if (workerCount == 0)
+        {
+            uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        t_ThreadIndex = 0;
+        s_Data.Running = true;
+        s_Data.Workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; i++)
+            s_Data.Workers.emplace_back(WorkerMain, i + 1);
+
+        GG_CORE_INFO("Job system started with {0} worker threads", workerCount);
+    }
+
+    void JobSystem::Shutdown()
+    {
+        if (!s_Data.Running.load())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(s_Data.QueueMutex);
+            s_Data.Running = false;
+        }
+        s_Data.WakeCondition.notify_all();
+
+        // Workers drain whatever is still queued before exiting
+        for (std::thread& worker : s_Data.Workers)
+            worker.join();
+        s_Data.Workers.clear();
+    }
+
+    uint32_t JobSystem::GetThreadCount()
+    {
+        return (uint32_t)s_Data.Workers.size() + 1;
+    }
+
+    uint32_t JobSystem::GetThreadIndex()
+    {
+        return t_ThreadIndex;
+    }
+
+    void JobSystem::Execute(JobCounter& counter, const std::function<void()>& job)
+    {
+        counter.fetch_add(1, std::memory_order_relaxed);
+
+        if (!s_Data.Running.load())
+        {
+            job();
+            counter.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+
+        Push([job, &counter]()
+        {
+            job();
+            counter.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    void JobSystem::Dispatch(JobCounter& counter, uint32_t jobCount, uint32_t groupSize, const std::function<void(JobDispatchArgs)>& job)
+    {
+        if (jobCount == 0 || groupSize == 0)
+            return;
+
+        const uint32_t groupCount = (jobCount + groupSize - 1) / groupSize;
+        auto sharedJob = std::make_shared<std::function<void(JobDispatchArgs)>>(job);
+
+        for (uint32_t groupIndex = 0; groupIndex < groupCount; groupIndex++)
+        {
+            Execute(counter, [sharedJob, groupIndex, groupSize, jobCount]()
+            {
+                const uint32_t begin = groupIndex * groupSize;
+                const uint32_t end = std::min(begin + groupSize, jobCount);
+                for (uint32_t i = begin; i < end; i++)
+                    (*sharedJob)({ i, groupIndex });
+            });
+        }
+    }
+
+    void JobSystem::Wait(const JobCounter& counter)
+    {
+        // A job run here would see the calling thread's index, which only owned threads have
+        const bool canHelp = t_ThreadIndex != ForeignThreadIndex;
+        while (IsBusy(counter))
+        {
+            if (!canHelp || !TryRunOne())
+                std::this_thread::yield();
+        }
+    }
+
+}
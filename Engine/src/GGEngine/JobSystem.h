@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Core.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+namespace GGEngine {
+
+    // Incremented when jobs are kicked, decremented as they finish.
+    // A counter reaching zero means every job attached to it has completed.
+    using JobCounter = std::atomic<uint32_t>;
+
+    struct JobDispatchArgs
+    {
+        uint32_t JobIndex;   // Index of this invocation across the whole dispatch
+        uint32_t GroupIndex; // Index of the group (one queued job) the invocation runs in
+    };
+
+    class GG_API JobSystem
+    {
+    public:
+        // GetThreadIndex on threads the job system does not own (watchers, writers, ...)
+        static constexpr uint32_t ForeignThreadIndex = UINT32_MAX;
+
+        // Called on the main thread. workerCount == 0 picks hardware_concurrency - 1 (at least one worker)
+        static void Init(uint32_t workerCount = 0);
+        static void Shutdown();
+
+        // Threads that may execute jobs: all workers plus the main thread
+        static uint32_t GetThreadCount();
+        // 0 on the main thread, 1..N on workers. Stable for the lifetime of a thread,
+        // so it can index per-thread resources (command pools, scratch memory, ...).
+        // ForeignThreadIndex on any other thread; jobs never run there.
+        static uint32_t GetThreadIndex();
+
+        static void Execute(JobCounter& counter, const std::function<void()>& job);
+
+        // Runs job jobCount times, batching groupSize invocations into each queued job
+        static void Dispatch(JobCounter& counter, uint32_t jobCount, uint32_t groupSize, const std::function<void(JobDispatchArgs)>& job);
+
+        static bool IsBusy(const JobCounter& counter) { return counter.load(std::memory_order_acquire) > 0; }
+
+        // Blocks until the counter reaches zero. The main thread and workers help by running
+        // queued jobs; other threads only wait.
+        static void Wait(const JobCounter& counter);
+    };
+
+}
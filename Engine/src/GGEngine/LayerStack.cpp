@@ -9,10 +9,18 @@ namespace GGEngine
 
     LayerStack::~LayerStack()
     {
-        for (Layer* layer : m_Layers)
+        Clear();
+    }
+
+    void LayerStack::Clear()
+    {
+        for (auto it = m_Layers.rbegin(); it != m_Layers.rend(); ++it)
         {
-            delete layer;
+            (*it)->OnDetach();
+            delete *it;
         }
+        m_Layers.clear();
+        m_LayerInsertIndex = 0;
     }
 
     void LayerStack::PushLayer(Layer* layer)
@@ -19,6 +19,9 @@ namespace GGEngine
         void PopLayer(Layer* layer);
         void PopOverlay(Layer* overlay);
 
+        // Detaches and deletes every layer, overlays first
+        void Clear();
+
         std::vector<Layer*>::iterator begin() { return m_Layers.begin(); }
         std::vector<Layer*>::iterator end() { return m_Layers.end(); }
 
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Core.h"
+
+namespace GGEngine {
+
+    // Read-only memory mapping of a whole file. Pages are faulted in on first touch,
+    // so parsing a header does not read the rest of the file from disk.
+    class GG_API MappedFile
+    {
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::string& path) { Open(path); }
+        ~MappedFile() { Close(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Open(const std::string& path);
+        void Close();
+
+        bool IsOpen() const { return m_Data != nullptr; }
+        const uint8_t* GetData() const { return m_Data; }
+        size_t GetSize() const { return m_Size; }
+
+    private:
+        const uint8_t* m_Data = nullptr;
+        size_t m_Size = 0;
+        void* m_File = nullptr;
+        void* m_Mapping = nullptr;
+    };
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Math.h"
+
+#include <cfloat>
+#include <cstdint>
+
+namespace GGEngine {
+
+    // Distances along a ray are in multiples of Direction; pass a unit direction to get
+    // world units
+    struct Ray
+    {
+        Vec3 Origin;
+        Vec3 Direction{ 0.0f, 0.0f, 1.0f };
+        float MaxDistance = FLT_MAX;
+    };
+
+    // Points with Dot(Normal, p) + Distance >= 0 are on the inside
+    struct Plane
+    {
+        Vec3 Normal;
+        float Distance = 0.0f;
+
+        constexpr float SignedDistance(const Vec3& point) const { return Dot(Normal, point) + Distance; }
+    };
+
+    enum class Containment : uint8_t
+    {
+        Outside = 0,
+        Intersecting,
+        Inside
+    };
+
+    struct Frustum
+    {
+        Plane Planes[6]; // Left, right, bottom, top, near, far
+
+        // Planes of a view-projection matrix with Vulkan clip space (depth 0..1)
+        static Frustum FromMatrix(const Mat4& viewProjection)
+        {
+            const Mat4& m = viewProjection;
+            auto row = [&m](int r) { return Vec4(m(r, 0), m(r, 1), m(r, 2), m(r, 3)); };
+            const Vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+            const Vec4 planes[6] = { r3 + r0, r3 - r0, r3 + r1, r3 - r1, r2, r3 - r2 };
+
+            Frustum frustum;
+            for (int i = 0; i < 6; i++)
+            {
+                const float length = Length(planes[i].XYZ());
+                frustum.Planes[i] = { planes[i].XYZ() / length, planes[i].w / length };
+            }
+            return frustum;
+        }
+
+        // Conservative: boxes near a corner may report Intersecting while fully outside
+        Containment Test(const AABB& box) const
+        {
+            const Vec3 center = box.GetCenter();
+            const Vec3 extents = box.GetExtents();
+            Containment result = Containment::Inside;
+            for (const Plane& plane : Planes)
+            {
+                const float distance = plane.SignedDistance(center);
+                const float radius = std::fabs(plane.Normal.x) * extents.x + std::fabs(plane.Normal.y) * extents.y + std::fabs(plane.Normal.z) * extents.z;
+                if (distance < -radius)
+                    return Containment::Outside;
+                if (distance < radius)
+                    result = Containment::Intersecting;
+            }
+            return result;
+        }
+
+        bool Overlaps(const AABB& box) const { return Test(box) != Containment::Outside; }
+    };
+
+    // Per-axis 1 / direction, for repeated slab tests against one ray
+    inline Vec3 InverseDirection(const Vec3& direction)
+    {
+        return { 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+    }
+
+    // Slab test. distance is where the ray enters the box, 0 when it starts inside.
+    inline bool IntersectRayAABB(const Vec3& origin, const Vec3& inverseDirection, const AABB& box, float maxDistance, float& distance)
+    {
+        const float x1 = (box.Min.x - origin.x) * inverseDirection.x, x2 = (box.Max.x - origin.x) * inverseDirection.x;
+        const float y1 = (box.Min.y - origin.y) * inverseDirection.y, y2 = (box.Max.y - origin.y) * inverseDirection.y;
+        const float z1 = (box.Min.z - origin.z) * inverseDirection.z, z2 = (box.Max.z - origin.z) * inverseDirection.z;
+        const float enter = Max(Max(Min(x1, x2), Min(y1, y2)), Max(Min(z1, z2), 0.0f));
+        const float exit = Min(Min(Max(x1, x2), Max(y1, y2)), Min(Max(z1, z2), maxDistance));
+        distance = enter;
+        return enter <= exit;
+    }
+
+}
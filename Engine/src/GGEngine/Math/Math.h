@@ -0,0 +1,344 @@
+#pragma once
+
+#include <cmath>
+
+// Scalar math types. Everything that does not need <cmath> is constexpr; batch work over
+// arrays goes through the SIMD kernels in MathKernels.h.
+
+namespace GGEngine {
+
+    constexpr float Pi = 3.14159265358979323846f;
+
+    constexpr float Radians(float degrees) { return degrees * (Pi / 180.0f); }
+    constexpr float Degrees(float radians) { return radians * (180.0f / Pi); }
+    constexpr float Min(float a, float b) { return a < b ? a : b; }
+    constexpr float Max(float a, float b) { return a > b ? a : b; }
+    constexpr float Clamp(float v, float lo, float hi) { return Min(Max(v, lo), hi); }
+    constexpr float Lerp(float a, float b, float t) { return a + (b - a) * t; }
+
+    struct Vec2
+    {
+        float x = 0.0f, y = 0.0f;
+
+        constexpr Vec2() = default;
+        constexpr Vec2(float x, float y) : x(x), y(y) {}
+        constexpr explicit Vec2(float s) : x(s), y(s) {}
+
+        constexpr Vec2 operator+(const Vec2& o) const { return { x + o.x, y + o.y }; }
+        constexpr Vec2 operator-(const Vec2& o) const { return { x - o.x, y - o.y }; }
+        constexpr Vec2 operator*(const Vec2& o) const { return { x * o.x, y * o.y }; }
+        constexpr Vec2 operator*(float s) const { return { x * s, y * s }; }
+        constexpr Vec2 operator-() const { return { -x, -y }; }
+        constexpr bool operator==(const Vec2& o) const { return x == o.x && y == o.y; }
+        constexpr bool operator!=(const Vec2& o) const { return !(*this == o); }
+    };
+
+    struct Vec3
+    {
+        float x = 0.0f, y = 0.0f, z = 0.0f;
+
+        constexpr Vec3() = default;
+        constexpr Vec3(float x, float y, float z) : x(x), y(y), z(z) {}
+        constexpr explicit Vec3(float s) : x(s), y(s), z(s) {}
+
+        constexpr Vec3 operator+(const Vec3& o) const { return { x + o.x, y + o.y, z + o.z }; }
+        constexpr Vec3 operator-(const Vec3& o) const { return { x - o.x, y - o.y, z - o.z }; }
+        constexpr Vec3 operator*(const Vec3& o) const { return { x * o.x, y * o.y, z * o.z }; }
+        constexpr Vec3 operator*(float s) const { return { x * s, y * s, z * s }; }
+        constexpr Vec3 operator/(float s) const { return { x / s, y / s, z / s }; }
+        constexpr Vec3 operator-() const { return { -x, -y, -z }; }
+        constexpr Vec3& operator+=(const Vec3& o) { x += o.x; y += o.y; z += o.z; return *this; }
+        constexpr Vec3& operator-=(const Vec3& o) { x -= o.x; y -= o.y; z -= o.z; return *this; }
+        constexpr Vec3& operator*=(float s) { x *= s; y *= s; z *= s; return *this; }
+        constexpr bool operator==(const Vec3& o) const { return x == o.x && y == o.y && z == o.z; }
+        constexpr bool operator!=(const Vec3& o) const { return !(*this == o); }
+    };
+
+    struct alignas(16) Vec4
+    {
+        float x = 0.0f, y = 0.0f, z = 0.0f, w = 0.0f;
+
+        constexpr Vec4() = default;
+        constexpr Vec4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+        constexpr Vec4(const Vec3& v, float w) : x(v.x), y(v.y), z(v.z), w(w) {}
+        constexpr explicit Vec4(float s) : x(s), y(s), z(s), w(s) {}
+
+        constexpr Vec3 XYZ() const { return { x, y, z }; }
+
+        constexpr Vec4 operator+(const Vec4& o) const { return { x + o.x, y + o.y, z + o.z, w + o.w }; }
+        constexpr Vec4 operator-(const Vec4& o) const { return { x - o.x, y - o.y, z - o.z, w - o.w }; }
+        constexpr Vec4 operator*(const Vec4& o) const { return { x * o.x, y * o.y, z * o.z, w * o.w }; }
+        constexpr Vec4 operator*(float s) const { return { x * s, y * s, z * s, w * s }; }
+        constexpr bool operator==(const Vec4& o) const { return x == o.x && y == o.y && z == o.z && w == o.w; }
+        constexpr bool operator!=(const Vec4& o) const { return !(*this == o); }
+    };
+
+    constexpr float Dot(const Vec2& a, const Vec2& b) { return a.x * b.x + a.y * b.y; }
+    constexpr float Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    constexpr float Dot(const Vec4& a, const Vec4& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+    constexpr Vec3 Cross(const Vec3& a, const Vec3& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+    constexpr Vec3 Min(const Vec3& a, const Vec3& b) { return { Min(a.x, b.x), Min(a.y, b.y), Min(a.z, b.z) }; }
+    constexpr Vec3 Max(const Vec3& a, const Vec3& b) { return { Max(a.x, b.x), Max(a.y, b.y), Max(a.z, b.z) }; }
+    constexpr Vec3 Lerp(const Vec3& a, const Vec3& b, float t) { return a + (b - a) * t; }
+    constexpr float LengthSquared(const Vec3& v) { return Dot(v, v); }
+    inline float Length(const Vec3& v) { return std::sqrt(Dot(v, v)); }
+    // Zero vectors stay zero
+    inline Vec3 Normalize(const Vec3& v)
+    {
+        const float length = Length(v);
+        return length > 0.0f ? v / length : v;
+    }
+
+    // Unit quaternion rotation, (x, y, z) the vector part
+    struct Quat
+    {
+        float x = 0.0f, y = 0.0f, z = 0.0f, w = 1.0f;
+
+        constexpr Quat() = default;
+        constexpr Quat(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+        static Quat FromAxisAngle(const Vec3& axis, float radians)
+        {
+            const float s = std::sin(radians * 0.5f);
+            return { axis.x * s, axis.y * s, axis.z * s, std::cos(radians * 0.5f) };
+        }
+
+        // Applies o first, then this
+        constexpr Quat operator*(const Quat& o) const
+        {
+            return {
+                w * o.x + x * o.w + y * o.z - z * o.y,
+                w * o.y - x * o.z + y * o.w + z * o.x,
+                w * o.z + x * o.y - y * o.x + z * o.w,
+                w * o.w - x * o.x - y * o.y - z * o.z
+            };
+        }
+
+        constexpr Quat Conjugate() const { return { -x, -y, -z, w }; }
+
+        constexpr Vec3 Rotate(const Vec3& v) const
+        {
+            // v + 2w(q x v) + 2q x (q x v)
+            const Vec3 q(x, y, z);
+            const Vec3 t = Cross(q, v) * 2.0f;
+            return v + t * w + Cross(q, t);
+        }
+    };
+
+    inline Quat Normalize(const Quat& q)
+    {
+        const float length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+        return length > 0.0f ? Quat(q.x / length, q.y / length, q.z / length, q.w / length) : Quat();
+    }
+
+    // Column-major, matching GLSL: element (row, column) is Data[column * 4 + row], and
+    // a * b applies b first
+    struct alignas(16) Mat4
+    {
+        float Data[16] = {};
+
+        static constexpr Mat4 Identity()
+        {
+            Mat4 m;
+            m.Data[0] = m.Data[5] = m.Data[10] = m.Data[15] = 1.0f;
+            return m;
+        }
+
+        static constexpr Mat4 Translation(const Vec3& t)
+        {
+            Mat4 m = Identity();
+            m.Data[12] = t.x;
+            m.Data[13] = t.y;
+            m.Data[14] = t.z;
+            return m;
+        }
+
+        static constexpr Mat4 Scale(const Vec3& s)
+        {
+            Mat4 m;
+            m.Data[0] = s.x;
+            m.Data[5] = s.y;
+            m.Data[10] = s.z;
+            m.Data[15] = 1.0f;
+            return m;
+        }
+
+        // Scale, then rotate, then translate
+        static constexpr Mat4 FromTRS(const Vec3& t, const Quat& r, const Vec3& s)
+        {
+            const float xx = r.x * r.x, yy = r.y * r.y, zz = r.z * r.z;
+            const float xy = r.x * r.y, xz = r.x * r.z, yz = r.y * r.z;
+            const float wx = r.w * r.x, wy = r.w * r.y, wz = r.w * r.z;
+
+            Mat4 m;
+            m.Data[0] = (1.0f - 2.0f * (yy + zz)) * s.x;
+            m.Data[1] = 2.0f * (xy + wz) * s.x;
+            m.Data[2] = 2.0f * (xz - wy) * s.x;
+            m.Data[4] = 2.0f * (xy - wz) * s.y;
+            m.Data[5] = (1.0f - 2.0f * (xx + zz)) * s.y;
+            m.Data[6] = 2.0f * (yz + wx) * s.y;
+            m.Data[8] = 2.0f * (xz + wy) * s.z;
+            m.Data[9] = 2.0f * (yz - wx) * s.z;
+            m.Data[10] = (1.0f - 2.0f * (xx + yy)) * s.z;
+            m.Data[12] = t.x;
+            m.Data[13] = t.y;
+            m.Data[14] = t.z;
+            m.Data[15] = 1.0f;
+            return m;
+        }
+
+        // Right-handed view looking from eye towards target
+        static Mat4 LookAt(const Vec3& eye, const Vec3& target, const Vec3& up)
+        {
+            const Vec3 f = Normalize(target - eye);
+            const Vec3 s = Normalize(Cross(f, up));
+            const Vec3 u = Cross(s, f);
+
+            Mat4 m = Identity();
+            m.Data[0] = s.x;  m.Data[4] = s.y;  m.Data[8] = s.z;
+            m.Data[1] = u.x;  m.Data[5] = u.y;  m.Data[9] = u.z;
+            m.Data[2] = -f.x; m.Data[6] = -f.y; m.Data[10] = -f.z;
+            m.Data[12] = -Dot(s, eye);
+            m.Data[13] = -Dot(u, eye);
+            m.Data[14] = Dot(f, eye);
+            return m;
+        }
+
+        // Vulkan clip space: depth 0..1 and y pointing down
+        static Mat4 Perspective(float fovY, float aspect, float nearPlane, float farPlane)
+        {
+            const float f = 1.0f / std::tan(fovY * 0.5f);
+            Mat4 m;
+            m.Data[0] = f / aspect;
+            m.Data[5] = -f;
+            m.Data[10] = farPlane / (nearPlane - farPlane);
+            m.Data[11] = -1.0f;
+            m.Data[14] = nearPlane * farPlane / (nearPlane - farPlane);
+            return m;
+        }
+
+        constexpr float operator()(int row, int column) const { return Data[column * 4 + row]; }
+
+        constexpr Mat4 operator*(const Mat4& b) const
+        {
+            Mat4 result;
+            for (int column = 0; column < 4; column++)
+            {
+                for (int row = 0; row < 4; row++)
+                {
+                    float sum = 0.0f;
+                    for (int k = 0; k < 4; k++)
+                        sum += Data[k * 4 + row] * b.Data[column * 4 + k];
+                    result.Data[column * 4 + row] = sum;
+                }
+            }
+            return result;
+        }
+
+        constexpr Vec4 operator*(const Vec4& v) const
+        {
+            return {
+                Data[0] * v.x + Data[4] * v.y + Data[8] * v.z + Data[12] * v.w,
+                Data[1] * v.x + Data[5] * v.y + Data[9] * v.z + Data[13] * v.w,
+                Data[2] * v.x + Data[6] * v.y + Data[10] * v.z + Data[14] * v.w,
+                Data[3] * v.x + Data[7] * v.y + Data[11] * v.z + Data[15] * v.w
+            };
+        }
+
+        constexpr Mat4 Transposed() const
+        {
+            Mat4 result;
+            for (int column = 0; column < 4; column++)
+                for (int row = 0; row < 4; row++)
+                    result.Data[row * 4 + column] = Data[column * 4 + row];
+            return result;
+        }
+
+        constexpr Vec3 GetTranslation() const { return { Data[12], Data[13], Data[14] }; }
+
+        constexpr Vec3 TransformPoint(const Vec3& p) const
+        {
+            return {
+                Data[0] * p.x + Data[4] * p.y + Data[8] * p.z + Data[12],
+                Data[1] * p.x + Data[5] * p.y + Data[9] * p.z + Data[13],
+                Data[2] * p.x + Data[6] * p.y + Data[10] * p.z + Data[14]
+            };
+        }
+
+        constexpr Vec3 TransformDirection(const Vec3& d) const
+        {
+            return {
+                Data[0] * d.x + Data[4] * d.y + Data[8] * d.z,
+                Data[1] * d.x + Data[5] * d.y + Data[9] * d.z,
+                Data[2] * d.x + Data[6] * d.y + Data[10] * d.z
+            };
+        }
+
+        // General 4x4 inverse; a singular matrix yields all zeros
+        constexpr Mat4 Inverse() const
+        {
+            const float* m = Data;
+            Mat4 inv;
+            float* o = inv.Data;
+            o[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+            o[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+            o[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+            o[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+            o[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+            o[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+            o[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+            o[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+            o[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+            o[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+            o[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+            o[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+            o[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+            o[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+            o[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+            o[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+            const float det = m[0] * o[0] + m[1] * o[4] + m[2] * o[8] + m[3] * o[12];
+            if (det == 0.0f)
+                return Mat4();
+            const float invDet = 1.0f / det;
+            for (float& value : inv.Data)
+                value *= invDet;
+            return inv;
+        }
+    };
+
+    struct AABB
+    {
+        Vec3 Min;
+        Vec3 Max;
+
+        constexpr AABB() = default;
+        constexpr AABB(const Vec3& min, const Vec3& max) : Min(min), Max(max) {}
+
+        constexpr Vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+        constexpr Vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+        constexpr float GetSurfaceArea() const
+        {
+            const Vec3 d = Max - Min;
+            return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+
+        constexpr bool Contains(const AABB& o) const
+        {
+            return Min.x <= o.Min.x && Min.y <= o.Min.y && Min.z <= o.Min.z
+                && Max.x >= o.Max.x && Max.y >= o.Max.y && Max.z >= o.Max.z;
+        }
+
+        constexpr bool Overlaps(const AABB& o) const
+        {
+            return Min.x <= o.Max.x && Max.x >= o.Min.x
+                && Min.y <= o.Max.y && Max.y >= o.Min.y
+                && Min.z <= o.Max.z && Max.z >= o.Min.z;
+        }
+
+        constexpr AABB Expanded(float margin) const { return { Min - Vec3(margin), Max + Vec3(margin) }; }
+
+        static constexpr AABB Merge(const AABB& a, const AABB& b) { return { GGEngine::Min(a.Min, b.Min), GGEngine::Max(a.Max, b.Max) }; }
+    };
+
+}
@@ -0,0 +1,46 @@
+#include "MathKernels.h"
+
+#include "GGEngine/CpuFeatures.h"
+
+namespace GGEngine {
+
+    const MathKernels* SimdMath::Get(SimdLevel level)
+    {
+        const CpuFeatures& cpu = CpuFeatures::Get();
+        switch (level)
+        {
+            case SimdLevel::Scalar: return GetScalarMathKernels();
+            case SimdLevel::SSE4:   return cpu.SSE41 ? GetSSE4MathKernels() : nullptr;
+            case SimdLevel::AVX2:   return cpu.AVX2 && cpu.FMA ? GetAVX2MathKernels() : nullptr;
+            case SimdLevel::NEON:   return cpu.NEON ? GetNEONMathKernels() : nullptr;
+            default:                return nullptr;
+        }
+    }
+
+    const MathKernels& SimdMath::Get()
+    {
+        static const MathKernels* s_Best = []()
+        {
+            for (SimdLevel level : { SimdLevel::AVX2, SimdLevel::NEON, SimdLevel::SSE4 })
+            {
+                if (const MathKernels* kernels = Get(level))
+                    return kernels;
+            }
+            return GetScalarMathKernels();
+        }();
+        return *s_Best;
+    }
+
+    const char* SimdMath::GetLevelName(SimdLevel level)
+    {
+        switch (level)
+        {
+            case SimdLevel::Scalar: return "Scalar";
+            case SimdLevel::SSE4:   return "SSE4.1";
+            case SimdLevel::AVX2:   return "AVX2+FMA";
+            case SimdLevel::NEON:   return "NEON";
+            default:                return "Unknown";
+        }
+    }
+
+}
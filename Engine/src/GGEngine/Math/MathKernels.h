@@ -0,0 +1,63 @@
+#pragma once
+
+#include "GGEngine/Core.h"
+#include "Math.h"
+
+#include <cstdint>
+
+namespace GGEngine {
+
+    enum class SimdLevel : uint8_t
+    {
+        Scalar = 0,
+        SSE4,
+        AVX2,   // With FMA
+        NEON,
+        Count
+    };
+
+    // Batch kernels over arrays. Point batches are structure-of-arrays: one array per
+    // coordinate, all with the same alignment so the kernels that align their stores align
+    // the loads too. Every level computes the same results up to float rounding (FMA).
+    struct MathKernels
+    {
+        SimdLevel Level;
+
+        // out = m * (x, y, z, 1) for count points; outputs may alias the inputs
+        void (*TransformPoints)(const Mat4& m, const float* x, const float* y, const float* z,
+            float* outX, float* outY, float* outZ, uint32_t count);
+
+        // out[i] = a[i] * b[i]; out may alias a or b
+        void (*MultiplyMat4)(const Mat4* a, const Mat4* b, Mat4* out, uint32_t count);
+
+        // worlds[s] = worlds[parents[s]] * locals[s] for every slot s in slots. No parent
+        // may itself be in the batch.
+        void (*ComposeWorldMatrices)(Mat4* worlds, const Mat4* locals, const uint32_t* parents,
+            const uint32_t* slots, uint32_t count);
+
+        // out[i] = bounds of boxes[i] under the affine matrices[i]
+        void (*TransformAABBs)(const Mat4* matrices, const AABB* boxes, AABB* out, uint32_t count);
+    };
+
+    // Picks the widest kernel set the running CPU supports, once
+    class GG_API SimdMath
+    {
+    public:
+        static const MathKernels& Get();
+        static SimdLevel GetLevel() { return Get().Level; }
+
+        // A specific level, or nullptr when it is not built into this binary or the CPU
+        // lacks it. For benchmarks and tests comparing implementations.
+        static const MathKernels* Get(SimdLevel level);
+
+        static const char* GetLevelName(SimdLevel level);
+    };
+
+    // Each translation unit is built for its instruction set and returns nullptr when the
+    // target architecture doesn't have it
+    const MathKernels* GetScalarMathKernels();
+    const MathKernels* GetSSE4MathKernels();
+    const MathKernels* GetAVX2MathKernels();
+    const MathKernels* GetNEONMathKernels();
+
+}
@@ -0,0 +1,161 @@
+#include "MathKernels.h"
+
+// Built with AVX2 and FMA enabled (see CMakeLists.txt) and without the precompiled header.
+// Only intrinsics, raw floats and functions with internal linkage belong here: an inline
+// function from a shared header compiled in this file could be the copy the linker keeps
+// for the whole program, and fault on CPUs without AVX2.
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+    #define GG_MATH_AVX2
+    #include <immintrin.h>
+#endif
+
+namespace GGEngine {
+
+#if defined(GG_MATH_AVX2)
+
+    namespace {
+
+        // out = a * b on column-major 4x4 floats, two result columns per step: both halves
+        // hold the same column of a, and each half of b holds one column. out may alias
+        // either input.
+        inline void Multiply(const float* a, const float* b, float* out)
+        {
+            const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 0));
+            const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 4));
+            const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 8));
+            const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 12));
+            const __m256 b01 = _mm256_loadu_ps(b);
+            const __m256 b23 = _mm256_loadu_ps(b + 8);
+
+            __m256 r01 = _mm256_mul_ps(a0, _mm256_permute_ps(b01, 0x00));
+            __m256 r23 = _mm256_mul_ps(a0, _mm256_permute_ps(b23, 0x00));
+            r01 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b01, 0x55), r01);
+            r23 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b23, 0x55), r23);
+            r01 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b01, 0xAA), r01);
+            r23 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b23, 0xAA), r23);
+            r01 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b01, 0xFF), r01);
+            r23 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b23, 0xFF), r23);
+            _mm256_storeu_ps(out, r01);
+            _mm256_storeu_ps(out + 8, r23);
+        }
+
+        void TransformPoints(const Mat4& m, const float* x, const float* y, const float* z,
+            float* outX, float* outY, float* outZ, uint32_t count)
+        {
+            const float* d = m.Data;
+            const __m256 m00 = _mm256_set1_ps(d[0]), m10 = _mm256_set1_ps(d[1]), m20 = _mm256_set1_ps(d[2]);
+            const __m256 m01 = _mm256_set1_ps(d[4]), m11 = _mm256_set1_ps(d[5]), m21 = _mm256_set1_ps(d[6]);
+            const __m256 m02 = _mm256_set1_ps(d[8]), m12 = _mm256_set1_ps(d[9]), m22 = _mm256_set1_ps(d[10]);
+            const __m256 m03 = _mm256_set1_ps(d[12]), m13 = _mm256_set1_ps(d[13]), m23 = _mm256_set1_ps(d[14]);
+
+            // Peel up to seven points so the stores are aligned; arrays from the same
+            // allocator usually share their alignment, which aligns the loads too
+            uint32_t i = (uint32_t)(((32 - ((uintptr_t)outX & 31)) & 31) / sizeof(float));
+            i = i < count ? i : count;
+            if (i > 0)
+                GetScalarMathKernels()->TransformPoints(m, x, y, z, outX, outY, outZ, i);
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 px = _mm256_loadu_ps(x + i);
+                const __m256 py = _mm256_loadu_ps(y + i);
+                const __m256 pz = _mm256_loadu_ps(z + i);
+                const __m256 rx = _mm256_fmadd_ps(m00, px, _mm256_fmadd_ps(m01, py, _mm256_fmadd_ps(m02, pz, m03)));
+                const __m256 ry = _mm256_fmadd_ps(m10, px, _mm256_fmadd_ps(m11, py, _mm256_fmadd_ps(m12, pz, m13)));
+                const __m256 rz = _mm256_fmadd_ps(m20, px, _mm256_fmadd_ps(m21, py, _mm256_fmadd_ps(m22, pz, m23)));
+                _mm256_storeu_ps(outX + i, rx);
+                _mm256_storeu_ps(outY + i, ry);
+                _mm256_storeu_ps(outZ + i, rz);
+            }
+            if (i < count)
+                GetScalarMathKernels()->TransformPoints(m, x + i, y + i, z + i, outX + i, outY + i, outZ + i, count - i);
+        }
+
+        void MultiplyMat4(const Mat4* a, const Mat4* b, Mat4* out, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++)
+                Multiply(a[i].Data, b[i].Data, out[i].Data);
+        }
+
+        void ComposeWorldMatrices(Mat4* worlds, const Mat4* locals, const uint32_t* parents,
+            const uint32_t* slots, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const uint32_t slot = slots[i];
+                Multiply(worlds[parents[slot]].Data, locals[slot].Data, worlds[slot].Data);
+            }
+        }
+
+        inline __m256 Combine(__m128 low, __m128 high)
+        {
+            return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+        }
+
+        // Writes the min and max held in one 128-bit half to a six-float box:
+        // (min.xyz, junk), then (min.z, max.xyz) over it, so nothing past the box is touched
+        inline void StoreBox(float* box, __m128 min, __m128 max)
+        {
+            const __m128 shiftedMax = _mm_shuffle_ps(max, max, _MM_SHUFFLE(2, 1, 0, 0));
+            _mm_storeu_ps(box, min);
+            _mm_storeu_ps(box + 2, _mm_blend_ps(_mm_shuffle_ps(min, min, _MM_SHUFFLE(2, 2, 2, 2)), shiftedMax, 0xE));
+        }
+
+        void TransformAABBs(const Mat4* matrices, const AABB* boxes, AABB* out, uint32_t count)
+        {
+            // Two boxes per step, one in each 128-bit half; in-lane permutes splat each
+            // half's own center and extents
+            const __m256 half = _mm256_set1_ps(0.5f);
+            const __m256 signBit = _mm256_set1_ps(-0.0f);
+            uint32_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                const float* box0 = &boxes[i].Min.x;
+                const float* box1 = &boxes[i + 1].Min.x;
+                const __m256 min = Combine(_mm_loadu_ps(box0), _mm_loadu_ps(box1));
+                const __m256 tail = Combine(_mm_loadu_ps(box0 + 2), _mm_loadu_ps(box1 + 2));
+                const __m256 max = _mm256_permute_ps(tail, _MM_SHUFFLE(3, 3, 2, 1));
+                const __m256 center = _mm256_mul_ps(_mm256_add_ps(min, max), half);
+                const __m256 extents = _mm256_mul_ps(_mm256_sub_ps(max, min), half);
+
+                const float* d0 = matrices[i].Data;
+                const float* d1 = matrices[i + 1].Data;
+                const __m256 c0 = Combine(_mm_load_ps(d0 + 0), _mm_load_ps(d1 + 0));
+                const __m256 c1 = Combine(_mm_load_ps(d0 + 4), _mm_load_ps(d1 + 4));
+                const __m256 c2 = Combine(_mm_load_ps(d0 + 8), _mm_load_ps(d1 + 8));
+                const __m256 c3 = Combine(_mm_load_ps(d0 + 12), _mm_load_ps(d1 + 12));
+
+                __m256 newCenter = _mm256_fmadd_ps(c0, _mm256_permute_ps(center, 0x00), c3);
+                newCenter = _mm256_fmadd_ps(c1, _mm256_permute_ps(center, 0x55), newCenter);
+                newCenter = _mm256_fmadd_ps(c2, _mm256_permute_ps(center, 0xAA), newCenter);
+                __m256 newExtents = _mm256_mul_ps(_mm256_andnot_ps(signBit, c0), _mm256_permute_ps(extents, 0x00));
+                newExtents = _mm256_fmadd_ps(_mm256_andnot_ps(signBit, c1), _mm256_permute_ps(extents, 0x55), newExtents);
+                newExtents = _mm256_fmadd_ps(_mm256_andnot_ps(signBit, c2), _mm256_permute_ps(extents, 0xAA), newExtents);
+
+                const __m256 newMin = _mm256_sub_ps(newCenter, newExtents);
+                const __m256 newMax = _mm256_add_ps(newCenter, newExtents);
+                StoreBox(&out[i].Min.x, _mm256_castps256_ps128(newMin), _mm256_castps256_ps128(newMax));
+                StoreBox(&out[i + 1].Min.x, _mm256_extractf128_ps(newMin, 1), _mm256_extractf128_ps(newMax, 1));
+            }
+            if (i < count)
+                GetScalarMathKernels()->TransformAABBs(matrices + i, boxes + i, out + i, count - i);
+        }
+
+    }
+
+    const MathKernels* GetAVX2MathKernels()
+    {
+        static const MathKernels s_Kernels = { SimdLevel::AVX2, TransformPoints, MultiplyMat4, ComposeWorldMatrices, TransformAABBs };
+        return &s_Kernels;
+    }
+
+#else
+
+    const MathKernels* GetAVX2MathKernels()
+    {
+        return nullptr;
+    }
+
+#endif
+
+}
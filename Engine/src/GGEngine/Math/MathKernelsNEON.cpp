@@ -0,0 +1,146 @@
+#include "MathKernels.h"
+
+// Advanced SIMD is part of the AArch64 baseline, so this needs no extra compiler flags.
+// On other targets it only provides the null entry point.
+
+#if defined(_M_ARM64) || defined(__aarch64__)
+    #define GG_MATH_NEON
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <arm64_neon.h>
+    #else
+        #include <arm_neon.h>
+    #endif
+#endif
+
+namespace GGEngine {
+
+#if defined(GG_MATH_NEON)
+
+    namespace {
+
+        // out = a * b on column-major 4x4 floats; out may alias either input
+        inline void Multiply(const float* a, const float* b, float* out)
+        {
+            const float32x4_t a0 = vld1q_f32(a + 0);
+            const float32x4_t a1 = vld1q_f32(a + 4);
+            const float32x4_t a2 = vld1q_f32(a + 8);
+            const float32x4_t a3 = vld1q_f32(a + 12);
+            const float32x4_t b0 = vld1q_f32(b + 0);
+            const float32x4_t b1 = vld1q_f32(b + 4);
+            const float32x4_t b2 = vld1q_f32(b + 8);
+            const float32x4_t b3 = vld1q_f32(b + 12);
+
+            float32x4_t r0 = vmulq_laneq_f32(a0, b0, 0);
+            float32x4_t r1 = vmulq_laneq_f32(a0, b1, 0);
+            float32x4_t r2 = vmulq_laneq_f32(a0, b2, 0);
+            float32x4_t r3 = vmulq_laneq_f32(a0, b3, 0);
+            r0 = vfmaq_laneq_f32(r0, a1, b0, 1);
+            r1 = vfmaq_laneq_f32(r1, a1, b1, 1);
+            r2 = vfmaq_laneq_f32(r2, a1, b2, 1);
+            r3 = vfmaq_laneq_f32(r3, a1, b3, 1);
+            r0 = vfmaq_laneq_f32(r0, a2, b0, 2);
+            r1 = vfmaq_laneq_f32(r1, a2, b1, 2);
+            r2 = vfmaq_laneq_f32(r2, a2, b2, 2);
+            r3 = vfmaq_laneq_f32(r3, a2, b3, 2);
+            r0 = vfmaq_laneq_f32(r0, a3, b0, 3);
+            r1 = vfmaq_laneq_f32(r1, a3, b1, 3);
+            r2 = vfmaq_laneq_f32(r2, a3, b2, 3);
+            r3 = vfmaq_laneq_f32(r3, a3, b3, 3);
+            vst1q_f32(out + 0, r0);
+            vst1q_f32(out + 4, r1);
+            vst1q_f32(out + 8, r2);
+            vst1q_f32(out + 12, r3);
+        }
+
+        void TransformPoints(const Mat4& m, const float* x, const float* y, const float* z,
+            float* outX, float* outY, float* outZ, uint32_t count)
+        {
+            const float* d = m.Data;
+            const float32x4_t m00 = vdupq_n_f32(d[0]), m10 = vdupq_n_f32(d[1]), m20 = vdupq_n_f32(d[2]);
+            const float32x4_t m01 = vdupq_n_f32(d[4]), m11 = vdupq_n_f32(d[5]), m21 = vdupq_n_f32(d[6]);
+            const float32x4_t m02 = vdupq_n_f32(d[8]), m12 = vdupq_n_f32(d[9]), m22 = vdupq_n_f32(d[10]);
+            const float32x4_t m03 = vdupq_n_f32(d[12]), m13 = vdupq_n_f32(d[13]), m23 = vdupq_n_f32(d[14]);
+
+            uint32_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const float32x4_t px = vld1q_f32(x + i);
+                const float32x4_t py = vld1q_f32(y + i);
+                const float32x4_t pz = vld1q_f32(z + i);
+                vst1q_f32(outX + i, vfmaq_f32(vfmaq_f32(vfmaq_f32(m03, m02, pz), m01, py), m00, px));
+                vst1q_f32(outY + i, vfmaq_f32(vfmaq_f32(vfmaq_f32(m13, m12, pz), m11, py), m10, px));
+                vst1q_f32(outZ + i, vfmaq_f32(vfmaq_f32(vfmaq_f32(m23, m22, pz), m21, py), m20, px));
+            }
+            if (i < count)
+                GetScalarMathKernels()->TransformPoints(m, x + i, y + i, z + i, outX + i, outY + i, outZ + i, count - i);
+        }
+
+        void MultiplyMat4(const Mat4* a, const Mat4* b, Mat4* out, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++)
+                Multiply(a[i].Data, b[i].Data, out[i].Data);
+        }
+
+        void ComposeWorldMatrices(Mat4* worlds, const Mat4* locals, const uint32_t* parents,
+            const uint32_t* slots, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const uint32_t slot = slots[i];
+                Multiply(worlds[parents[slot]].Data, locals[slot].Data, worlds[slot].Data);
+            }
+        }
+
+        void TransformAABBs(const Mat4* matrices, const AABB* boxes, AABB* out, uint32_t count)
+        {
+            const float32x4_t half = vdupq_n_f32(0.5f);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                // (min.xyz, max.x) and (min.z, max.xyz): neither load reads past the box
+                const float* box = &boxes[i].Min.x;
+                const float32x4_t min = vld1q_f32(box);
+                const float32x4_t tail = vld1q_f32(box + 2);
+                const float32x4_t max = vextq_f32(tail, tail, 1);
+                const float32x4_t center = vmulq_f32(vaddq_f32(min, max), half);
+                const float32x4_t extents = vmulq_f32(vsubq_f32(max, min), half);
+
+                const float* d = matrices[i].Data;
+                const float32x4_t c0 = vld1q_f32(d + 0);
+                const float32x4_t c1 = vld1q_f32(d + 4);
+                const float32x4_t c2 = vld1q_f32(d + 8);
+                const float32x4_t c3 = vld1q_f32(d + 12);
+
+                float32x4_t newCenter = vfmaq_laneq_f32(c3, c0, center, 0);
+                newCenter = vfmaq_laneq_f32(newCenter, c1, center, 1);
+                newCenter = vfmaq_laneq_f32(newCenter, c2, center, 2);
+                float32x4_t newExtents = vmulq_laneq_f32(vabsq_f32(c0), extents, 0);
+                newExtents = vfmaq_laneq_f32(newExtents, vabsq_f32(c1), extents, 1);
+                newExtents = vfmaq_laneq_f32(newExtents, vabsq_f32(c2), extents, 2);
+
+                // (min.xyz, junk), then (min.z, max.xyz) over it
+                const float32x4_t newMin = vsubq_f32(newCenter, newExtents);
+                const float32x4_t newMax = vaddq_f32(newCenter, newExtents);
+                float* result = &out[i].Min.x;
+                vst1q_f32(result, newMin);
+                vst1q_f32(result + 2, vextq_f32(vdupq_laneq_f32(newMin, 2), newMax, 3));
+            }
+        }
+
+    }
+
+    const MathKernels* GetNEONMathKernels()
+    {
+        static const MathKernels s_Kernels = { SimdLevel::NEON, TransformPoints, MultiplyMat4, ComposeWorldMatrices, TransformAABBs };
+        return &s_Kernels;
+    }
+
+#else
+
+    const MathKernels* GetNEONMathKernels()
+    {
+        return nullptr;
+    }
+
+#endif
+
+}
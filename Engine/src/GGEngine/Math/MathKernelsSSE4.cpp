@@ -0,0 +1,146 @@
+#include "MathKernels.h"
+
+// Built with SSE4.1 enabled (see CMakeLists.txt) and without the precompiled header.
+// Only intrinsics, raw floats and functions with internal linkage belong here: an inline
+// function from a shared header compiled in this file could be the copy the linker keeps
+// for the whole program.
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+    #define GG_MATH_SSE4
+    #include <smmintrin.h>
+#endif
+
+namespace GGEngine {
+
+#if defined(GG_MATH_SSE4)
+
+    namespace {
+
+        inline __m128 Splat(__m128 v, int lane)
+        {
+            switch (lane)
+            {
+                case 0:  return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+                case 1:  return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+                case 2:  return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+                default: return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+            }
+        }
+
+        // out = a * b on column-major 4x4 floats. a is loaded up front and each column of b
+        // before its result is stored, so out may alias either.
+        inline void Multiply(const float* a, const float* b, float* out)
+        {
+            const __m128 a0 = _mm_load_ps(a + 0);
+            const __m128 a1 = _mm_load_ps(a + 4);
+            const __m128 a2 = _mm_load_ps(a + 8);
+            const __m128 a3 = _mm_load_ps(a + 12);
+            for (int column = 0; column < 4; column++)
+            {
+                const __m128 bc = _mm_load_ps(b + column * 4);
+                __m128 result = _mm_mul_ps(a0, Splat(bc, 0));
+                result = _mm_add_ps(result, _mm_mul_ps(a1, Splat(bc, 1)));
+                result = _mm_add_ps(result, _mm_mul_ps(a2, Splat(bc, 2)));
+                result = _mm_add_ps(result, _mm_mul_ps(a3, Splat(bc, 3)));
+                _mm_store_ps(out + column * 4, result);
+            }
+        }
+
+        void TransformPoints(const Mat4& m, const float* x, const float* y, const float* z,
+            float* outX, float* outY, float* outZ, uint32_t count)
+        {
+            const float* d = m.Data;
+            const __m128 m00 = _mm_set1_ps(d[0]), m10 = _mm_set1_ps(d[1]), m20 = _mm_set1_ps(d[2]);
+            const __m128 m01 = _mm_set1_ps(d[4]), m11 = _mm_set1_ps(d[5]), m21 = _mm_set1_ps(d[6]);
+            const __m128 m02 = _mm_set1_ps(d[8]), m12 = _mm_set1_ps(d[9]), m22 = _mm_set1_ps(d[10]);
+            const __m128 m03 = _mm_set1_ps(d[12]), m13 = _mm_set1_ps(d[13]), m23 = _mm_set1_ps(d[14]);
+
+            uint32_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 px = _mm_loadu_ps(x + i);
+                const __m128 py = _mm_loadu_ps(y + i);
+                const __m128 pz = _mm_loadu_ps(z + i);
+                const __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, px), _mm_mul_ps(m01, py)), _mm_add_ps(_mm_mul_ps(m02, pz), m03));
+                const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, px), _mm_mul_ps(m11, py)), _mm_add_ps(_mm_mul_ps(m12, pz), m13));
+                const __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, px), _mm_mul_ps(m21, py)), _mm_add_ps(_mm_mul_ps(m22, pz), m23));
+                _mm_storeu_ps(outX + i, rx);
+                _mm_storeu_ps(outY + i, ry);
+                _mm_storeu_ps(outZ + i, rz);
+            }
+            if (i < count)
+                GetScalarMathKernels()->TransformPoints(m, x + i, y + i, z + i, outX + i, outY + i, outZ + i, count - i);
+        }
+
+        void MultiplyMat4(const Mat4* a, const Mat4* b, Mat4* out, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++)
+                Multiply(a[i].Data, b[i].Data, out[i].Data);
+        }
+
+        void ComposeWorldMatrices(Mat4* worlds, const Mat4* locals, const uint32_t* parents,
+            const uint32_t* slots, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const uint32_t slot = slots[i];
+                Multiply(worlds[parents[slot]].Data, locals[slot].Data, worlds[slot].Data);
+            }
+        }
+
+        void TransformAABBs(const Mat4* matrices, const AABB* boxes, AABB* out, uint32_t count)
+        {
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 signBit = _mm_set1_ps(-0.0f);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                // A box is six packed floats: load (min.xyz, max.x) and (min.z, max.xyz) so
+                // neither load reads past it
+                const float* box = &boxes[i].Min.x;
+                const __m128 min = _mm_loadu_ps(box);
+                const __m128 tail = _mm_loadu_ps(box + 2);
+                const __m128 max = _mm_shuffle_ps(tail, tail, _MM_SHUFFLE(3, 3, 2, 1));
+                const __m128 center = _mm_mul_ps(_mm_add_ps(min, max), half);
+                const __m128 extents = _mm_mul_ps(_mm_sub_ps(max, min), half);
+
+                const float* d = matrices[i].Data;
+                const __m128 c0 = _mm_load_ps(d + 0);
+                const __m128 c1 = _mm_load_ps(d + 4);
+                const __m128 c2 = _mm_load_ps(d + 8);
+                const __m128 c3 = _mm_load_ps(d + 12);
+
+                __m128 newCenter = _mm_add_ps(_mm_mul_ps(c0, Splat(center, 0)), c3);
+                newCenter = _mm_add_ps(newCenter, _mm_mul_ps(c1, Splat(center, 1)));
+                newCenter = _mm_add_ps(newCenter, _mm_mul_ps(c2, Splat(center, 2)));
+                __m128 newExtents = _mm_mul_ps(_mm_andnot_ps(signBit, c0), Splat(extents, 0));
+                newExtents = _mm_add_ps(newExtents, _mm_mul_ps(_mm_andnot_ps(signBit, c1), Splat(extents, 1)));
+                newExtents = _mm_add_ps(newExtents, _mm_mul_ps(_mm_andnot_ps(signBit, c2), Splat(extents, 2)));
+
+                // Same split on the way out: (min.xyz, junk), then (min.z, max.xyz) over it
+                const __m128 newMin = _mm_sub_ps(newCenter, newExtents);
+                const __m128 newMax = _mm_add_ps(newCenter, newExtents);
+                const __m128 shiftedMax = _mm_shuffle_ps(newMax, newMax, _MM_SHUFFLE(2, 1, 0, 0));
+                float* result = &out[i].Min.x;
+                _mm_storeu_ps(result, newMin);
+                _mm_storeu_ps(result + 2, _mm_blend_ps(Splat(newMin, 2), shiftedMax, 0xE));
+            }
+        }
+
+    }
+
+    const MathKernels* GetSSE4MathKernels()
+    {
+        static const MathKernels s_Kernels = { SimdLevel::SSE4, TransformPoints, MultiplyMat4, ComposeWorldMatrices, TransformAABBs };
+        return &s_Kernels;
+    }
+
+#else
+
+    const MathKernels* GetSSE4MathKernels()
+    {
+        return nullptr;
+    }
+
+#endif
+
+}
@@ -0,0 +1,64 @@
+#include "MathKernels.h"
+
+// Reference kernels, built with the target's baseline flags. Also the fallback for
+// batch tails shorter than a vector in the SIMD kernels' own translation units.
+
+namespace GGEngine {
+
+    namespace {
+
+        void TransformPoints(const Mat4& m, const float* x, const float* y, const float* z,
+            float* outX, float* outY, float* outZ, uint32_t count)
+        {
+            const float* d = m.Data;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const float px = x[i], py = y[i], pz = z[i];
+                outX[i] = d[0] * px + d[4] * py + d[8] * pz + d[12];
+                outY[i] = d[1] * px + d[5] * py + d[9] * pz + d[13];
+                outZ[i] = d[2] * px + d[6] * py + d[10] * pz + d[14];
+            }
+        }
+
+        void MultiplyMat4(const Mat4* a, const Mat4* b, Mat4* out, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++)
+                out[i] = a[i] * b[i];
+        }
+
+        void ComposeWorldMatrices(Mat4* worlds, const Mat4* locals, const uint32_t* parents,
+            const uint32_t* slots, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const uint32_t slot = slots[i];
+                worlds[slot] = worlds[parents[slot]] * locals[slot];
+            }
+        }
+
+        void TransformAABBs(const Mat4* matrices, const AABB* boxes, AABB* out, uint32_t count)
+        {
+            // Transform the center, and grow the extents by the absolute rotation-scale part
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const float* d = matrices[i].Data;
+                const Vec3 center = boxes[i].GetCenter();
+                const Vec3 extents = boxes[i].GetExtents();
+                const Vec3 newCenter = matrices[i].TransformPoint(center);
+                const Vec3 newExtents(
+                    std::fabs(d[0]) * extents.x + std::fabs(d[4]) * extents.y + std::fabs(d[8]) * extents.z,
+                    std::fabs(d[1]) * extents.x + std::fabs(d[5]) * extents.y + std::fabs(d[9]) * extents.z,
+                    std::fabs(d[2]) * extents.x + std::fabs(d[6]) * extents.y + std::fabs(d[10]) * extents.z);
+                out[i] = AABB(newCenter - newExtents, newCenter + newExtents);
+            }
+        }
+
+    }
+
+    const MathKernels* GetScalarMathKernels()
+    {
+        static const MathKernels s_Kernels = { SimdLevel::Scalar, TransformPoints, MultiplyMat4, ComposeWorldMatrices, TransformAABBs };
+        return &s_Kernels;
+    }
+
+}
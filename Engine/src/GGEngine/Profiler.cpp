@@ -0,0 +1,95 @@
+#include "Profiler.h"
+
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace GGEngine {
+
+    namespace {
+
+        struct NameStats
+        {
+            double TotalMs = 0.0;
+            double MaxMs = 0.0; // Worst single frame
+            uint64_t Frames = 0; // Frames the name appeared in
+        };
+
+        struct ProfilerData
+        {
+            std::mutex Mutex;
+            std::vector<ProfileSample> Current;
+            std::vector<ProfileSample> Last;
+            std::unordered_map<std::string, NameStats> Stats;
+            std::unordered_map<std::string, double> FrameTotals; // Scratch for BeginFrame
+            uint64_t FrameCount = 0;
+        };
+
+        ProfilerData s_Data;
+
+    }
+
+    void Profiler::BeginFrame()
+    {
+        std::lock_guard<std::mutex> lock(s_Data.Mutex);
+        if (s_Data.Current.empty())
+            return;
+
+        // A name recorded several times in one frame (per-chunk work, nested calls) counts once
+        s_Data.FrameTotals.clear();
+        for (const ProfileSample& sample : s_Data.Current)
+            s_Data.FrameTotals[sample.Name] += (sample.End - sample.Start) * 1000.0;
+        for (const auto& [name, milliseconds] : s_Data.FrameTotals)
+        {
+            NameStats& stats = s_Data.Stats[name];
+            stats.TotalMs += milliseconds;
+            stats.MaxMs = std::max(stats.MaxMs, milliseconds);
+            stats.Frames++;
+        }
+        s_Data.FrameCount++;
+
+        s_Data.Last.swap(s_Data.Current);
+        s_Data.Current.clear();
+    }
+
+    void Profiler::Reset()
+    {
+        std::lock_guard<std::mutex> lock(s_Data.Mutex);
+        s_Data.Current.clear();
+        s_Data.Last.clear();
+        s_Data.Stats.clear();
+        s_Data.FrameCount = 0;
+    }
+
+    void Profiler::Record(const std::string& name, double start, double end)
+    {
+        const uint32_t threadIndex = JobSystem::GetThreadIndex();
+        std::lock_guard<std::mutex> lock(s_Data.Mutex);
+        s_Data.Current.push_back({ name, start, end, threadIndex });
+    }
+
+    std::vector<ProfileSample> Profiler::GetLastFrame()
+    {
+        std::lock_guard<std::mutex> lock(s_Data.Mutex);
+        return s_Data.Last;
+    }
+
+    void Profiler::Report()
+    {
+        std::lock_guard<std::mutex> lock(s_Data.Mutex);
+        if (s_Data.Stats.empty())
+            return;
+
+        std::vector<std::pair<std::string, NameStats>> sorted(s_Data.Stats.begin(), s_Data.Stats.end());
+        std::sort(sorted.begin(), sorted.end(),
+            [](const auto& a, const auto& b) { return a.second.TotalMs > b.second.TotalMs; });
+
+        GG_CORE_INFO("Profile over {0} frames (ms per frame)", s_Data.FrameCount);
+        for (const auto& [name, stats] : sorted)
+        {
+            GG_CORE_INFO("  {0}: avg {1:.3f}  max {2:.3f}  ({3} frames)",
+                name, stats.TotalMs / (double)stats.Frames, stats.MaxMs, stats.Frames);
+        }
+    }
+
+}
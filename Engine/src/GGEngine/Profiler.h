@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Core.h"
+#include "Timer.h"
+
+#include <string>
+#include <vector>
+
+namespace GGEngine {
+
+    struct ProfileSample
+    {
+        std::string Name;
+        double Start = 0.0; // Engine clock (Timer::Now), seconds
+        double End = 0.0;
+        uint32_t ThreadIndex = 0; // JobSystem thread index
+    };
+
+    // Named CPU timings from any thread, collected per frame. Totals per name accumulate
+    // across frames for the report; the last complete frame can be inspected in full.
+    class GG_API Profiler
+    {
+    public:
+        // Main thread, once per frame: samples recorded since the previous call become the last frame
+        static void BeginFrame();
+        static void Reset();
+
+        // Any thread
+        static void Record(const std::string& name, double start, double end);
+
+        static std::vector<ProfileSample> GetLastFrame();
+
+        // Logs avg/max milliseconds per frame for every name, costliest first
+        static void Report();
+    };
+
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(const char* name)
+            : m_Name(name), m_Start(Timer::Now()) {}
+        ~ProfileScope() { Profiler::Record(m_Name, m_Start, Timer::Now()); }
+
+    private:
+        const char* m_Name;
+        double m_Start;
+    };
+
+}
+
+#define GG_PROFILE_CONCAT_INNER(a, b) a##b
+#define GG_PROFILE_CONCAT(a, b) GG_PROFILE_CONCAT_INNER(a, b)
+#define GG_PROFILE_SCOPE(name) ::GGEngine::ProfileScope GG_PROFILE_CONCAT(ggProfileScope, __LINE__)(name)
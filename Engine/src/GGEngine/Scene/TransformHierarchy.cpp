@@ -0,0 +1,265 @@
+#include "TransformHierarchy.h"
+
+#include "GGEngine/Log.h"
+#include "GGEngine/Math/MathKernels.h"
+
+#include <algorithm>
+
+namespace GGEngine {
+
+    namespace {
+
+        template<typename T>
+        void Permute(std::vector<T>& values, const std::vector<uint32_t>& newSlot, uint32_t newCount)
+        {
+            std::vector<T> sorted(newCount);
+            for (size_t slot = 0; slot < values.size(); slot++)
+            {
+                if (newSlot[slot] != UINT32_MAX)
+                    sorted[newSlot[slot]] = values[slot];
+            }
+            values.swap(sorted);
+        }
+
+    }
+
+    TransformID TransformHierarchy::Create(TransformID parent)
+    {
+        GG_CORE_ASSERT(parent == NullTransform || IsValid(parent), "Invalid parent transform");
+
+        TransformID id;
+        if (!m_FreeIDs.empty())
+        {
+            id = m_FreeIDs.back();
+            m_FreeIDs.pop_back();
+        }
+        else
+        {
+            id = (TransformID)m_SlotOf.size();
+            m_SlotOf.push_back(s_NoSlot);
+        }
+
+        // Appended out of depth order; the next Update sorts it into place
+        const uint32_t slot = (uint32_t)m_IDs.size();
+        m_SlotOf[id] = slot;
+        m_IDs.push_back(id);
+        m_Parents.push_back(parent == NullTransform ? s_NoSlot : m_SlotOf[parent]);
+        m_Positions.emplace_back();
+        m_Rotations.emplace_back();
+        m_Scales.emplace_back(1.0f);
+        m_Locals.push_back(Mat4::Identity());
+        m_Worlds.push_back(Mat4::Identity());
+        m_LocalDirty.push_back(1);
+        m_Changed.push_back(0);
+
+        m_Count++;
+        m_TopologyDirty = true;
+        return id;
+    }
+
+    void TransformHierarchy::Destroy(TransformID node)
+    {
+        if (!IsValid(node))
+            return;
+
+        m_IDs[m_SlotOf[node]] = NullTransform;
+        m_SlotOf[node] = s_NoSlot;
+        m_FreeIDs.push_back(node);
+        m_Count--;
+        m_TopologyDirty = true;
+    }
+
+    bool TransformHierarchy::IsValid(TransformID node) const
+    {
+        return node < m_SlotOf.size() && m_SlotOf[node] != s_NoSlot;
+    }
+
+    void TransformHierarchy::SetParent(TransformID node, TransformID parent)
+    {
+        GG_CORE_ASSERT(IsValid(node) && (parent == NullTransform || IsValid(parent)), "Invalid transform");
+        // A cycle would keep Sort from ever finishing
+        for (uint32_t slot = parent == NullTransform ? s_NoSlot : m_SlotOf[parent]; slot != s_NoSlot; slot = m_Parents[slot])
+        {
+            if (slot == m_SlotOf[node])
+            {
+                GG_CORE_ERROR("TransformHierarchy: reparenting transform {0} under {1} would create a cycle", node, parent);
+                return;
+            }
+        }
+
+        m_Parents[m_SlotOf[node]] = parent == NullTransform ? s_NoSlot : m_SlotOf[parent];
+        MarkDirty(node);
+        m_TopologyDirty = true;
+    }
+
+    TransformID TransformHierarchy::GetParent(TransformID node) const
+    {
+        const uint32_t parent = m_Parents[m_SlotOf[node]];
+        return parent == s_NoSlot ? NullTransform : m_IDs[parent];
+    }
+
+    void TransformHierarchy::SetLocal(TransformID node, const Vec3& position, const Quat& rotation, const Vec3& scale)
+    {
+        const uint32_t slot = m_SlotOf[node];
+        m_Positions[slot] = position;
+        m_Rotations[slot] = rotation;
+        m_Scales[slot] = scale;
+        m_LocalDirty[slot] = 1;
+    }
+
+    void TransformHierarchy::SetPosition(TransformID node, const Vec3& position)
+    {
+        m_Positions[m_SlotOf[node]] = position;
+        MarkDirty(node);
+    }
+
+    void TransformHierarchy::SetRotation(TransformID node, const Quat& rotation)
+    {
+        m_Rotations[m_SlotOf[node]] = rotation;
+        MarkDirty(node);
+    }
+
+    void TransformHierarchy::SetScale(TransformID node, const Vec3& scale)
+    {
+        m_Scales[m_SlotOf[node]] = scale;
+        MarkDirty(node);
+    }
+
+    void TransformHierarchy::MarkDirty(TransformID node)
+    {
+        m_LocalDirty[m_SlotOf[node]] = 1;
+    }
+
+    void TransformHierarchy::Sort()
+    {
+        // Depth of every slot, or -1 when it or an ancestor was destroyed. Chains are walked
+        // once: each slot is resolved from its parent's memoized depth.
+        const uint32_t slotCount = (uint32_t)m_IDs.size();
+        const int32_t unknown = -2;
+        std::vector<int32_t> depth(slotCount, unknown);
+        std::vector<uint32_t> chain;
+        for (uint32_t slot = 0; slot < slotCount; slot++)
+        {
+            uint32_t current = slot;
+            while (current != s_NoSlot && depth[current] == unknown)
+            {
+                chain.push_back(current);
+                current = m_Parents[current];
+            }
+            int32_t next = current == s_NoSlot ? 0 : (depth[current] < 0 ? -1 : depth[current] + 1);
+            while (!chain.empty())
+            {
+                const uint32_t link = chain.back();
+                chain.pop_back();
+                if (next >= 0 && m_IDs[link] == NullTransform)
+                    next = -1;
+                depth[link] = next;
+                if (next >= 0)
+                    next++;
+            }
+        }
+
+        // Counting sort by depth, stable so siblings keep their relative order
+        m_LevelEnds.clear();
+        for (uint32_t slot = 0; slot < slotCount; slot++)
+        {
+            if (depth[slot] < 0)
+            {
+                // Descendants of a destroyed node go with it
+                if (m_IDs[slot] != NullTransform)
+                {
+                    m_SlotOf[m_IDs[slot]] = s_NoSlot;
+                    m_FreeIDs.push_back(m_IDs[slot]);
+                    m_Count--;
+                }
+                continue;
+            }
+            if ((size_t)depth[slot] >= m_LevelEnds.size())
+                m_LevelEnds.resize(depth[slot] + 1, 0);
+            m_LevelEnds[depth[slot]]++;
+        }
+        uint32_t total = 0;
+        for (uint32_t& end : m_LevelEnds)
+        {
+            total += end;
+            end = total;
+        }
+
+        std::vector<uint32_t> newSlot(slotCount, s_NoSlot);
+        std::vector<uint32_t> cursor(m_LevelEnds.size(), 0);
+        for (size_t level = 1; level < m_LevelEnds.size(); level++)
+            cursor[level] = m_LevelEnds[level - 1];
+        for (uint32_t slot = 0; slot < slotCount; slot++)
+        {
+            if (depth[slot] >= 0)
+                newSlot[slot] = cursor[depth[slot]]++;
+        }
+
+        for (uint32_t& parent : m_Parents)
+            parent = parent == s_NoSlot ? s_NoSlot : newSlot[parent];
+        Permute(m_IDs, newSlot, total);
+        Permute(m_Parents, newSlot, total);
+        Permute(m_Positions, newSlot, total);
+        Permute(m_Rotations, newSlot, total);
+        Permute(m_Scales, newSlot, total);
+        Permute(m_Locals, newSlot, total);
+        Permute(m_Worlds, newSlot, total);
+        Permute(m_LocalDirty, newSlot, total);
+        m_Changed.assign(total, 0);
+
+        for (uint32_t slot = 0; slot < total; slot++)
+            m_SlotOf[m_IDs[slot]] = slot;
+        m_TopologyDirty = false;
+    }
+
+    void TransformHierarchy::Update()
+    {
+        if (m_TopologyDirty)
+            Sort();
+
+        const uint32_t slotCount = (uint32_t)m_IDs.size();
+        for (uint32_t slot = 0; slot < slotCount; slot++)
+        {
+            if (m_LocalDirty[slot])
+                m_Locals[slot] = Mat4::FromTRS(m_Positions[slot], m_Rotations[slot], m_Scales[slot]);
+        }
+
+        uint32_t updated = 0;
+        uint32_t levelBegin = 0;
+        for (size_t level = 0; level < m_LevelEnds.size(); level++)
+        {
+            const uint32_t levelEnd = m_LevelEnds[level];
+            if (level == 0)
+            {
+                for (uint32_t slot = levelBegin; slot < levelEnd; slot++)
+                {
+                    m_Changed[slot] = m_LocalDirty[slot];
+                    if (m_LocalDirty[slot])
+                    {
+                        m_Worlds[slot] = m_Locals[slot];
+                        updated++;
+                    }
+                }
+            }
+            else
+            {
+                m_Batch.clear();
+                for (uint32_t slot = levelBegin; slot < levelEnd; slot++)
+                {
+                    const uint8_t changed = m_LocalDirty[slot] | m_Changed[m_Parents[slot]];
+                    m_Changed[slot] = changed;
+                    if (changed)
+                        m_Batch.push_back(slot);
+                }
+                // Parents belong to the previous level, so nothing in a batch depends on another entry of it
+                SimdMath::Get().ComposeWorldMatrices(m_Worlds.data(), m_Locals.data(), m_Parents.data(), m_Batch.data(), (uint32_t)m_Batch.size());
+                updated += (uint32_t)m_Batch.size();
+            }
+            levelBegin = levelEnd;
+        }
+
+        std::fill(m_LocalDirty.begin(), m_LocalDirty.end(), 0);
+        m_LastUpdateCount = updated;
+    }
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "GGEngine/Core.h"
+#include "GGEngine/Math/Math.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace GGEngine {
+
+    using TransformID = uint32_t;
+    constexpr TransformID NullTransform = UINT32_MAX;
+
+    // Parent/child transforms in flat arrays sorted by depth, so parents always come before
+    // their children and a level can be composed in one pass. Only nodes whose local
+    // transform changed, and their descendants, are recomputed by Update.
+    //
+    // Ids are stable; array positions are not. Topology changes (create, destroy, reparent)
+    // are cheap to record and re-sort the arrays once, in the next Update.
+    class GG_API TransformHierarchy
+    {
+    public:
+        TransformID Create(TransformID parent = NullTransform);
+        // Descendants are destroyed with the node once the hierarchy next updates
+        void Destroy(TransformID node);
+        bool IsValid(TransformID node) const;
+
+        // Reparenting a node under itself or one of its descendants is logged and ignored
+        void SetParent(TransformID node, TransformID parent);
+        TransformID GetParent(TransformID node) const;
+
+        void SetLocal(TransformID node, const Vec3& position, const Quat& rotation, const Vec3& scale);
+        void SetPosition(TransformID node, const Vec3& position);
+        void SetRotation(TransformID node, const Quat& rotation);
+        void SetScale(TransformID node, const Vec3& scale);
+        const Vec3& GetPosition(TransformID node) const { return m_Positions[m_SlotOf[node]]; }
+        const Quat& GetRotation(TransformID node) const { return m_Rotations[m_SlotOf[node]]; }
+        const Vec3& GetScale(TransformID node) const { return m_Scales[m_SlotOf[node]]; }
+
+        // As of the last Update
+        const Mat4& GetWorldMatrix(TransformID node) const { return m_Worlds[m_SlotOf[node]]; }
+
+        void Update();
+
+        uint32_t GetCount() const { return m_Count; }
+        uint32_t GetDepth() const { return (uint32_t)m_LevelEnds.size(); }
+        // World matrices the last Update recomputed
+        uint32_t GetLastUpdateCount() const { return m_LastUpdateCount; }
+
+    private:
+        static constexpr uint32_t s_NoSlot = UINT32_MAX;
+
+        void MarkDirty(TransformID node);
+        void Sort();
+
+        // Per id
+        std::vector<uint32_t> m_SlotOf;
+        std::vector<TransformID> m_FreeIDs;
+        uint32_t m_Count = 0;
+
+        // Per slot, depth-sorted after Sort. Parents are slots, so Update never goes through ids.
+        std::vector<TransformID> m_IDs; // NullTransform once destroyed
+        std::vector<uint32_t> m_Parents;
+        std::vector<Vec3> m_Positions;
+        std::vector<Quat> m_Rotations;
+        std::vector<Vec3> m_Scales;
+        std::vector<Mat4> m_Locals;
+        std::vector<Mat4> m_Worlds;
+        std::vector<uint8_t> m_LocalDirty;
+        std::vector<uint8_t> m_Changed; // World matrix recomputed this Update
+
+        std::vector<uint32_t> m_LevelEnds; // One past the last slot of each depth
+        std::vector<uint32_t> m_Batch;     // Slots of one level to recompute
+        bool m_TopologyDirty = false;
+        uint32_t m_LastUpdateCount = 0;
+    };
+
+}
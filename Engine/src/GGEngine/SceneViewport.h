@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Core.h"
+
+namespace GGEngine {
+
+    struct SceneViewportSpecification
+    {
+        float ClearColor[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
+        // The requested size must hold this long before the target is rebuilt, so dragging
+        // a panel edge does not reallocate every frame. The old target is stretched meanwhile.
+        double ResizeDelaySeconds = 0.15;
+    };
+
+    // Offscreen color and depth target the renderer draws the scene into, sized to an ImGui
+    // panel rather than the window. ImGui samples the color image through its own
+    // descriptor set, so showing it costs no copy. The scene is only rendered on frames
+    // where the viewport was displayed. Main thread only.
+    class GG_API SceneViewport
+    {
+    public:
+        virtual ~SceneViewport() = default;
+
+        // Inside an ImGui window: follows the window's content region and draws the scene
+        // image into it. Panels that are closed, collapsed or behind another dock tab skip
+        // the call, and their scene is not rendered.
+        virtual void Draw() = 0;
+
+        // Requested size in pixels; the target follows once the size has settled
+        virtual void Resize(uint32_t width, uint32_t height) = 0;
+        // Size of the current target, zero until the first Resize
+        virtual uint32_t GetWidth() const = 0;
+        virtual uint32_t GetHeight() const = 0;
+
+        // ImTextureID of the color target for this frame, 0 while there is none. Calling it
+        // marks the viewport as displayed, so its scene is rendered this frame. The ID
+        // changes when the target is rebuilt.
+        virtual uint64_t GetImGuiTextureID() = 0;
+
+        static std::shared_ptr<SceneViewport> Create(const SceneViewportSpecification& specification = SceneViewportSpecification());
+    };
+
+}
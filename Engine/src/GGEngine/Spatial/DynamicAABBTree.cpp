@@ -0,0 +1,497 @@
+#include "DynamicAABBTree.h"
+
+#include "QueryBatch.h"
+
+#include "GGEngine/Log.h"
+
+namespace GGEngine {
+
+    namespace {
+
+        // Fat bounds stretch this many displacements ahead of a moving proxy
+        const float s_DisplacementMultiplier = 2.0f;
+        // A move is refitted in place when an ancestor at most this many levels up still
+        // contains the new fat bounds; anything farther is reinserted
+        const uint32_t s_MaxRefitLevels = 3;
+
+        // Depth-first traversal stack: inline storage, spilling to the heap for deep trees
+        class NodeStack
+        {
+        public:
+            bool IsEmpty() const { return m_Count == 0; }
+
+            void Push(uint32_t node)
+            {
+                if (m_Count < s_InlineCapacity)
+                    m_Inline[m_Count] = node;
+                else
+                    m_Spill.push_back(node);
+                m_Count++;
+            }
+
+            uint32_t Pop()
+            {
+                m_Count--;
+                if (m_Count < s_InlineCapacity)
+                    return m_Inline[m_Count];
+                const uint32_t node = m_Spill.back();
+                m_Spill.pop_back();
+                return node;
+            }
+
+        private:
+            static constexpr uint32_t s_InlineCapacity = 64;
+            uint32_t m_Inline[s_InlineCapacity];
+            std::vector<uint32_t> m_Spill;
+            uint32_t m_Count = 0;
+        };
+
+    }
+
+    DynamicAABBTree::DynamicAABBTree(float margin)
+        : m_Margin(margin)
+    {
+    }
+
+    uint32_t DynamicAABBTree::AllocateNode()
+    {
+        uint32_t node;
+        if (m_FreeList != s_NullNode)
+        {
+            node = m_FreeList;
+            m_FreeList = m_Nodes[node].Parent;
+            m_Nodes[node] = Node();
+        }
+        else
+        {
+            node = (uint32_t)m_Nodes.size();
+            m_Nodes.emplace_back();
+            m_LeafBounds.emplace_back();
+            m_UserData.push_back(0);
+        }
+        return node;
+    }
+
+    void DynamicAABBTree::FreeNode(uint32_t node)
+    {
+        m_Nodes[node].Parent = m_FreeList;
+        m_Nodes[node].Height = -1;
+        m_FreeList = node;
+    }
+
+    SpatialID DynamicAABBTree::CreateProxy(const AABB& bounds, uint32_t userData)
+    {
+        const uint32_t proxy = AllocateNode();
+        m_Nodes[proxy].Box = bounds.Expanded(m_Margin);
+        m_LeafBounds[proxy] = bounds;
+        m_UserData[proxy] = userData;
+        InsertLeaf(proxy);
+        m_ProxyCount++;
+        return proxy;
+    }
+
+    void DynamicAABBTree::DestroyProxy(SpatialID proxy)
+    {
+        GG_CORE_ASSERT(proxy < m_Nodes.size() && m_Nodes[proxy].IsLeaf() && m_Nodes[proxy].Height == 0, "Invalid proxy");
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        m_ProxyCount--;
+    }
+
+    bool DynamicAABBTree::MoveProxy(SpatialID proxy, const AABB& bounds, const Vec3& displacement)
+    {
+        GG_CORE_ASSERT(proxy < m_Nodes.size() && m_Nodes[proxy].IsLeaf() && m_Nodes[proxy].Height == 0, "Invalid proxy");
+        m_LeafBounds[proxy] = bounds;
+        if (m_Nodes[proxy].Box.Contains(bounds))
+            return false;
+
+        AABB fat = bounds.Expanded(m_Margin);
+        const Vec3 stretch = displacement * s_DisplacementMultiplier;
+        (stretch.x < 0.0f ? fat.Min.x : fat.Max.x) += stretch.x;
+        (stretch.y < 0.0f ? fat.Min.y : fat.Max.y) += stretch.y;
+        (stretch.z < 0.0f ? fat.Min.z : fat.Max.z) += stretch.z;
+
+        // Refit when the proxy stays within a small subtree: the nodes below that ancestor
+        // take the new bounds and nothing above it changes
+        uint32_t ancestor = m_Nodes[proxy].Parent;
+        bool refit = ancestor == s_NullNode;
+        for (uint32_t level = 0; ancestor != s_NullNode && level < s_MaxRefitLevels; level++)
+        {
+            if (m_Nodes[ancestor].Box.Contains(fat))
+            {
+                refit = true;
+                break;
+            }
+            ancestor = m_Nodes[ancestor].Parent;
+        }
+
+        if (refit)
+        {
+            m_Nodes[proxy].Box = fat;
+            for (uint32_t node = m_Nodes[proxy].Parent; node != ancestor; node = m_Nodes[node].Parent)
+                m_Nodes[node].Box = AABB::Merge(m_Nodes[m_Nodes[node].Child1].Box, m_Nodes[m_Nodes[node].Child2].Box);
+        }
+        else
+        {
+            RemoveLeaf(proxy);
+            m_Nodes[proxy].Box = fat;
+            InsertLeaf(proxy);
+        }
+        return true;
+    }
+
+    void DynamicAABBTree::InsertLeaf(uint32_t leaf)
+    {
+        if (m_Root == s_NullNode)
+        {
+            m_Root = leaf;
+            m_Nodes[leaf].Parent = s_NullNode;
+            return;
+        }
+
+        // Descend towards the sibling that adds the least surface area: pairing with a
+        // node costs its merged area, and every ancestor pays for the growth it causes
+        const AABB leafBox = m_Nodes[leaf].Box;
+        uint32_t index = m_Root;
+        while (!m_Nodes[index].IsLeaf())
+        {
+            const Node& node = m_Nodes[index];
+            const float area = node.Box.GetSurfaceArea();
+            const float combinedArea = AABB::Merge(node.Box, leafBox).GetSurfaceArea();
+            const float cost = 2.0f * combinedArea;
+            const float inheritanceCost = 2.0f * (combinedArea - area);
+
+            auto descendCost = [&](uint32_t child)
+            {
+                const Node& c = m_Nodes[child];
+                const float merged = AABB::Merge(leafBox, c.Box).GetSurfaceArea();
+                return (c.IsLeaf() ? merged : merged - c.Box.GetSurfaceArea()) + inheritanceCost;
+            };
+            const float cost1 = descendCost(node.Child1);
+            const float cost2 = descendCost(node.Child2);
+
+            if (cost < cost1 && cost < cost2)
+                break;
+            index = cost1 < cost2 ? node.Child1 : node.Child2;
+        }
+
+        const uint32_t sibling = index;
+        const uint32_t oldParent = m_Nodes[sibling].Parent;
+        const uint32_t newParent = AllocateNode();
+        Node& parent = m_Nodes[newParent];
+        parent.Parent = oldParent;
+        parent.Box = AABB::Merge(leafBox, m_Nodes[sibling].Box);
+        parent.Height = m_Nodes[sibling].Height + 1;
+        parent.Child1 = sibling;
+        parent.Child2 = leaf;
+        m_Nodes[sibling].Parent = newParent;
+        m_Nodes[leaf].Parent = newParent;
+
+        if (oldParent == s_NullNode)
+            m_Root = newParent;
+        else if (m_Nodes[oldParent].Child1 == sibling)
+            m_Nodes[oldParent].Child1 = newParent;
+        else
+            m_Nodes[oldParent].Child2 = newParent;
+
+        FixUpwards(oldParent);
+    }
+
+    void DynamicAABBTree::RemoveLeaf(uint32_t leaf)
+    {
+        if (leaf == m_Root)
+        {
+            m_Root = s_NullNode;
+            return;
+        }
+
+        const uint32_t parent = m_Nodes[leaf].Parent;
+        const uint32_t grandParent = m_Nodes[parent].Parent;
+        const uint32_t sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+        // The sibling takes the parent's place
+        m_Nodes[sibling].Parent = grandParent;
+        if (grandParent == s_NullNode)
+            m_Root = sibling;
+        else if (m_Nodes[grandParent].Child1 == parent)
+            m_Nodes[grandParent].Child1 = sibling;
+        else
+            m_Nodes[grandParent].Child2 = sibling;
+        FreeNode(parent);
+
+        FixUpwards(grandParent);
+    }
+
+    void DynamicAABBTree::FixUpwards(uint32_t node)
+    {
+        while (node != s_NullNode)
+        {
+            node = Balance(node);
+            Node& n = m_Nodes[node];
+            const Node& child1 = m_Nodes[n.Child1];
+            const Node& child2 = m_Nodes[n.Child2];
+            n.Height = 1 + std::max(child1.Height, child2.Height);
+            n.Box = AABB::Merge(child1.Box, child2.Box);
+            node = n.Parent;
+        }
+    }
+
+    uint32_t DynamicAABBTree::Balance(uint32_t iA)
+    {
+        // Rotates the taller child of A up when the children's heights differ by more
+        // than one; A takes the shorter of that child's children. Returns the node now in
+        // A's place.
+        Node& A = m_Nodes[iA];
+        if (A.IsLeaf() || A.Height < 2)
+            return iA;
+
+        const uint32_t iB = A.Child1;
+        const uint32_t iC = A.Child2;
+        Node& B = m_Nodes[iB];
+        Node& C = m_Nodes[iC];
+        const int32_t balance = C.Height - B.Height;
+
+        auto replaceInParent = [this, iA](uint32_t replacement)
+        {
+            const uint32_t parent = m_Nodes[replacement].Parent;
+            if (parent == s_NullNode)
+                m_Root = replacement;
+            else if (m_Nodes[parent].Child1 == iA)
+                m_Nodes[parent].Child1 = replacement;
+            else
+                m_Nodes[parent].Child2 = replacement;
+        };
+
+        if (balance > 1)
+        {
+            const uint32_t iF = C.Child1;
+            const uint32_t iG = C.Child2;
+            Node& F = m_Nodes[iF];
+            Node& G = m_Nodes[iG];
+
+            C.Child1 = iA;
+            C.Parent = A.Parent;
+            A.Parent = iC;
+            replaceInParent(iC);
+
+            if (F.Height > G.Height)
+            {
+                C.Child2 = iF;
+                A.Child2 = iG;
+                G.Parent = iA;
+                A.Box = AABB::Merge(B.Box, G.Box);
+                C.Box = AABB::Merge(A.Box, F.Box);
+                A.Height = 1 + std::max(B.Height, G.Height);
+                C.Height = 1 + std::max(A.Height, F.Height);
+            }
+            else
+            {
+                C.Child2 = iG;
+                A.Child2 = iF;
+                F.Parent = iA;
+                A.Box = AABB::Merge(B.Box, F.Box);
+                C.Box = AABB::Merge(A.Box, G.Box);
+                A.Height = 1 + std::max(B.Height, F.Height);
+                C.Height = 1 + std::max(A.Height, G.Height);
+            }
+            return iC;
+        }
+
+        if (balance < -1)
+        {
+            const uint32_t iD = B.Child1;
+            const uint32_t iE = B.Child2;
+            Node& D = m_Nodes[iD];
+            Node& E = m_Nodes[iE];
+
+            B.Child1 = iA;
+            B.Parent = A.Parent;
+            A.Parent = iB;
+            replaceInParent(iB);
+
+            if (D.Height > E.Height)
+            {
+                B.Child2 = iD;
+                A.Child1 = iE;
+                E.Parent = iA;
+                A.Box = AABB::Merge(C.Box, E.Box);
+                B.Box = AABB::Merge(A.Box, D.Box);
+                A.Height = 1 + std::max(C.Height, E.Height);
+                B.Height = 1 + std::max(A.Height, D.Height);
+            }
+            else
+            {
+                B.Child2 = iE;
+                A.Child1 = iD;
+                D.Parent = iA;
+                A.Box = AABB::Merge(C.Box, D.Box);
+                B.Box = AABB::Merge(A.Box, E.Box);
+                A.Height = 1 + std::max(C.Height, D.Height);
+                B.Height = 1 + std::max(A.Height, E.Height);
+            }
+            return iB;
+        }
+
+        return iA;
+    }
+
+    uint32_t DynamicAABBTree::GetHeight() const
+    {
+        return m_Root == s_NullNode ? 0 : (uint32_t)m_Nodes[m_Root].Height;
+    }
+
+    float DynamicAABBTree::GetAreaRatio() const
+    {
+        if (m_Root == s_NullNode)
+            return 0.0f;
+
+        float totalArea = 0.0f;
+        for (const Node& node : m_Nodes)
+        {
+            if (node.Height > 0)
+                totalArea += node.Box.GetSurfaceArea();
+        }
+        return totalArea / m_Nodes[m_Root].Box.GetSurfaceArea();
+    }
+
+    void DynamicAABBTree::CollectLeaves(uint32_t node, std::vector<SpatialID>& hits) const
+    {
+        NodeStack stack;
+        stack.Push(node);
+        while (!stack.IsEmpty())
+        {
+            const Node& n = m_Nodes[stack.Pop()];
+            if (n.IsLeaf())
+            {
+                hits.push_back((SpatialID)(&n - m_Nodes.data()));
+                continue;
+            }
+            stack.Push(n.Child1);
+            stack.Push(n.Child2);
+        }
+    }
+
+    void DynamicAABBTree::QueryOverlaps(const AABB& box, std::vector<SpatialID>& hits) const
+    {
+        if (m_Root == s_NullNode)
+            return;
+
+        NodeStack stack;
+        stack.Push(m_Root);
+        while (!stack.IsEmpty())
+        {
+            const uint32_t index = stack.Pop();
+            const Node& node = m_Nodes[index];
+            if (!node.Box.Overlaps(box))
+                continue;
+
+            if (node.IsLeaf())
+            {
+                if (m_LeafBounds[index].Overlaps(box))
+                    hits.push_back(index);
+                continue;
+            }
+            stack.Push(node.Child1);
+            stack.Push(node.Child2);
+        }
+    }
+
+    void DynamicAABBTree::QueryFrustum(const Frustum& frustum, std::vector<SpatialID>& hits) const
+    {
+        if (m_Root == s_NullNode)
+            return;
+
+        NodeStack stack;
+        stack.Push(m_Root);
+        while (!stack.IsEmpty())
+        {
+            const uint32_t index = stack.Pop();
+            const Node& node = m_Nodes[index];
+            const Containment containment = frustum.Test(node.Box);
+            if (containment == Containment::Outside)
+                continue;
+
+            if (node.IsLeaf())
+            {
+                if (containment == Containment::Inside || frustum.Overlaps(m_LeafBounds[index]))
+                    hits.push_back(index);
+                continue;
+            }
+
+            // Everything below a node that is fully inside is visible
+            if (containment == Containment::Inside)
+            {
+                CollectLeaves(index, hits);
+                continue;
+            }
+            stack.Push(node.Child1);
+            stack.Push(node.Child2);
+        }
+    }
+
+    RayHit DynamicAABBTree::Raycast(const Ray& ray) const
+    {
+        RayHit closest;
+        closest.Distance = ray.MaxDistance;
+        if (m_Root == s_NullNode)
+            return closest;
+
+        const Vec3 inverseDirection = InverseDirection(ray.Direction);
+        NodeStack stack;
+        stack.Push(m_Root);
+        while (!stack.IsEmpty())
+        {
+            const uint32_t index = stack.Pop();
+            const Node& node = m_Nodes[index];
+            float distance;
+            if (!IntersectRayAABB(ray.Origin, inverseDirection, node.Box, closest.Distance, distance))
+                continue;
+
+            if (node.IsLeaf())
+            {
+                if (IntersectRayAABB(ray.Origin, inverseDirection, m_LeafBounds[index], closest.Distance, distance))
+                {
+                    closest.ID = index;
+                    closest.Distance = distance;
+                }
+                continue;
+            }
+
+            // Visit the nearer child first so its hits prune the farther one
+            float distance1, distance2;
+            const bool hit1 = IntersectRayAABB(ray.Origin, inverseDirection, m_Nodes[node.Child1].Box, closest.Distance, distance1);
+            const bool hit2 = IntersectRayAABB(ray.Origin, inverseDirection, m_Nodes[node.Child2].Box, closest.Distance, distance2);
+            if (hit1 && hit2)
+            {
+                stack.Push(distance1 < distance2 ? node.Child2 : node.Child1);
+                stack.Push(distance1 < distance2 ? node.Child1 : node.Child2);
+            }
+            else if (hit1)
+            {
+                stack.Push(node.Child1);
+            }
+            else if (hit2)
+            {
+                stack.Push(node.Child2);
+            }
+        }
+
+        return closest;
+    }
+
+    void DynamicAABBTree::QueryOverlaps(const AABB* boxes, uint32_t count, QueryResults& results) const
+    {
+        SpatialBatch::Collect(count, results, [&](uint32_t i, std::vector<SpatialID>& hits) { QueryOverlaps(boxes[i], hits); });
+    }
+
+    void DynamicAABBTree::QueryFrustums(const Frustum* frustums, uint32_t count, QueryResults& results) const
+    {
+        SpatialBatch::Collect(count, results, [&](uint32_t i, std::vector<SpatialID>& hits) { QueryFrustum(frustums[i], hits); });
+    }
+
+    void DynamicAABBTree::Raycast(const Ray* rays, uint32_t count, RayHit* hits) const
+    {
+        SpatialBatch::Run(count, [&](uint32_t i) { hits[i] = Raycast(rays[i]); });
+    }
+
+}
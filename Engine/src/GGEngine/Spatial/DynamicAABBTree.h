@@ -0,0 +1,81 @@
+#pragma once
+
+#include "GGEngine/Core.h"
+#include "SpatialQuery.h"
+
+namespace GGEngine {
+
+    // Bounding volume hierarchy for objects of any size that move and change independently.
+    // Leaves hold fattened bounds, so small moves don't touch the tree at all; larger ones
+    // refit the few nodes above the leaf, and only moves that leave the local subtree
+    // reinsert it. Insertion picks the sibling by surface area and rotations keep the tree
+    // balanced.
+    //
+    // Proxy ids are stable until destroyed. Queries test the exact bounds at the leaves and
+    // are const, so batches run in parallel on the job system.
+    class GG_API DynamicAABBTree
+    {
+    public:
+        // margin fattens every leaf on all sides
+        explicit DynamicAABBTree(float margin = 0.1f);
+
+        SpatialID CreateProxy(const AABB& bounds, uint32_t userData = 0);
+        void DestroyProxy(SpatialID proxy);
+
+        // displacement is the expected motion until the next move; the fat bounds stretch
+        // that way. Returns true when the tree changed.
+        bool MoveProxy(SpatialID proxy, const AABB& bounds, const Vec3& displacement = Vec3());
+
+        const AABB& GetBounds(SpatialID proxy) const { return m_LeafBounds[proxy]; }
+        const AABB& GetFatBounds(SpatialID proxy) const { return m_Nodes[proxy].Box; }
+        uint32_t GetUserData(SpatialID proxy) const { return m_UserData[proxy]; }
+
+        void QueryOverlaps(const AABB& box, std::vector<SpatialID>& hits) const;
+        void QueryFrustum(const Frustum& frustum, std::vector<SpatialID>& hits) const;
+        RayHit Raycast(const Ray& ray) const; // Closest hit
+
+        // Batches, spread across the job system
+        void QueryOverlaps(const AABB* boxes, uint32_t count, QueryResults& results) const;
+        void QueryFrustums(const Frustum* frustums, uint32_t count, QueryResults& results) const;
+        void Raycast(const Ray* rays, uint32_t count, RayHit* hits) const;
+
+        uint32_t GetProxyCount() const { return m_ProxyCount; }
+        uint32_t GetHeight() const;
+        // Summed surface area of the internal nodes over the root's; lower is a better tree
+        float GetAreaRatio() const;
+
+    private:
+        static constexpr uint32_t s_NullNode = UINT32_MAX;
+
+        struct Node
+        {
+            AABB Box;                      // Fattened for leaves
+            uint32_t Parent = s_NullNode;  // Next free node while on the free list
+            uint32_t Child1 = s_NullNode;  // s_NullNode for leaves
+            uint32_t Child2 = s_NullNode;
+            int32_t Height = 0;            // Leaves are 0, free nodes -1
+
+            bool IsLeaf() const { return Child1 == s_NullNode; }
+        };
+
+        uint32_t AllocateNode();
+        void FreeNode(uint32_t node);
+        void InsertLeaf(uint32_t leaf);
+        void RemoveLeaf(uint32_t leaf);
+        uint32_t Balance(uint32_t node);
+        // Recomputes boxes and heights from node up to the root, rebalancing on the way
+        void FixUpwards(uint32_t node);
+        void CollectLeaves(uint32_t node, std::vector<SpatialID>& hits) const;
+
+        std::vector<Node> m_Nodes;
+        uint32_t m_Root = s_NullNode;
+        uint32_t m_FreeList = s_NullNode;
+        uint32_t m_ProxyCount = 0;
+        float m_Margin;
+
+        // Per node, meaningful for leaves
+        std::vector<AABB> m_LeafBounds;
+        std::vector<uint32_t> m_UserData;
+    };
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "SpatialQuery.h"
+
+#include "GGEngine/JobSystem.h"
+
+#include <algorithm>
+
+// Parallel execution of query batches for the spatial structures. Queries are split into
+// groups of consecutive queries, one job each; queries only read the structure, so jobs
+// share nothing.
+
+namespace GGEngine {
+
+    namespace SpatialBatch {
+
+        constexpr uint32_t QueriesPerJob = 32;
+
+        // query(i) for every query in the batch
+        template<typename QueryFn>
+        void Run(uint32_t queryCount, const QueryFn& query)
+        {
+            if (queryCount <= QueriesPerJob)
+            {
+                for (uint32_t i = 0; i < queryCount; i++)
+                    query(i);
+                return;
+            }
+
+            JobCounter counter{ 0 };
+            JobSystem::Dispatch(counter, queryCount, QueriesPerJob, [&query](JobDispatchArgs args) { query(args.JobIndex); });
+            JobSystem::Wait(counter);
+        }
+
+        // query(i, hits) appends the ids query i found. Each job group collects into its own
+        // buffer; groups cover consecutive queries, so concatenating them keeps query order.
+        template<typename QueryFn>
+        void Collect(uint32_t queryCount, QueryResults& results, const QueryFn& query)
+        {
+            results.Offsets.assign(queryCount + 1, 0);
+            results.IDs.clear();
+
+            auto runQuery = [&](uint32_t i, std::vector<SpatialID>& hits)
+            {
+                const size_t before = hits.size();
+                query(i, hits);
+                results.Offsets[i + 1] = (uint32_t)(hits.size() - before);
+            };
+
+            if (queryCount <= QueriesPerJob)
+            {
+                for (uint32_t i = 0; i < queryCount; i++)
+                    runQuery(i, results.IDs);
+            }
+            else
+            {
+                std::vector<std::vector<SpatialID>> groupHits((queryCount + QueriesPerJob - 1) / QueriesPerJob);
+                JobCounter counter{ 0 };
+                JobSystem::Dispatch(counter, queryCount, QueriesPerJob,
+                    [&](JobDispatchArgs args) { runQuery(args.JobIndex, groupHits[args.GroupIndex]); });
+                JobSystem::Wait(counter);
+
+                size_t total = 0;
+                for (const std::vector<SpatialID>& hits : groupHits)
+                    total += hits.size();
+                results.IDs.reserve(total);
+                for (const std::vector<SpatialID>& hits : groupHits)
+                    results.IDs.insert(results.IDs.end(), hits.begin(), hits.end());
+            }
+
+            for (uint32_t i = 0; i < queryCount; i++)
+                results.Offsets[i + 1] += results.Offsets[i];
+        }
+
+    }
+
+}
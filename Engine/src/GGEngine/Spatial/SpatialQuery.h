@@ -0,0 +1,31 @@
+#pragma once
+
+#include "GGEngine/Math/Geometry.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace GGEngine {
+
+    using SpatialID = uint32_t;
+    constexpr SpatialID NullSpatialID = UINT32_MAX;
+
+    struct RayHit
+    {
+        SpatialID ID = NullSpatialID; // NullSpatialID when nothing was hit
+        float Distance = 0.0f;
+    };
+
+    // Hits of a batch of queries, in query order: query i found
+    // IDs[Offsets[i]] up to IDs[Offsets[i + 1]]
+    struct QueryResults
+    {
+        std::vector<uint32_t> Offsets;
+        std::vector<SpatialID> IDs;
+
+        uint32_t GetQueryCount() const { return Offsets.empty() ? 0 : (uint32_t)Offsets.size() - 1; }
+        uint32_t GetHitCount(uint32_t query) const { return Offsets[query + 1] - Offsets[query]; }
+        const SpatialID* GetHits(uint32_t query) const { return IDs.data() + Offsets[query]; }
+    };
+
+}
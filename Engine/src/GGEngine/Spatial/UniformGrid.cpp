@@ -0,0 +1,507 @@
+#include "UniformGrid.h"
+
+#include "QueryBatch.h"
+
+#include "GGEngine/Log.h"
+
+namespace GGEngine {
+
+    namespace {
+
+        // Cells are packed 21 bits per axis, offset so +-1M cells per axis fit
+        const int32_t s_CellBias = 1 << 20;
+
+        uint64_t PackCell(int32_t x, int32_t y, int32_t z)
+        {
+            const uint64_t mask = (1u << 21) - 1;
+            return ((uint64_t)(x + s_CellBias) & mask)
+                | (((uint64_t)(y + s_CellBias) & mask) << 21)
+                | (((uint64_t)(z + s_CellBias) & mask) << 42);
+        }
+
+        // Frustum queries split cell ranges down to this many cells before testing each cell
+        const int32_t s_LeafCells = 64;
+
+        // How far MakeRoom looks for a bucket with a free slot
+        const uint32_t s_MaxShift = 64;
+
+        // Past this many cells per object, frustum queries test every object instead
+        const uint64_t s_SparseCellsPerEntry = 64;
+
+        // Cell boxes grow by this fraction of a cell, so float rounding in CellOf can't
+        // cull an object that sits exactly on a cell boundary
+        const float s_CellSlack = 1.0e-3f;
+
+    }
+
+    UniformGrid::UniformGrid(float cellSize)
+        : m_CellSize(cellSize), m_InverseCellSize(1.0f / cellSize)
+    {
+        GG_CORE_ASSERT(cellSize > 0.0f, "Grid cells need a positive size");
+    }
+
+    UniformGrid::Cell UniformGrid::CellOf(const Vec3& point) const
+    {
+        // Clamped before the conversion, which is undefined for out-of-range floats
+        auto axis = [this](float value)
+        {
+            const float cell = std::floor(value * m_InverseCellSize);
+            return (int32_t)Clamp(cell, (float)(1 - s_CellBias), (float)(s_CellBias - 1));
+        };
+        return { axis(point.x), axis(point.y), axis(point.z) };
+    }
+
+    uint32_t UniformGrid::BucketOf(uint64_t key) const
+    {
+        return (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> m_BucketShift);
+    }
+
+    template<typename Fn>
+    void UniformGrid::ForEachInCell(const Cell& cell, const Fn& fn) const
+    {
+        const uint64_t key = PackCell(cell.x, cell.y, cell.z);
+        const uint32_t bucket = BucketOf(key);
+        const uint32_t start = m_BucketStarts[bucket];
+        const uint32_t end = start + m_BucketSizes[bucket];
+        for (uint32_t entry = start; entry < end; entry++)
+        {
+            if (m_EntryCells[entry] == key)
+                fn(entry);
+        }
+    }
+
+    SpatialID UniformGrid::Insert(const AABB& bounds, uint32_t userData)
+    {
+        SpatialID id;
+        if (!m_FreeIDs.empty())
+        {
+            id = m_FreeIDs.back();
+            m_FreeIDs.pop_back();
+        }
+        else
+        {
+            id = (SpatialID)m_Bounds.size();
+            m_Bounds.emplace_back();
+            m_UserData.push_back(0);
+            m_Alive.push_back(0);
+            m_EntryOf.push_back(s_NoEntry);
+            m_IsPending.push_back(0);
+        }
+
+        m_Bounds[id] = bounds;
+        m_UserData[id] = userData;
+        m_Alive[id] = 1;
+        m_Count++;
+        MarkPending(id);
+        return id;
+    }
+
+    void UniformGrid::Remove(SpatialID id)
+    {
+        if (!IsValid(id))
+            return;
+
+        m_Alive[id] = 0;
+        m_FreeIDs.push_back(id);
+        m_Count--;
+        MarkPending(id);
+    }
+
+    void UniformGrid::Move(SpatialID id, const AABB& bounds)
+    {
+        GG_CORE_ASSERT(IsValid(id), "Invalid grid object");
+        m_Bounds[id] = bounds;
+        MarkPending(id);
+    }
+
+    void UniformGrid::MarkPending(SpatialID id)
+    {
+        if (m_IsPending[id])
+            return;
+        m_IsPending[id] = 1;
+        m_Pending.push_back(id);
+    }
+
+    void UniformGrid::Update()
+    {
+        if (m_Pending.empty())
+            return;
+
+        // Patching beats re-sorting unless the buckets got too crowded or most objects changed
+        bool rebuild = m_BucketSizes.size() < m_Count || m_Pending.size() > m_Count / 2;
+        for (SpatialID id : m_Pending)
+        {
+            m_IsPending[id] = 0;
+            if (rebuild)
+                continue;
+
+            const Cell lo = CellOf(m_Bounds[id].Min);
+            const uint64_t key = PackCell(lo.x, lo.y, lo.z);
+            const uint32_t entry = m_EntryOf[id];
+            if (entry != s_NoEntry)
+            {
+                if (m_Alive[id] && m_EntryCells[entry] == key)
+                {
+                    // Same cell: only the bounds change
+                    m_EntryBounds[entry] = m_Bounds[id];
+                    Include(lo, CellOf(m_Bounds[id].Max));
+                    continue;
+                }
+                RemoveEntry(entry);
+            }
+            if (m_Alive[id])
+                rebuild = !PlaceEntry(id, key);
+        }
+        m_Pending.clear();
+
+        if (rebuild)
+            Rebuild();
+    }
+
+    void UniformGrid::Rebuild()
+    {
+        // At least as many buckets as objects, a power of two so the hash is a shift
+        uint32_t bucketBits = 1;
+        while ((1u << bucketBits) < m_Count && bucketBits < 31)
+            bucketBits++;
+        const uint32_t bucketCount = 1u << bucketBits;
+        m_BucketShift = 64 - bucketBits;
+        m_BucketStarts.assign(bucketCount + 1, 0);
+        m_BucketSizes.assign(bucketCount, 0);
+
+        // Count per bucket, remembering each object's cell for the scatter below
+        const uint32_t idCount = (uint32_t)m_Bounds.size();
+        std::vector<uint64_t> keys(idCount);
+        m_Reach = 0;
+        m_MinCell = { INT32_MAX, INT32_MAX, INT32_MAX };
+        m_MaxCell = { INT32_MIN, INT32_MIN, INT32_MIN };
+        for (SpatialID id = 0; id < idCount; id++)
+        {
+            m_EntryOf[id] = s_NoEntry;
+            if (!m_Alive[id])
+                continue;
+
+            const Cell lo = CellOf(m_Bounds[id].Min);
+            Include(lo, CellOf(m_Bounds[id].Max));
+            keys[id] = PackCell(lo.x, lo.y, lo.z);
+            m_BucketSizes[BucketOf(keys[id])]++;
+        }
+
+        // Every bucket gets one spare slot, so most objects crossing into it fit in place
+        for (uint32_t bucket = 0; bucket < bucketCount; bucket++)
+            m_BucketStarts[bucket + 1] = m_BucketStarts[bucket] + m_BucketSizes[bucket] + 1;
+
+        const uint32_t entryCount = m_BucketStarts[bucketCount];
+        m_EntryCells.assign(entryCount, UINT64_MAX);
+        m_EntryBounds.resize(entryCount);
+        m_EntryIDs.assign(entryCount, NullSpatialID);
+        std::fill(m_BucketSizes.begin(), m_BucketSizes.end(), 0);
+        for (SpatialID id = 0; id < idCount; id++)
+        {
+            if (!m_Alive[id])
+                continue;
+
+            const uint32_t bucket = BucketOf(keys[id]);
+            const uint32_t entry = m_BucketStarts[bucket] + m_BucketSizes[bucket]++;
+            m_EntryCells[entry] = keys[id];
+            m_EntryBounds[entry] = m_Bounds[id];
+            m_EntryIDs[entry] = id;
+            m_EntryOf[id] = entry;
+        }
+    }
+
+    bool UniformGrid::PlaceEntry(SpatialID id, uint64_t key)
+    {
+        const uint32_t bucket = BucketOf(key);
+        if (m_BucketStarts[bucket] + m_BucketSizes[bucket] == m_BucketStarts[bucket + 1] && !MakeRoom(bucket))
+            return false;
+
+        const uint32_t entry = m_BucketStarts[bucket] + m_BucketSizes[bucket]++;
+        m_EntryCells[entry] = key;
+        m_EntryBounds[entry] = m_Bounds[id];
+        m_EntryIDs[entry] = id;
+        m_EntryOf[id] = entry;
+        Include(CellOf(m_Bounds[id].Min), CellOf(m_Bounds[id].Max));
+        return true;
+    }
+
+    void UniformGrid::RemoveEntry(uint32_t entry)
+    {
+        // The bucket's last entry fills the hole, keeping its entries contiguous
+        const uint32_t bucket = BucketOf(m_EntryCells[entry]);
+        const uint32_t last = m_BucketStarts[bucket] + --m_BucketSizes[bucket];
+        m_EntryOf[m_EntryIDs[entry]] = s_NoEntry;
+        if (entry != last)
+        {
+            MoveEntry(last, entry);
+            return;
+        }
+        m_EntryCells[last] = UINT64_MAX;
+        m_EntryIDs[last] = NullSpatialID;
+    }
+
+    void UniformGrid::MoveEntry(uint32_t from, uint32_t to)
+    {
+        m_EntryCells[to] = m_EntryCells[from];
+        m_EntryBounds[to] = m_EntryBounds[from];
+        m_EntryIDs[to] = m_EntryIDs[from];
+        m_EntryOf[m_EntryIDs[to]] = to;
+        m_EntryCells[from] = UINT64_MAX;
+        m_EntryIDs[from] = NullSpatialID;
+    }
+
+    bool UniformGrid::MakeRoom(uint32_t bucket)
+    {
+        const uint32_t bucketCount = (uint32_t)m_BucketSizes.size();
+        auto hasRoom = [this](uint32_t b) { return m_BucketStarts[b] + m_BucketSizes[b] < m_BucketStarts[b + 1]; };
+        for (uint32_t distance = 1; distance <= s_MaxShift; distance++)
+        {
+            if (bucket + distance < bucketCount && hasRoom(bucket + distance))
+            {
+                // Each bucket above moves its first entry to its free end and starts one later,
+                // passing the freed slot down
+                for (uint32_t b = bucket + distance; b > bucket; b--)
+                {
+                    if (m_BucketSizes[b] > 0)
+                        MoveEntry(m_BucketStarts[b], m_BucketStarts[b] + m_BucketSizes[b]);
+                    m_BucketStarts[b]++;
+                }
+                return true;
+            }
+            if (bucket >= distance && hasRoom(bucket - distance))
+            {
+                // Each bucket below starts one earlier and moves its last entry there, passing
+                // the freed slot up
+                for (uint32_t b = bucket - distance + 1; b <= bucket; b++)
+                {
+                    m_BucketStarts[b]--;
+                    if (m_BucketSizes[b] > 0)
+                        MoveEntry(m_BucketStarts[b] + m_BucketSizes[b], m_BucketStarts[b]);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void UniformGrid::Include(const Cell& lo, const Cell& hi)
+    {
+        m_Reach = std::max({ m_Reach, hi.x - lo.x, hi.y - lo.y, hi.z - lo.z });
+        m_MinCell = { std::min(m_MinCell.x, lo.x), std::min(m_MinCell.y, lo.y), std::min(m_MinCell.z, lo.z) };
+        m_MaxCell = { std::max(m_MaxCell.x, lo.x), std::max(m_MaxCell.y, lo.y), std::max(m_MaxCell.z, lo.z) };
+    }
+
+    void UniformGrid::ScanAll(const AABB& box, std::vector<SpatialID>& hits) const
+    {
+        for (size_t entry = 0; entry < m_EntryIDs.size(); entry++)
+        {
+            if (m_EntryIDs[entry] != NullSpatialID && m_EntryBounds[entry].Overlaps(box))
+                hits.push_back(m_EntryIDs[entry]);
+        }
+    }
+
+    void UniformGrid::QueryOverlaps(const AABB& box, std::vector<SpatialID>& hits) const
+    {
+        if (m_Count == 0 || m_EntryIDs.empty())
+            return;
+
+        // An object overlapping the box has its min corner at most m_Reach cells before it
+        const Cell lo = CellOf(box.Min);
+        const Cell hi = CellOf(box.Max);
+        const Cell first = { std::max(lo.x - m_Reach, m_MinCell.x), std::max(lo.y - m_Reach, m_MinCell.y), std::max(lo.z - m_Reach, m_MinCell.z) };
+        const Cell last = { std::min(hi.x, m_MaxCell.x), std::min(hi.y, m_MaxCell.y), std::min(hi.z, m_MaxCell.z) };
+        if (first.x > last.x || first.y > last.y || first.z > last.z)
+            return;
+
+        // Past one cell per object, walking the flat arrays is cheaper than hashing cells
+        const uint64_t cellCount = (uint64_t)(last.x - first.x + 1) * (uint64_t)(last.y - first.y + 1) * (uint64_t)(last.z - first.z + 1);
+        if (cellCount > m_EntryIDs.size())
+        {
+            ScanAll(box, hits);
+            return;
+        }
+
+        for (int32_t z = first.z; z <= last.z; z++)
+        {
+            for (int32_t y = first.y; y <= last.y; y++)
+            {
+                for (int32_t x = first.x; x <= last.x; x++)
+                {
+                    ForEachInCell({ x, y, z }, [&](uint32_t entry)
+                    {
+                        if (m_EntryBounds[entry].Overlaps(box))
+                            hits.push_back(m_EntryIDs[entry]);
+                    });
+                }
+            }
+        }
+    }
+
+    void UniformGrid::QueryFrustum(const Frustum& frustum, std::vector<SpatialID>& hits) const
+    {
+        if (m_Count == 0 || m_EntryIDs.empty())
+            return;
+
+        const uint64_t cellCount = (uint64_t)(m_MaxCell.x - m_MinCell.x + 1) * (uint64_t)(m_MaxCell.y - m_MinCell.y + 1) * (uint64_t)(m_MaxCell.z - m_MinCell.z + 1);
+        if (cellCount > (uint64_t)m_EntryIDs.size() * s_SparseCellsPerEntry)
+        {
+            // Very sparse grid: testing every object beats visiting mostly empty cells
+            for (size_t entry = 0; entry < m_EntryIDs.size(); entry++)
+            {
+                if (m_EntryIDs[entry] != NullSpatialID && frustum.Overlaps(m_EntryBounds[entry]))
+                    hits.push_back(m_EntryIDs[entry]);
+            }
+            return;
+        }
+
+        CullCells(frustum, m_MinCell, m_MaxCell, hits);
+    }
+
+    void UniformGrid::CullCells(const Frustum& frustum, const Cell& first, const Cell& last, std::vector<SpatialID>& hits) const
+    {
+        // Objects whose min corner is in cells first..last lie within this box
+        const float slack = m_CellSize * s_CellSlack;
+        auto cellRangeBox = [&](const Cell& rangeFirst, const Cell& rangeLast)
+        {
+            return AABB(
+                Vec3((float)rangeFirst.x, (float)rangeFirst.y, (float)rangeFirst.z) * m_CellSize - Vec3(slack),
+                Vec3((float)(rangeLast.x + 1 + m_Reach), (float)(rangeLast.y + 1 + m_Reach), (float)(rangeLast.z + 1 + m_Reach)) * m_CellSize + Vec3(slack));
+        };
+
+        const Containment range = frustum.Test(cellRangeBox(first, last));
+        if (range == Containment::Outside)
+            return;
+
+        const int32_t size[3] = { last.x - first.x + 1, last.y - first.y + 1, last.z - first.z + 1 };
+        if (range == Containment::Intersecting && size[0] * size[1] * size[2] > s_LeafCells)
+        {
+            // Halve the longest axis
+            const int axis = size[0] >= size[1] ? (size[0] >= size[2] ? 0 : 2) : (size[1] >= size[2] ? 1 : 2);
+            Cell lowLast = last;
+            Cell highFirst = first;
+            int32_t* lowAxes[3] = { &lowLast.x, &lowLast.y, &lowLast.z };
+            int32_t* highAxes[3] = { &highFirst.x, &highFirst.y, &highFirst.z };
+            *highAxes[axis] += size[axis] / 2;
+            *lowAxes[axis] = *highAxes[axis] - 1;
+            CullCells(frustum, first, lowLast, hits);
+            CullCells(frustum, highFirst, last, hits);
+            return;
+        }
+
+        for (int32_t z = first.z; z <= last.z; z++)
+        {
+            for (int32_t y = first.y; y <= last.y; y++)
+            {
+                for (int32_t x = first.x; x <= last.x; x++)
+                {
+                    const Cell cell = { x, y, z };
+                    const Containment containment = range == Containment::Inside ? range : frustum.Test(cellRangeBox(cell, cell));
+                    if (containment == Containment::Outside)
+                        continue;
+
+                    ForEachInCell(cell, [&](uint32_t entry)
+                    {
+                        if (containment == Containment::Inside || frustum.Overlaps(m_EntryBounds[entry]))
+                            hits.push_back(m_EntryIDs[entry]);
+                    });
+                }
+            }
+        }
+    }
+
+    RayHit UniformGrid::Raycast(const Ray& ray) const
+    {
+        RayHit closest;
+        closest.Distance = ray.MaxDistance;
+        if (m_Count == 0 || m_EntryIDs.empty())
+            return closest;
+
+        // Cells any object covers
+        const Cell first = m_MinCell;
+        const Cell last = { m_MaxCell.x + m_Reach, m_MaxCell.y + m_Reach, m_MaxCell.z + m_Reach };
+        const AABB region(
+            Vec3((float)first.x, (float)first.y, (float)first.z) * m_CellSize,
+            Vec3((float)(last.x + 1), (float)(last.y + 1), (float)(last.z + 1)) * m_CellSize);
+
+        const Vec3 inverseDirection = InverseDirection(ray.Direction);
+        float enter;
+        if (!IntersectRayAABB(ray.Origin, inverseDirection, region, ray.MaxDistance, enter))
+            return closest;
+
+        // Walk the cells along the ray (Amanatides & Woo). Objects covering a cell have
+        // their min corner up to m_Reach cells before it, so each step checks that block.
+        const Vec3 start = ray.Origin + ray.Direction * enter;
+        Cell cell = CellOf(start);
+        cell = { std::clamp(cell.x, first.x, last.x), std::clamp(cell.y, first.y, last.y), std::clamp(cell.z, first.z, last.z) };
+
+        int32_t* cellAxes[3] = { &cell.x, &cell.y, &cell.z };
+        const float direction[3] = { ray.Direction.x, ray.Direction.y, ray.Direction.z };
+        const float origin[3] = { ray.Origin.x, ray.Origin.y, ray.Origin.z };
+        const float inverse[3] = { inverseDirection.x, inverseDirection.y, inverseDirection.z };
+        const int32_t lowest[3] = { first.x, first.y, first.z };
+        const int32_t highest[3] = { last.x, last.y, last.z };
+        int32_t step[3];
+        float next[3], delta[3];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            const int32_t c = *cellAxes[axis];
+            step[axis] = direction[axis] > 0.0f ? 1 : (direction[axis] < 0.0f ? -1 : 0);
+            if (step[axis] == 0)
+            {
+                next[axis] = FLT_MAX;
+                delta[axis] = FLT_MAX;
+                continue;
+            }
+            const float boundary = (float)(step[axis] > 0 ? c + 1 : c) * m_CellSize;
+            next[axis] = (boundary - origin[axis]) * inverse[axis];
+            delta[axis] = m_CellSize * std::fabs(inverse[axis]);
+        }
+
+        float cellEnter = enter;
+        while (cellEnter <= closest.Distance)
+        {
+            for (int32_t z = std::max(cell.z - m_Reach, m_MinCell.z); z <= std::min(cell.z, m_MaxCell.z); z++)
+            {
+                for (int32_t y = std::max(cell.y - m_Reach, m_MinCell.y); y <= std::min(cell.y, m_MaxCell.y); y++)
+                {
+                    for (int32_t x = std::max(cell.x - m_Reach, m_MinCell.x); x <= std::min(cell.x, m_MaxCell.x); x++)
+                    {
+                        ForEachInCell({ x, y, z }, [&](uint32_t entry)
+                        {
+                            float distance;
+                            if (IntersectRayAABB(ray.Origin, inverseDirection, m_EntryBounds[entry], closest.Distance, distance))
+                            {
+                                closest.ID = m_EntryIDs[entry];
+                                closest.Distance = distance;
+                            }
+                        });
+                    }
+                }
+            }
+
+            const int axis = next[0] < next[1] ? (next[0] < next[2] ? 0 : 2) : (next[1] < next[2] ? 1 : 2);
+            cellEnter = next[axis];
+            *cellAxes[axis] += step[axis];
+            next[axis] += delta[axis];
+            if (*cellAxes[axis] < lowest[axis] || *cellAxes[axis] > highest[axis])
+                break;
+        }
+        return closest;
+    }
+
+    void UniformGrid::QueryOverlaps(const AABB* boxes, uint32_t count, QueryResults& results) const
+    {
+        SpatialBatch::Collect(count, results, [&](uint32_t i, std::vector<SpatialID>& hits) { QueryOverlaps(boxes[i], hits); });
+    }
+
+    void UniformGrid::QueryFrustums(const Frustum* frustums, uint32_t count, QueryResults& results) const
+    {
+        SpatialBatch::Collect(count, results, [&](uint32_t i, std::vector<SpatialID>& hits) { QueryFrustum(frustums[i], hits); });
+    }
+
+    void UniformGrid::Raycast(const Ray* rays, uint32_t count, RayHit* hits) const
+    {
+        SpatialBatch::Run(count, [&](uint32_t i) { hits[i] = Raycast(rays[i]); });
+    }
+
+}
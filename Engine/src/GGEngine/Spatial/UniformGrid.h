@@ -0,0 +1,103 @@
+#pragma once
+
+#include "GGEngine/Core.h"
+#include "SpatialQuery.h"
+
+namespace GGEngine {
+
+    // Hashed uniform grid for many similar-sized objects no larger than a cell or two:
+    // particles, debris, crowds. Each object lives in the cell holding its min corner, so
+    // it is stored once and found once; queries widen their cell range by the largest
+    // object span seen.
+    //
+    // Objects sit in flat arrays grouped by bucket, so queries walk contiguous memory. Each
+    // bucket starts with a spare slot: Update writes moves within a cell in place and
+    // relocates objects that changed cell, borrowing slots from nearby buckets when one
+    // fills up. It counting-sorts everything again only when the objects outgrow the
+    // buckets or most of them changed. Queries see the state of the last Update, are
+    // const, and batches run in parallel on the job system.
+    class GG_API UniformGrid
+    {
+    public:
+        explicit UniformGrid(float cellSize);
+
+        SpatialID Insert(const AABB& bounds, uint32_t userData = 0);
+        void Remove(SpatialID id);
+        void Move(SpatialID id, const AABB& bounds);
+        bool IsValid(SpatialID id) const { return id < m_Alive.size() && m_Alive[id]; }
+
+        const AABB& GetBounds(SpatialID id) const { return m_Bounds[id]; }
+        uint32_t GetUserData(SpatialID id) const { return m_UserData[id]; }
+
+        void Update();
+
+        void QueryOverlaps(const AABB& box, std::vector<SpatialID>& hits) const;
+        void QueryFrustum(const Frustum& frustum, std::vector<SpatialID>& hits) const;
+        RayHit Raycast(const Ray& ray) const; // Closest hit
+
+        // Batches, spread across the job system
+        void QueryOverlaps(const AABB* boxes, uint32_t count, QueryResults& results) const;
+        void QueryFrustums(const Frustum* frustums, uint32_t count, QueryResults& results) const;
+        void Raycast(const Ray* rays, uint32_t count, RayHit* hits) const;
+
+        uint32_t GetCount() const { return m_Count; }
+        float GetCellSize() const { return m_CellSize; }
+        // Cells an object reaches past its min corner's cell, as of the last Update
+        int32_t GetReach() const { return m_Reach; }
+
+    private:
+        static constexpr uint32_t s_NoEntry = UINT32_MAX;
+
+        struct Cell
+        {
+            int32_t x, y, z;
+        };
+
+        Cell CellOf(const Vec3& point) const;
+        uint32_t BucketOf(uint64_t key) const;
+        void MarkPending(SpatialID id);
+        void Rebuild();
+        bool PlaceEntry(SpatialID id, uint64_t key);
+        void RemoveEntry(uint32_t entry);
+        void MoveEntry(uint32_t from, uint32_t to);
+        // Gives a full bucket a free slot by shifting the buckets up to the nearest one
+        // with room, one entry each. False when none is close.
+        bool MakeRoom(uint32_t bucket);
+        // Widens the occupied range and reach for an object spanning cells lo..hi
+        void Include(const Cell& lo, const Cell& hi);
+        void ScanAll(const AABB& box, std::vector<SpatialID>& hits) const;
+        // Calls fn(entry) for every entry whose min corner lies in cell
+        template<typename Fn>
+        void ForEachInCell(const Cell& cell, const Fn& fn) const;
+        // Frustum culling of the min-corner cells first..last, halving the range until it
+        // is small or fully inside
+        void CullCells(const Frustum& frustum, const Cell& first, const Cell& last, std::vector<SpatialID>& hits) const;
+
+        float m_CellSize;
+        float m_InverseCellSize;
+
+        // Per id
+        std::vector<AABB> m_Bounds;
+        std::vector<uint32_t> m_UserData;
+        std::vector<uint8_t> m_Alive;
+        std::vector<uint32_t> m_EntryOf;      // s_NoEntry until the next Update places it
+        std::vector<uint8_t> m_IsPending;
+        std::vector<SpatialID> m_FreeIDs;
+        std::vector<SpatialID> m_Pending;     // Inserted, moved or removed since the last Update
+        uint32_t m_Count = 0;
+
+        // Entries grouped by bucket: bucket b holds m_BucketSizes[b] entries from
+        // m_BucketStarts[b], with room up to m_BucketStarts[b + 1]. Free slots have no id.
+        std::vector<uint32_t> m_BucketStarts;
+        std::vector<uint32_t> m_BucketSizes;
+        std::vector<uint64_t> m_EntryCells;   // Packed min-corner cell, to skip hash collisions
+        std::vector<AABB> m_EntryBounds;
+        std::vector<SpatialID> m_EntryIDs;
+        uint32_t m_BucketShift = 64;
+        // Only grow between rebuilds, which keeps them conservative
+        int32_t m_Reach = 0;
+        Cell m_MinCell{ 0, 0, 0 };            // Range of occupied min-corner cells
+        Cell m_MaxCell{ -1, -1, -1 };
+    };
+
+}
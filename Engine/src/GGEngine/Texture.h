@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Core.h"
+
+namespace GGEngine {
+
+    enum class TextureState
+    {
+        Loading,
+        Ready,
+        Failed
+    };
+
+    struct TextureSpecification
+    {
+        bool SRGB = true;          // Color data; turn off for masks, normal maps and other linear data
+        bool GenerateMips = true;
+        bool LinearFilter = true;
+    };
+
+    class GG_API Texture2D
+    {
+    public:
+        virtual ~Texture2D() = default;
+
+        // Zero until the file has been decoded
+        virtual uint32_t GetWidth() const = 0;
+        virtual uint32_t GetHeight() const = 0;
+        virtual uint32_t GetMipLevels() const = 0;
+
+        virtual TextureState GetState() const = 0;
+        bool IsReady() const { return GetState() == TextureState::Ready; }
+
+        virtual const std::string& GetPath() const = 0;
+
+        // ImTextureID for ImGui::Image. Shows a white placeholder until the texture has streamed in.
+        virtual uint64_t GetImGuiTextureID() = 0;
+
+        // PNG, QOI or cooked KTX2 (see TextureCooker). Returns immediately: decoding runs on the job system and the upload is
+        // spread over frames. Loading a path again while it is alive returns the same texture.
+        static std::shared_ptr<Texture2D> Create(const std::string& path, const TextureSpecification& specification = TextureSpecification());
+    };
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <chrono>
+
+namespace GGEngine {
+
+    class Timer
+    {
+    public:
+        Timer() { Reset(); }
+
+        void Reset() { m_Start = std::chrono::steady_clock::now(); }
+
+        double Elapsed() const
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_Start).count();
+        }
+
+        double ElapsedMillis() const { return Elapsed() * 1000.0; }
+
+        // Engine clock in seconds. Event, frame and present timestamps all use it.
+        static double Now()
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+    private:
+        std::chrono::steady_clock::time_point m_Start;
+    };
+
+}
@@ -10,9 +10,10 @@ namespace GGEngine {
         std::string Title;
         unsigned int Width;
         unsigned int Height;
+        bool Headless; // No OS window; rendering goes to offscreen images
 
-        WindowProps(const std::string& title = "GGEngine", unsigned int width = 1280, unsigned int height = 720)
-        : Title(title), Width(width), Height(height) {}
+        WindowProps(const std::string& title = "GGEngine", unsigned int width = 1280, unsigned int height = 720, bool headless = false)
+        : Title(title), Width(width), Height(height), Headless(headless) {}
     };
 
     class GG_API Window
@@ -21,10 +22,19 @@ namespace GGEngine {
         using EventCallbackFn = std::function<void(Event&)>;
         virtual ~Window() = default;
 
+        // Dispatches pending events without blocking
         virtual void OnUpdate() = 0;
+        // Blocks until an event arrives or timeoutSeconds pass, then dispatches what arrived
+        virtual void WaitEvents(double timeoutSeconds) = 0;
+        // Wakes a WaitEvents in progress. Callable from any thread.
+        virtual void PostEmptyEvent() = 0;
 
         virtual unsigned int GetWidth() const = 0;
         virtual unsigned int GetHeight() const = 0;
+        // Cached from platform events, so the main loop never has to query the platform layer
+        virtual unsigned int GetFramebufferWidth() const = 0;
+        virtual unsigned int GetFramebufferHeight() const = 0;
+        virtual bool IsIconified() const = 0;
 
         virtual void SetEventCallback(const EventCallbackFn& callback) = 0;
         virtual void SetVSync(bool enabled) = 0;
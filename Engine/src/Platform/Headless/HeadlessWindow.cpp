@@ -0,0 +1,15 @@
+#include "HeadlessWindow.h"
+
+namespace GGEngine {
+
+    HeadlessWindow::HeadlessWindow(const WindowProps& props)
+    {
+        m_Data.Title = props.Title;
+        m_Data.Width = props.Width;
+        m_Data.Height = props.Height;
+        m_Data.VSync = false;
+
+        GG_CORE_INFO("Creating headless window {0} ({1}, {2})", props.Title, props.Width, props.Height);
+    }
+
+}
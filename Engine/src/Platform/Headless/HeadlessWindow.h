@@ -0,0 +1,45 @@
+#pragma once
+
+#include "GGEngine/Window.h"
+
+namespace GGEngine {
+
+    // Window stand-in for runs without a display. It has a fixed size, never produces
+    // input events and has no native handle; the renderer targets offscreen images instead.
+    class HeadlessWindow : public Window
+    {
+    public:
+        HeadlessWindow(const WindowProps& props);
+        virtual ~HeadlessWindow() = default;
+
+        void OnUpdate() override {}
+        // Nothing to wait for: headless runs never idle
+        void WaitEvents(double) override {}
+        void PostEmptyEvent() override {}
+
+        inline unsigned int GetWidth() const override { return m_Data.Width; }
+        inline unsigned int GetHeight() const override { return m_Data.Height; }
+        inline unsigned int GetFramebufferWidth() const override { return m_Data.Width; }
+        inline unsigned int GetFramebufferHeight() const override { return m_Data.Height; }
+        bool IsIconified() const override { return false; }
+
+        inline void SetEventCallback(const EventCallbackFn& callback) override { m_Data.EventCallback = callback; }
+        void SetVSync(bool enabled) override { m_Data.VSync = enabled; }
+        bool IsVSync() const override { return m_Data.VSync; }
+
+        inline void* GetNativeWindow() const override { return nullptr; }
+    private:
+        struct WindowData
+        {
+            std::string Title;
+            unsigned int Width, Height;
+            bool VSync;
+
+            EventCallbackFn EventCallback;
+        };
+
+    private:
+        WindowData m_Data;
+    };
+
+}
@@ -0,0 +1,305 @@
+#include "ShaderCompiler.h"
+
+#include "GGEngine/Hash.h"
+#include "GGEngine/Log.h"
+
+#ifdef GG_SHADERC
+#include <shaderc/shaderc.hpp>
+#endif
+
+namespace GGEngine {
+
+    // Bump when the cache layout or compile options change
+    static constexpr uint32_t s_CacheMagic = 0x43534747; // "GGSC"
+    static constexpr uint32_t s_CacheVersion = 1;
+
+    namespace {
+
+        bool ReadFile(const std::string& path, std::string& out)
+        {
+            std::ifstream in(path, std::ios::in | std::ios::binary);
+            if (!in)
+                return false;
+            out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            return true;
+        }
+
+        uint64_t ComputeKey(const ShaderSource& source, const std::string& text, ShaderStage stage, ShaderLanguage language)
+        {
+            uint64_t key = Hash::FNV1a64(text);
+            key = Hash::FNV1a64(source.EntryPoint, key);
+            for (const auto& define : source.Defines)
+            {
+                key = Hash::FNV1a64(define.first, key);
+                key = Hash::FNV1a64("=", key);
+                key = Hash::FNV1a64(define.second, key);
+                key = Hash::FNV1a64(";", key);
+            }
+            key = Hash::Value((uint32_t)stage, key);
+            key = Hash::Value((uint32_t)language, key);
+            key = Hash::Value(s_CacheVersion, key);
+            return key;
+        }
+
+        std::string CachePath(const std::string& cacheDirectory, uint64_t key)
+        {
+            char name[32];
+            snprintf(name, sizeof(name), "%016llx.spvc", (unsigned long long)key);
+            return (std::filesystem::path(cacheDirectory) / name).string();
+        }
+
+        // Layout: magic, version, key, dependency count, SPIR-V word count,
+        // then per dependency (content hash, path length, path), then the SPIR-V words
+        bool ReadCache(const std::string& path, uint64_t key, ShaderBinary& binary)
+        {
+            std::ifstream in(path, std::ios::in | std::ios::binary);
+            if (!in)
+                return false;
+
+            uint32_t magic = 0, version = 0, dependencyCount = 0, wordCount = 0;
+            uint64_t storedKey = 0;
+            in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+            in.read(reinterpret_cast<char*>(&version), sizeof(version));
+            in.read(reinterpret_cast<char*>(&storedKey), sizeof(storedKey));
+            in.read(reinterpret_cast<char*>(&dependencyCount), sizeof(dependencyCount));
+            in.read(reinterpret_cast<char*>(&wordCount), sizeof(wordCount));
+            if (!in || magic != s_CacheMagic || version != s_CacheVersion || storedKey != key || wordCount == 0)
+                return false;
+
+            std::vector<std::string> dependencies;
+            for (uint32_t i = 0; i < dependencyCount; i++)
+            {
+                uint64_t storedHash = 0;
+                uint32_t pathLength = 0;
+                in.read(reinterpret_cast<char*>(&storedHash), sizeof(storedHash));
+                in.read(reinterpret_cast<char*>(&pathLength), sizeof(pathLength));
+                if (!in || pathLength > 4096)
+                    return false;
+                std::string dependency(pathLength, '\0');
+                in.read(&dependency[0], pathLength);
+
+                // Included files are not part of the key, so they are validated here
+                std::string text;
+                if (!in || !ReadFile(dependency, text) || Hash::FNV1a64(text) != storedHash)
+                    return false;
+                dependencies.push_back(std::move(dependency));
+            }
+
+            binary.SpirV.resize(wordCount);
+            in.read(reinterpret_cast<char*>(binary.SpirV.data()), (std::streamsize)wordCount * sizeof(uint32_t));
+            if (!in)
+            {
+                binary.SpirV.clear();
+                return false;
+            }
+            binary.Dependencies.insert(binary.Dependencies.end(), dependencies.begin(), dependencies.end());
+            binary.FromCache = true;
+            return true;
+        }
+
+        void WriteCache(const std::string& path, uint64_t key, const ShaderBinary& binary)
+        {
+            // Write next to the final file and rename, so concurrent readers never see a partial entry
+            const std::string tempPath = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+            {
+                std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+                if (!out)
+                    return;
+
+                const uint32_t dependencyCount = (uint32_t)binary.Dependencies.size() - 1;
+                const uint32_t wordCount = (uint32_t)binary.SpirV.size();
+                out.write(reinterpret_cast<const char*>(&s_CacheMagic), sizeof(s_CacheMagic));
+                out.write(reinterpret_cast<const char*>(&s_CacheVersion), sizeof(s_CacheVersion));
+                out.write(reinterpret_cast<const char*>(&key), sizeof(key));
+                out.write(reinterpret_cast<const char*>(&dependencyCount), sizeof(dependencyCount));
+                out.write(reinterpret_cast<const char*>(&wordCount), sizeof(wordCount));
+                for (size_t i = 1; i < binary.Dependencies.size(); i++)
+                {
+                    const std::string& dependency = binary.Dependencies[i];
+                    std::string text;
+                    ReadFile(dependency, text);
+                    const uint64_t hash = Hash::FNV1a64(text);
+                    const uint32_t pathLength = (uint32_t)dependency.size();
+                    out.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+                    out.write(reinterpret_cast<const char*>(&pathLength), sizeof(pathLength));
+                    out.write(dependency.data(), pathLength);
+                }
+                out.write(reinterpret_cast<const char*>(binary.SpirV.data()), (std::streamsize)wordCount * sizeof(uint32_t));
+            }
+
+            std::error_code error;
+            std::filesystem::rename(tempPath, path, error);
+            if (error)
+                std::filesystem::remove(tempPath, error);
+        }
+
+#ifdef GG_SHADERC
+        // Resolves #include "file" relative to the including file and <file> relative to the main source
+        class Includer : public shaderc::CompileOptions::IncluderInterface
+        {
+        public:
+            Includer(const std::string& rootDirectory, std::vector<std::string>& dependencies)
+                : m_RootDirectory(rootDirectory), m_Dependencies(dependencies) {}
+
+            shaderc_include_result* GetInclude(const char* requestedSource, shaderc_include_type type, const char* requestingSource, size_t includeDepth) override
+            {
+                std::filesystem::path base = type == shaderc_include_type_relative
+                    ? std::filesystem::path(requestingSource).parent_path()
+                    : std::filesystem::path(m_RootDirectory);
+
+                auto* include = new IncludeData();
+                include->Path = (base / requestedSource).lexically_normal().string();
+                if (ReadFile(include->Path, include->Content))
+                {
+                    if (std::find(m_Dependencies.begin(), m_Dependencies.end(), include->Path) == m_Dependencies.end())
+                        m_Dependencies.push_back(include->Path);
+                    include->Result.source_name = include->Path.c_str();
+                    include->Result.source_name_length = include->Path.size();
+                }
+                else
+                {
+                    // An empty source name tells shaderc the include failed; content carries the message
+                    include->Content = "Cannot open include file " + include->Path;
+                    include->Result.source_name = "";
+                    include->Result.source_name_length = 0;
+                }
+                include->Result.content = include->Content.c_str();
+                include->Result.content_length = include->Content.size();
+                include->Result.user_data = include;
+                return &include->Result;
+            }
+
+            void ReleaseInclude(shaderc_include_result* data) override
+            {
+                delete static_cast<IncludeData*>(data->user_data);
+            }
+
+        private:
+            struct IncludeData
+            {
+                shaderc_include_result Result = {};
+                std::string Path;
+                std::string Content;
+            };
+
+            std::string m_RootDirectory;
+            std::vector<std::string>& m_Dependencies;
+        };
+
+        shaderc_shader_kind ToShaderKind(ShaderStage stage)
+        {
+            switch (stage)
+            {
+                case ShaderStage::Vertex:         return shaderc_vertex_shader;
+                case ShaderStage::Fragment:       return shaderc_fragment_shader;
+                case ShaderStage::Compute:        return shaderc_compute_shader;
+                case ShaderStage::Geometry:       return shaderc_geometry_shader;
+                case ShaderStage::TessControl:    return shaderc_tess_control_shader;
+                case ShaderStage::TessEvaluation: return shaderc_tess_evaluation_shader;
+            }
+            return shaderc_glsl_infer_from_source;
+        }
+#endif
+
+    }
+
+    bool ShaderCompiler::ParsePath(const std::string& path, ShaderStage& stage, ShaderLanguage& language)
+    {
+        std::filesystem::path file(path);
+        std::string extension = file.extension().string();
+        language = ShaderLanguage::GLSL;
+        if (extension == ".hlsl" || extension == ".spv")
+        {
+            language = extension == ".hlsl" ? ShaderLanguage::HLSL : ShaderLanguage::SPIRV;
+            extension = file.stem().extension().string();
+        }
+
+        if (extension == ".vert")      stage = ShaderStage::Vertex;
+        else if (extension == ".frag") stage = ShaderStage::Fragment;
+        else if (extension == ".comp") stage = ShaderStage::Compute;
+        else if (extension == ".geom") stage = ShaderStage::Geometry;
+        else if (extension == ".tesc") stage = ShaderStage::TessControl;
+        else if (extension == ".tese") stage = ShaderStage::TessEvaluation;
+        else return false;
+        return true;
+    }
+
+    bool ShaderCompiler::IsAvailable()
+    {
+#ifdef GG_SHADERC
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    ShaderBinary ShaderCompiler::Compile(const ShaderSource& source, const std::string& cacheDirectory)
+    {
+        ShaderBinary binary;
+        binary.Dependencies.push_back(source.Path);
+
+        ShaderStage stage;
+        ShaderLanguage language;
+        if (!ParsePath(source.Path, stage, language))
+        {
+            binary.Error = "Cannot infer shader stage from " + source.Path;
+            return binary;
+        }
+
+        std::string text;
+        if (!ReadFile(source.Path, text))
+        {
+            binary.Error = "Cannot open " + source.Path;
+            return binary;
+        }
+
+        if (language == ShaderLanguage::SPIRV)
+        {
+            if (text.empty() || text.size() % sizeof(uint32_t) != 0)
+            {
+                binary.Error = source.Path + " is not a SPIR-V binary";
+                return binary;
+            }
+            binary.SpirV.resize(text.size() / sizeof(uint32_t));
+            memcpy(binary.SpirV.data(), text.data(), text.size());
+            return binary;
+        }
+
+        const uint64_t key = ComputeKey(source, text, stage, language);
+        const std::string cachePath = CachePath(cacheDirectory, key);
+        if (ReadCache(cachePath, key, binary))
+            return binary;
+
+#ifdef GG_SHADERC
+        shaderc::CompileOptions options;
+        options.SetSourceLanguage(language == ShaderLanguage::HLSL ? shaderc_source_language_hlsl : shaderc_source_language_glsl);
+        options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
+#ifdef GG_DIST
+        options.SetOptimizationLevel(shaderc_optimization_level_performance);
+#else
+        options.SetGenerateDebugInfo();
+#endif
+        for (const auto& define : source.Defines)
+            options.AddMacroDefinition(define.first, define.second);
+        options.SetIncluder(std::make_unique<Includer>(std::filesystem::path(source.Path).parent_path().string(), binary.Dependencies));
+
+        // shaderc compilers are cheap to keep around but not meant to be shared between threads
+        thread_local shaderc::Compiler compiler;
+        shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(text, ToShaderKind(stage), source.Path.c_str(), source.EntryPoint.c_str(), options);
+        if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+        {
+            binary.Error = result.GetErrorMessage();
+            return binary;
+        }
+        binary.SpirV.assign(result.cbegin(), result.cend());
+
+        std::error_code error;
+        std::filesystem::create_directories(cacheDirectory, error);
+        WriteCache(cachePath, key, binary);
+#else
+        binary.Error = source.Path + ": not in the shader cache and the engine was built without a shader compiler";
+#endif
+        return binary;
+    }
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace GGEngine {
+
+    enum class ShaderStage
+    {
+        Vertex, Fragment, Compute, Geometry, TessControl, TessEvaluation
+    };
+
+    enum class ShaderLanguage
+    {
+        GLSL, HLSL, SPIRV
+    };
+
+    struct ShaderSource
+    {
+        // Stage and language come from the extension: name.vert / name.frag / name.comp ...
+        // for GLSL, name.vert.hlsl ... for HLSL, name.vert.spv ... for precompiled SPIR-V
+        std::string Path;
+        std::vector<std::pair<std::string, std::string>> Defines;
+        std::string EntryPoint = "main";
+    };
+
+    struct ShaderBinary
+    {
+        std::vector<uint32_t> SpirV;
+        std::vector<std::string> Dependencies; // Every file that went into the binary, main source first
+        std::string Error;
+        bool FromCache = false;
+
+        bool IsValid() const { return !SpirV.empty(); }
+    };
+
+    // Turns shader sources into SPIR-V. Results are cached on disk keyed by a hash of the
+    // source text, defines, entry point and stage; cache entries also record the hash of
+    // every included file so editing a header invalidates them. Thread-safe.
+    class ShaderCompiler
+    {
+    public:
+        static bool ParsePath(const std::string& path, ShaderStage& stage, ShaderLanguage& language);
+
+        // False when the engine was built without a shader compiler; only the cache and
+        // precompiled .spv files can be loaded then
+        static bool IsAvailable();
+
+        static ShaderBinary Compile(const ShaderSource& source, const std::string& cacheDirectory);
+    };
+
+}
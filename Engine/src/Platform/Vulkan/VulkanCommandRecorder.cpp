@@ -0,0 +1,146 @@
+#include "VulkanCommandRecorder.h"
+
+#include "VulkanContext.h"
+#include "GGEngine/JobSystem.h"
+#include "GGEngine/Log.h"
+
+namespace GGEngine {
+
+    void VulkanCommandRecorder::Init(VkDevice device, uint32_t queueFamily, uint32_t frameCount, const VkAllocationCallbacks* allocator)
+    {
+        m_Device = device;
+        m_Allocator = allocator;
+
+        const uint32_t threadCount = JobSystem::GetThreadCount();
+        m_Frames.resize(frameCount);
+        for (std::vector<ThreadPool>& threadPools : m_Frames)
+        {
+            threadPools.resize(threadCount);
+            for (ThreadPool& threadPool : threadPools)
+            {
+                VkCommandPoolCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+                info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+                info.queueFamilyIndex = queueFamily;
+                VkResult err = vkCreateCommandPool(m_Device, &info, m_Allocator, &threadPool.Pool);
+                VulkanContext::CheckVkResult(err);
+            }
+        }
+
+        GG_CORE_TRACE("Command recorder: {0} frames x {1} thread pools", frameCount, threadCount);
+    }
+
+    void VulkanCommandRecorder::Shutdown()
+    {
+        for (std::vector<ThreadPool>& threadPools : m_Frames)
+        {
+            for (ThreadPool& threadPool : threadPools)
+                vkDestroyCommandPool(m_Device, threadPool.Pool, m_Allocator);
+        }
+        m_Frames.clear();
+        m_Secondaries.clear();
+    }
+
+    void VulkanCommandRecorder::BeginFrame(uint32_t frameIndex, const VkCommandBufferInheritanceInfo& inheritance, VkExtent2D renderArea)
+    {
+        m_FrameIndex = frameIndex;
+        m_Inheritance = inheritance;
+        m_RenderArea = renderArea;
+        m_Secondaries.clear();
+
+        for (ThreadPool& threadPool : m_Frames[m_FrameIndex])
+        {
+            if (threadPool.Used == 0)
+                continue;
+            VkResult err = vkResetCommandPool(m_Device, threadPool.Pool, 0);
+            VulkanContext::CheckVkResult(err);
+            threadPool.Used = 0;
+        }
+    }
+
+    VkCommandBuffer VulkanCommandRecorder::BeginSecondary()
+    {
+        ThreadPool& threadPool = m_Frames[m_FrameIndex][JobSystem::GetThreadIndex()];
+        if (threadPool.Used == threadPool.Buffers.size())
+        {
+            VkCommandBufferAllocateInfo allocInfo = {};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = threadPool.Pool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            allocInfo.commandBufferCount = 1;
+            VkCommandBuffer commandBuffer;
+            VkResult err = vkAllocateCommandBuffers(m_Device, &allocInfo, &commandBuffer);
+            VulkanContext::CheckVkResult(err);
+            threadPool.Buffers.push_back(commandBuffer);
+        }
+        VkCommandBuffer commandBuffer = threadPool.Buffers[threadPool.Used++];
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        beginInfo.pInheritanceInfo = &m_Inheritance;
+        VkResult err = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        VulkanContext::CheckVkResult(err);
+
+        // Dynamic state is not inherited by secondary command buffers
+        VkViewport viewport = {};
+        viewport.width = (float)m_RenderArea.width;
+        viewport.height = (float)m_RenderArea.height;
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        VkRect2D scissor = {};
+        scissor.extent = m_RenderArea;
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+        return commandBuffer;
+    }
+
+    void VulkanCommandRecorder::RecordParallel(uint32_t itemCount, uint32_t minSliceSize, const RecordFn& recordFn)
+    {
+        if (itemCount == 0)
+            return;
+
+        minSliceSize = std::max(minSliceSize, 1u);
+        const uint32_t maxSlices = (itemCount + minSliceSize - 1) / minSliceSize;
+        const uint32_t sliceCount = std::min(maxSlices, JobSystem::GetThreadCount());
+        const uint32_t sliceSize = (itemCount + sliceCount - 1) / sliceCount;
+
+        // Each slice writes its own slot so execution order matches item order
+        const size_t firstSlot = m_Secondaries.size();
+        m_Secondaries.resize(firstSlot + sliceCount, VK_NULL_HANDLE);
+
+        JobCounter counter{ 0 };
+        JobSystem::Dispatch(counter, sliceCount, 1, [&](JobDispatchArgs args)
+        {
+            const uint32_t begin = args.JobIndex * sliceSize;
+            const uint32_t end = std::min(begin + sliceSize, itemCount);
+
+            VkCommandBuffer commandBuffer = BeginSecondary();
+            if (begin < end)
+                recordFn(commandBuffer, begin, end);
+            VkResult err = vkEndCommandBuffer(commandBuffer);
+            VulkanContext::CheckVkResult(err);
+
+            m_Secondaries[firstSlot + args.JobIndex] = commandBuffer;
+        });
+        JobSystem::Wait(counter);
+    }
+
+    void VulkanCommandRecorder::RecordSingle(const std::function<void(VkCommandBuffer commandBuffer)>& recordFn)
+    {
+        VkCommandBuffer commandBuffer = BeginSecondary();
+        recordFn(commandBuffer);
+        VkResult err = vkEndCommandBuffer(commandBuffer);
+        VulkanContext::CheckVkResult(err);
+        m_Secondaries.push_back(commandBuffer);
+    }
+
+    void VulkanCommandRecorder::ExecuteCommands(VkCommandBuffer primary)
+    {
+        if (m_Secondaries.empty())
+            return;
+        vkCmdExecuteCommands(primary, (uint32_t)m_Secondaries.size(), m_Secondaries.data());
+        m_Secondaries.clear();
+    }
+
+}
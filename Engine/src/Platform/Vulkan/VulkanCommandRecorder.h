@@ -0,0 +1,63 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+namespace GGEngine {
+
+    // Records secondary command buffers for a render pass across the job system.
+    // Every job thread owns one command pool per frame in flight, so recording never
+    // needs a lock and a frame's pools can be reset wholesale once its fence signals.
+    class VulkanCommandRecorder
+    {
+    public:
+        // Records items [begin, end) of a draw list. Viewport and scissor are already set
+        // to the full render area when this is called.
+        using RecordFn = std::function<void(VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end)>;
+
+        void Init(VkDevice device, uint32_t queueFamily, uint32_t frameCount, const VkAllocationCallbacks* allocator);
+        void Shutdown();
+
+        // Resets every thread's pool for frameIndex. The previous submission using that
+        // frame slot must have completed. pNext chains in inheritance must outlive the frame.
+        void BeginFrame(uint32_t frameIndex, const VkCommandBufferInheritanceInfo& inheritance, VkExtent2D renderArea);
+
+        // Splits itemCount into slices of at least minSliceSize items, records each slice into
+        // its own secondary command buffer on the job system and waits for all of them.
+        // Slices are executed in item order regardless of which thread recorded them.
+        void RecordParallel(uint32_t itemCount, uint32_t minSliceSize, const RecordFn& recordFn);
+
+        // Records a single secondary command buffer on the calling thread
+        void RecordSingle(const std::function<void(VkCommandBuffer commandBuffer)>& recordFn);
+
+        bool HasCommands() const { return !m_Secondaries.empty(); }
+
+        // Executes everything recorded this frame, in recording order, inside the current
+        // render pass of primary. The pass must have been begun with secondary contents.
+        void ExecuteCommands(VkCommandBuffer primary);
+
+        uint32_t GetFrameCount() const { return (uint32_t)m_Frames.size(); }
+
+    private:
+        struct ThreadPool
+        {
+            VkCommandPool Pool = VK_NULL_HANDLE;
+            std::vector<VkCommandBuffer> Buffers;
+            uint32_t Used = 0;
+        };
+
+        VkCommandBuffer BeginSecondary();
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* m_Allocator = nullptr;
+
+        std::vector<std::vector<ThreadPool>> m_Frames; // [frame][thread]
+        uint32_t m_FrameIndex = 0;
+
+        VkCommandBufferInheritanceInfo m_Inheritance = {};
+        VkExtent2D m_RenderArea = {};
+
+        std::vector<VkCommandBuffer> m_Secondaries;
+    };
+
+}
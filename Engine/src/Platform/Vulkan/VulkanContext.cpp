@@ -1,5 +1,9 @@
 #include "VulkanContext.h"
+#include "VulkanImage.h"
+#include "VulkanDeviceSelector.h"
 #include "GGEngine/Log.h"
+#include "GGEngine/FrameStats.h"
+#include "GGEngine/Timer.h"
 
 #include <glad/vulkan.h>
 #include <stdio.h>
@@ -41,41 +45,86 @@ namespace GGEngine {
             abort();
     }
 
+    VulkanContext* VulkanContext::s_Instance = nullptr;
+
+    static const uint32_t s_MaxImGuiTextures = 1024;
+    static const uint32_t s_MaxGPUCullObjects = 65536;
+    // Deferred destroys waiting for the frame boundary to pick their value; timeline values start at 1
+    static const uint64_t s_UnassignedTimelineValue = 0;
+
     VulkanContext::VulkanContext(GLFWwindow* windowHandle)
         : m_WindowHandle(windowHandle)
     {
+        GG_CORE_ASSERT(!s_Instance, "VulkanContext already exists!");
+        s_Instance = this;
+    }
+
+    VulkanContext::VulkanContext(const VulkanHeadlessSpec& headlessSpec)
+        : m_Headless(true), m_HeadlessSpec(headlessSpec)
+    {
+        GG_CORE_ASSERT(!s_Instance, "VulkanContext already exists!");
+        GG_CORE_ASSERT(headlessSpec.ImageCount >= 2, "Headless ring needs at least two images");
+        s_Instance = this;
     }
 
     VulkanContext::~VulkanContext()
     {
         Shutdown();
+        s_Instance = nullptr;
     }
 
     void VulkanContext::Init()
     {
-        if (!glfwVulkanSupported())
+        if (m_Headless)
         {
-            GG_CORE_CRITICAL("GLFW: Vulkan Not Supported!");
-            return;
+            SetupVulkan();
+            SetupHeadless();
         }
+        else
+        {
+            if (!glfwVulkanSupported())
+            {
+                GG_CORE_CRITICAL("GLFW: Vulkan Not Supported!");
+                return;
+            }
 
-        ImVector<const char*> extensions;
-        uint32_t extensionsCount = 0;
-        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&extensionsCount);
-        for (uint32_t i = 0; i < extensionsCount; i++)
-            extensions.push_back(glfwExtensions[i]);
+            SetupVulkan();
 
-        SetupVulkan();
+            // Create Window Surface
+            VkSurfaceKHR surface;
+            VkResult err = glfwCreateWindowSurface(m_Instance, m_WindowHandle, m_Allocator, &surface);
+            CheckVkResult(err);
 
-        // Create Window Surface
-        VkSurfaceKHR surface;
-        VkResult err = glfwCreateWindowSurface(m_Instance, m_WindowHandle, m_Allocator, &surface);
-        CheckVkResult(err);
+            // Create Framebuffers
+            int w, h;
+            glfwGetFramebufferSize(m_WindowHandle, &w, &h);
+            m_FramebufferExtent = { (uint32_t)w, (uint32_t)h };
+            SetupVulkanWindow(surface, w, h);
+        }
 
-        // Create Framebuffers
-        int w, h;
-        glfwGetFramebufferSize(m_WindowHandle, &w, &h);
-        SetupVulkanWindow(surface, w, h);
+        m_InheritanceRendering.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+        m_InheritanceRendering.colorAttachmentCount = 1;
+        m_InheritanceRendering.pColorAttachmentFormats = &m_ColorFormat;
+        m_InheritanceRendering.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        m_CommandRecorder.Init(m_Device, m_QueueFamily, GetImageCount(), m_Allocator);
+        m_FrameTimelineValues.assign(GetImageCount(), 0);
+        m_Readback.Init(m_Device, m_PhysicalDevice, m_Allocator);
+        m_RenderGraph.Init(m_Device, m_PhysicalDevice, m_Allocator);
+
+        m_ShaderLibrary.Init(m_Device, m_Allocator, "ShaderCache");
+#ifndef GG_DIST
+        if (!m_Headless)
+            m_ShaderLibrary.SetHotReload(true);
+#endif
+        m_PipelineCache.Init(m_Device, m_PhysicalDevice, m_Allocator, m_UseDynamicRendering, "PipelineCache");
+        m_ShaderReloadListener = m_ShaderLibrary.AddReloadListener([this](const VulkanShader& shader) { m_PipelineCache.OnShaderReloaded(shader); });
+        m_TextureStreamer.Init(m_Device, m_PhysicalDevice, m_Allocator);
+        m_GPUCuller.Init(m_Device, m_PhysicalDevice, m_Allocator, GetImageCount(), s_MaxGPUCullObjects);
+        m_ImGuiRenderer.Init(m_Device, m_PhysicalDevice, m_Allocator, GetImageCount(), GetRenderPass(), m_ColorFormat);
+        m_SceneRenderer.Init(m_Device, m_PhysicalDevice, m_Allocator, m_ColorFormat, m_UseDynamicRendering);
+        m_ViewportRenderer.Init(m_Device);
+        m_PresentTracker.Init(m_Device, m_PresentTiming);
 
         GG_CORE_INFO("Vulkan Context initialized successfully");
     }
@@ -85,7 +134,27 @@ namespace GGEngine {
         VkResult err = vkDeviceWaitIdle(m_Device);
         CheckVkResult(err);
 
-        CleanupVulkanWindow();
+        for (std::promise<ReadbackImage>& promise : m_FrameReadbacks)
+            promise.set_value(ReadbackImage());
+        m_FrameReadbacks.clear();
+        m_PresentTracker.Shutdown();
+        m_Readback.Shutdown();
+        m_ShaderLibrary.RemoveReloadListener(m_ShaderReloadListener);
+        m_PipelineCache.Shutdown();
+        m_ShaderLibrary.Shutdown();
+        m_TextureStreamer.Shutdown();
+        m_GPUCuller.Shutdown();
+        m_ImGuiRenderer.Shutdown();
+        m_SceneRenderer.Shutdown();
+        m_RenderGraph.Shutdown();
+        m_ViewportRenderer.Shutdown();
+
+        FlushDeferredDestroys(true);
+        m_CommandRecorder.Shutdown();
+        if (m_Headless)
+            CleanupHeadless();
+        else
+            CleanupVulkanWindow();
         CleanupVulkan();
     }
 
@@ -103,8 +172,21 @@ namespace GGEngine {
 
         // Create Vulkan Instance
         {
+            // Request the highest API version the loader offers, capped at 1.3
+            uint32_t instanceVersion = VK_API_VERSION_1_0;
+            if (vkEnumerateInstanceVersion)
+                vkEnumerateInstanceVersion(&instanceVersion);
+            m_ApiVersion = std::min(instanceVersion, (uint32_t)VK_API_VERSION_1_3);
+
+            VkApplicationInfo appInfo = {};
+            appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+            appInfo.pApplicationName = "GGEngine";
+            appInfo.pEngineName = "GGEngine";
+            appInfo.apiVersion = m_ApiVersion;
+
             VkInstanceCreateInfo createInfo = {};
             createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+            createInfo.pApplicationInfo = &appInfo;
 
             // Enumerate available extensions
             uint32_t propertiesCount;
@@ -114,11 +196,15 @@ namespace GGEngine {
             err = vkEnumerateInstanceExtensionProperties(nullptr, &propertiesCount, properties.Data);
             CheckVkResult(err);
 
+            // Surface extensions are only needed when presenting to a window
             ImVector<const char*> instanceExtensions;
-            uint32_t glfwExtCount = 0;
-            const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtCount);
-            for (uint32_t i = 0; i < glfwExtCount; i++)
-                instanceExtensions.push_back(glfwExtensions[i]);
+            if (!m_Headless)
+            {
+                uint32_t glfwExtCount = 0;
+                const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtCount);
+                for (uint32_t i = 0; i < glfwExtCount; i++)
+                    instanceExtensions.push_back(glfwExtensions[i]);
+            }
 
             // Enable required extensions
             if (IsExtensionAvailable(properties, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
@@ -162,21 +248,29 @@ namespace GGEngine {
 #endif
         }
 
-        // Select Physical Device (GPU)
-        m_PhysicalDevice = ImGui_ImplVulkanH_SelectPhysicalDevice(m_Instance);
-        IM_ASSERT(m_PhysicalDevice != VK_NULL_HANDLE);
+        // Select Physical Device (GPU) and graphics queue family
+        if (!VulkanDeviceSelector::Select(m_Instance, m_ApiVersion, !m_Headless, m_DevicePreference, m_PhysicalDevice, m_QueueFamily))
+        {
+            GG_CORE_CRITICAL("Vulkan: no usable GPU found");
+            abort();
+        }
 
         // Load physical device-level functions
         gladLoaderLoadVulkan(m_Instance, m_PhysicalDevice, VK_NULL_HANDLE);
 
-        // Select graphics queue family
-        m_QueueFamily = ImGui_ImplVulkanH_SelectQueueFamilyIndex(m_PhysicalDevice);
-        IM_ASSERT(m_QueueFamily != (uint32_t)-1);
+        {
+            VkPhysicalDeviceProperties deviceProperties;
+            vkGetPhysicalDeviceProperties(m_PhysicalDevice, &deviceProperties);
+            m_ApiVersion = std::min(m_ApiVersion, deviceProperties.apiVersion);
+            VulkanDeviceSelector::LogCapabilities(m_PhysicalDevice);
+            FrameStats::SetDeviceDescription(VulkanDeviceSelector::Describe(deviceProperties));
+        }
 
         // Create Logical Device (with 1 queue)
         {
             ImVector<const char*> deviceExtensions;
-            deviceExtensions.push_back("VK_KHR_swapchain");
+            if (!m_Headless)
+                deviceExtensions.push_back("VK_KHR_swapchain");
 
             // Enumerate physical device extension
             uint32_t propertiesCount;
@@ -190,6 +284,111 @@ namespace GGEngine {
                 deviceExtensions.push_back(VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME);
 #endif
 
+            // Optional features are queried and then enabled through the same pNext chain
+            void* featureChain = nullptr;
+
+            // Timeline semaphores (required): core in 1.2, otherwise VK_KHR_timeline_semaphore
+            VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures = {};
+            timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+            const bool timelineExtension = m_ApiVersion < VK_API_VERSION_1_2
+                && IsExtensionAvailable(properties, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+            if (m_ApiVersion >= VK_API_VERSION_1_2 || timelineExtension)
+            {
+                if (timelineExtension)
+                    deviceExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+                timelineFeatures.pNext = featureChain;
+                featureChain = &timelineFeatures;
+            }
+
+            // Dynamic rendering: core in 1.3, otherwise VK_KHR_dynamic_rendering (whose
+            // dependencies are all core in 1.2)
+            VkPhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures = {};
+            dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES;
+            const bool dynamicRenderingExtension = m_ApiVersion < VK_API_VERSION_1_3 && m_ApiVersion >= VK_API_VERSION_1_2
+                && IsExtensionAvailable(properties, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+            if (m_ApiVersion >= VK_API_VERSION_1_3 || dynamicRenderingExtension)
+            {
+                dynamicRenderingFeatures.pNext = featureChain;
+                featureChain = &dynamicRenderingFeatures;
+            }
+
+            // Present timing: VK_KHR_present_id tags presents and VK_KHR_present_wait reports
+            // when they reach the display. Optional, for latency measurement and pacing.
+            VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures = {};
+            presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+            VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = {};
+            presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+            const bool presentTimingExtensions = !m_Headless
+                && IsExtensionAvailable(properties, VK_KHR_PRESENT_ID_EXTENSION_NAME)
+                && IsExtensionAvailable(properties, VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+            if (presentTimingExtensions)
+            {
+                presentIdFeatures.pNext = featureChain;
+                presentWaitFeatures.pNext = &presentIdFeatures;
+                featureChain = &presentWaitFeatures;
+            }
+
+            PFN_vkGetPhysicalDeviceFeatures2 getFeatures2 = vkGetPhysicalDeviceFeatures2 ? vkGetPhysicalDeviceFeatures2 : vkGetPhysicalDeviceFeatures2KHR;
+            if (featureChain != nullptr && getFeatures2 != nullptr)
+            {
+                VkPhysicalDeviceFeatures2 features = {};
+                features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+                features.pNext = featureChain;
+                getFeatures2(m_PhysicalDevice, &features);
+            }
+
+            if (timelineFeatures.timelineSemaphore != VK_TRUE)
+            {
+                GG_CORE_CRITICAL("Vulkan: timeline semaphores are not supported by this device");
+                abort();
+            }
+
+            // Unsupported optional features leave the chain, their extensions stay disabled
+            auto unlinkFeature = [&featureChain](const void* feature)
+            {
+                VkBaseOutStructure** link = (VkBaseOutStructure**)&featureChain;
+                while (*link != nullptr && *link != feature)
+                    link = &(*link)->pNext;
+                if (*link != nullptr)
+                    *link = (*link)->pNext;
+            };
+
+            m_UseDynamicRendering = dynamicRenderingFeatures.dynamicRendering == VK_TRUE;
+            if (m_UseDynamicRendering && dynamicRenderingExtension)
+                deviceExtensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+            else if (!m_UseDynamicRendering)
+                unlinkFeature(&dynamicRenderingFeatures);
+
+            m_PresentTiming = presentIdFeatures.presentId == VK_TRUE && presentWaitFeatures.presentWait == VK_TRUE;
+            if (m_PresentTiming)
+            {
+                deviceExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+                deviceExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+            }
+            else
+            {
+                unlinkFeature(&presentWaitFeatures);
+                unlinkFeature(&presentIdFeatures);
+            }
+
+            // Block-compressed textures (BC1-7), for cooked KTX2 files. Optional: without it
+            // the texture streamer rejects them and only loads PNG/QOI sources.
+            VkPhysicalDeviceFeatures supportedFeatures = {};
+            vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &supportedFeatures);
+            VkPhysicalDeviceFeatures enabledFeatures = {};
+            enabledFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+            m_TextureCompressionBC = supportedFeatures.textureCompressionBC == VK_TRUE;
+
+            // GPU-driven draws: many indirect commands per call, the object index as
+            // firstInstance, and a GPU-written draw count. All optional.
+            enabledFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+            enabledFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+            m_MultiDrawIndirect = supportedFeatures.multiDrawIndirect == VK_TRUE;
+            m_DrawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance == VK_TRUE;
+            const bool drawIndirectCount = IsExtensionAvailable(properties, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+            if (drawIndirectCount)
+                deviceExtensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
             const float queuePriority[] = { 1.0f };
             VkDeviceQueueCreateInfo queueInfo[1] = {};
             queueInfo[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
@@ -199,10 +398,12 @@ namespace GGEngine {
 
             VkDeviceCreateInfo createInfo = {};
             createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+            createInfo.pNext = featureChain;
             createInfo.queueCreateInfoCount = sizeof(queueInfo) / sizeof(queueInfo[0]);
             createInfo.pQueueCreateInfos = queueInfo;
             createInfo.enabledExtensionCount = (uint32_t)deviceExtensions.Size;
             createInfo.ppEnabledExtensionNames = deviceExtensions.Data;
+            createInfo.pEnabledFeatures = &enabledFeatures;
             err = vkCreateDevice(m_PhysicalDevice, &createInfo, m_Allocator, &m_Device);
             CheckVkResult(err);
 
@@ -210,13 +411,33 @@ namespace GGEngine {
             gladLoaderLoadVulkan(m_Instance, m_PhysicalDevice, m_Device);
 
             vkGetDeviceQueue(m_Device, m_QueueFamily, 0, &m_Queue);
+
+            if (m_UseDynamicRendering)
+            {
+                m_CmdBeginRendering = m_ApiVersion >= VK_API_VERSION_1_3 ? vkCmdBeginRendering : vkCmdBeginRenderingKHR;
+                m_CmdEndRendering = m_ApiVersion >= VK_API_VERSION_1_3 ? vkCmdEndRendering : vkCmdEndRenderingKHR;
+                GG_CORE_INFO("Vulkan: dynamic rendering enabled");
+            }
+
+            if (drawIndirectCount)
+                m_CmdDrawIndexedIndirectCount = vkCmdDrawIndexedIndirectCountKHR;
+
+            m_Timeline.Init(m_Device, m_ApiVersion, m_Allocator);
+
+            VkCommandPoolCreateInfo poolInfo = {};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolInfo.queueFamilyIndex = m_QueueFamily;
+            err = vkCreateCommandPool(m_Device, &poolInfo, m_Allocator, &m_OneTimeCommandPool);
+            CheckVkResult(err);
         }
 
         // Create Descriptor Pool
         {
             VkDescriptorPoolSize poolSizes[] =
             {
-                { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, IMGUI_IMPL_VULKAN_MINIMUM_IMAGE_SAMPLER_POOL_SIZE },
+                // ImGui's font atlas plus one set per texture shown through ImGui::Image
+                { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, IMGUI_IMPL_VULKAN_MINIMUM_IMAGE_SAMPLER_POOL_SIZE + s_MaxImGuiTextures },
             };
             VkDescriptorPoolCreateInfo poolInfo = {};
             poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
@@ -233,7 +454,7 @@ namespace GGEngine {
 
     void VulkanContext::SetupVulkanWindow(VkSurfaceKHR surface, int width, int height)
     {
-        ImGui_ImplVulkanH_Window* wd = &m_WindowData;
+        VkResult err;
 
         // Check for WSI support
         VkBool32 res;
@@ -247,21 +468,151 @@ namespace GGEngine {
         // Select Surface Format
         const VkFormat requestSurfaceImageFormat[] = { VK_FORMAT_B8G8R8A8_UNORM, VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_B8G8R8_UNORM, VK_FORMAT_R8G8B8_UNORM };
         const VkColorSpaceKHR requestSurfaceColorSpace = VK_COLORSPACE_SRGB_NONLINEAR_KHR;
-        wd->Surface = surface;
-        wd->SurfaceFormat = ImGui_ImplVulkanH_SelectSurfaceFormat(m_PhysicalDevice, wd->Surface, requestSurfaceImageFormat, (size_t)IM_COUNTOF(requestSurfaceImageFormat), requestSurfaceColorSpace);
+        const VkSurfaceFormatKHR surfaceFormat = ImGui_ImplVulkanH_SelectSurfaceFormat(m_PhysicalDevice, surface, requestSurfaceImageFormat, (size_t)IM_COUNTOF(requestSurfaceImageFormat), requestSurfaceColorSpace);
 
         // Select Present Mode (VSync)
         VkPresentModeKHR presentModes[] = { VK_PRESENT_MODE_FIFO_KHR };
-        wd->PresentMode = ImGui_ImplVulkanH_SelectPresentMode(m_PhysicalDevice, wd->Surface, &presentModes[0], IM_COUNTOF(presentModes));
+        const VkPresentModeKHR presentMode = ImGui_ImplVulkanH_SelectPresentMode(m_PhysicalDevice, surface, &presentModes[0], IM_COUNTOF(presentModes));
+        m_ColorFormat = surfaceFormat.format;
 
-        // Create SwapChain, RenderPass, Framebuffer, etc.
+        // With dynamic rendering there is no render pass or framebuffers, so a resize only
+        // rebuilds the swapchain and its image views
         IM_ASSERT(m_MinImageCount >= 2);
-        ImGui_ImplVulkanH_CreateOrResizeWindow(m_Instance, m_PhysicalDevice, m_Device, wd, m_QueueFamily, m_Allocator, width, height, m_MinImageCount, 0);
+        m_Swapchain.Init(m_PhysicalDevice, m_Device, surface, surfaceFormat, presentMode, m_MinImageCount, m_UseDynamicRendering, m_Allocator);
+        m_Swapchain.Create((uint32_t)std::max(width, 0), (uint32_t)std::max(height, 0));
+        m_SwapchainTransferSrc = m_Swapchain.SupportsTransferSrc();
+
+        // Frame slots are sized once from the first swapchain; later ones may have a
+        // different image count without touching per-frame resources
+        m_WindowFrames.resize(std::max(m_Swapchain.GetImageCount(), m_MinImageCount));
+        for (WindowFrame& frame : m_WindowFrames)
+        {
+            VkCommandPoolCreateInfo poolInfo = {};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.queueFamilyIndex = m_QueueFamily;
+            err = vkCreateCommandPool(m_Device, &poolInfo, m_Allocator, &frame.CommandPool);
+            CheckVkResult(err);
+
+            VkCommandBufferAllocateInfo allocInfo = {};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = frame.CommandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            err = vkAllocateCommandBuffers(m_Device, &allocInfo, &frame.CommandBuffer);
+            CheckVkResult(err);
+
+            VkSemaphoreCreateInfo semaphoreInfo = {};
+            semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            err = vkCreateSemaphore(m_Device, &semaphoreInfo, m_Allocator, &frame.ImageAcquired);
+            CheckVkResult(err);
+        }
+        m_FrameIndex = (uint32_t)m_WindowFrames.size() - 1;
+    }
+
+    void VulkanContext::SetupHeadless()
+    {
+        VkResult err;
+        m_ColorFormat = m_HeadlessSpec.Format;
+
+        // Without dynamic rendering the ring needs a render pass compatible with every image.
+        // Frames end in TRANSFER_SRC_OPTIMAL so their contents can be copied out directly.
+        if (!m_UseDynamicRendering)
+        {
+            VkAttachmentDescription attachment = {};
+            attachment.format = m_ColorFormat;
+            attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+            attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+            attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            attachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+            VkAttachmentReference colorAttachment = {};
+            colorAttachment.attachment = 0;
+            colorAttachment.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+            VkSubpassDescription subpass = {};
+            subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+            subpass.colorAttachmentCount = 1;
+            subpass.pColorAttachments = &colorAttachment;
+
+            VkSubpassDependency dependencies[2] = {};
+            dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+            dependencies[0].dstSubpass = 0;
+            dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+            dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            dependencies[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            dependencies[1].srcSubpass = 0;
+            dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+            dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+            VkRenderPassCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+            info.attachmentCount = 1;
+            info.pAttachments = &attachment;
+            info.subpassCount = 1;
+            info.pSubpasses = &subpass;
+            info.dependencyCount = (uint32_t)IM_COUNTOF(dependencies);
+            info.pDependencies = dependencies;
+            err = vkCreateRenderPass(m_Device, &info, m_Allocator, &m_HeadlessRenderPass);
+            CheckVkResult(err);
+        }
+
+        m_HeadlessFrames.resize(m_HeadlessSpec.ImageCount);
+        for (HeadlessFrame& frame : m_HeadlessFrames)
+        {
+            VulkanImageSpec imageSpec;
+            imageSpec.Width = m_HeadlessSpec.Width;
+            imageSpec.Height = m_HeadlessSpec.Height;
+            imageSpec.Format = m_ColorFormat;
+            imageSpec.Usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+            frame.Image = std::make_unique<VulkanImage>();
+            frame.Image->Create(imageSpec);
+
+            if (m_HeadlessRenderPass != VK_NULL_HANDLE)
+            {
+                VkImageView view = frame.Image->GetView();
+                VkFramebufferCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+                info.renderPass = m_HeadlessRenderPass;
+                info.attachmentCount = 1;
+                info.pAttachments = &view;
+                info.width = m_HeadlessSpec.Width;
+                info.height = m_HeadlessSpec.Height;
+                info.layers = 1;
+                err = vkCreateFramebuffer(m_Device, &info, m_Allocator, &frame.Framebuffer);
+                CheckVkResult(err);
+            }
+
+            VkCommandPoolCreateInfo poolInfo = {};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.queueFamilyIndex = m_QueueFamily;
+            err = vkCreateCommandPool(m_Device, &poolInfo, m_Allocator, &frame.CommandPool);
+            CheckVkResult(err);
+
+            VkCommandBufferAllocateInfo allocInfo = {};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = frame.CommandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            err = vkAllocateCommandBuffers(m_Device, &allocInfo, &frame.CommandBuffer);
+            CheckVkResult(err);
+        }
+
+        m_FrameIndex = m_HeadlessSpec.ImageCount - 1;
+        GG_CORE_INFO("Vulkan: headless ring of {0} images ({1}x{2})", m_HeadlessSpec.ImageCount, m_HeadlessSpec.Width, m_HeadlessSpec.Height);
     }
 
     void VulkanContext::CleanupVulkan()
     {
         vkDestroyDescriptorPool(m_Device, m_DescriptorPool, m_Allocator);
+        vkDestroyCommandPool(m_Device, m_OneTimeCommandPool, m_Allocator);
+        m_Timeline.Shutdown();
 
 #ifdef _DEBUG
         auto f_vkDestroyDebugReportCallbackEXT = (PFN_vkDestroyDebugReportCallbackEXT)vkGetInstanceProcAddr(m_Instance, "vkDestroyDebugReportCallbackEXT");
@@ -274,27 +625,327 @@ namespace GGEngine {
 
     void VulkanContext::CleanupVulkanWindow()
     {
-        ImGui_ImplVulkanH_DestroyWindow(m_Instance, m_Device, &m_WindowData, m_Allocator);
-        vkDestroySurfaceKHR(m_Instance, m_WindowData.Surface, m_Allocator);
+        for (WindowFrame& frame : m_WindowFrames)
+        {
+            vkDestroyCommandPool(m_Device, frame.CommandPool, m_Allocator);
+            vkDestroySemaphore(m_Device, frame.ImageAcquired, m_Allocator);
+        }
+        m_WindowFrames.clear();
+        m_Swapchain.Shutdown(m_Instance);
+    }
+
+    void VulkanContext::CleanupHeadless()
+    {
+        for (HeadlessFrame& frame : m_HeadlessFrames)
+        {
+            vkDestroyCommandPool(m_Device, frame.CommandPool, m_Allocator);
+            if (frame.Framebuffer != VK_NULL_HANDLE)
+                vkDestroyFramebuffer(m_Device, frame.Framebuffer, m_Allocator);
+            frame.Image.reset();
+        }
+        m_HeadlessFrames.clear();
+
+        if (m_HeadlessRenderPass != VK_NULL_HANDLE)
+        {
+            vkDestroyRenderPass(m_Device, m_HeadlessRenderPass, m_Allocator);
+            m_HeadlessRenderPass = VK_NULL_HANDLE;
+        }
+    }
+
+    VkExtent2D VulkanContext::GetExtent() const
+    {
+        if (m_Headless)
+            return { m_HeadlessSpec.Width, m_HeadlessSpec.Height };
+        return m_Swapchain.GetExtent();
+    }
+
+    VulkanContext::FrameTarget VulkanContext::GetFrameTarget(uint32_t frameIndex)
+    {
+        FrameTarget target;
+        if (m_Headless)
+        {
+            const HeadlessFrame& frame = m_HeadlessFrames[frameIndex];
+            target.Image = frame.Image->GetImage();
+            target.View = frame.Image->GetView();
+            target.Framebuffer = frame.Framebuffer;
+            target.CommandPool = frame.CommandPool;
+            target.CommandBuffer = frame.CommandBuffer;
+        }
+        else
+        {
+            const WindowFrame& frame = m_WindowFrames[frameIndex];
+            target.Image = m_Swapchain.GetImage(m_ImageIndex);
+            target.View = m_Swapchain.GetView(m_ImageIndex);
+            target.Framebuffer = m_Swapchain.GetFramebuffer(m_ImageIndex);
+            target.CommandPool = frame.CommandPool;
+            target.CommandBuffer = frame.CommandBuffer;
+        }
+        return target;
+    }
+
+    void VulkanContext::SetClearColor(float r, float g, float b, float a)
+    {
+        m_ClearValue.color.float32[0] = r;
+        m_ClearValue.color.float32[1] = g;
+        m_ClearValue.color.float32[2] = b;
+        m_ClearValue.color.float32[3] = a;
+    }
+
+    uint32_t VulkanContext::FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const
+    {
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &memoryProperties);
+        for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+        {
+            if ((typeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+                return i;
+        }
+        GG_CORE_ERROR("[Vulkan] No memory type matches bits {0:#x} with properties {1:#x}", typeBits, properties);
+        return 0;
     }
 
     void VulkanContext::RecreateSwapchain(int width, int height)
     {
-        ImGui_ImplVulkan_SetMinImageCount(m_MinImageCount);
-        ImGui_ImplVulkanH_CreateOrResizeWindow(m_Instance, m_PhysicalDevice, m_Device, &m_WindowData, m_QueueFamily, m_Allocator, width, height, m_MinImageCount, 0);
-        m_WindowData.FrameIndex = 0;
+        // Frame slots, their command buffers and semaphores carry over unchanged; only the
+        // images are replaced, and the old ones are retired once the new ones have all been acquired
+        const VkSwapchainKHR oldSwapchain = m_Swapchain.GetSwapchain();
+        if (!m_Swapchain.Create((uint32_t)width, (uint32_t)height))
+            return;
+        m_PresentTracker.RetireSwapchain(oldSwapchain);
         m_SwapChainRebuild = false;
+        m_SwapchainTransferSrc = m_Swapchain.SupportsTransferSrc();
+    }
+
+    void VulkanContext::OnFramebufferResize(uint32_t width, uint32_t height)
+    {
+        m_FramebufferExtent = { width, height };
+        const VkExtent2D extent = m_Swapchain.GetExtent();
+        if (width != extent.width || height != extent.height)
+            m_SwapChainRebuild = true;
+    }
+
+    uint64_t VulkanContext::SubmitOneTime(const std::function<void(VkCommandBuffer commandBuffer)>& recordFn)
+    {
+        VkCommandBufferAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = m_OneTimeCommandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        VkCommandBuffer commandBuffer;
+        VkResult err = vkAllocateCommandBuffers(m_Device, &allocInfo, &commandBuffer);
+        CheckVkResult(err);
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        err = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        CheckVkResult(err);
+        recordFn(commandBuffer);
+        err = vkEndCommandBuffer(commandBuffer);
+        CheckVkResult(err);
+
+        const uint64_t signalValue = m_Timeline.AdvanceSubmitValue();
+        VkSemaphore timelineSemaphore = m_Timeline.GetSemaphore();
+
+        VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.signalSemaphoreValueCount = 1;
+        timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &timelineSemaphore;
+        err = vkQueueSubmit(m_Queue, 1, &submitInfo, VK_NULL_HANDLE);
+        CheckVkResult(err);
+        m_Readback.OnSubmit(commandBuffer, signalValue);
+
+        VkDevice device = m_Device;
+        VkCommandPool pool = m_OneTimeCommandPool;
+        DeferDestroy(signalValue, [device, pool, commandBuffer]() { vkFreeCommandBuffers(device, pool, 1, &commandBuffer); });
+        return signalValue;
+    }
+
+    void VulkanContext::DeferDestroy(std::function<void()> destroyFn)
+    {
+        // One-time submissions may reserve values before the frame being recorded does, so
+        // the value is only assigned at the next frame boundary, once the frame has submitted
+        DeferDestroy(s_UnassignedTimelineValue, std::move(destroyFn));
+    }
+
+    void VulkanContext::DeferDestroy(uint64_t timelineValue, std::function<void()> destroyFn)
+    {
+        std::lock_guard<std::mutex> lock(m_DeferredDestroyMutex);
+        m_DeferredDestroys.push_back({ timelineValue, std::move(destroyFn) });
+    }
+
+    void VulkanContext::FlushDeferredDestroys(bool waitAll)
+    {
+        std::vector<DeferredDestroy> ready;
+        {
+            std::lock_guard<std::mutex> lock(m_DeferredDestroyMutex);
+            if (m_DeferredDestroys.empty())
+                return;
+
+            // Everything deferred since the last flush waits for all work submitted until now
+            const uint64_t lastSubmitted = m_Timeline.GetLastSubmittedValue();
+            for (DeferredDestroy& entry : m_DeferredDestroys)
+            {
+                if (entry.TimelineValue == s_UnassignedTimelineValue)
+                    entry.TimelineValue = lastSubmitted;
+            }
+
+            const uint64_t completed = waitAll ? UINT64_MAX : m_Timeline.GetCompletedValue();
+            auto it = std::stable_partition(m_DeferredDestroys.begin(), m_DeferredDestroys.end(),
+                [completed](const DeferredDestroy& entry) { return entry.TimelineValue > completed; });
+            std::move(it, m_DeferredDestroys.end(), std::back_inserter(ready));
+            m_DeferredDestroys.erase(it, m_DeferredDestroys.end());
+        }
+
+        // Run outside the lock; destroy callbacks may defer further work
+        for (DeferredDestroy& entry : ready)
+            entry.DestroyFn();
+    }
+
+    uint32_t VulkanContext::AddRenderCallback(const RenderCallbackFn& callback)
+    {
+        uint32_t id = m_NextRenderCallbackId++;
+        m_RenderCallbacks.emplace_back(id, callback);
+        return id;
+    }
+
+    void VulkanContext::RemoveRenderCallback(uint32_t id)
+    {
+        m_RenderCallbacks.erase(std::remove_if(m_RenderCallbacks.begin(), m_RenderCallbacks.end(),
+            [id](const std::pair<uint32_t, RenderCallbackFn>& entry) { return entry.first == id; }), m_RenderCallbacks.end());
+    }
+
+    uint32_t VulkanContext::AddRenderGraphCallback(const RenderGraphCallbackFn& callback)
+    {
+        uint32_t id = m_NextRenderCallbackId++;
+        m_RenderGraphCallbacks.emplace_back(id, callback);
+        return id;
+    }
+
+    void VulkanContext::RemoveRenderGraphCallback(uint32_t id)
+    {
+        m_RenderGraphCallbacks.erase(std::remove_if(m_RenderGraphCallbacks.begin(), m_RenderGraphCallbacks.end(),
+            [id](const std::pair<uint32_t, RenderGraphCallbackFn>& entry) { return entry.first == id; }), m_RenderGraphCallbacks.end());
+    }
+
+    std::future<ReadbackImage> VulkanContext::ReadbackNextFrame()
+    {
+        std::promise<ReadbackImage> promise;
+        std::future<ReadbackImage> future = promise.get_future();
+        if (!CanReadbackFrames())
+        {
+            GG_CORE_WARN("[Vulkan] Frame readback needs swapchain images created with transfer source usage");
+            promise.set_value(ReadbackImage());
+            return future;
+        }
+        m_FrameReadbacks.push_back(std::move(promise));
+        return future;
+    }
+
+    void VulkanContext::FlushReadbacks()
+    {
+        // Requests for a frame that was never rendered cannot complete anymore
+        for (std::promise<ReadbackImage>& promise : m_FrameReadbacks)
+            promise.set_value(ReadbackImage());
+        m_FrameReadbacks.clear();
+
+        m_Timeline.WaitFor(m_Timeline.GetLastSubmittedValue());
+        m_Readback.Resolve(m_Timeline.GetCompletedValue());
+    }
+
+    void VulkanContext::RecordMainPass(const FrameTarget& target, VkExtent2D extent, ImDrawData* drawData, bool useSecondaries, bool engineImGui)
+    {
+        // The graph has moved the target to COLOR_ATTACHMENT_OPTIMAL; previous contents are cleared
+        if (m_UseDynamicRendering)
+        {
+            VkRenderingAttachmentInfo colorAttachment = {};
+            colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            colorAttachment.imageView = target.View;
+            colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+            colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            colorAttachment.clearValue = m_ClearValue;
+
+            VkRenderingInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+            info.flags = useSecondaries ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0;
+            info.renderArea.extent = extent;
+            info.layerCount = 1;
+            info.colorAttachmentCount = 1;
+            info.pColorAttachments = &colorAttachment;
+            m_CmdBeginRendering(target.CommandBuffer, &info);
+        }
+        else
+        {
+            VkRenderPassBeginInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            info.renderPass = GetRenderPass();
+            info.framebuffer = target.Framebuffer;
+            info.renderArea.extent = extent;
+            info.clearValueCount = 1;
+            info.pClearValues = &m_ClearValue;
+            vkCmdBeginRenderPass(target.CommandBuffer, &info, useSecondaries ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+        }
+
+        if (useSecondaries)
+        {
+            m_CommandRecorder.ExecuteCommands(target.CommandBuffer);
+            if (engineImGui)
+                m_ImGuiRenderer.Execute(target.CommandBuffer);
+        }
+        else
+        {
+            ImGui_ImplVulkan_RenderDrawData(drawData, target.CommandBuffer);
+        }
+
+        if (m_UseDynamicRendering)
+            m_CmdEndRendering(target.CommandBuffer);
+        else
+            vkCmdEndRenderPass(target.CommandBuffer);
     }
 
     void VulkanContext::BeginFrame()
     {
-        // Check if we need to resize
-        int fbWidth, fbHeight;
-        glfwGetFramebufferSize(m_WindowHandle, &fbWidth, &fbHeight);
-        if (fbWidth > 0 && fbHeight > 0 && (m_SwapChainRebuild || m_WindowData.Width != fbWidth || m_WindowData.Height != fbHeight))
+        // Steady-state frames should not allocate host memory in the driver at all
+        if (IsTrackingHostAllocations())
         {
-            RecreateSwapchain(fbWidth, fbHeight);
+            const VulkanHostAllocationStats stats = m_HostAllocator.EndFrame();
+            const uint64_t allocations = stats.GetFrameAllocations();
+            FrameStats::AddDriverAllocations((uint32_t)allocations);
+            if (allocations > 0)
+            {
+                std::string scopes;
+                for (uint32_t scope = 0; scope < VulkanHostAllocationStats::ScopeCount; scope++)
+                {
+                    if (stats.FrameAllocations[scope] > 0)
+                        scopes += std::string(" ") + VulkanHostAllocationStats::GetScopeName(scope) + "=" + std::to_string(stats.FrameAllocations[scope]);
+                }
+                GG_CORE_TRACE("Vulkan driver allocated {0} times ({1} bytes) last frame:{2}", allocations, stats.GetFrameBytes(), scopes);
+            }
         }
+
+        FlushDeferredDestroys(false);
+        m_Readback.Resolve(m_Timeline.GetCompletedValue());
+        m_PresentTracker.Update();
+        m_ShaderLibrary.Update();
+        m_PipelineCache.Update();
+        m_TextureStreamer.Update();
+        m_GPUCuller.Update();
+        if (m_Headless)
+            return;
+
+        // Resize events and out-of-date results from acquire/present flag the rebuild; a
+        // minimized window reports no area and keeps the old swapchain until restored
+        if (m_SwapChainRebuild && m_FramebufferExtent.width > 0 && m_FramebufferExtent.height > 0)
+            RecreateSwapchain((int)m_FramebufferExtent.width, (int)m_FramebufferExtent.height);
     }
 
     void VulkanContext::EndFrame()
@@ -304,93 +955,258 @@ namespace GGEngine {
 
     void VulkanContext::FrameRender(ImDrawData* drawData)
     {
-        ImGui_ImplVulkanH_Window* wd = &m_WindowData;
+        VkResult err;
+        VkSemaphore imageAcquiredSemaphore = VK_NULL_HANDLE;
+        VkSemaphore renderCompleteSemaphore = VK_NULL_HANDLE;
 
-        VkSemaphore imageAcquiredSemaphore = wd->FrameSemaphores[wd->SemaphoreIndex].ImageAcquiredSemaphore;
-        VkSemaphore renderCompleteSemaphore = wd->FrameSemaphores[wd->SemaphoreIndex].RenderCompleteSemaphore;
-        VkResult err = vkAcquireNextImageKHR(m_Device, wd->Swapchain, UINT64_MAX, imageAcquiredSemaphore, VK_NULL_HANDLE, &wd->FrameIndex);
-        if (err == VK_ERROR_OUT_OF_DATE_KHR || err == VK_SUBOPTIMAL_KHR)
-            m_SwapChainRebuild = true;
-        if (err == VK_ERROR_OUT_OF_DATE_KHR)
-            return;
-        if (err != VK_SUBOPTIMAL_KHR)
-            CheckVkResult(err);
+        // Frame slots rotate independently of swapchain images. Frame pacing: the previous
+        // submission that used this slot's resources must be done. That says nothing about
+        // its present, so render-complete semaphores belong to swapchain images instead:
+        // acquiring an image again means its last present has consumed the semaphore.
+        m_FrameIndex = (m_FrameIndex + 1) % GetImageCount();
+        m_Timeline.WaitFor(m_FrameTimelineValues[m_FrameIndex]);
 
-        ImGui_ImplVulkanH_Frame* fd = &wd->Frames[wd->FrameIndex];
+        if (!m_Headless)
         {
-            err = vkWaitForFences(m_Device, 1, &fd->Fence, VK_TRUE, UINT64_MAX);
-            CheckVkResult(err);
+            const WindowFrame& frame = m_WindowFrames[m_FrameIndex];
+            imageAcquiredSemaphore = frame.ImageAcquired;
+            err = m_Swapchain.AcquireNextImage(imageAcquiredSemaphore, m_ImageIndex);
+            if (err == VK_ERROR_OUT_OF_DATE_KHR || err == VK_SUBOPTIMAL_KHR)
+                m_SwapChainRebuild = true;
+            if (err == VK_ERROR_OUT_OF_DATE_KHR)
+                return;
+            if (err != VK_SUBOPTIMAL_KHR)
+                CheckVkResult(err);
+            renderCompleteSemaphore = m_Swapchain.GetRenderComplete(m_ImageIndex);
+            m_ImageAcquired = true;
+        }
 
-            err = vkResetFences(m_Device, 1, &fd->Fence);
-            CheckVkResult(err);
+        const FrameTarget target = GetFrameTarget(m_FrameIndex);
+        const VkExtent2D extent = GetExtent();
+
+        // Let registered submitters record their slices of the draw list in parallel
+        // before the primary command buffer is opened
+        bool engineImGui = false;
+        {
+            VkCommandBufferInheritanceInfo inheritance = {};
+            inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+            if (m_UseDynamicRendering)
+            {
+                inheritance.pNext = &m_InheritanceRendering;
+            }
+            else
+            {
+                inheritance.renderPass = GetRenderPass();
+                inheritance.subpass = 0;
+                inheritance.framebuffer = target.Framebuffer;
+            }
+            m_CommandRecorder.BeginFrame(m_FrameIndex, inheritance, extent);
+
+            for (auto& entry : m_RenderCallbacks)
+                entry.second(m_CommandRecorder);
+
+            // Draw lists keep their secondaries across frames, so those are recorded without a
+            // framebuffer; the render pass alone makes them compatible with every swapchain image
+            inheritance.framebuffer = VK_NULL_HANDLE;
+            engineImGui = m_ImGuiRenderer.Prepare(drawData, inheritance);
         }
+
+        // A subpass is either fully inline or fully secondary, so once anything was
+        // recorded in parallel the ImGui draw data goes into a secondary as well. Until the
+        // engine ImGui pipeline has compiled, the vendored backend renders the draw data.
+        const bool useSecondaries = m_CommandRecorder.HasCommands() || engineImGui;
+        if (m_CommandRecorder.HasCommands() && !engineImGui)
         {
-            err = vkResetCommandPool(m_Device, fd->CommandPool, 0);
+            m_CommandRecorder.RecordSingle([drawData](VkCommandBuffer commandBuffer)
+            {
+                ImGui_ImplVulkan_RenderDrawData(drawData, commandBuffer);
+            });
+        }
+
+        {
+            err = vkResetCommandPool(m_Device, target.CommandPool, 0);
             CheckVkResult(err);
             VkCommandBufferBeginInfo info = {};
             info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
             info.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-            err = vkBeginCommandBuffer(fd->CommandBuffer, &info);
+            err = vkBeginCommandBuffer(target.CommandBuffer, &info);
             CheckVkResult(err);
         }
+
+        // The frame graph: registered passes, then the main pass into the frame target,
+        // then readbacks of it. Layout transitions between them come from the graph.
         {
-            VkRenderPassBeginInfo info = {};
-            info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-            info.renderPass = wd->RenderPass;
-            info.framebuffer = fd->Framebuffer;
-            info.renderArea.extent.width = wd->Width;
-            info.renderArea.extent.height = wd->Height;
-            info.clearValueCount = 1;
-            info.pClearValues = &wd->ClearValue;
-            vkCmdBeginRenderPass(fd->CommandBuffer, &info, VK_SUBPASS_CONTENTS_INLINE);
-        }
+            // Contents are never kept, so the target enters the graph as UNDEFINED, ordered
+            // after the acquire semaphore wait; it leaves for present or, headless, for copies
+            const VkImageLayout targetFinalLayout = m_Headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+            m_RenderGraph.BeginFrame(extent);
+            const RenderGraphResource backbuffer = m_RenderGraph.ImportImage("Backbuffer", { target.Image, target.View, m_ColorFormat, extent },
+                VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, targetFinalLayout);
+
+            const GPUCullOutput culled = m_GPUCuller.AddPasses(m_RenderGraph);
+            const RenderGraphResource imguiGeometry = engineImGui ? m_ImGuiRenderer.AddPasses(m_RenderGraph) : RenderGraphNullResource;
+            for (auto& entry : m_RenderGraphCallbacks)
+                entry.second(m_RenderGraph, backbuffer);
+            m_SceneColorTargets.clear();
+            m_SceneRenderer.AddPasses(m_RenderGraph, m_SceneColorTargets);
+
+            m_RenderGraph.AddPass("Main",
+                [this, backbuffer, targetFinalLayout, &culled, imguiGeometry](RenderGraphBuilder& builder)
+                {
+                    // ImGui samples the scene viewports straight from their targets
+                    for (RenderGraphResource sceneColor : m_SceneColorTargets)
+                        builder.Read(sceneColor, RenderGraphUsage::SampledFragment);
+                    if (imguiGeometry != RenderGraphNullResource)
+                    {
+                        builder.Read(imguiGeometry, RenderGraphUsage::VertexBuffer);
+                        builder.Read(imguiGeometry, RenderGraphUsage::IndexBuffer);
+                    }
+                    // Render callbacks draw the GPU-culled objects
+                    if (culled.Draws != RenderGraphNullResource)
+                        builder.Read(culled.Draws, RenderGraphUsage::IndirectBuffer);
+                    if (culled.Count != RenderGraphNullResource)
+                        builder.Read(culled.Count, RenderGraphUsage::IndirectBuffer);
+                    // A VkRenderPass ends in its attachment's finalLayout by itself
+                    builder.Write(backbuffer, RenderGraphUsage::ColorAttachment, m_UseDynamicRendering ? VK_IMAGE_LAYOUT_UNDEFINED : targetFinalLayout);
+                },
+                [this, &target, extent, drawData, useSecondaries, engineImGui](RenderGraphPassContext&)
+                {
+                    RecordMainPass(target, extent, drawData, useSecondaries, engineImGui);
+                });
+
+            if (!m_FrameReadbacks.empty())
+            {
+                m_RenderGraph.AddPass("Readback",
+                    [backbuffer](RenderGraphBuilder& builder)
+                    {
+                        builder.Read(backbuffer, RenderGraphUsage::TransferSrc);
+                        builder.SetSideEffects();
+                    },
+                    [this, backbuffer](RenderGraphPassContext& context)
+                    {
+                        const RenderGraphImage& image = context.GetImage(backbuffer);
+                        for (std::promise<ReadbackImage>& promise : m_FrameReadbacks)
+                            m_Readback.ReadImage(context.GetCommandBuffer(), image.Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image.Format, image.Extent, std::move(promise));
+                        m_FrameReadbacks.clear();
+                    });
+            }
 
-        // Record dear imgui primitives into command buffer
-        ImGui_ImplVulkan_RenderDrawData(drawData, fd->CommandBuffer);
+            m_RenderGraph.Compile();
+            m_RenderGraph.Execute(target.CommandBuffer);
+        }
 
         // Submit command buffer
-        vkCmdEndRenderPass(fd->CommandBuffer);
         {
+            // The binary semaphore only feeds present; completion is tracked on the timeline
+            const uint64_t frameValue = m_Timeline.AdvanceSubmitValue();
+            m_FrameTimelineValues[m_FrameIndex] = frameValue;
+
+            VkSemaphore signalSemaphores[2];
+            uint64_t signalValues[2];
+            uint32_t signalCount = 0;
+            if (renderCompleteSemaphore != VK_NULL_HANDLE)
+            {
+                signalSemaphores[signalCount] = renderCompleteSemaphore;
+                signalValues[signalCount++] = 0;
+            }
+            signalSemaphores[signalCount] = m_Timeline.GetSemaphore();
+            signalValues[signalCount++] = frameValue;
+
+            VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+            timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+            timelineInfo.signalSemaphoreValueCount = signalCount;
+            timelineInfo.pSignalSemaphoreValues = signalValues;
+
             VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
             VkSubmitInfo info = {};
             info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            info.waitSemaphoreCount = 1;
+            info.pNext = &timelineInfo;
+            info.waitSemaphoreCount = imageAcquiredSemaphore != VK_NULL_HANDLE ? 1 : 0;
             info.pWaitSemaphores = &imageAcquiredSemaphore;
             info.pWaitDstStageMask = &waitStage;
             info.commandBufferCount = 1;
-            info.pCommandBuffers = &fd->CommandBuffer;
-            info.signalSemaphoreCount = 1;
-            info.pSignalSemaphores = &renderCompleteSemaphore;
+            info.pCommandBuffers = &target.CommandBuffer;
+            info.signalSemaphoreCount = signalCount;
+            info.pSignalSemaphores = signalSemaphores;
 
-            err = vkEndCommandBuffer(fd->CommandBuffer);
+            err = vkEndCommandBuffer(target.CommandBuffer);
             CheckVkResult(err);
-            err = vkQueueSubmit(m_Queue, 1, &info, fd->Fence);
+
+            Timer submitTimer;
+            err = vkQueueSubmit(m_Queue, 1, &info, VK_NULL_HANDLE);
+            FrameStats::AddSubmitTime(submitTimer.ElapsedMillis());
             CheckVkResult(err);
+            m_Readback.OnSubmit(target.CommandBuffer, frameValue);
         }
     }
 
     void VulkanContext::FramePresent()
     {
-        if (m_SwapChainRebuild)
+        // Headless frames stay in the offscreen ring. A suboptimal image that was rendered
+        // is still presented, so its render-complete semaphore is always waited on.
+        if (m_Headless)
             return;
 
-        ImGui_ImplVulkanH_Window* wd = &m_WindowData;
-        VkSemaphore renderCompleteSemaphore = wd->FrameSemaphores[wd->SemaphoreIndex].RenderCompleteSemaphore;
+        m_PresentSwapchains.clear();
+        m_PresentImageIndices.clear();
+        m_PresentWaitSemaphores.clear();
+        const bool presentMain = m_ImageAcquired;
+        if (presentMain)
+        {
+            m_PresentSwapchains.push_back(m_Swapchain.GetSwapchain());
+            m_PresentImageIndices.push_back(m_ImageIndex);
+            m_PresentWaitSemaphores.push_back(m_Swapchain.GetRenderComplete(m_ImageIndex));
+            m_ImageAcquired = false;
+        }
+        m_ViewportRenderer.AppendPresents(m_PresentSwapchains, m_PresentImageIndices, m_PresentWaitSemaphores);
+        if (m_PresentSwapchains.empty())
+            return;
+        m_PresentResults.assign(m_PresentSwapchains.size(), VK_SUCCESS);
+
         VkPresentInfoKHR info = {};
         info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        info.waitSemaphoreCount = 1;
-        info.pWaitSemaphores = &renderCompleteSemaphore;
-        info.swapchainCount = 1;
-        info.pSwapchains = &wd->Swapchain;
-        info.pImageIndices = &wd->FrameIndex;
+        info.waitSemaphoreCount = (uint32_t)m_PresentWaitSemaphores.size();
+        info.pWaitSemaphores = m_PresentWaitSemaphores.data();
+        info.swapchainCount = (uint32_t)m_PresentSwapchains.size();
+        info.pSwapchains = m_PresentSwapchains.data();
+        info.pImageIndices = m_PresentImageIndices.data();
+        info.pResults = m_PresentResults.data();
+
+        Timer presentTimer;
+        // Only the main window's present is timed; viewports get id 0
+        VkPresentIdKHR presentIds = {};
+        const uint64_t mainPresentId = presentMain ? m_PresentTracker.NextPresentId() : 0;
+        if (mainPresentId != 0)
+        {
+            m_PresentIdValues.assign(m_PresentSwapchains.size(), 0);
+            m_PresentIdValues[0] = mainPresentId;
+            presentIds.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+            presentIds.swapchainCount = (uint32_t)m_PresentIdValues.size();
+            presentIds.pPresentIds = m_PresentIdValues.data();
+            info.pNext = &presentIds;
+        }
+
         VkResult err = vkQueuePresentKHR(m_Queue, &info);
-        if (err == VK_ERROR_OUT_OF_DATE_KHR || err == VK_SUBOPTIMAL_KHR)
-            m_SwapChainRebuild = true;
-        if (err == VK_ERROR_OUT_OF_DATE_KHR)
-            return;
-        if (err != VK_SUBOPTIMAL_KHR)
+        FrameStats::AddSubmitTime(presentTimer.ElapsedMillis());
+        if (err != VK_SUCCESS && err != VK_SUBOPTIMAL_KHR && err != VK_ERROR_OUT_OF_DATE_KHR)
             CheckVkResult(err);
-        wd->SemaphoreIndex = (wd->SemaphoreIndex + 1) % wd->SemaphoreCount;
+
+        // Each swapchain reports its own result; one being out of date does not affect the others
+        if (presentMain)
+        {
+            m_PresentTracker.OnPresented(m_PresentSwapchains[0], mainPresentId, m_PresentResults[0], FrameStats::GetFrameStartTime(), FrameStats::GetFrameInputTime());
+            if (m_PresentResults[0] == VK_ERROR_OUT_OF_DATE_KHR || m_PresentResults[0] == VK_SUBOPTIMAL_KHR)
+                m_SwapChainRebuild = true;
+            else
+                CheckVkResult(m_PresentResults[0]);
+        }
+        m_ViewportRenderer.OnPresented(m_PresentResults.data() + (presentMain ? 1 : 0));
+    }
+
+    void VulkanContext::RenderViewports()
+    {
+        if (!m_Headless)
+            m_ViewportRenderer.Render();
     }
 
 }
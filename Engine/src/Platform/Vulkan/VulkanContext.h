@@ -8,23 +8,72 @@
 
 #include "imgui_impl_vulkan.h"
 
+#include "VulkanCommandRecorder.h"
+#include "VulkanGPUCulling.h"
+#include "VulkanHostAllocator.h"
+#include "VulkanImGuiRenderer.h"
+#include "VulkanImage.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanPresentTracker.h"
+#include "VulkanReadback.h"
+#include "VulkanRenderGraph.h"
+#include "VulkanSceneViewport.h"
+#include "VulkanShader.h"
+#include "VulkanSwapchain.h"
+#include "VulkanTexture.h"
+#include "VulkanTimeline.h"
+#include "VulkanViewportRenderer.h"
+
 namespace GGEngine {
 
+    struct VulkanHeadlessSpec
+    {
+        uint32_t Width = 1280;
+        uint32_t Height = 720;
+        uint32_t ImageCount = 3;
+        VkFormat Format = VK_FORMAT_R8G8B8A8_UNORM;
+    };
+
     class VulkanContext
     {
     public:
+        // Called once per frame with the recorder primed for the main render pass.
+        // Anything recorded through it executes before the ImGui draw data.
+        using RenderCallbackFn = std::function<void(VulkanCommandRecorder& recorder)>;
+        // Called once per frame to declare passes on the frame graph. They run before the
+        // main pass, which clears and draws into backbuffer.
+        using RenderGraphCallbackFn = std::function<void(VulkanRenderGraph& graph, RenderGraphResource backbuffer)>;
+
         VulkanContext(GLFWwindow* windowHandle);
+        // No surface or swapchain: frames cycle through a ring of offscreen images
+        VulkanContext(const VulkanHeadlessSpec& headlessSpec);
         ~VulkanContext();
 
+        // Before Init: a device index or part of a device name, empty to pick by score
+        void SetDevicePreference(const std::string& preference) { m_DevicePreference = preference; }
+        // Before Init: route the driver's host allocations through VulkanHostAllocator
+        void SetHostAllocationTracking(bool enabled) { m_Allocator = enabled ? m_HostAllocator.GetCallbacks() : nullptr; }
         void Init();
         void Shutdown();
 
         // Frame management
         void BeginFrame();
         void EndFrame();
+        void FrameRender(ImDrawData* drawData);
+        // ImGui's secondary platform windows, after ImGui::UpdatePlatformWindows
+        void RenderViewports();
+        // Presents the main window and every rendered viewport with one vkQueuePresentKHR
+        void FramePresent();
+
+        uint32_t AddRenderCallback(const RenderCallbackFn& callback);
+        void RemoveRenderCallback(uint32_t id);
+        uint32_t AddRenderGraphCallback(const RenderGraphCallbackFn& callback);
+        void RemoveRenderGraphCallback(uint32_t id);
 
-        // Swapchain rebuild (on resize)
+        // Swapchain rebuild (on resize). Frames in flight keep their old images; nothing waits.
         void RecreateSwapchain(int width, int height);
+        // From the window's framebuffer resize event: the next BeginFrame rebuilds at this size
+        void OnFramebufferResize(uint32_t width, uint32_t height);
 
         // Accessors for ImGui initialization
         VkInstance GetInstance() const { return m_Instance; }
@@ -33,40 +82,210 @@ namespace GGEngine {
         VkQueue GetQueue() const { return m_Queue; }
         uint32_t GetQueueFamily() const { return m_QueueFamily; }
         VkDescriptorPool GetDescriptorPool() const { return m_DescriptorPool; }
-        VkRenderPass GetRenderPass() const { return m_WindowData.RenderPass; }
+        VkRenderPass GetRenderPass() const { return m_Headless ? m_HeadlessRenderPass : m_Swapchain.GetRenderPass(); }
+        // Stable address, so it can be handed to pipeline rendering create infos
+        const VkFormat& GetColorFormat() const { return m_ColorFormat; }
+        const VkAllocationCallbacks* GetAllocator() const { return m_Allocator; }
+        bool IsTrackingHostAllocations() const { return m_Allocator != nullptr; }
+        // Totals and the previous frame's driver allocations; empty unless tracking
+        const VulkanHostAllocationStats& GetHostAllocationStats() const { return m_HostAllocator.GetLastFrame(); }
+        uint32_t GetApiVersion() const { return m_ApiVersion; }
         uint32_t GetMinImageCount() const { return m_MinImageCount; }
-        uint32_t GetImageCount() const { return m_WindowData.ImageCount; }
+        // Frames in flight. Fixed at Init, independent of how many images later swapchains get.
+        uint32_t GetImageCount() const { return m_Headless ? (uint32_t)m_HeadlessFrames.size() : (uint32_t)m_WindowFrames.size(); }
+        VkExtent2D GetExtent() const;
+
+        bool IsHeadless() const { return m_Headless; }
+        // Offscreen image of a headless ring slot. Rendered frames leave it in TRANSFER_SRC_OPTIMAL.
+        const VulkanImage* GetHeadlessImage(uint32_t index) const { return m_HeadlessFrames[index].Image.get(); }
+        uint32_t GetFrameIndex() const { return m_FrameIndex; }
+
+        void SetClearColor(float r, float g, float b, float a);
+
+        VulkanCommandRecorder& GetCommandRecorder() { return m_CommandRecorder; }
+        VulkanRenderGraph& GetRenderGraph() { return m_RenderGraph; }
+        // Streamed textures or pipelines are still on their way and will change later frames
+        bool HasPendingWork() { return m_TextureStreamer.GetPendingCount() > 0 || m_PipelineCache.GetCompilingCount() > 0 || m_SceneRenderer.HasPendingResize(); }
+        // Main window ImGui rendering with per-draw-list reuse
+        const ImGuiRendererStats& GetImGuiRendererStats() const { return m_ImGuiRenderer.GetStats(); }
+
+        // True when VK_KHR_dynamic_rendering (or Vulkan 1.3) was enabled at device creation.
+        // The main pass then renders straight to swapchain image views, with no VkRenderPass
+        // or VkFramebuffer, and GetRenderPass() returns VK_NULL_HANDLE.
+        bool UsesDynamicRendering() const { return m_UseDynamicRendering; }
+        void CmdBeginRendering(VkCommandBuffer commandBuffer, const VkRenderingInfo* renderingInfo) const { m_CmdBeginRendering(commandBuffer, renderingInfo); }
+        void CmdEndRendering(VkCommandBuffer commandBuffer) const { m_CmdEndRendering(commandBuffer); }
+
+        // Indirect draw features, enabled when present. GPU culling needs a first instance;
+        // draw indirect count comes from VK_KHR_draw_indirect_count.
+        bool SupportsMultiDrawIndirect() const { return m_MultiDrawIndirect; }
+        bool SupportsDrawIndirectFirstInstance() const { return m_DrawIndirectFirstInstance; }
+        bool SupportsDrawIndirectCount() const { return m_CmdDrawIndexedIndirectCount != nullptr; }
+        void CmdDrawIndexedIndirectCount(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkBuffer countBuffer,
+            VkDeviceSize countOffset, uint32_t maxDrawCount, uint32_t stride) const { m_CmdDrawIndexedIndirectCount(commandBuffer, buffer, offset, countBuffer, countOffset, maxDrawCount, stride); }
+
+        uint32_t FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const;
+
+        // GPU timeline of the graphics queue. Frame pacing, upload completion and deferred
+        // destruction are all expressed as values on it.
+        VulkanTimeline& GetTimeline() { return m_Timeline; }
+
+        // Records one-off work (uploads, copies) and submits it without blocking.
+        // Returns the timeline value reached once the work has executed. Main thread only.
+        uint64_t SubmitOneTime(const std::function<void(VkCommandBuffer commandBuffer)>& recordFn);
+
+        // Destroys a resource once the GPU has finished everything submitted so far,
+        // including the frame currently being recorded. Callable from any thread.
+        void DeferDestroy(std::function<void()> destroyFn);
+        void DeferDestroy(uint64_t timelineValue, std::function<void()> destroyFn);
+
+        VulkanShaderLibrary& GetShaderLibrary() { return m_ShaderLibrary; }
+        VulkanPipelineCache& GetPipelineCache() { return m_PipelineCache; }
+        VulkanTextureStreamer& GetTextureStreamer() { return m_TextureStreamer; }
+        // Objects added here are culled on the GPU every frame, ahead of the main pass;
+        // render callbacks draw the survivors with RecordDraws
+        VulkanGPUCuller& GetGPUCuller() { return m_GPUCuller; }
+        // Scene passes into the offscreen targets of displayed SceneViewports, ahead of the main pass
+        VulkanSceneRenderer& GetSceneRenderer() { return m_SceneRenderer; }
+        bool SupportsTextureCompressionBC() const { return m_TextureCompressionBC; }
+
+        // GPU -> CPU copies, resolved against the timeline at the start of later frames
+        VulkanReadback& GetReadback() { return m_Readback; }
+        bool CanReadbackFrames() const { return m_Headless || m_SwapchainTransferSrc; }
+        // Copies the color target of the next rendered frame once its rendering has finished
+        std::future<ReadbackImage> ReadbackNextFrame();
+        // Waits for everything submitted so far and resolves the readbacks it carried
+        void FlushReadbacks();
 
-        ImGui_ImplVulkanH_Window* GetWindowData() { return &m_WindowData; }
+        // Display times of the main window's presents, and low-latency frame pacing
+        VulkanPresentTracker& GetPresentTracker() { return m_PresentTracker; }
 
         bool NeedsSwapchainRebuild() const { return m_SwapChainRebuild; }
         void SetSwapchainRebuild(bool rebuild) { m_SwapChainRebuild = rebuild; }
 
+        static VulkanContext& Get() { return *s_Instance; }
+        static void CheckVkResult(VkResult err);
+
     private:
+        // Everything FrameRender needs for one frame slot, from the swapchain or the headless ring
+        struct FrameTarget
+        {
+            VkImage Image;
+            VkImageView View;
+            VkFramebuffer Framebuffer;
+            VkCommandPool CommandPool;
+            VkCommandBuffer CommandBuffer;
+        };
+
+        // Per frame slot; the swapchain image is whichever one was acquired for the frame
+        struct WindowFrame
+        {
+            VkCommandPool CommandPool = VK_NULL_HANDLE;
+            VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+            VkSemaphore ImageAcquired = VK_NULL_HANDLE;
+        };
+
+        struct HeadlessFrame
+        {
+            std::unique_ptr<VulkanImage> Image;
+            VkFramebuffer Framebuffer = VK_NULL_HANDLE;
+            VkCommandPool CommandPool = VK_NULL_HANDLE;
+            VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+        };
+
         void SetupVulkan();
         void SetupVulkanWindow(VkSurfaceKHR surface, int width, int height);
+        void SetupHeadless();
         void CleanupVulkan();
         void CleanupVulkanWindow();
-        void FrameRender(ImDrawData* drawData);
-        void FramePresent();
-
-        static void CheckVkResult(VkResult err);
+        void CleanupHeadless();
+        FrameTarget GetFrameTarget(uint32_t frameIndex);
+        void RecordMainPass(const FrameTarget& target, VkExtent2D extent, ImDrawData* drawData, bool useSecondaries, bool engineImGui);
+        // Runs the destroys whose timeline value has completed. Entries from the value-less
+        // DeferDestroy are first keyed to the last value submitted so far.
+        void FlushDeferredDestroys(bool waitAll);
 
     private:
         GLFWwindow* m_WindowHandle = nullptr;
 
-        VkAllocationCallbacks* m_Allocator = nullptr;
+        VulkanHostAllocator m_HostAllocator;
+        VkAllocationCallbacks* m_Allocator = nullptr; // m_HostAllocator's callbacks when tracking
         VkInstance m_Instance = VK_NULL_HANDLE;
         VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
         VkDevice m_Device = VK_NULL_HANDLE;
         uint32_t m_QueueFamily = (uint32_t)-1;
         VkQueue m_Queue = VK_NULL_HANDLE;
-        VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;
         VkDescriptorPool m_DescriptorPool = VK_NULL_HANDLE;
+        uint32_t m_ApiVersion = VK_API_VERSION_1_0;
+
+        bool m_UseDynamicRendering = false;
+        std::string m_DevicePreference;
+        bool m_TextureCompressionBC = false;
+        bool m_MultiDrawIndirect = false;
+        bool m_DrawIndirectFirstInstance = false;
+        PFN_vkCmdDrawIndexedIndirectCount m_CmdDrawIndexedIndirectCount = nullptr;
+        PFN_vkCmdBeginRendering m_CmdBeginRendering = nullptr;
+        PFN_vkCmdEndRendering m_CmdEndRendering = nullptr;
+        VkCommandBufferInheritanceRenderingInfo m_InheritanceRendering = {};
 
-        ImGui_ImplVulkanH_Window m_WindowData;
+        VulkanSwapchain m_Swapchain;
+        std::vector<WindowFrame> m_WindowFrames;
+        uint32_t m_ImageIndex = 0;   // Swapchain image of the current frame
+        bool m_ImageAcquired = false; // Cleared once presented, or when acquisition failed
         uint32_t m_MinImageCount = 2;
         bool m_SwapChainRebuild = false;
+        VkExtent2D m_FramebufferExtent = {}; // Latest size reported by the window
+        VulkanViewportRenderer m_ViewportRenderer;
+        std::vector<VkSwapchainKHR> m_PresentSwapchains;
+        std::vector<uint32_t> m_PresentImageIndices;
+        std::vector<VkSemaphore> m_PresentWaitSemaphores;
+        std::vector<VkResult> m_PresentResults;
+        std::vector<uint64_t> m_PresentIdValues;
+        bool m_PresentTiming = false; // VK_KHR_present_id and VK_KHR_present_wait enabled
+        VulkanPresentTracker m_PresentTracker;
+
+        bool m_Headless = false;
+        VulkanHeadlessSpec m_HeadlessSpec;
+        std::vector<HeadlessFrame> m_HeadlessFrames;
+        VkRenderPass m_HeadlessRenderPass = VK_NULL_HANDLE;
+
+        VkFormat m_ColorFormat = VK_FORMAT_UNDEFINED;
+        VkClearValue m_ClearValue = {};
+        uint32_t m_FrameIndex = 0;
+
+        VulkanTimeline m_Timeline;
+        std::vector<uint64_t> m_FrameTimelineValues; // Last value submitted per frame slot
+        VkCommandPool m_OneTimeCommandPool = VK_NULL_HANDLE;
+
+        struct DeferredDestroy
+        {
+            uint64_t TimelineValue;
+            std::function<void()> DestroyFn;
+        };
+        std::vector<DeferredDestroy> m_DeferredDestroys;
+        std::mutex m_DeferredDestroyMutex;
+
+        VulkanReadback m_Readback;
+        VulkanShaderLibrary m_ShaderLibrary;
+        VulkanPipelineCache m_PipelineCache;
+        uint32_t m_ShaderReloadListener = 0;
+        VulkanTextureStreamer m_TextureStreamer;
+        VulkanGPUCuller m_GPUCuller;
+        std::vector<std::promise<ReadbackImage>> m_FrameReadbacks;
+        bool m_SwapchainTransferSrc = false; // Surfaces may not support transfer source usage
+
+        VulkanCommandRecorder m_CommandRecorder;
+        std::vector<std::pair<uint32_t, RenderCallbackFn>> m_RenderCallbacks;
+        uint32_t m_NextRenderCallbackId = 1;
+
+        VulkanRenderGraph m_RenderGraph;
+        std::vector<std::pair<uint32_t, RenderGraphCallbackFn>> m_RenderGraphCallbacks;
+
+        VulkanImGuiRenderer m_ImGuiRenderer;
+        VulkanSceneRenderer m_SceneRenderer;
+        std::vector<RenderGraphResource> m_SceneColorTargets; // This frame's, read by the main pass
+
+        static VulkanContext* s_Instance;
 
 #ifdef _DEBUG
         VkDebugReportCallbackEXT m_DebugReport = VK_NULL_HANDLE;
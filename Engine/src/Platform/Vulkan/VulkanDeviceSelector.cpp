@@ -0,0 +1,288 @@
+#include "VulkanDeviceSelector.h"
+
+#include "GGEngine/Log.h"
+
+#include <algorithm>
+#include <cctype>
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+namespace GGEngine {
+
+    namespace {
+
+        const char* GetTypeName(VkPhysicalDeviceType type)
+        {
+            switch (type)
+            {
+            case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   return "discrete";
+            case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return "integrated";
+            case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    return "virtual";
+            case VK_PHYSICAL_DEVICE_TYPE_CPU:            return "cpu";
+            default:                                     return "other";
+            }
+        }
+
+        // Discrete always beats integrated; memory and features only break ties within a type
+        int64_t GetTypeScore(VkPhysicalDeviceType type)
+        {
+            switch (type)
+            {
+            case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   return 100000;
+            case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return 50000;
+            case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    return 20000;
+            case VK_PHYSICAL_DEVICE_TYPE_CPU:            return 10000;
+            default:                                     return 0;
+            }
+        }
+
+        std::string FormatDriverVersion(const VkPhysicalDeviceProperties& properties)
+        {
+            const uint32_t version = properties.driverVersion;
+            char text[32];
+            if (properties.vendorID == 0x10DE) // NVIDIA: 10.8.8.6 bits
+                snprintf(text, sizeof(text), "%u.%u.%u", version >> 22, (version >> 14) & 0xFF, (version >> 6) & 0xFF);
+#ifdef _WIN32
+            else if (properties.vendorID == 0x8086) // Intel on Windows: 18.14 bits
+                snprintf(text, sizeof(text), "%u.%u", version >> 14, version & 0x3FFF);
+#endif
+            else
+                snprintf(text, sizeof(text), "%u.%u.%u", VK_API_VERSION_MAJOR(version), VK_API_VERSION_MINOR(version), VK_API_VERSION_PATCH(version));
+            return text;
+        }
+
+        std::string FormatBytes(uint64_t bytes)
+        {
+            char text[32];
+            if (bytes >= (1ull << 30))
+                snprintf(text, sizeof(text), "%.1f GiB", bytes / (double)(1ull << 30));
+            else
+                snprintf(text, sizeof(text), "%llu MiB", (unsigned long long)(bytes >> 20));
+            return text;
+        }
+
+        bool HasExtension(const std::vector<VkExtensionProperties>& extensions, const char* name)
+        {
+            for (const VkExtensionProperties& extension : extensions)
+            {
+                if (strcmp(extension.extensionName, name) == 0)
+                    return true;
+            }
+            return false;
+        }
+
+        bool ContainsCaseInsensitive(const std::string& text, const std::string& part)
+        {
+            auto it = std::search(text.begin(), text.end(), part.begin(), part.end(),
+                [](char a, char b) { return std::tolower((unsigned char)a) == std::tolower((unsigned char)b); });
+            return it != text.end();
+        }
+
+    }
+
+    std::vector<VulkanDeviceCandidate> VulkanDeviceSelector::Enumerate(VkInstance instance, uint32_t apiVersion, bool present)
+    {
+        uint32_t count = 0;
+        vkEnumeratePhysicalDevices(instance, &count, nullptr);
+        std::vector<VkPhysicalDevice> devices(count);
+        vkEnumeratePhysicalDevices(instance, &count, devices.data());
+
+        PFN_vkGetPhysicalDeviceFeatures2 getFeatures2 = vkGetPhysicalDeviceFeatures2 ? vkGetPhysicalDeviceFeatures2 : vkGetPhysicalDeviceFeatures2KHR;
+
+        std::vector<VulkanDeviceCandidate> candidates;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            VulkanDeviceCandidate candidate;
+            candidate.Device = devices[i];
+            candidate.Index = i;
+            vkGetPhysicalDeviceProperties(devices[i], &candidate.Properties);
+
+            VkPhysicalDeviceMemoryProperties memory;
+            vkGetPhysicalDeviceMemoryProperties(devices[i], &memory);
+            for (uint32_t h = 0; h < memory.memoryHeapCount; h++)
+            {
+                if (memory.memoryHeaps[h].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+                    candidate.DeviceLocalBytes = std::max(candidate.DeviceLocalBytes, (uint64_t)memory.memoryHeaps[h].size);
+            }
+
+            uint32_t extensionCount = 0;
+            vkEnumerateDeviceExtensionProperties(devices[i], nullptr, &extensionCount, nullptr);
+            std::vector<VkExtensionProperties> extensions(extensionCount);
+            vkEnumerateDeviceExtensionProperties(devices[i], nullptr, &extensionCount, extensions.data());
+
+            // The cull pass dispatches on the graphics queue, so prefer a family doing both
+            uint32_t familyCount = 0;
+            vkGetPhysicalDeviceQueueFamilyProperties(devices[i], &familyCount, nullptr);
+            std::vector<VkQueueFamilyProperties> families(familyCount);
+            vkGetPhysicalDeviceQueueFamilyProperties(devices[i], &familyCount, families.data());
+            bool familyHasCompute = false;
+            for (uint32_t f = 0; f < familyCount; f++)
+            {
+                if (!(families[f].queueFlags & VK_QUEUE_GRAPHICS_BIT))
+                    continue;
+                if (present && !glfwGetPhysicalDevicePresentationSupport(instance, devices[i], f))
+                    continue;
+                const bool compute = (families[f].queueFlags & VK_QUEUE_COMPUTE_BIT) != 0;
+                if (candidate.QueueFamily == UINT32_MAX || (compute && !familyHasCompute))
+                {
+                    candidate.QueueFamily = f;
+                    familyHasCompute = compute;
+                }
+            }
+
+            const uint32_t deviceApi = std::min(apiVersion, candidate.Properties.apiVersion);
+            const bool timelineExtension = HasExtension(extensions, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+            VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures = {};
+            timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+            if (getFeatures2 != nullptr && (deviceApi >= VK_API_VERSION_1_2 || timelineExtension))
+            {
+                VkPhysicalDeviceFeatures2 features2 = {};
+                features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+                features2.pNext = &timelineFeatures;
+                getFeatures2(devices[i], &features2);
+            }
+            VkPhysicalDeviceFeatures features;
+            vkGetPhysicalDeviceFeatures(devices[i], &features);
+
+            if (candidate.QueueFamily == UINT32_MAX)
+                candidate.Rejection = present ? "no graphics queue that can present" : "no graphics queue";
+            else if (timelineFeatures.timelineSemaphore != VK_TRUE)
+                candidate.Rejection = "no timeline semaphores";
+            else if (present && !HasExtension(extensions, VK_KHR_SWAPCHAIN_EXTENSION_NAME))
+                candidate.Rejection = "no VK_KHR_swapchain";
+
+            candidate.Score = GetTypeScore(candidate.Properties.deviceType);
+            candidate.Score += (int64_t)(candidate.DeviceLocalBytes >> 26); // 16 per GiB
+            if (deviceApi >= VK_API_VERSION_1_3 || HasExtension(extensions, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME))
+                candidate.Score += 8;
+            if (HasExtension(extensions, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME) && features.multiDrawIndirect)
+                candidate.Score += 4;
+            if (features.textureCompressionBC)
+                candidate.Score += 4;
+            if (familyHasCompute)
+                candidate.Score += 2;
+            candidates.push_back(std::move(candidate));
+        }
+        return candidates;
+    }
+
+    bool VulkanDeviceSelector::Select(VkInstance instance, uint32_t apiVersion, bool present, const std::string& preference,
+        VkPhysicalDevice& device, uint32_t& queueFamily)
+    {
+        const std::vector<VulkanDeviceCandidate> candidates = Enumerate(instance, apiVersion, present);
+
+        GG_CORE_INFO("Vulkan devices:");
+        const VulkanDeviceCandidate* best = nullptr;
+        for (const VulkanDeviceCandidate& candidate : candidates)
+        {
+            if (candidate.Rejection.empty())
+                GG_CORE_INFO("  [{0}] {1}, {2} device-local, score {3}", candidate.Index, Describe(candidate.Properties), FormatBytes(candidate.DeviceLocalBytes), candidate.Score);
+            else
+                GG_CORE_INFO("  [{0}] {1}, unusable: {2}", candidate.Index, Describe(candidate.Properties), candidate.Rejection);
+            if (candidate.Rejection.empty() && (best == nullptr || candidate.Score > best->Score))
+                best = &candidate;
+        }
+
+        if (!preference.empty())
+        {
+            const bool isIndex = std::all_of(preference.begin(), preference.end(), [](char c) { return std::isdigit((unsigned char)c) != 0; });
+            const VulkanDeviceCandidate* match = nullptr;
+            for (const VulkanDeviceCandidate& candidate : candidates)
+            {
+                if (isIndex ? candidate.Index == (uint32_t)std::strtoul(preference.c_str(), nullptr, 10)
+                            : ContainsCaseInsensitive(candidate.Properties.deviceName, preference))
+                {
+                    match = &candidate;
+                    break;
+                }
+            }
+
+            if (match == nullptr)
+                GG_CORE_WARN("Vulkan: no device matches GPU override \"{0}\", selecting by score", preference);
+            else if (!match->Rejection.empty())
+                GG_CORE_WARN("Vulkan: GPU override \"{0}\" names {1}, which is unusable ({2}); selecting by score", preference, match->Properties.deviceName, match->Rejection);
+            else
+                best = match;
+        }
+
+        if (best == nullptr)
+            return false;
+        device = best->Device;
+        queueFamily = best->QueueFamily;
+        return true;
+    }
+
+    void VulkanDeviceSelector::LogCapabilities(VkPhysicalDevice device)
+    {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(device, &properties);
+        const VkPhysicalDeviceLimits& limits = properties.limits;
+
+        GG_CORE_INFO("Vulkan device: {0}", Describe(properties));
+        GG_CORE_INFO("  Vendor {0:#06x}, device {1:#06x}", properties.vendorID, properties.deviceID);
+        GG_CORE_INFO("  Limits: image2D {0}, compute invocations {1}, shared memory {2} KiB, push constants {3} B",
+            limits.maxImageDimension2D, limits.maxComputeWorkGroupInvocations, limits.maxComputeSharedMemorySize / 1024, limits.maxPushConstantsSize);
+        GG_CORE_INFO("          storage range {0}, uniform range {1}, bound sets {2}, draw indirect count {3}, anisotropy {4}",
+            FormatBytes(limits.maxStorageBufferRange), limits.maxUniformBufferRange, limits.maxBoundDescriptorSets, limits.maxDrawIndirectCount, limits.maxSamplerAnisotropy);
+        GG_CORE_INFO("          timestamp period {0} ns, non-coherent atom {1} B, buffer image granularity {2} B",
+            limits.timestampPeriod, limits.nonCoherentAtomSize, limits.bufferImageGranularity);
+
+        VkPhysicalDeviceMemoryProperties memory;
+        vkGetPhysicalDeviceMemoryProperties(device, &memory);
+        for (uint32_t h = 0; h < memory.memoryHeapCount; h++)
+        {
+            std::string types;
+            for (uint32_t t = 0; t < memory.memoryTypeCount; t++)
+            {
+                if (memory.memoryTypes[t].heapIndex != h)
+                    continue;
+                const VkMemoryPropertyFlags flags = memory.memoryTypes[t].propertyFlags;
+                types += " [";
+                types += (flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) ? "D" : "-";
+                types += (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) ? "V" : "-";
+                types += (flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) ? "C" : "-";
+                types += (flags & VK_MEMORY_PROPERTY_HOST_CACHED_BIT) ? "H" : "-";
+                types += "]";
+            }
+            GG_CORE_INFO("  Heap {0}: {1}{2}, types{3}", h, FormatBytes(memory.memoryHeaps[h].size),
+                (memory.memoryHeaps[h].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? " device-local" : "", types);
+        }
+
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, families.data());
+        for (uint32_t f = 0; f < familyCount; f++)
+        {
+            const VkQueueFlags flags = families[f].queueFlags;
+            GG_CORE_INFO("  Queue family {0}: {1} queue(s){2}{3}{4}{5}, timestamp bits {6}", f, families[f].queueCount,
+                (flags & VK_QUEUE_GRAPHICS_BIT) ? " graphics" : "", (flags & VK_QUEUE_COMPUTE_BIT) ? " compute" : "",
+                (flags & VK_QUEUE_TRANSFER_BIT) ? " transfer" : "", (flags & VK_QUEUE_SPARSE_BINDING_BIT) ? " sparse" : "",
+                families[f].timestampValidBits);
+        }
+
+        uint32_t extensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> extensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, extensions.data());
+        std::string names;
+        for (const VkExtensionProperties& extension : extensions)
+        {
+            if (!names.empty())
+                names += ' ';
+            names += extension.extensionName;
+        }
+        GG_CORE_INFO("  {0} extensions: {1}", extensionCount, names);
+    }
+
+    std::string VulkanDeviceSelector::Describe(const VkPhysicalDeviceProperties& properties)
+    {
+        char text[512];
+        snprintf(text, sizeof(text), "%s (%s, driver %s, Vulkan %u.%u.%u)", properties.deviceName, GetTypeName(properties.deviceType),
+            FormatDriverVersion(properties).c_str(), VK_API_VERSION_MAJOR(properties.apiVersion), VK_API_VERSION_MINOR(properties.apiVersion),
+            VK_API_VERSION_PATCH(properties.apiVersion));
+        return text;
+    }
+
+}
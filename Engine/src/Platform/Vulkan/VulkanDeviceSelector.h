@@ -0,0 +1,41 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+namespace GGEngine {
+
+    struct VulkanDeviceCandidate
+    {
+        VkPhysicalDevice Device = VK_NULL_HANDLE;
+        uint32_t Index = 0; // In enumeration order, what --gpu=N refers to
+        VkPhysicalDeviceProperties Properties = {};
+        uint64_t DeviceLocalBytes = 0; // Largest device-local heap
+        uint32_t QueueFamily = UINT32_MAX;
+        int64_t Score = 0;
+        std::string Rejection; // Empty when the engine can run on the device
+    };
+
+    // Picks the GPU instead of taking the first discrete one: devices missing something the
+    // engine requires (a graphics queue, timeline semaphores, presentation) are rejected, the
+    // rest are scored by type, then device-local memory, then optional features.
+    class VulkanDeviceSelector
+    {
+    public:
+        // preference: empty for the best score, a device index, or part of a device name
+        // (case-insensitive). An override naming an unusable or unknown device is reported
+        // and scoring decides instead. Returns false when no device is usable.
+        static bool Select(VkInstance instance, uint32_t apiVersion, bool present, const std::string& preference,
+            VkPhysicalDevice& device, uint32_t& queueFamily);
+
+        // Every device with its score or rejection reason
+        static std::vector<VulkanDeviceCandidate> Enumerate(VkInstance instance, uint32_t apiVersion, bool present);
+
+        // Logs identity, driver, limits, memory heaps, queue families and extensions, so
+        // performance reports carry the hardware context
+        static void LogCapabilities(VkPhysicalDevice device);
+
+        // "Name (type, driver x.y.z, Vulkan a.b.c)"
+        static std::string Describe(const VkPhysicalDeviceProperties& properties);
+    };
+
+}
@@ -0,0 +1,496 @@
+#include "VulkanGPUCulling.h"
+
+#include "VulkanContext.h"
+#include "GGEngine/GPUCulling.h"
+
+namespace GGEngine {
+
+    static const char* s_CullShaderPath = "assets/shaders/GPUCull.comp";
+    static constexpr uint32_t s_CullGroupSize = 64; // local_size_x of the shader
+
+    // Push constants of GPUCull.comp
+    struct CullConstants
+    {
+        float Planes[6][4];
+        uint32_t ObjectCount;
+        uint32_t Compact;
+    };
+
+    static GPUDrawObject ToDrawObject(const GPUCullObject& object)
+    {
+        GPUDrawObject drawObject;
+        drawObject.Center[0] = object.Center.x;
+        drawObject.Center[1] = object.Center.y;
+        drawObject.Center[2] = object.Center.z;
+        drawObject.Radius = object.Radius;
+        drawObject.IndexCount = object.IndexCount;
+        drawObject.FirstIndex = object.FirstIndex;
+        drawObject.VertexOffset = object.VertexOffset;
+        return drawObject;
+    }
+
+    uint32_t GPUCulling::AddObject(const GPUCullObject& object)
+    {
+        return VulkanContext::Get().GetGPUCuller().AddObject(ToDrawObject(object));
+    }
+
+    void GPUCulling::UpdateObject(uint32_t handle, const GPUCullObject& object)
+    {
+        VulkanContext::Get().GetGPUCuller().UpdateObject(handle, ToDrawObject(object));
+    }
+
+    void GPUCulling::RemoveObject(uint32_t handle)
+    {
+        VulkanContext::Get().GetGPUCuller().RemoveObject(handle);
+    }
+
+    void GPUCulling::SetViewProjection(const Mat4& viewProjection)
+    {
+        VulkanContext::Get().GetGPUCuller().SetViewProjection(viewProjection.Data);
+    }
+
+    bool GPUCulling::GetVisibleCount(uint32_t& count)
+    {
+        const VulkanGPUCuller& culler = VulkanContext::Get().GetGPUCuller();
+        if (!culler.IsCompacting() || culler.GetStats().VisibleReadbacks == 0)
+            return false;
+        count = culler.GetStats().Visible;
+        return true;
+    }
+
+    void VulkanGPUCuller::Init(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator, uint32_t frameCount, uint32_t maxObjects)
+    {
+        m_Device = device;
+        m_PhysicalDevice = physicalDevice;
+        m_Allocator = allocator;
+        m_FrameCount = frameCount;
+
+        // The object index travels as firstInstance, so that one is required
+        VulkanContext& context = VulkanContext::Get();
+        m_Supported = context.SupportsDrawIndirectFirstInstance();
+        m_Compact = context.SupportsDrawIndirectCount() && context.SupportsMultiDrawIndirect();
+        m_MultiDraw = context.SupportsMultiDrawIndirect();
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(m_PhysicalDevice, &properties);
+        m_MaxObjects = m_MultiDraw ? std::min(maxObjects, properties.limits.maxDrawIndirectCount) : maxObjects;
+    }
+
+    void VulkanGPUCuller::Shutdown()
+    {
+        DestroyFrames();
+        DestroyBuffer(m_ObjectBuffer);
+        if (m_Pipeline != VK_NULL_HANDLE)
+            vkDestroyPipeline(m_Device, m_Pipeline, m_Allocator);
+        if (m_PipelineLayout != VK_NULL_HANDLE)
+            vkDestroyPipelineLayout(m_Device, m_PipelineLayout, m_Allocator);
+        if (m_SetLayout != VK_NULL_HANDLE)
+            vkDestroyDescriptorSetLayout(m_Device, m_SetLayout, m_Allocator);
+        m_Pipeline = VK_NULL_HANDLE;
+        m_PipelineLayout = VK_NULL_HANDLE;
+        m_SetLayout = VK_NULL_HANDLE;
+        m_Shader.reset();
+        m_VisibleReadbacks.clear();
+
+        m_Objects.clear();
+        m_ObjectCount = 0;
+        m_FreeIndices.clear();
+        m_Dirty.clear();
+        m_DirtyFlags.clear();
+    }
+
+    void VulkanGPUCuller::SetFrameCount(uint32_t frameCount)
+    {
+        if (frameCount == m_FrameCount)
+            return;
+        m_FrameCount = frameCount;
+        if (m_Frames.empty())
+            return;
+        DestroyFrames();
+        CreateFrames(frameCount);
+    }
+
+    uint32_t VulkanGPUCuller::AddObject(const GPUDrawObject& object)
+    {
+        if (!m_Supported)
+        {
+            GG_CORE_ERROR("[Vulkan] GPU culling needs indirect draws with a first instance");
+            return UINT32_MAX;
+        }
+
+        uint32_t index;
+        if (!m_FreeIndices.empty())
+        {
+            index = m_FreeIndices.back();
+            m_FreeIndices.pop_back();
+        }
+        else if (m_ObjectCount < m_MaxObjects)
+        {
+            index = m_ObjectCount++;
+            m_Objects.emplace_back();
+            m_DirtyFlags.push_back(0);
+        }
+        else
+        {
+            GG_CORE_ERROR("[Vulkan] GPU culling object limit ({0}) reached", m_MaxObjects);
+            return UINT32_MAX;
+        }
+
+        if (m_ObjectBuffer.Handle == VK_NULL_HANDLE)
+            CreateResources();
+        UpdateObject(index, object);
+        return index;
+    }
+
+    void VulkanGPUCuller::UpdateObject(uint32_t index, const GPUDrawObject& object)
+    {
+        GG_CORE_ASSERT(index < m_ObjectCount, "GPU cull object index out of range");
+        m_Objects[index] = object;
+        if (!m_DirtyFlags[index])
+        {
+            m_DirtyFlags[index] = 1;
+            m_Dirty.push_back(index);
+        }
+    }
+
+    void VulkanGPUCuller::RemoveObject(uint32_t index)
+    {
+        UpdateObject(index, GPUDrawObject());
+        m_FreeIndices.push_back(index);
+    }
+
+    void VulkanGPUCuller::SetViewProjection(const float viewProjection[16])
+    {
+        // Gribb-Hartmann: planes are sums of the matrix rows; 0..1 depth makes near row 2 alone
+        auto row = [viewProjection](int r, int c) { return viewProjection[c * 4 + r]; };
+        for (int c = 0; c < 4; c++)
+        {
+            m_Planes[0][c] = row(3, c) + row(0, c); // Left
+            m_Planes[1][c] = row(3, c) - row(0, c); // Right
+            m_Planes[2][c] = row(3, c) + row(1, c); // Bottom
+            m_Planes[3][c] = row(3, c) - row(1, c); // Top
+            m_Planes[4][c] = row(2, c);             // Near
+            m_Planes[5][c] = row(3, c) - row(2, c); // Far
+        }
+        for (float* plane : m_Planes)
+        {
+            const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            if (length > 0.0f)
+            {
+                for (int c = 0; c < 4; c++)
+                    plane[c] /= length;
+            }
+        }
+    }
+
+    void VulkanGPUCuller::Update()
+    {
+        if (!m_Shader || !m_Shader->IsReady() || m_Shader->GetVersion() == m_ShaderVersion)
+            return;
+        CreatePipeline();
+    }
+
+    GPUCullOutput VulkanGPUCuller::AddPasses(VulkanRenderGraph& graph)
+    {
+        GPUCullOutput output;
+        if (!IsReady())
+            return output;
+
+        while (!m_VisibleReadbacks.empty() && m_VisibleReadbacks.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            std::vector<uint8_t> bytes = m_VisibleReadbacks.front().get();
+            if (bytes.size() >= sizeof(uint32_t))
+            {
+                memcpy(&m_Stats.Visible, bytes.data(), sizeof(uint32_t));
+                m_Stats.VisibleReadbacks++;
+            }
+            m_VisibleReadbacks.pop_front();
+        }
+        m_Stats.Objects = m_ObjectCount;
+        if (!m_Compact)
+            m_Stats.Visible = m_ObjectCount;
+
+        // The frame slot's previous submission has completed, so its staging buffer is free.
+        // Changed objects are packed in index order; consecutive indices share a copy region.
+        VulkanContext& context = VulkanContext::Get();
+        Frame& frame = m_Frames[context.GetFrameIndex()];
+        std::vector<VkBufferCopy> regions;
+        std::sort(m_Dirty.begin(), m_Dirty.end());
+        GPUDrawObject* staged = static_cast<GPUDrawObject*>(frame.Staging.Mapped);
+        for (uint32_t i = 0; i < (uint32_t)m_Dirty.size(); i++)
+        {
+            const uint32_t index = m_Dirty[i];
+            staged[i] = m_Objects[index];
+            m_DirtyFlags[index] = 0;
+            const VkDeviceSize dstOffset = (VkDeviceSize)index * sizeof(GPUDrawObject);
+            if (!regions.empty() && regions.back().dstOffset + regions.back().size == dstOffset)
+                regions.back().size += sizeof(GPUDrawObject);
+            else
+                regions.push_back({ (VkDeviceSize)i * sizeof(GPUDrawObject), dstOffset, sizeof(GPUDrawObject) });
+        }
+        m_Stats.Uploaded = (uint32_t)m_Dirty.size();
+        m_Dirty.clear();
+
+        // Last frame's cull may still be reading the objects this frame's upload overwrites
+        const RenderGraphResource objects = graph.ImportBuffer("GPUCullObjects", { m_ObjectBuffer.Handle, m_ObjectBuffer.Size }, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        output.Draws = graph.ImportBuffer("GPUCullDraws", { frame.Draws.Handle, frame.Draws.Size });
+        if (m_Compact)
+            output.Count = graph.ImportBuffer("GPUCullCount", { frame.Count.Handle, frame.Count.Size });
+
+        // Declared even when nothing changed: a steady topology keeps the compiled graph cached
+        graph.AddPass("GPUCullUpload",
+            [&](RenderGraphBuilder& builder)
+            {
+                builder.Write(objects, RenderGraphUsage::TransferDst);
+                if (m_Compact)
+                    builder.Write(output.Count, RenderGraphUsage::TransferDst);
+            },
+            [this, &frame, regions](RenderGraphPassContext& context)
+            {
+                if (!regions.empty())
+                    vkCmdCopyBuffer(context.GetCommandBuffer(), frame.Staging.Handle, m_ObjectBuffer.Handle, (uint32_t)regions.size(), regions.data());
+                if (m_Compact)
+                    vkCmdFillBuffer(context.GetCommandBuffer(), frame.Count.Handle, 0, sizeof(uint32_t), 0);
+            });
+
+        graph.AddPass("GPUCull",
+            [&](RenderGraphBuilder& builder)
+            {
+                builder.Read(objects, RenderGraphUsage::StorageReadCompute);
+                builder.Write(output.Draws, RenderGraphUsage::StorageWriteCompute);
+                if (m_Compact)
+                    builder.Write(output.Count, RenderGraphUsage::StorageWriteCompute);
+            },
+            [this, &frame](RenderGraphPassContext& context)
+            {
+                CullConstants constants;
+                memcpy(constants.Planes, m_Planes, sizeof(m_Planes));
+                constants.ObjectCount = m_ObjectCount;
+                constants.Compact = m_Compact ? 1 : 0;
+
+                VkCommandBuffer commandBuffer = context.GetCommandBuffer();
+                vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline);
+                vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1, &frame.DescriptorSet, 0, nullptr);
+                vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+                vkCmdDispatch(commandBuffer, (m_ObjectCount + s_CullGroupSize - 1) / s_CullGroupSize, 1, 1);
+            });
+
+        if (m_Compact)
+        {
+            graph.AddPass("GPUCullStats",
+                [&](RenderGraphBuilder& builder)
+                {
+                    builder.Read(output.Count, RenderGraphUsage::TransferSrc);
+                    builder.SetSideEffects();
+                },
+                [this, &frame](RenderGraphPassContext& context)
+                {
+                    m_VisibleReadbacks.push_back(VulkanContext::Get().GetReadback().ReadBuffer(context.GetCommandBuffer(), frame.Count.Handle, 0, sizeof(uint32_t)));
+                });
+        }
+
+        return output;
+    }
+
+    void VulkanGPUCuller::RecordDraws(VkCommandBuffer commandBuffer) const
+    {
+        if (!IsReady())
+            return;
+
+        VulkanContext& context = VulkanContext::Get();
+        const Frame& frame = m_Frames[context.GetFrameIndex()];
+        const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+        if (m_Compact)
+        {
+            context.CmdDrawIndexedIndirectCount(commandBuffer, frame.Draws.Handle, 0, frame.Count.Handle, 0, m_ObjectCount, stride);
+        }
+        else if (m_MultiDraw)
+        {
+            vkCmdDrawIndexedIndirect(commandBuffer, frame.Draws.Handle, 0, m_ObjectCount, stride);
+        }
+        else
+        {
+            for (uint32_t i = 0; i < m_ObjectCount; i++)
+                vkCmdDrawIndexedIndirect(commandBuffer, frame.Draws.Handle, (VkDeviceSize)i * stride, 1, stride);
+        }
+    }
+
+    void VulkanGPUCuller::CreateResources()
+    {
+        m_ObjectBuffer = CreateBuffer((VkDeviceSize)m_MaxObjects * sizeof(GPUDrawObject),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        VkDescriptorSetLayoutBinding bindings[3] = {};
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            bindings[i].binding = i;
+            bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+        VkDescriptorSetLayoutCreateInfo setLayoutInfo = {};
+        setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        setLayoutInfo.bindingCount = 3;
+        setLayoutInfo.pBindings = bindings;
+        VkResult err = vkCreateDescriptorSetLayout(m_Device, &setLayoutInfo, m_Allocator, &m_SetLayout);
+        VulkanContext::CheckVkResult(err);
+
+        VkPushConstantRange pushConstants = {};
+        pushConstants.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstants.size = sizeof(CullConstants);
+        VkPipelineLayoutCreateInfo layoutInfo = {};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutInfo.setLayoutCount = 1;
+        layoutInfo.pSetLayouts = &m_SetLayout;
+        layoutInfo.pushConstantRangeCount = 1;
+        layoutInfo.pPushConstantRanges = &pushConstants;
+        err = vkCreatePipelineLayout(m_Device, &layoutInfo, m_Allocator, &m_PipelineLayout);
+        VulkanContext::CheckVkResult(err);
+
+        CreateFrames(m_FrameCount);
+
+        ShaderSource source;
+        source.Path = s_CullShaderPath;
+        m_Shader = VulkanContext::Get().GetShaderLibrary().Load(source);
+    }
+
+    VulkanGPUCuller::Buffer VulkanGPUCuller::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
+    {
+        Buffer buffer;
+        buffer.Size = size;
+
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        VkResult err = vkCreateBuffer(m_Device, &bufferInfo, m_Allocator, &buffer.Handle);
+        VulkanContext::CheckVkResult(err);
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(m_Device, buffer.Handle, &requirements);
+        VkMemoryAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = requirements.size;
+        allocInfo.memoryTypeIndex = VulkanContext::Get().FindMemoryType(requirements.memoryTypeBits, properties);
+        err = vkAllocateMemory(m_Device, &allocInfo, m_Allocator, &buffer.Memory);
+        VulkanContext::CheckVkResult(err);
+        err = vkBindBufferMemory(m_Device, buffer.Handle, buffer.Memory, 0);
+        VulkanContext::CheckVkResult(err);
+
+        if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            err = vkMapMemory(m_Device, buffer.Memory, 0, VK_WHOLE_SIZE, 0, &buffer.Mapped);
+            VulkanContext::CheckVkResult(err);
+        }
+        return buffer;
+    }
+
+    void VulkanGPUCuller::DestroyBuffer(Buffer& buffer)
+    {
+        if (buffer.Handle != VK_NULL_HANDLE)
+            vkDestroyBuffer(m_Device, buffer.Handle, m_Allocator);
+        if (buffer.Memory != VK_NULL_HANDLE)
+            vkFreeMemory(m_Device, buffer.Memory, m_Allocator);
+        buffer = Buffer();
+    }
+
+    void VulkanGPUCuller::CreateFrames(uint32_t frameCount)
+    {
+        VkDescriptorPoolSize poolSize = { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 * frameCount };
+        VkDescriptorPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.maxSets = frameCount;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        VkResult err = vkCreateDescriptorPool(m_Device, &poolInfo, m_Allocator, &m_DescriptorPool);
+        VulkanContext::CheckVkResult(err);
+
+        m_Frames.resize(frameCount);
+        for (Frame& frame : m_Frames)
+        {
+            frame.Staging = CreateBuffer((VkDeviceSize)m_MaxObjects * sizeof(GPUDrawObject), VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            frame.Draws = CreateBuffer((VkDeviceSize)m_MaxObjects * sizeof(VkDrawIndexedIndirectCommand),
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            frame.Count = CreateBuffer(sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+                | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+            VkDescriptorSetAllocateInfo allocInfo = {};
+            allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocInfo.descriptorPool = m_DescriptorPool;
+            allocInfo.descriptorSetCount = 1;
+            allocInfo.pSetLayouts = &m_SetLayout;
+            err = vkAllocateDescriptorSets(m_Device, &allocInfo, &frame.DescriptorSet);
+            VulkanContext::CheckVkResult(err);
+
+            VkDescriptorBufferInfo bufferInfos[3] =
+            {
+                { m_ObjectBuffer.Handle, 0, VK_WHOLE_SIZE },
+                { frame.Draws.Handle, 0, VK_WHOLE_SIZE },
+                { frame.Count.Handle, 0, VK_WHOLE_SIZE },
+            };
+            VkWriteDescriptorSet writes[3] = {};
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                writes[i].dstSet = frame.DescriptorSet;
+                writes[i].dstBinding = i;
+                writes[i].descriptorCount = 1;
+                writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                writes[i].pBufferInfo = &bufferInfos[i];
+            }
+            vkUpdateDescriptorSets(m_Device, 3, writes, 0, nullptr);
+        }
+    }
+
+    void VulkanGPUCuller::DestroyFrames()
+    {
+        for (Frame& frame : m_Frames)
+        {
+            DestroyBuffer(frame.Staging);
+            DestroyBuffer(frame.Draws);
+            DestroyBuffer(frame.Count);
+        }
+        m_Frames.clear();
+        if (m_DescriptorPool != VK_NULL_HANDLE)
+            vkDestroyDescriptorPool(m_Device, m_DescriptorPool, m_Allocator);
+        m_DescriptorPool = VK_NULL_HANDLE;
+
+        // Counts being read back may belong to destroyed frames
+        m_VisibleReadbacks.clear();
+    }
+
+    void VulkanGPUCuller::CreatePipeline()
+    {
+        VkComputePipelineCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        info.stage.module = m_Shader->GetModule();
+        info.stage.pName = m_Shader->GetSource().EntryPoint.c_str();
+        info.layout = m_PipelineLayout;
+
+        // A failed build waits for the next reload instead of retrying every frame
+        m_ShaderVersion = m_Shader->GetVersion();
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VulkanContext& context = VulkanContext::Get();
+        VkResult err = vkCreateComputePipelines(m_Device, context.GetPipelineCache().GetHandle(), 1, &info, m_Allocator, &pipeline);
+        if (err != VK_SUCCESS)
+        {
+            GG_CORE_ERROR("[Vulkan] Failed to create the GPU cull pipeline ({0})", (int)err);
+            return;
+        }
+
+        // Frames in flight may still be dispatching with the previous pipeline
+        if (m_Pipeline != VK_NULL_HANDLE)
+        {
+            VkDevice device = m_Device;
+            VkPipeline oldPipeline = m_Pipeline;
+            const VkAllocationCallbacks* allocator = m_Allocator;
+            context.DeferDestroy([device, oldPipeline, allocator]() { vkDestroyPipeline(device, oldPipeline, allocator); });
+        }
+        m_Pipeline = pipeline;
+    }
+
+}
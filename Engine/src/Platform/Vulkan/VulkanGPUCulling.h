@@ -0,0 +1,137 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+#include "VulkanRenderGraph.h"
+#include "VulkanShader.h"
+
+#include <future>
+
+namespace GGEngine {
+
+    // One drawable as the cull shader sees it (std430). A draw is an indexed range of the
+    // caller's bound index/vertex buffers, bounded by a world-space sphere.
+    struct GPUDrawObject
+    {
+        float Center[3] = { 0.0f, 0.0f, 0.0f };
+        float Radius = 0.0f;
+        uint32_t IndexCount = 0; // 0 disables the object
+        uint32_t FirstIndex = 0;
+        int32_t VertexOffset = 0;
+        uint32_t Reserved = 0;
+    };
+
+    struct GPUCullStats
+    {
+        uint32_t Objects = 0;
+        uint32_t Visible = 0;  // From a frame or more ago; objects when not compacting
+        uint32_t Uploaded = 0; // Objects copied to the GPU last frame
+        uint32_t VisibleReadbacks = 0; // Visible counts received from the GPU so far
+    };
+
+    // Graph resources the cull passes produced this frame. Passes issuing the draws read
+    // them as RenderGraphUsage::IndirectBuffer.
+    struct GPUCullOutput
+    {
+        RenderGraphResource Draws = RenderGraphNullResource;
+        RenderGraphResource Count = RenderGraphNullResource; // Null without draw indirect count
+    };
+
+    // GPU-driven draw submission. Objects live in a device-local storage buffer that only
+    // receives the objects changed since the last frame; a compute pass tests every object
+    // against the view frustum and appends visible ones to an indirect buffer, which the
+    // main pass consumes with a single vkCmdDrawIndexedIndirectCount. CPU cost per frame
+    // does not depend on the object count. Without draw indirect count every object keeps
+    // its own indirect command and culled ones get an instance count of 0.
+    // The object index arrives as gl_InstanceIndex, for per-object data in vertex shaders.
+    // Main thread only.
+    class VulkanGPUCuller
+    {
+    public:
+        void Init(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator, uint32_t frameCount, uint32_t maxObjects);
+        // The device must be idle
+        void Shutdown();
+        // Per-frame buffers follow the swapchain image count; the device must be idle
+        void SetFrameCount(uint32_t frameCount);
+
+        // Returns the object's index, or UINT32_MAX when the buffer is full
+        uint32_t AddObject(const GPUDrawObject& object);
+        void UpdateObject(uint32_t index, const GPUDrawObject& object);
+        void RemoveObject(uint32_t index);
+        uint32_t GetObjectCount() const { return m_ObjectCount; }
+
+        // Column-major, clip = viewProjection * world, Vulkan depth range
+        void SetViewProjection(const float viewProjection[16]);
+
+        // Frame boundary, after the shader library: (re)builds the cull pipeline
+        void Update();
+        // The cull pipeline is built and there is something to draw
+        bool IsReady() const { return m_Pipeline != VK_NULL_HANDLE && m_ObjectCount > 0; }
+
+        // Declares the upload, cull and statistics passes for the current frame slot
+        GPUCullOutput AddPasses(VulkanRenderGraph& graph);
+        // Records the indirect draws for the current frame slot. The caller binds the pipeline,
+        // vertex and index buffers; inside the main pass, from a render callback.
+        void RecordDraws(VkCommandBuffer commandBuffer) const;
+
+        const GPUCullStats& GetStats() const { return m_Stats; }
+        // Visible objects are compacted and counted on the GPU (draw indirect count)
+        bool IsCompacting() const { return m_Compact; }
+
+    private:
+        struct Buffer
+        {
+            VkBuffer Handle = VK_NULL_HANDLE;
+            VkDeviceMemory Memory = VK_NULL_HANDLE;
+            VkDeviceSize Size = 0;
+            void* Mapped = nullptr;
+        };
+
+        // Everything a frame in flight writes
+        struct Frame
+        {
+            Buffer Staging; // Changed objects, host-visible
+            Buffer Draws;
+            Buffer Count;
+            VkDescriptorSet DescriptorSet = VK_NULL_HANDLE;
+        };
+
+        // Buffers and descriptors are only created with the first object
+        void CreateResources();
+        Buffer CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+        void DestroyBuffer(Buffer& buffer);
+        void CreateFrames(uint32_t frameCount);
+        void DestroyFrames();
+        void CreatePipeline();
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* m_Allocator = nullptr;
+        bool m_Supported = false;
+        bool m_Compact = false;   // Draw indirect count is available
+        bool m_MultiDraw = false; // Otherwise one vkCmdDrawIndexedIndirect per object
+        uint32_t m_FrameCount = 0;
+
+        uint32_t m_MaxObjects = 0;
+        std::vector<GPUDrawObject> m_Objects;
+        uint32_t m_ObjectCount = 0; // Highest used index + 1
+        std::vector<uint32_t> m_FreeIndices;
+        std::vector<uint32_t> m_Dirty;
+        std::vector<uint8_t> m_DirtyFlags;
+        float m_Planes[6][4] = {};
+
+        Buffer m_ObjectBuffer;
+        std::vector<Frame> m_Frames;
+        VkDescriptorPool m_DescriptorPool = VK_NULL_HANDLE;
+        VkDescriptorSetLayout m_SetLayout = VK_NULL_HANDLE;
+        VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+        VkPipeline m_Pipeline = VK_NULL_HANDLE;
+        std::shared_ptr<VulkanShader> m_Shader;
+        uint32_t m_ShaderVersion = 0;
+
+        std::deque<std::future<std::vector<uint8_t>>> m_VisibleReadbacks; // Oldest first
+        GPUCullStats m_Stats;
+    };
+
+}
@@ -0,0 +1,163 @@
+#include "VulkanHostAllocator.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace GGEngine {
+
+    namespace {
+
+        // Sits directly in front of every block handed to the driver
+        struct AllocationHeader
+        {
+            void* Base;      // What malloc returned
+            size_t Size;
+            size_t Alignment;
+            uint32_t Scope;
+        };
+
+    }
+
+    uint64_t VulkanHostAllocationStats::GetLiveBytes() const
+    {
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < ScopeCount; i++)
+            total += LiveBytes[i];
+        return total;
+    }
+
+    uint64_t VulkanHostAllocationStats::GetFrameAllocations() const
+    {
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < ScopeCount; i++)
+            total += FrameAllocations[i];
+        return total;
+    }
+
+    uint64_t VulkanHostAllocationStats::GetFrameBytes() const
+    {
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < ScopeCount; i++)
+            total += FrameBytes[i];
+        return total;
+    }
+
+    const char* VulkanHostAllocationStats::GetScopeName(uint32_t scope)
+    {
+        switch (scope)
+        {
+        case VK_SYSTEM_ALLOCATION_SCOPE_COMMAND:  return "command";
+        case VK_SYSTEM_ALLOCATION_SCOPE_OBJECT:   return "object";
+        case VK_SYSTEM_ALLOCATION_SCOPE_CACHE:    return "cache";
+        case VK_SYSTEM_ALLOCATION_SCOPE_DEVICE:   return "device";
+        case VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE: return "instance";
+        default:                                  return "unknown";
+        }
+    }
+
+    VulkanHostAllocator::VulkanHostAllocator()
+    {
+        m_Callbacks.pUserData = this;
+        m_Callbacks.pfnAllocation = Allocate;
+        m_Callbacks.pfnReallocation = Reallocate;
+        m_Callbacks.pfnFree = Free;
+        m_Callbacks.pfnInternalAllocation = InternalAllocate;
+        m_Callbacks.pfnInternalFree = InternalFree;
+    }
+
+    VulkanHostAllocationStats VulkanHostAllocator::EndFrame()
+    {
+        VulkanHostAllocationStats stats;
+        for (uint32_t i = 0; i < ScopeCount; i++)
+        {
+            stats.LiveBytes[i] = m_LiveBytes[i].load(std::memory_order_relaxed);
+            stats.LiveAllocations[i] = m_LiveAllocations[i].load(std::memory_order_relaxed);
+            stats.FrameAllocations[i] = m_FrameAllocations[i].exchange(0, std::memory_order_relaxed);
+            stats.FrameBytes[i] = m_FrameBytes[i].exchange(0, std::memory_order_relaxed);
+        }
+        stats.FrameFrees = m_FrameFrees.exchange(0, std::memory_order_relaxed);
+        stats.InternalBytes = m_InternalBytes.load(std::memory_order_relaxed);
+        m_LastFrame = stats;
+        return stats;
+    }
+
+    void* VulkanHostAllocator::AllocateTracked(size_t size, size_t alignment, VkSystemAllocationScope scope)
+    {
+        if (size == 0)
+            return nullptr;
+
+        // Vulkan alignments are powers of two; the header keeps its own alignment as well
+        alignment = std::max(alignment, alignof(AllocationHeader));
+        void* base = std::malloc(size + alignment + sizeof(AllocationHeader));
+        if (base == nullptr)
+            return nullptr;
+
+        const uintptr_t start = (uintptr_t)base + sizeof(AllocationHeader);
+        void* memory = (void*)((start + alignment - 1) & ~(uintptr_t)(alignment - 1));
+        AllocationHeader* header = (AllocationHeader*)memory - 1;
+        header->Base = base;
+        header->Size = size;
+        header->Alignment = alignment;
+        header->Scope = scope < ScopeCount ? (uint32_t)scope : 0;
+
+        m_LiveBytes[header->Scope].fetch_add(size, std::memory_order_relaxed);
+        m_LiveAllocations[header->Scope].fetch_add(1, std::memory_order_relaxed);
+        m_FrameAllocations[header->Scope].fetch_add(1, std::memory_order_relaxed);
+        m_FrameBytes[header->Scope].fetch_add(size, std::memory_order_relaxed);
+        return memory;
+    }
+
+    void VulkanHostAllocator::FreeTracked(void* memory)
+    {
+        if (memory == nullptr)
+            return;
+
+        const AllocationHeader* header = (const AllocationHeader*)memory - 1;
+        m_LiveBytes[header->Scope].fetch_sub(header->Size, std::memory_order_relaxed);
+        m_LiveAllocations[header->Scope].fetch_sub(1, std::memory_order_relaxed);
+        m_FrameFrees.fetch_add(1, std::memory_order_relaxed);
+        std::free(header->Base);
+    }
+
+    void* VKAPI_PTR VulkanHostAllocator::Allocate(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope)
+    {
+        return ((VulkanHostAllocator*)userData)->AllocateTracked(size, alignment, scope);
+    }
+
+    void* VKAPI_PTR VulkanHostAllocator::Reallocate(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope)
+    {
+        VulkanHostAllocator* allocator = (VulkanHostAllocator*)userData;
+        if (original == nullptr)
+            return allocator->AllocateTracked(size, alignment, scope);
+        if (size == 0)
+        {
+            allocator->FreeTracked(original);
+            return nullptr;
+        }
+
+        // On failure the original block must stay valid, so allocate before freeing
+        const AllocationHeader* header = (const AllocationHeader*)original - 1;
+        void* memory = allocator->AllocateTracked(size, alignment, scope);
+        if (memory == nullptr)
+            return nullptr;
+        std::memcpy(memory, original, std::min(size, header->Size));
+        allocator->FreeTracked(original);
+        return memory;
+    }
+
+    void VKAPI_PTR VulkanHostAllocator::Free(void* userData, void* memory)
+    {
+        ((VulkanHostAllocator*)userData)->FreeTracked(memory);
+    }
+
+    void VKAPI_PTR VulkanHostAllocator::InternalAllocate(void* userData, size_t size, VkInternalAllocationType, VkSystemAllocationScope)
+    {
+        ((VulkanHostAllocator*)userData)->m_InternalBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void VKAPI_PTR VulkanHostAllocator::InternalFree(void* userData, size_t size, VkInternalAllocationType, VkSystemAllocationScope)
+    {
+        ((VulkanHostAllocator*)userData)->m_InternalBytes.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+}
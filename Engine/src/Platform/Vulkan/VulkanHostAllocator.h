@@ -0,0 +1,66 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+namespace GGEngine {
+
+    struct VulkanHostAllocationStats
+    {
+        // Indexed by VkSystemAllocationScope
+        static constexpr uint32_t ScopeCount = VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1;
+
+        uint64_t LiveBytes[ScopeCount] = {};
+        uint64_t LiveAllocations[ScopeCount] = {};
+        // Since the previous EndFrame
+        uint64_t FrameAllocations[ScopeCount] = {};
+        uint64_t FrameBytes[ScopeCount] = {};
+        uint64_t FrameFrees = 0;
+        uint64_t InternalBytes = 0; // Executable memory and the like, reported but not owned
+
+        uint64_t GetLiveBytes() const;
+        uint64_t GetFrameAllocations() const;
+        uint64_t GetFrameBytes() const;
+
+        static const char* GetScopeName(uint32_t scope);
+    };
+
+    // VkAllocationCallbacks that route the driver's host allocations through the engine and
+    // account for them by VkSystemAllocationScope. Shows how much host memory the driver
+    // holds and, more importantly, whether it allocates while frames are recorded; a
+    // steady-state frame should not allocate at all. Drivers call in from any thread.
+    class VulkanHostAllocator
+    {
+    public:
+        VulkanHostAllocator();
+
+        // Must outlive every object created with it, the instance included
+        VkAllocationCallbacks* GetCallbacks() { return &m_Callbacks; }
+
+        // Snapshot of the live totals and the current frame's counters, which then restart
+        VulkanHostAllocationStats EndFrame();
+        const VulkanHostAllocationStats& GetLastFrame() const { return m_LastFrame; }
+
+    private:
+        static void* VKAPI_PTR Allocate(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope);
+        static void* VKAPI_PTR Reallocate(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope);
+        static void VKAPI_PTR Free(void* userData, void* memory);
+        static void VKAPI_PTR InternalAllocate(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+        static void VKAPI_PTR InternalFree(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+
+        void* AllocateTracked(size_t size, size_t alignment, VkSystemAllocationScope scope);
+        void FreeTracked(void* memory);
+
+    private:
+        static constexpr uint32_t ScopeCount = VulkanHostAllocationStats::ScopeCount;
+
+        VkAllocationCallbacks m_Callbacks = {};
+        std::atomic<uint64_t> m_LiveBytes[ScopeCount] = {};
+        std::atomic<uint64_t> m_LiveAllocations[ScopeCount] = {};
+        std::atomic<uint64_t> m_FrameAllocations[ScopeCount] = {};
+        std::atomic<uint64_t> m_FrameBytes[ScopeCount] = {};
+        std::atomic<uint64_t> m_FrameFrees{ 0 };
+        std::atomic<uint64_t> m_InternalBytes{ 0 };
+        VulkanHostAllocationStats m_LastFrame;
+    };
+
+}
@@ -0,0 +1,600 @@
+#include "VulkanImGuiRenderer.h"
+
+#include "VulkanContext.h"
+#include "GGEngine/Hash.h"
+
+#include "imgui.h"
+#include "imgui_impl_vulkan.h"
+
+namespace GGEngine {
+
+    static const char* s_VertexShaderPath = "assets/shaders/ImGui.vert";
+    static const char* s_FragmentShaderPath = "assets/shaders/ImGui.frag";
+    static constexpr VkDeviceSize s_MinArenaSize = 1024 * 1024;
+    static constexpr VkDeviceSize s_MinRingRegionSize = 256 * 1024;
+    static constexpr VkDeviceSize s_RangeAlignment = 16;
+
+    // Push constants of ImGui.vert
+    struct ImGuiConstants
+    {
+        float Scale[2];
+        float Translate[2];
+    };
+
+    static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    static VkDeviceSize GrowSize(VkDeviceSize current, VkDeviceSize minimum, VkDeviceSize required)
+    {
+        VkDeviceSize size = std::max(current, minimum);
+        while (size < required)
+            size *= 2;
+        return size;
+    }
+
+    static uint64_t HashList(const ImDrawList* list)
+    {
+        uint64_t hash = Hash::Fast64(list->VtxBuffer.Data, (size_t)list->VtxBuffer.Size * sizeof(ImDrawVert));
+        hash = Hash::Fast64(list->IdxBuffer.Data, (size_t)list->IdxBuffer.Size * sizeof(ImDrawIdx), hash);
+        for (const ImDrawCmd& cmd : list->CmdBuffer)
+        {
+            hash = Hash::Value(cmd.ClipRect, hash);
+            hash = Hash::Value(cmd.UserCallback != nullptr ? ImTextureID_Invalid : cmd.GetTexID(), hash);
+            hash = Hash::Value(cmd.VtxOffset, hash);
+            hash = Hash::Value(cmd.IdxOffset, hash);
+            hash = Hash::Value(cmd.ElemCount, hash);
+            hash = Hash::Value(cmd.UserCallback, hash);
+        }
+        return hash;
+    }
+
+    void VulkanImGuiRenderer::Init(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator, uint32_t frameCount,
+        VkRenderPass renderPass, VkFormat colorFormat)
+    {
+        m_Device = device;
+        m_PhysicalDevice = physicalDevice;
+        m_Allocator = allocator;
+        m_FrameCount = frameCount;
+
+        CreatePipelineLayout();
+
+        VulkanContext& context = VulkanContext::Get();
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = context.GetQueueFamily();
+        VkResult err = vkCreateCommandPool(m_Device, &poolInfo, m_Allocator, &m_CommandPool);
+        VulkanContext::CheckVkResult(err);
+
+        ShaderSource vertexSource;
+        vertexSource.Path = s_VertexShaderPath;
+        m_VertexShader = context.GetShaderLibrary().Load(vertexSource);
+        ShaderSource fragmentSource;
+        fragmentSource.Path = s_FragmentShaderPath;
+        m_FragmentShader = context.GetShaderLibrary().Load(fragmentSource);
+
+        // Same state as the backend's pipeline
+        GraphicsPipelineDesc desc;
+        desc.VertexShader = m_VertexShader;
+        desc.FragmentShader = m_FragmentShader;
+        desc.Layout = m_PipelineLayout;
+        desc.VertexBindings = { { 0, (uint32_t)sizeof(ImDrawVert), VK_VERTEX_INPUT_RATE_VERTEX } };
+        desc.VertexAttributes =
+        {
+            { 0, 0, VK_FORMAT_R32G32_SFLOAT, (uint32_t)offsetof(ImDrawVert, pos) },
+            { 1, 0, VK_FORMAT_R32G32_SFLOAT, (uint32_t)offsetof(ImDrawVert, uv) },
+            { 2, 0, VK_FORMAT_R8G8B8A8_UNORM, (uint32_t)offsetof(ImDrawVert, col) },
+        };
+        desc.BlendEnable = true;
+        desc.ColorFormats = { colorFormat };
+        desc.RenderPass = renderPass;
+        m_PipelineHash = context.GetPipelineCache().Declare(desc);
+    }
+
+    void VulkanImGuiRenderer::Shutdown()
+    {
+        DestroyBuffer(m_Arena);
+        DestroyBuffer(m_UploadRing);
+        m_RingRegionSize = 0;
+        m_FreeRanges.clear();
+        m_RetiredRanges.clear();
+        m_Copies.clear();
+
+        // Frees every command buffer allocated from it
+        if (m_CommandPool != VK_NULL_HANDLE)
+            vkDestroyCommandPool(m_Device, m_CommandPool, m_Allocator);
+        m_CommandPool = VK_NULL_HANDLE;
+        m_FreeCommandBuffers.clear();
+        m_RetiredCommandBuffers.clear();
+        m_Lists.clear();
+        m_FrameLists.clear();
+        m_Secondaries.clear();
+
+        if (m_PipelineLayout != VK_NULL_HANDLE)
+            vkDestroyPipelineLayout(m_Device, m_PipelineLayout, m_Allocator);
+        if (m_SetLayout != VK_NULL_HANDLE)
+            vkDestroyDescriptorSetLayout(m_Device, m_SetLayout, m_Allocator);
+        m_PipelineLayout = VK_NULL_HANDLE;
+        m_SetLayout = VK_NULL_HANDLE;
+        m_VertexShader.reset();
+        m_FragmentShader.reset();
+        m_Pipeline = VK_NULL_HANDLE;
+    }
+
+    bool VulkanImGuiRenderer::Prepare(ImDrawData* drawData, const VkCommandBufferInheritanceInfo& inheritance)
+    {
+        m_Stats = ImGuiRendererStats();
+        m_Secondaries.clear();
+        m_Copies.clear();
+
+        VulkanContext& context = VulkanContext::Get();
+        m_Pipeline = context.GetPipelineCache().Get(m_PipelineHash);
+        if (m_Pipeline == VK_NULL_HANDLE)
+            return false;
+
+        m_Stats.Active = true;
+        m_FrameCounter++;
+        ReleaseCompleted();
+        if (m_Arena.Handle == VK_NULL_HANDLE)
+            GrowArena(s_MinArenaSize);
+
+        // Descriptor sets must exist before command lists reference their texture IDs
+        UpdateTextures(drawData);
+
+        // Everything a recording depends on besides the list itself
+        uint64_t frameKey = Hash::Value(drawData->DisplayPos);
+        frameKey = Hash::Value(drawData->DisplaySize, frameKey);
+        frameKey = Hash::Value(drawData->FramebufferScale, frameKey);
+        frameKey = Hash::Value(m_Pipeline, frameKey);
+        frameKey = Hash::Value(m_ArenaGeneration, frameKey);
+        frameKey = Hash::Value(inheritance.renderPass, frameKey);
+
+        m_FrameLists.clear();
+        VkDeviceSize frameBytes = 0;
+        for (const ImDrawList* list : drawData->CmdLists)
+        {
+            CachedList& cached = m_Lists[list];
+            cached.LastUsedFrame = m_FrameCounter;
+            m_FrameLists.push_back({ list, &cached });
+
+            const uint64_t hash = HashList(list);
+            if (cached.CommandBuffer == VK_NULL_HANDLE || hash != cached.ContentHash)
+                cached.NeedsUpload = true;
+            cached.ContentHash = hash;
+
+            cached.HasCallbacks = false;
+            for (const ImDrawCmd& cmd : list->CmdBuffer)
+                cached.HasCallbacks |= cmd.UserCallback != nullptr && cmd.UserCallback != ImDrawCallback_ResetRenderState;
+
+            frameBytes += AlignUp(AlignUp((VkDeviceSize)list->VtxBuffer.Size * sizeof(ImDrawVert), 4) + (VkDeviceSize)list->IdxBuffer.Size * sizeof(ImDrawIdx), s_RangeAlignment);
+        }
+
+        // Lists that were not submitted this frame (closed or hidden windows) give their space back
+        const uint64_t lastSubmitted = context.GetTimeline().GetLastSubmittedValue();
+        for (auto it = m_Lists.begin(); it != m_Lists.end();)
+        {
+            if (it->second.LastUsedFrame == m_FrameCounter)
+            {
+                ++it;
+                continue;
+            }
+            if (it->second.Allocation.Size > 0)
+                m_RetiredRanges.push_back({ lastSubmitted, it->second.Allocation });
+            if (it->second.CommandBuffer != VK_NULL_HANDLE)
+                m_RetiredCommandBuffers.push_back({ lastSubmitted, it->second.CommandBuffer });
+            it = m_Lists.erase(it);
+        }
+
+        // Changed lists move to a fresh range: the old one may still be read by frames in flight.
+        // When the arena is full it is replaced, and every list uploads into the new one.
+        for (int attempt = 0; attempt < 2; attempt++)
+        {
+            bool allocated = true;
+            for (auto& [list, entry] : m_FrameLists)
+            {
+                CachedList& cached = *entry;
+                if (!cached.NeedsUpload)
+                    continue;
+
+                if (cached.Allocation.Size > 0)
+                    m_RetiredRanges.push_back({ lastSubmitted, cached.Allocation });
+                cached.Allocation = Range();
+                cached.IndexOffset = AlignUp((VkDeviceSize)list->VtxBuffer.Size * sizeof(ImDrawVert), 4);
+                const VkDeviceSize size = AlignUp(cached.IndexOffset + (VkDeviceSize)list->IdxBuffer.Size * sizeof(ImDrawIdx), s_RangeAlignment);
+                if (size > 0 && !Allocate(size, cached.Allocation))
+                {
+                    allocated = false;
+                    break;
+                }
+            }
+            if (allocated)
+                break;
+            GrowArena(GrowSize(m_Arena.Size * 2, s_MinArenaSize, frameBytes * 2));
+        }
+
+        // One bulk copy into the arena: changed lists are packed into this frame slot's ring
+        // region in the same layout as their arena ranges
+        VkDeviceSize uploadBytes = 0;
+        for (const auto& [list, cached] : m_FrameLists)
+        {
+            if (cached->NeedsUpload)
+                uploadBytes += cached->Allocation.Size;
+        }
+        EnsureUploadRing(uploadBytes);
+
+        const VkDeviceSize regionOffset = (VkDeviceSize)context.GetFrameIndex() * m_RingRegionSize;
+        uint8_t* region = static_cast<uint8_t*>(m_UploadRing.Mapped) + regionOffset;
+        VkDeviceSize ringOffset = 0;
+        for (const auto& [list, entry] : m_FrameLists)
+        {
+            const CachedList& cached = *entry;
+            if (!cached.NeedsUpload || cached.Allocation.Size == 0)
+                continue;
+
+            memcpy(region + ringOffset, list->VtxBuffer.Data, (size_t)list->VtxBuffer.Size * sizeof(ImDrawVert));
+            memcpy(region + ringOffset + cached.IndexOffset, list->IdxBuffer.Data, (size_t)list->IdxBuffer.Size * sizeof(ImDrawIdx));
+
+            const VkDeviceSize srcOffset = regionOffset + ringOffset;
+            if (!m_Copies.empty() && m_Copies.back().srcOffset + m_Copies.back().size == srcOffset
+                && m_Copies.back().dstOffset + m_Copies.back().size == cached.Allocation.Offset)
+                m_Copies.back().size += cached.Allocation.Size;
+            else
+                m_Copies.push_back({ srcOffset, cached.Allocation.Offset, cached.Allocation.Size });
+            ringOffset += cached.Allocation.Size;
+        }
+        m_Stats.UploadedBytes = uploadBytes;
+
+        // Unchanged lists recorded against the same frame state re-execute as they are.
+        // Secondaries are recorded with simultaneous use, as frames in flight may still execute them.
+        for (auto& [list, entry] : m_FrameLists)
+        {
+            CachedList& cached = *entry;
+            if (cached.NeedsUpload || cached.HasCallbacks || cached.RecordedKey != frameKey)
+            {
+                RecordList(list, cached, drawData, inheritance);
+                cached.RecordedKey = frameKey;
+                m_Stats.RecordedLists++;
+            }
+            else
+            {
+                m_Stats.ReusedLists++;
+            }
+            cached.NeedsUpload = false;
+            m_Secondaries.push_back(cached.CommandBuffer);
+        }
+        m_Stats.Lists = (uint32_t)m_Secondaries.size();
+        m_Stats.GeometryBytes = m_Arena.Size;
+        return true;
+    }
+
+    RenderGraphResource VulkanImGuiRenderer::AddPasses(VulkanRenderGraph& graph)
+    {
+        // Ranges being written were released only after the frames reading them completed,
+        // so nothing before the graph needs to be waited for
+        const RenderGraphResource arena = graph.ImportBuffer("ImGuiGeometry", { m_Arena.Handle, m_Arena.Size });
+
+        // Declared even when nothing changed: a steady topology keeps the compiled graph cached
+        graph.AddPass("ImGuiUpload",
+            [arena](RenderGraphBuilder& builder)
+            {
+                builder.Write(arena, RenderGraphUsage::TransferDst);
+            },
+            [this](RenderGraphPassContext& context)
+            {
+                if (!m_Copies.empty())
+                    vkCmdCopyBuffer(context.GetCommandBuffer(), m_UploadRing.Handle, m_Arena.Handle, (uint32_t)m_Copies.size(), m_Copies.data());
+            });
+        return arena;
+    }
+
+    void VulkanImGuiRenderer::Execute(VkCommandBuffer primary) const
+    {
+        if (!m_Secondaries.empty())
+            vkCmdExecuteCommands(primary, (uint32_t)m_Secondaries.size(), m_Secondaries.data());
+    }
+
+    void VulkanImGuiRenderer::CreatePipelineLayout()
+    {
+        // Identical to the backend's texture set layout, so its descriptor sets (ImTextureIDs)
+        // bind to this pipeline layout
+        VkDescriptorSetLayoutBinding binding = {};
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        VkDescriptorSetLayoutCreateInfo setLayoutInfo = {};
+        setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        setLayoutInfo.bindingCount = 1;
+        setLayoutInfo.pBindings = &binding;
+        VkResult err = vkCreateDescriptorSetLayout(m_Device, &setLayoutInfo, m_Allocator, &m_SetLayout);
+        VulkanContext::CheckVkResult(err);
+
+        VkPushConstantRange pushConstants = {};
+        pushConstants.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushConstants.size = sizeof(ImGuiConstants);
+        VkPipelineLayoutCreateInfo layoutInfo = {};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutInfo.setLayoutCount = 1;
+        layoutInfo.pSetLayouts = &m_SetLayout;
+        layoutInfo.pushConstantRangeCount = 1;
+        layoutInfo.pPushConstantRanges = &pushConstants;
+        err = vkCreatePipelineLayout(m_Device, &layoutInfo, m_Allocator, &m_PipelineLayout);
+        VulkanContext::CheckVkResult(err);
+    }
+
+    void VulkanImGuiRenderer::UpdateTextures(ImDrawData* drawData)
+    {
+        if (drawData->Textures == nullptr)
+            return;
+        for (ImTextureData* texture : *drawData->Textures)
+        {
+            if (texture->Status != ImTextureStatus_OK)
+                ImGui_ImplVulkan_UpdateTexture(texture);
+        }
+    }
+
+    bool VulkanImGuiRenderer::Allocate(VkDeviceSize size, Range& range)
+    {
+        for (auto it = m_FreeRanges.begin(); it != m_FreeRanges.end(); ++it)
+        {
+            if (it->Size < size)
+                continue;
+            range = { it->Offset, size };
+            it->Offset += size;
+            it->Size -= size;
+            if (it->Size == 0)
+                m_FreeRanges.erase(it);
+            return true;
+        }
+        return false;
+    }
+
+    void VulkanImGuiRenderer::Free(const Range& range)
+    {
+        // Kept sorted and coalesced with both neighbours
+        auto next = std::lower_bound(m_FreeRanges.begin(), m_FreeRanges.end(), range.Offset,
+            [](const Range& free, VkDeviceSize offset) { return free.Offset < offset; });
+        auto it = m_FreeRanges.insert(next, range);
+        if (it + 1 != m_FreeRanges.end() && it->Offset + it->Size == (it + 1)->Offset)
+        {
+            it->Size += (it + 1)->Size;
+            m_FreeRanges.erase(it + 1);
+        }
+        if (it != m_FreeRanges.begin() && (it - 1)->Offset + (it - 1)->Size == it->Offset)
+        {
+            (it - 1)->Size += it->Size;
+            m_FreeRanges.erase(it);
+        }
+    }
+
+    void VulkanImGuiRenderer::GrowArena(VkDeviceSize size)
+    {
+        RetireBuffer(m_Arena);
+        m_Arena = CreateBuffer(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        m_FreeRanges = { { 0, size } };
+        m_RetiredRanges.clear();
+        m_ArenaGeneration++;
+
+        for (auto& entry : m_Lists)
+        {
+            entry.second.Allocation = Range();
+            entry.second.NeedsUpload = true;
+        }
+        GG_CORE_TRACE("[Vulkan] ImGui geometry arena: {0} KB", size / 1024);
+    }
+
+    void VulkanImGuiRenderer::EnsureUploadRing(VkDeviceSize frameBytes)
+    {
+        if (m_UploadRing.Handle != VK_NULL_HANDLE && frameBytes <= m_RingRegionSize)
+            return;
+
+        // Other regions may still be read by frames in flight
+        RetireBuffer(m_UploadRing);
+        m_RingRegionSize = GrowSize(m_RingRegionSize * 2, s_MinRingRegionSize, frameBytes);
+        m_UploadRing = CreateBuffer(m_RingRegionSize * m_FrameCount, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    }
+
+    void VulkanImGuiRenderer::ReleaseCompleted()
+    {
+        if (m_RetiredRanges.empty() && m_RetiredCommandBuffers.empty())
+            return;
+
+        const uint64_t completed = VulkanContext::Get().GetTimeline().GetCompletedValue();
+        auto ranges = std::partition(m_RetiredRanges.begin(), m_RetiredRanges.end(),
+            [completed](const std::pair<uint64_t, Range>& entry) { return entry.first > completed; });
+        for (auto it = ranges; it != m_RetiredRanges.end(); ++it)
+            Free(it->second);
+        m_RetiredRanges.erase(ranges, m_RetiredRanges.end());
+
+        auto buffers = std::partition(m_RetiredCommandBuffers.begin(), m_RetiredCommandBuffers.end(),
+            [completed](const std::pair<uint64_t, VkCommandBuffer>& entry) { return entry.first > completed; });
+        for (auto it = buffers; it != m_RetiredCommandBuffers.end(); ++it)
+            m_FreeCommandBuffers.push_back(it->second);
+        m_RetiredCommandBuffers.erase(buffers, m_RetiredCommandBuffers.end());
+    }
+
+    VkCommandBuffer VulkanImGuiRenderer::AcquireCommandBuffer()
+    {
+        if (!m_FreeCommandBuffers.empty())
+        {
+            VkCommandBuffer commandBuffer = m_FreeCommandBuffers.back();
+            m_FreeCommandBuffers.pop_back();
+            return commandBuffer;
+        }
+
+        VkCommandBufferAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = m_CommandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+        VkCommandBuffer commandBuffer;
+        VkResult err = vkAllocateCommandBuffers(m_Device, &allocInfo, &commandBuffer);
+        VulkanContext::CheckVkResult(err);
+        return commandBuffer;
+    }
+
+    void VulkanImGuiRenderer::RecordList(const ImDrawList* list, CachedList& cached, ImDrawData* drawData, const VkCommandBufferInheritanceInfo& inheritance)
+    {
+        // The previous recording may be pending in frames in flight; it is reused once they finish
+        if (cached.CommandBuffer != VK_NULL_HANDLE)
+            m_RetiredCommandBuffers.push_back({ VulkanContext::Get().GetTimeline().GetLastSubmittedValue(), cached.CommandBuffer });
+        cached.CommandBuffer = AcquireCommandBuffer();
+        VkCommandBuffer commandBuffer = cached.CommandBuffer;
+
+        // Beginning implicitly resets it; the pool allows individual resets
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+        beginInfo.pInheritanceInfo = &inheritance;
+        VkResult err = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        VulkanContext::CheckVkResult(err);
+
+        SetupRenderState(commandBuffer, cached, drawData);
+
+        // Project clip rectangles into framebuffer space
+        const ImVec2 clipOffset = drawData->DisplayPos;
+        const ImVec2 clipScale = drawData->FramebufferScale;
+        const float framebufferWidth = drawData->DisplaySize.x * clipScale.x;
+        const float framebufferHeight = drawData->DisplaySize.y * clipScale.y;
+
+        ImGui_ImplVulkan_RenderState renderState;
+        renderState.CommandBuffer = commandBuffer;
+        renderState.Pipeline = m_Pipeline;
+        renderState.PipelineLayout = m_PipelineLayout;
+
+        VkDescriptorSet boundSet = VK_NULL_HANDLE;
+        for (const ImDrawCmd& cmd : list->CmdBuffer)
+        {
+            if (cmd.UserCallback != nullptr)
+            {
+                if (cmd.UserCallback == ImDrawCallback_ResetRenderState)
+                {
+                    SetupRenderState(commandBuffer, cached, drawData);
+                }
+                else
+                {
+                    ImGuiPlatformIO& platformIO = ImGui::GetPlatformIO();
+                    platformIO.Renderer_RenderState = &renderState;
+                    cmd.UserCallback(list, &cmd);
+                    platformIO.Renderer_RenderState = nullptr;
+                }
+                boundSet = VK_NULL_HANDLE;
+                continue;
+            }
+
+            const float minX = std::max((cmd.ClipRect.x - clipOffset.x) * clipScale.x, 0.0f);
+            const float minY = std::max((cmd.ClipRect.y - clipOffset.y) * clipScale.y, 0.0f);
+            const float maxX = std::min((cmd.ClipRect.z - clipOffset.x) * clipScale.x, framebufferWidth);
+            const float maxY = std::min((cmd.ClipRect.w - clipOffset.y) * clipScale.y, framebufferHeight);
+            if (maxX <= minX || maxY <= minY)
+                continue;
+
+            VkRect2D scissor;
+            scissor.offset = { (int32_t)minX, (int32_t)minY };
+            scissor.extent = { (uint32_t)(maxX - minX), (uint32_t)(maxY - minY) };
+            vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+            VkDescriptorSet set = (VkDescriptorSet)cmd.GetTexID();
+            if (set != boundSet)
+            {
+                vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1, &set, 0, nullptr);
+                boundSet = set;
+            }
+            vkCmdDrawIndexed(commandBuffer, cmd.ElemCount, 1, cmd.IdxOffset, (int32_t)cmd.VtxOffset, 0);
+        }
+
+        err = vkEndCommandBuffer(commandBuffer);
+        VulkanContext::CheckVkResult(err);
+    }
+
+    void VulkanImGuiRenderer::SetupRenderState(VkCommandBuffer commandBuffer, const CachedList& cached, ImDrawData* drawData) const
+    {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
+        if (cached.Allocation.Size > 0)
+        {
+            const VkDeviceSize vertexOffset = cached.Allocation.Offset;
+            vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_Arena.Handle, &vertexOffset);
+            vkCmdBindIndexBuffer(commandBuffer, m_Arena.Handle, cached.Allocation.Offset + cached.IndexOffset,
+                sizeof(ImDrawIdx) == 2 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32);
+        }
+
+        // Dynamic state is not inherited by secondary command buffers
+        VkViewport viewport = {};
+        viewport.width = drawData->DisplaySize.x * drawData->FramebufferScale.x;
+        viewport.height = drawData->DisplaySize.y * drawData->FramebufferScale.y;
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+        // Display space to clip space
+        ImGuiConstants constants;
+        constants.Scale[0] = 2.0f / drawData->DisplaySize.x;
+        constants.Scale[1] = 2.0f / drawData->DisplaySize.y;
+        constants.Translate[0] = -1.0f - drawData->DisplayPos.x * constants.Scale[0];
+        constants.Translate[1] = -1.0f - drawData->DisplayPos.y * constants.Scale[1];
+        vkCmdPushConstants(commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+    }
+
+    VulkanImGuiRenderer::Buffer VulkanImGuiRenderer::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
+    {
+        Buffer buffer;
+        buffer.Size = size;
+
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        VkResult err = vkCreateBuffer(m_Device, &bufferInfo, m_Allocator, &buffer.Handle);
+        VulkanContext::CheckVkResult(err);
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(m_Device, buffer.Handle, &requirements);
+        VkMemoryAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = requirements.size;
+        allocInfo.memoryTypeIndex = VulkanContext::Get().FindMemoryType(requirements.memoryTypeBits, properties);
+        err = vkAllocateMemory(m_Device, &allocInfo, m_Allocator, &buffer.Memory);
+        VulkanContext::CheckVkResult(err);
+        err = vkBindBufferMemory(m_Device, buffer.Handle, buffer.Memory, 0);
+        VulkanContext::CheckVkResult(err);
+
+        // Mapped for the buffer's whole lifetime
+        if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            err = vkMapMemory(m_Device, buffer.Memory, 0, VK_WHOLE_SIZE, 0, &buffer.Mapped);
+            VulkanContext::CheckVkResult(err);
+        }
+        return buffer;
+    }
+
+    void VulkanImGuiRenderer::RetireBuffer(Buffer& buffer)
+    {
+        if (buffer.Handle == VK_NULL_HANDLE)
+            return;
+
+        VkDevice device = m_Device;
+        VkBuffer handle = buffer.Handle;
+        VkDeviceMemory memory = buffer.Memory;
+        const VkAllocationCallbacks* allocator = m_Allocator;
+        VulkanContext::Get().DeferDestroy([device, handle, memory, allocator]()
+        {
+            vkDestroyBuffer(device, handle, allocator);
+            vkFreeMemory(device, memory, allocator);
+        });
+        buffer = Buffer();
+    }
+
+    void VulkanImGuiRenderer::DestroyBuffer(Buffer& buffer)
+    {
+        if (buffer.Handle != VK_NULL_HANDLE)
+            vkDestroyBuffer(m_Device, buffer.Handle, m_Allocator);
+        if (buffer.Memory != VK_NULL_HANDLE)
+            vkFreeMemory(m_Device, buffer.Memory, m_Allocator);
+        buffer = Buffer();
+    }
+
+}
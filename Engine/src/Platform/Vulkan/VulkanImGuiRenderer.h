@@ -0,0 +1,131 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+#include "VulkanRenderGraph.h"
+#include "VulkanShader.h"
+
+struct ImDrawData;
+struct ImDrawList;
+
+namespace GGEngine {
+
+    struct ImGuiRendererStats
+    {
+        bool Active = false;        // False while the backend renders in its place
+        uint32_t Lists = 0;
+        uint32_t ReusedLists = 0;   // Neither uploaded nor recorded this frame
+        uint32_t RecordedLists = 0;
+        uint64_t UploadedBytes = 0;
+        uint64_t GeometryBytes = 0; // Capacity of the device-local geometry arena
+    };
+
+    // Renders the main window's ImGui draw data in place of ImGui_ImplVulkan_RenderDrawData,
+    // which reallocates its vertex/index buffers as they grow and re-uploads every list
+    // every frame. Each ImDrawList owns a range of a device-local geometry arena and a
+    // secondary command buffer. Lists are hashed every frame: changed ones are written to
+    // this frame slot's region of a persistently mapped upload ring and reach the arena
+    // with a single vkCmdCopyBuffer; unchanged ones, most editor panels on most frames,
+    // keep their GPU data and re-execute last frame's secondary as is.
+    // Textures still come from the ImGui Vulkan backend. Main thread only.
+    class VulkanImGuiRenderer
+    {
+    public:
+        void Init(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator, uint32_t frameCount,
+            VkRenderPass renderPass, VkFormat colorFormat);
+        // The device must be idle
+        void Shutdown();
+
+        // Uploads changed lists and (re)records the secondaries for the current frame slot.
+        // inheritance describes the main pass (framebuffer left null, so recordings survive
+        // swapchain rebuilds). Returns false while the pipeline is not ready; the caller
+        // then falls back to ImGui_ImplVulkan_RenderDrawData.
+        bool Prepare(ImDrawData* drawData, const VkCommandBufferInheritanceInfo& inheritance);
+
+        // Declares the upload pass; the returned arena is read by the pass that calls Execute
+        RenderGraphResource AddPasses(VulkanRenderGraph& graph);
+        // Inside the main pass, begun with secondary command buffer contents
+        void Execute(VkCommandBuffer primary) const;
+
+        const ImGuiRendererStats& GetStats() const { return m_Stats; }
+
+    private:
+        struct Buffer
+        {
+            VkBuffer Handle = VK_NULL_HANDLE;
+            VkDeviceMemory Memory = VK_NULL_HANDLE;
+            VkDeviceSize Size = 0;
+            void* Mapped = nullptr;
+        };
+
+        struct Range
+        {
+            VkDeviceSize Offset = 0;
+            VkDeviceSize Size = 0;
+        };
+
+        struct CachedList
+        {
+            uint64_t ContentHash = 0;
+            Range Allocation;             // Vertices, then indices at IndexOffset
+            VkDeviceSize IndexOffset = 0;
+            VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+            uint64_t RecordedKey = 0;     // Frame state the secondary was recorded against
+            uint64_t LastUsedFrame = 0;
+            bool HasCallbacks = false;    // User callbacks run while recording, so every frame
+            bool NeedsUpload = false;
+        };
+
+        Buffer CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+        // Defers destruction past the frames that may still use it
+        void RetireBuffer(Buffer& buffer);
+        void DestroyBuffer(Buffer& buffer);
+
+        void CreatePipelineLayout();
+        void UpdateTextures(ImDrawData* drawData);
+        // First fit; false when the arena is full
+        bool Allocate(VkDeviceSize size, Range& range);
+        void Free(const Range& range);
+        // Replaces the arena with one of at least size bytes; every list uploads again
+        void GrowArena(VkDeviceSize size);
+        void EnsureUploadRing(VkDeviceSize frameBytes);
+        void ReleaseCompleted();
+
+        VkCommandBuffer AcquireCommandBuffer();
+        void RecordList(const ImDrawList* list, CachedList& cached, ImDrawData* drawData, const VkCommandBufferInheritanceInfo& inheritance);
+        void SetupRenderState(VkCommandBuffer commandBuffer, const CachedList& cached, ImDrawData* drawData) const;
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* m_Allocator = nullptr;
+        uint32_t m_FrameCount = 0;
+
+        VkDescriptorSetLayout m_SetLayout = VK_NULL_HANDLE;
+        VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+        std::shared_ptr<VulkanShader> m_VertexShader;
+        std::shared_ptr<VulkanShader> m_FragmentShader;
+        uint64_t m_PipelineHash = 0;
+        VkPipeline m_Pipeline = VK_NULL_HANDLE; // This frame's, from the pipeline cache
+
+        Buffer m_Arena;
+        uint32_t m_ArenaGeneration = 0;
+        std::vector<Range> m_FreeRanges;                        // Sorted by offset
+        std::vector<std::pair<uint64_t, Range>> m_RetiredRanges; // Free once the timeline value completes
+
+        Buffer m_UploadRing;            // m_FrameCount regions of m_RingRegionSize bytes
+        VkDeviceSize m_RingRegionSize = 0;
+        std::vector<VkBufferCopy> m_Copies;
+
+        VkCommandPool m_CommandPool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> m_FreeCommandBuffers;
+        std::vector<std::pair<uint64_t, VkCommandBuffer>> m_RetiredCommandBuffers;
+
+        std::unordered_map<const ImDrawList*, CachedList> m_Lists;
+        std::vector<std::pair<const ImDrawList*, CachedList*>> m_FrameLists; // This frame's, in draw order
+        std::vector<VkCommandBuffer> m_Secondaries;
+        uint64_t m_FrameCounter = 0;
+        ImGuiRendererStats m_Stats;
+    };
+
+}
@@ -0,0 +1,108 @@
+#include "VulkanImage.h"
+
+#include "VulkanContext.h"
+
+namespace GGEngine {
+
+    VulkanImage::~VulkanImage()
+    {
+        Destroy();
+    }
+
+    void VulkanImage::Create(const VulkanImageSpec& spec)
+    {
+        Destroy();
+        m_Spec = spec;
+
+        VulkanContext& context = VulkanContext::Get();
+        VkDevice device = context.GetDevice();
+        const VkAllocationCallbacks* allocator = context.GetAllocator();
+
+        VkImageCreateInfo imageInfo = {};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = spec.Format;
+        imageInfo.extent = { spec.Width, spec.Height, 1 };
+        imageInfo.mipLevels = spec.MipLevels;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = spec.Samples;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = spec.Usage;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkResult err = vkCreateImage(device, &imageInfo, allocator, &m_Image);
+        VulkanContext::CheckVkResult(err);
+
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(device, m_Image, &requirements);
+
+        VkMemoryAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = requirements.size;
+        allocInfo.memoryTypeIndex = context.FindMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        err = vkAllocateMemory(device, &allocInfo, allocator, &m_Memory);
+        VulkanContext::CheckVkResult(err);
+        err = vkBindImageMemory(device, m_Image, m_Memory, 0);
+        VulkanContext::CheckVkResult(err);
+
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = m_Image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = spec.Format;
+        viewInfo.subresourceRange.aspectMask = spec.Aspect;
+        viewInfo.subresourceRange.levelCount = spec.MipLevels;
+        viewInfo.subresourceRange.layerCount = 1;
+        err = vkCreateImageView(device, &viewInfo, allocator, &m_View);
+        VulkanContext::CheckVkResult(err);
+
+        m_Layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    }
+
+    void VulkanImage::Destroy()
+    {
+        if (m_Image == VK_NULL_HANDLE)
+            return;
+
+        VulkanContext& context = VulkanContext::Get();
+        VkDevice device = context.GetDevice();
+        const VkAllocationCallbacks* allocator = context.GetAllocator();
+
+        vkDestroyImageView(device, m_View, allocator);
+        vkDestroyImage(device, m_Image, allocator);
+        vkFreeMemory(device, m_Memory, allocator);
+        m_View = VK_NULL_HANDLE;
+        m_Image = VK_NULL_HANDLE;
+        m_Memory = VK_NULL_HANDLE;
+    }
+
+    void VulkanImage::TransitionLayout(VkCommandBuffer commandBuffer, VkImageLayout newLayout,
+        VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+        VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+    {
+        RecordBarrier(commandBuffer, m_Image, m_Spec.Aspect, m_Layout, newLayout, srcStage, srcAccess, dstStage, dstAccess, m_Spec.MipLevels);
+        m_Layout = newLayout;
+    }
+
+    void VulkanImage::RecordBarrier(VkCommandBuffer commandBuffer, VkImage image, VkImageAspectFlags aspect,
+        VkImageLayout oldLayout, VkImageLayout newLayout,
+        VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+        VkPipelineStageFlags dstStage, VkAccessFlags dstAccess,
+        uint32_t mipLevels)
+    {
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = aspect;
+        barrier.subresourceRange.levelCount = mipLevels;
+        barrier.subresourceRange.layerCount = 1;
+        vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+}
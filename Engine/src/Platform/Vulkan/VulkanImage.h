@@ -0,0 +1,65 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+namespace GGEngine {
+
+    struct VulkanImageSpec
+    {
+        uint32_t Width = 1;
+        uint32_t Height = 1;
+        VkFormat Format = VK_FORMAT_R8G8B8A8_UNORM;
+        VkImageUsageFlags Usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        VkImageAspectFlags Aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        uint32_t MipLevels = 1;
+        VkSampleCountFlagBits Samples = VK_SAMPLE_COUNT_1_BIT;
+    };
+
+    // Device-local 2D image with a full view. Used for offscreen attachments that
+    // are not tied to a render pass: with dynamic rendering any of these can be bound
+    // as a color or depth target directly.
+    class VulkanImage
+    {
+    public:
+        VulkanImage() = default;
+        ~VulkanImage();
+
+        VulkanImage(const VulkanImage&) = delete;
+        VulkanImage& operator=(const VulkanImage&) = delete;
+
+        void Create(const VulkanImageSpec& spec);
+        void Destroy();
+
+        bool IsValid() const { return m_Image != VK_NULL_HANDLE; }
+
+        VkImage GetImage() const { return m_Image; }
+        VkImageView GetView() const { return m_View; }
+        VkFormat GetFormat() const { return m_Spec.Format; }
+        VkExtent2D GetExtent() const { return { m_Spec.Width, m_Spec.Height }; }
+        const VulkanImageSpec& GetSpec() const { return m_Spec; }
+
+        // Last layout recorded through TransitionLayout
+        VkImageLayout GetLayout() const { return m_Layout; }
+        // For layout changes recorded outside TransitionLayout (e.g. per-mip barriers)
+        void SetLayout(VkImageLayout layout) { m_Layout = layout; }
+
+        void TransitionLayout(VkCommandBuffer commandBuffer, VkImageLayout newLayout,
+            VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+            VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
+        // Full-subresource barrier for images the engine does not own (e.g. swapchain images)
+        static void RecordBarrier(VkCommandBuffer commandBuffer, VkImage image, VkImageAspectFlags aspect,
+            VkImageLayout oldLayout, VkImageLayout newLayout,
+            VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+            VkPipelineStageFlags dstStage, VkAccessFlags dstAccess,
+            uint32_t mipLevels = VK_REMAINING_MIP_LEVELS);
+
+    private:
+        VulkanImageSpec m_Spec;
+        VkImage m_Image = VK_NULL_HANDLE;
+        VkImageView m_View = VK_NULL_HANDLE;
+        VkDeviceMemory m_Memory = VK_NULL_HANDLE;
+        VkImageLayout m_Layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    };
+
+}
@@ -0,0 +1,475 @@
+#include "VulkanPipelineCache.h"
+
+#include "VulkanContext.h"
+#include "GGEngine/Hash.h"
+
+namespace GGEngine {
+
+    static const char* s_CacheFileName = "PipelineCache.bin";
+    static const char* s_ManifestFileName = "PipelineManifest.txt";
+
+    static uint64_t HashShader(const std::shared_ptr<VulkanShader>& shader, uint64_t seed)
+    {
+        if (!shader)
+            return Hash::Value((uint32_t)0, seed);
+
+        const ShaderSource& source = shader->GetSource();
+        uint64_t hash = Hash::FNV1a64(source.Path, seed);
+        hash = Hash::FNV1a64(source.EntryPoint, hash);
+        for (const auto& define : source.Defines)
+        {
+            hash = Hash::FNV1a64(define.first, hash);
+            hash = Hash::FNV1a64(define.second, hash);
+        }
+        return hash;
+    }
+
+    uint64_t GraphicsPipelineDesc::Hash() const
+    {
+        // Fields are hashed one by one so struct padding never leaks into the key
+        uint64_t hash = HashShader(VertexShader, Hash::FNV1aBasis);
+        hash = HashShader(FragmentShader, hash);
+
+        for (const VertexBindingDesc& binding : VertexBindings)
+        {
+            hash = Hash::Value(binding.Binding, hash);
+            hash = Hash::Value(binding.Stride, hash);
+            hash = Hash::Value(binding.InputRate, hash);
+        }
+        for (const VertexAttributeDesc& attribute : VertexAttributes)
+        {
+            hash = Hash::Value(attribute.Location, hash);
+            hash = Hash::Value(attribute.Binding, hash);
+            hash = Hash::Value(attribute.Format, hash);
+            hash = Hash::Value(attribute.Offset, hash);
+        }
+        hash = Hash::Value(Topology, hash);
+        hash = Hash::Value(CullMode, hash);
+        hash = Hash::Value(FrontFace, hash);
+
+        hash = Hash::Value(BlendEnable, hash);
+        if (BlendEnable)
+        {
+            hash = Hash::Value(SrcColorFactor, hash);
+            hash = Hash::Value(DstColorFactor, hash);
+            hash = Hash::Value(ColorBlendOp, hash);
+            hash = Hash::Value(SrcAlphaFactor, hash);
+            hash = Hash::Value(DstAlphaFactor, hash);
+            hash = Hash::Value(AlphaBlendOp, hash);
+        }
+
+        hash = Hash::Value(DepthTest, hash);
+        hash = Hash::Value(DepthWrite, hash);
+        hash = Hash::Value(DepthCompare, hash);
+
+        for (VkFormat format : ColorFormats)
+            hash = Hash::Value(format, hash);
+        hash = Hash::Value(DepthFormat, hash);
+        hash = Hash::Value(Samples, hash);
+        hash = Hash::Value(Subpass, hash);
+
+        // 0 is reserved for "no pipeline"
+        return hash != 0 ? hash : 1;
+    }
+
+    void VulkanPipelineCache::Init(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator,
+        bool dynamicRendering, const std::string& cacheDirectory)
+    {
+        m_Device = device;
+        m_PhysicalDevice = physicalDevice;
+        m_Allocator = allocator;
+        m_DynamicRendering = dynamicRendering;
+        m_CacheDirectory = cacheDirectory;
+
+        std::vector<uint8_t> initialData;
+        LoadCacheData(initialData);
+
+        VkPipelineCacheCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        info.initialDataSize = initialData.size();
+        info.pInitialData = initialData.empty() ? nullptr : initialData.data();
+        VkResult err = vkCreatePipelineCache(m_Device, &info, m_Allocator, &m_Cache);
+        VulkanContext::CheckVkResult(err);
+
+        std::ifstream manifest(std::filesystem::path(m_CacheDirectory) / s_ManifestFileName);
+        std::string line;
+        while (std::getline(manifest, line))
+        {
+            if (!line.empty())
+                m_PrewarmHashes.insert(std::strtoull(line.c_str(), nullptr, 16));
+        }
+
+        GG_CORE_INFO("Pipeline cache: {0} bytes of driver data, {1} pipelines to prewarm", initialData.size(), m_PrewarmHashes.size());
+    }
+
+    void VulkanPipelineCache::LoadCacheData(std::vector<uint8_t>& data)
+    {
+        std::ifstream in(std::filesystem::path(m_CacheDirectory) / s_CacheFileName, std::ios::in | std::ios::binary);
+        if (!in)
+            return;
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+        // Data from another driver or GPU is useless; some drivers even misbehave on it
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(m_PhysicalDevice, &properties);
+        VkPipelineCacheHeaderVersionOne header = {};
+        if (data.size() < sizeof(header))
+        {
+            data.clear();
+            return;
+        }
+        memcpy(&header, data.data(), sizeof(header));
+        if (header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+            || header.vendorID != properties.vendorID
+            || header.deviceID != properties.deviceID
+            || memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+        {
+            GG_CORE_INFO("Pipeline cache on disk was created by a different driver, starting fresh");
+            data.clear();
+        }
+    }
+
+    void VulkanPipelineCache::Shutdown()
+    {
+        JobSystem::Wait(m_CompileJobs);
+
+        std::error_code error;
+        std::filesystem::create_directories(m_CacheDirectory, error);
+
+        size_t size = 0;
+        vkGetPipelineCacheData(m_Device, m_Cache, &size, nullptr);
+        std::vector<uint8_t> data(size);
+        if (size > 0 && vkGetPipelineCacheData(m_Device, m_Cache, &size, data.data()) == VK_SUCCESS)
+        {
+            std::ofstream out(std::filesystem::path(m_CacheDirectory) / s_CacheFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(data.data()), (std::streamsize)size);
+        }
+
+        // Record what this run actually drew with; plus anything prewarmed that was never declared,
+        // so a run that skips part of the content does not shrink the list
+        std::unordered_set<uint64_t> declared;
+        std::unordered_set<uint64_t> used;
+        for (const auto& pair : m_Entries)
+        {
+            declared.insert(pair.second->DescHash);
+            if (pair.second->Used)
+                used.insert(pair.second->DescHash);
+        }
+        for (uint64_t hash : m_PrewarmHashes)
+        {
+            if (declared.count(hash) == 0)
+                used.insert(hash);
+        }
+        std::ofstream manifest(std::filesystem::path(m_CacheDirectory) / s_ManifestFileName, std::ios::out | std::ios::trunc);
+        for (uint64_t hash : used)
+            manifest << std::hex << hash << '\n';
+
+        for (auto& completed : m_Completed)
+            vkDestroyPipeline(m_Device, completed.second, m_Allocator);
+        m_Completed.clear();
+        m_CompilingModules.clear();
+        m_Pending.clear();
+        for (auto& pair : m_Entries)
+        {
+            VkPipeline pipeline = pair.second->Pipeline.load();
+            if (pipeline != VK_NULL_HANDLE)
+                vkDestroyPipeline(m_Device, pipeline, m_Allocator);
+        }
+        m_Entries.clear();
+
+        vkDestroyPipelineCache(m_Device, m_Cache, m_Allocator);
+        m_Cache = VK_NULL_HANDLE;
+    }
+
+    uint64_t VulkanPipelineCache::KeyOf(const GraphicsPipelineDesc& desc, uint64_t descHash) const
+    {
+        uint64_t key = Hash::Value(desc.Layout, descHash);
+        if (!m_DynamicRendering)
+            key = Hash::Value(desc.RenderPass, key);
+        return key != 0 ? key : 1;
+    }
+
+    uint64_t VulkanPipelineCache::Declare(const GraphicsPipelineDesc& desc)
+    {
+        const uint64_t descHash = desc.Hash();
+        const uint64_t hash = KeyOf(desc, descHash);
+        {
+            std::shared_lock<std::shared_mutex> lock(m_EntriesMutex);
+            if (m_Entries.find(hash) != m_Entries.end())
+                return hash;
+        }
+
+        Entry* entry = nullptr;
+        {
+            std::unique_lock<std::shared_mutex> lock(m_EntriesMutex);
+            auto& slot = m_Entries[hash];
+            if (slot)
+                return hash;
+            slot = std::make_unique<Entry>();
+            slot->Desc = desc;
+            slot->Key = hash;
+            slot->DescHash = descHash;
+            entry = slot.get();
+        }
+
+        if (m_PrewarmHashes.count(descHash) != 0)
+            Request(entry);
+        return hash;
+    }
+
+    VkPipeline VulkanPipelineCache::Get(uint64_t hash, uint64_t fallbackHash)
+    {
+        Entry* entry = nullptr;
+        Entry* fallback = nullptr;
+        {
+            std::shared_lock<std::shared_mutex> lock(m_EntriesMutex);
+            auto it = m_Entries.find(hash);
+            if (it != m_Entries.end())
+                entry = it->second.get();
+            if (fallbackHash != 0)
+            {
+                auto fallbackIt = m_Entries.find(fallbackHash);
+                if (fallbackIt != m_Entries.end())
+                    fallback = fallbackIt->second.get();
+            }
+        }
+
+        if (entry == nullptr)
+        {
+            GG_CORE_ERROR("Pipeline {0:x} was never declared", hash);
+            return VK_NULL_HANDLE;
+        }
+
+        entry->Used = true;
+        Request(entry);
+        VkPipeline pipeline = entry->Pipeline.load(std::memory_order_acquire);
+        if (pipeline != VK_NULL_HANDLE || fallback == nullptr)
+            return pipeline;
+
+        fallback->Used = true;
+        Request(fallback);
+        return fallback->Pipeline.load(std::memory_order_acquire);
+    }
+
+    bool VulkanPipelineCache::IsReady(uint64_t hash)
+    {
+        std::shared_lock<std::shared_mutex> lock(m_EntriesMutex);
+        auto it = m_Entries.find(hash);
+        return it != m_Entries.end() && it->second->Pipeline.load() != VK_NULL_HANDLE;
+    }
+
+    void VulkanPipelineCache::Request(Entry* entry)
+    {
+        if (entry->Requested.exchange(true))
+            return;
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        m_Pending.push_back(entry);
+    }
+
+    void VulkanPipelineCache::Update()
+    {
+        std::vector<Entry*> pending;
+        std::vector<std::pair<Entry*, VkPipeline>> completed;
+        {
+            std::lock_guard<std::mutex> lock(m_QueueMutex);
+            pending.swap(m_Pending);
+            completed.swap(m_Completed);
+        }
+
+        // Frames still in flight may have recorded the old pipeline
+        for (auto& pair : completed)
+        {
+            Entry* entry = pair.first;
+            entry->Compiling = false;
+            for (VkShaderModule module : entry->CompilingModules)
+            {
+                auto it = m_CompilingModules.find(module);
+                if (--it->second == 0)
+                    m_CompilingModules.erase(it);
+            }
+            entry->CompilingModules.clear();
+            if (pair.second == VK_NULL_HANDLE)
+                continue;
+
+            VkPipeline oldPipeline = entry->Pipeline.exchange(pair.second, std::memory_order_acq_rel);
+            if (oldPipeline != VK_NULL_HANDLE)
+            {
+                VkDevice device = m_Device;
+                const VkAllocationCallbacks* allocator = m_Allocator;
+                VulkanContext::Get().DeferDestroy([device, oldPipeline, allocator]() { vkDestroyPipeline(device, oldPipeline, allocator); });
+            }
+        }
+
+        std::vector<Entry*> waiting;
+        for (Entry* entry : pending)
+        {
+            const GraphicsPipelineDesc& desc = entry->Desc;
+            const bool shadersReady = (!desc.VertexShader || desc.VertexShader->IsReady())
+                && (!desc.FragmentShader || desc.FragmentShader->IsReady());
+            if (!shadersReady || entry->Compiling)
+            {
+                waiting.push_back(entry);
+                continue;
+            }
+            Compile(entry);
+        }
+
+        if (!waiting.empty())
+        {
+            std::lock_guard<std::mutex> lock(m_QueueMutex);
+            m_Pending.insert(m_Pending.end(), waiting.begin(), waiting.end());
+        }
+    }
+
+    void VulkanPipelineCache::Compile(Entry* entry)
+    {
+        // Modules are resolved here: a reload replaces them on the main thread
+        std::vector<ShaderStage> shaderStages;
+        for (const std::shared_ptr<VulkanShader>& shader : { entry->Desc.VertexShader, entry->Desc.FragmentShader })
+        {
+            if (shader)
+            {
+                shaderStages.push_back({ shader->GetVkStage(), shader->GetModule(), shader->GetSource().EntryPoint });
+                entry->CompilingModules.push_back(shader->GetModule());
+                m_CompilingModules[shader->GetModule()]++;
+            }
+        }
+
+        entry->Compiling = true;
+        JobSystem::Execute(m_CompileJobs, [this, entry, desc = entry->Desc, shaderStages = std::move(shaderStages)]()
+        {
+            VkPipeline pipeline = CreatePipeline(desc, shaderStages);
+            std::lock_guard<std::mutex> lock(m_QueueMutex);
+            m_Completed.emplace_back(entry, pipeline);
+        });
+    }
+
+    void VulkanPipelineCache::OnShaderReloaded(const VulkanShader& shader)
+    {
+        // Compiles in flight keep the replaced module alive (IsCompilingWith); entries still
+        // compiling stay pending and rebuild against the new module once their result is in
+        std::shared_lock<std::shared_mutex> lock(m_EntriesMutex);
+        std::lock_guard<std::mutex> queueLock(m_QueueMutex);
+        for (auto& pair : m_Entries)
+        {
+            Entry* entry = pair.second.get();
+            if (!entry->Requested)
+                continue;
+            if (entry->Desc.VertexShader.get() == &shader || entry->Desc.FragmentShader.get() == &shader)
+                m_Pending.push_back(entry);
+        }
+    }
+
+    VkPipeline VulkanPipelineCache::CreatePipeline(const GraphicsPipelineDesc& desc, const std::vector<ShaderStage>& shaderStages)
+    {
+        VkPipelineShaderStageCreateInfo stages[2] = {};
+        uint32_t stageCount = 0;
+        for (const ShaderStage& shaderStage : shaderStages)
+        {
+            VkPipelineShaderStageCreateInfo& stage = stages[stageCount++];
+            stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            stage.stage = shaderStage.Stage;
+            stage.module = shaderStage.Module;
+            stage.pName = shaderStage.EntryPoint.c_str();
+        }
+
+        std::vector<VkVertexInputBindingDescription> bindings;
+        for (const VertexBindingDesc& binding : desc.VertexBindings)
+            bindings.push_back({ binding.Binding, binding.Stride, binding.InputRate });
+        std::vector<VkVertexInputAttributeDescription> attributes;
+        for (const VertexAttributeDesc& attribute : desc.VertexAttributes)
+            attributes.push_back({ attribute.Location, attribute.Binding, attribute.Format, attribute.Offset });
+
+        VkPipelineVertexInputStateCreateInfo vertexInput = {};
+        vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInput.vertexBindingDescriptionCount = (uint32_t)bindings.size();
+        vertexInput.pVertexBindingDescriptions = bindings.data();
+        vertexInput.vertexAttributeDescriptionCount = (uint32_t)attributes.size();
+        vertexInput.pVertexAttributeDescriptions = attributes.data();
+
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = desc.Topology;
+
+        VkPipelineViewportStateCreateInfo viewport = {};
+        viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewport.viewportCount = 1;
+        viewport.scissorCount = 1;
+
+        VkPipelineRasterizationStateCreateInfo rasterization = {};
+        rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterization.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterization.cullMode = desc.CullMode;
+        rasterization.frontFace = desc.FrontFace;
+        rasterization.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo multisample = {};
+        multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisample.rasterizationSamples = desc.Samples;
+
+        VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencil.depthTestEnable = desc.DepthTest ? VK_TRUE : VK_FALSE;
+        depthStencil.depthWriteEnable = desc.DepthWrite ? VK_TRUE : VK_FALSE;
+        depthStencil.depthCompareOp = desc.DepthCompare;
+
+        std::vector<VkPipelineColorBlendAttachmentState> blendAttachments(std::max<size_t>(desc.ColorFormats.size(), 1));
+        for (VkPipelineColorBlendAttachmentState& blend : blendAttachments)
+        {
+            blend.blendEnable = desc.BlendEnable ? VK_TRUE : VK_FALSE;
+            blend.srcColorBlendFactor = desc.SrcColorFactor;
+            blend.dstColorBlendFactor = desc.DstColorFactor;
+            blend.colorBlendOp = desc.ColorBlendOp;
+            blend.srcAlphaBlendFactor = desc.SrcAlphaFactor;
+            blend.dstAlphaBlendFactor = desc.DstAlphaFactor;
+            blend.alphaBlendOp = desc.AlphaBlendOp;
+            blend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        }
+
+        VkPipelineColorBlendStateCreateInfo colorBlend = {};
+        colorBlend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlend.attachmentCount = (uint32_t)desc.ColorFormats.size();
+        colorBlend.pAttachments = blendAttachments.data();
+
+        const VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+        VkPipelineDynamicStateCreateInfo dynamicState = {};
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = (uint32_t)(sizeof(dynamicStates) / sizeof(dynamicStates[0]));
+        dynamicState.pDynamicStates = dynamicStates;
+
+        VkPipelineRenderingCreateInfo renderingInfo = {};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+        renderingInfo.colorAttachmentCount = (uint32_t)desc.ColorFormats.size();
+        renderingInfo.pColorAttachmentFormats = desc.ColorFormats.data();
+        renderingInfo.depthAttachmentFormat = desc.DepthFormat;
+
+        VkGraphicsPipelineCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        info.pNext = m_DynamicRendering ? &renderingInfo : nullptr;
+        info.stageCount = stageCount;
+        info.pStages = stages;
+        info.pVertexInputState = &vertexInput;
+        info.pInputAssemblyState = &inputAssembly;
+        info.pViewportState = &viewport;
+        info.pRasterizationState = &rasterization;
+        info.pMultisampleState = &multisample;
+        info.pDepthStencilState = &depthStencil;
+        info.pColorBlendState = &colorBlend;
+        info.pDynamicState = &dynamicState;
+        info.layout = desc.Layout;
+        info.renderPass = m_DynamicRendering ? VK_NULL_HANDLE : desc.RenderPass;
+        info.subpass = desc.Subpass;
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkResult err = vkCreateGraphicsPipelines(m_Device, m_Cache, 1, &info, m_Allocator, &pipeline);
+        if (err != VK_SUCCESS)
+        {
+            GG_CORE_ERROR("Pipeline creation failed (VkResult = {0}) for {1} / {2}", (int)err,
+                desc.VertexShader ? desc.VertexShader->GetSource().Path : "-",
+                desc.FragmentShader ? desc.FragmentShader->GetSource().Path : "-");
+            return VK_NULL_HANDLE;
+        }
+        return pipeline;
+    }
+
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+#include "VulkanShader.h"
+#include "GGEngine/JobSystem.h"
+
+#include <shared_mutex>
+
+namespace GGEngine {
+
+    struct VertexBindingDesc
+    {
+        uint32_t Binding = 0;
+        uint32_t Stride = 0;
+        VkVertexInputRate InputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    };
+
+    struct VertexAttributeDesc
+    {
+        uint32_t Location = 0;
+        uint32_t Binding = 0;
+        VkFormat Format = VK_FORMAT_UNDEFINED;
+        uint32_t Offset = 0;
+    };
+
+    // Everything that determines a graphics pipeline. Viewport and scissor are always dynamic.
+    struct GraphicsPipelineDesc
+    {
+        std::shared_ptr<VulkanShader> VertexShader;
+        std::shared_ptr<VulkanShader> FragmentShader;
+
+        // Handles change between runs, so they are left out of Hash() and only join the
+        // cache's in-run key
+        VkPipelineLayout Layout = VK_NULL_HANDLE;
+
+        std::vector<VertexBindingDesc> VertexBindings;
+        std::vector<VertexAttributeDesc> VertexAttributes;
+        VkPrimitiveTopology Topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        VkCullModeFlags CullMode = VK_CULL_MODE_NONE;
+        VkFrontFace FrontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+        bool BlendEnable = false;
+        VkBlendFactor SrcColorFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        VkBlendFactor DstColorFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        VkBlendOp ColorBlendOp = VK_BLEND_OP_ADD;
+        VkBlendFactor SrcAlphaFactor = VK_BLEND_FACTOR_ONE;
+        VkBlendFactor DstAlphaFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        VkBlendOp AlphaBlendOp = VK_BLEND_OP_ADD;
+
+        bool DepthTest = false;
+        bool DepthWrite = false;
+        VkCompareOp DepthCompare = VK_COMPARE_OP_LESS_OR_EQUAL;
+
+        // Attachment formats drive dynamic rendering; with render passes they stand in for
+        // render pass compatibility in the hash
+        std::vector<VkFormat> ColorFormats;
+        VkFormat DepthFormat = VK_FORMAT_UNDEFINED;
+        VkSampleCountFlagBits Samples = VK_SAMPLE_COUNT_1_BIT;
+        VkRenderPass RenderPass = VK_NULL_HANDLE; // Only used without dynamic rendering
+        uint32_t Subpass = 0;
+
+        // Compact 64-bit hash of everything but the handles, stable across runs so it can
+        // be recorded for prewarming
+        uint64_t Hash() const;
+    };
+
+    // Graphics pipelines keyed by GraphicsPipelineDesc::Hash combined with the layout and
+    // render pass handles, compiled on the job system against a VkPipelineCache that
+    // persists between runs. Lookups never block: a pipeline that is still compiling
+    // returns the fallback (or VK_NULL_HANDLE, skip the draw). Desc hashes used during a
+    // run are written to a manifest, and descs declared at the next startup whose hash is
+    // listed there compile right away.
+    class VulkanPipelineCache
+    {
+    public:
+        void Init(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator,
+            bool dynamicRendering, const std::string& cacheDirectory);
+        // Saves the driver cache and the manifest; the device must be idle
+        void Shutdown();
+
+        VkPipelineCache GetHandle() const { return m_Cache; }
+
+        // Registers desc and returns its key. Compiles immediately when the last run used it.
+        uint64_t Declare(const GraphicsPipelineDesc& desc);
+
+        // Thread-safe, usable from parallel recording. Requests compilation the first time a
+        // hash is asked for and returns VK_NULL_HANDLE (or the fallback's pipeline) until it is ready.
+        VkPipeline Get(uint64_t hash, uint64_t fallbackHash = 0);
+        VkPipeline Get(const GraphicsPipelineDesc& desc, uint64_t fallbackHash = 0) { return Get(Declare(desc), fallbackHash); }
+
+        bool IsReady(uint64_t hash);
+        uint32_t GetCompilingCount() const { return m_CompileJobs.load(); }
+
+        // Frame boundary, main thread: starts requested compiles whose shaders are ready
+        // and swaps finished pipelines in
+        void Update();
+
+        // Pipelines using shader are rebuilt; the old ones keep serving until then. Never
+        // blocks: pipelines still compiling against the old module are rebuilt once they finish.
+        void OnShaderReloaded(const VulkanShader& shader);
+        // A compile job started on the main thread may still read module. Main thread only.
+        bool IsCompilingWith(VkShaderModule module) const { return m_CompilingModules.count(module) != 0; }
+
+    private:
+        struct Entry
+        {
+            GraphicsPipelineDesc Desc;
+            uint64_t Key = 0;
+            uint64_t DescHash = 0;  // Desc.Hash(), what the manifest records
+            std::atomic<VkPipeline> Pipeline{ VK_NULL_HANDLE };
+            std::atomic<bool> Requested{ false };
+            std::atomic<bool> Used{ false };
+            bool Compiling = false; // Main thread only
+            std::vector<VkShaderModule> CompilingModules; // Main thread only, while Compiling
+        };
+
+        // Shader state read on the main thread, so compile jobs never touch a VulkanShader
+        // that a reload is updating
+        struct ShaderStage
+        {
+            VkShaderStageFlagBits Stage;
+            VkShaderModule Module;
+            std::string EntryPoint;
+        };
+
+        // DescHash plus the handles, which two otherwise equal descs may not share
+        uint64_t KeyOf(const GraphicsPipelineDesc& desc, uint64_t descHash) const;
+        void Request(Entry* entry);
+        void Compile(Entry* entry);
+        VkPipeline CreatePipeline(const GraphicsPipelineDesc& desc, const std::vector<ShaderStage>& shaderStages);
+        void LoadCacheData(std::vector<uint8_t>& data);
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* m_Allocator = nullptr;
+        bool m_DynamicRendering = false;
+        std::string m_CacheDirectory;
+
+        VkPipelineCache m_Cache = VK_NULL_HANDLE;
+
+        std::shared_mutex m_EntriesMutex;
+        std::unordered_map<uint64_t, std::unique_ptr<Entry>> m_Entries;
+        std::unordered_set<uint64_t> m_PrewarmHashes;
+
+        std::mutex m_QueueMutex;
+        std::vector<Entry*> m_Pending;                              // Requested, waiting for shaders
+        std::vector<std::pair<Entry*, VkPipeline>> m_Completed;     // Compiled, waiting for the frame boundary
+        JobCounter m_CompileJobs{ 0 };
+        std::unordered_map<VkShaderModule, uint32_t> m_CompilingModules; // Compiles reading each module, main thread only
+    };
+
+}
@@ -0,0 +1,220 @@
+#include "VulkanPresentTracker.h"
+
+#include "VulkanContext.h"
+#include "GGEngine/FrameStats.h"
+#include "GGEngine/Timer.h"
+
+#ifdef GG_PLATFORM_WINDOWS
+#include <timeapi.h>
+#endif
+
+namespace GGEngine {
+
+    // Waits are sliced so a retired swapchain or shutdown is noticed quickly; a present
+    // that has not shown up after a second (occluded window, lost surface) is dropped
+    static const uint64_t s_WaitSliceNs = 10ull * 1000 * 1000;
+    static const double s_GiveUpSeconds = 1.0;
+
+    // Pacing: the delay creeps up while frames make their refresh and drops fast on a
+    // miss. The margin keeps some of the period for the frame itself.
+    static const double s_DelayStep = 0.00025;
+    static const double s_DelayBackoff = 0.002;
+    static const double s_DelayMargin = 0.002;
+    static const double s_MinPacedPeriod = 0.002; // Below this presents are not refresh-bound
+    static const double s_SpinSeconds = 0.001;    // Tail of the delay spent yielding instead of sleeping
+
+    void VulkanPresentTracker::Init(VkDevice device, bool enabled)
+    {
+        m_Device = device;
+        m_Enabled = enabled;
+        if (!m_Enabled)
+            return;
+
+        m_Running = true;
+        m_Waiter = std::thread(&VulkanPresentTracker::WaitLoop, this);
+        GG_CORE_INFO("Vulkan: present timing enabled (VK_KHR_present_wait)");
+    }
+
+    void VulkanPresentTracker::Shutdown()
+    {
+        SetPacing(false);
+        if (!m_Enabled)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Running = false;
+            m_Pending.clear();
+        }
+        m_Wake.notify_all();
+        if (m_Waiter.joinable())
+            m_Waiter.join();
+        m_Enabled = false;
+    }
+
+    void VulkanPresentTracker::SetPacing(bool enabled)
+    {
+        enabled = enabled && m_Enabled;
+        if (enabled == m_Pacing)
+            return;
+        m_Pacing = enabled;
+
+#ifdef GG_PLATFORM_WINDOWS
+        // The default 15.6 ms scheduler tick would swallow the whole delay
+        if (m_Pacing)
+            timeBeginPeriod(1);
+        else
+            timeEndPeriod(1);
+#endif
+    }
+
+    uint64_t VulkanPresentTracker::NextPresentId()
+    {
+        return m_Enabled ? m_NextPresentId++ : 0;
+    }
+
+    void VulkanPresentTracker::OnPresented(VkSwapchainKHR swapchain, uint64_t presentId, VkResult result, double frameStartTime, double inputTime)
+    {
+        const double pacedAfter = m_PacedAfter;
+        m_PacedAfter = 0.0;
+        // A failed present never completes its id
+        if (presentId == 0 || (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR))
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            PendingPresent& present = m_Pending.emplace_back();
+            present.Swapchain = swapchain;
+            present.Id = presentId;
+            present.FrameStartTime = frameStartTime;
+            present.InputTime = inputTime;
+            present.PacedAfter = pacedAfter;
+        }
+        m_Wake.notify_one();
+    }
+
+    void VulkanPresentTracker::RetireSwapchain(VkSwapchainKHR swapchain)
+    {
+        if (!m_Enabled || swapchain == VK_NULL_HANDLE)
+            return;
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Pending.erase(std::remove_if(m_Pending.begin(), m_Pending.end(),
+            [swapchain](const PendingPresent& present) { return present.Swapchain == swapchain; }), m_Pending.end());
+        if (m_Waiting == swapchain)
+        {
+            m_CancelWait = true;
+            m_Progress.wait(lock, [this, swapchain] { return m_Waiting != swapchain; });
+            m_CancelWait = false;
+        }
+
+        // The new swapchain may run at another rate
+        std::fill(std::begin(m_Intervals), std::end(m_Intervals), 0.0);
+        m_RefreshPeriod = 0.0;
+        m_LastPresentTime = 0.0;
+    }
+
+    void VulkanPresentTracker::Update()
+    {
+        if (!m_Enabled)
+            return;
+
+        std::vector<MeasuredPresent> measured;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            measured.swap(m_Measured);
+        }
+        for (const MeasuredPresent& present : measured)
+        {
+            const double inputToPresentMs = present.InputTime > 0.0 ? (present.PresentTime - present.InputTime) * 1000.0 : -1.0;
+            FrameStats::RecordPresent((present.PresentTime - present.FrameStartTime) * 1000.0, inputToPresentMs);
+        }
+    }
+
+    void VulkanPresentTracker::WaitForFrameStart()
+    {
+        if (!m_Pacing)
+            return;
+
+        double startTime = 0.0;
+        {
+            // At most one frame queued for display: the previous one must be on screen
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            const bool settled = m_Progress.wait_for(lock, std::chrono::milliseconds(100),
+                [this] { return m_Pending.empty() && m_Waiting == VK_NULL_HANDLE; });
+            if (!settled || m_RefreshPeriod < s_MinPacedPeriod || m_LastPresentTime <= 0.0)
+                return;
+            m_PacedAfter = m_LastPresentTime;
+            startTime = m_LastPresentTime + m_Delay;
+        }
+
+        // Sleep most of the delay and yield through the rest, since sleeps overshoot
+        double remaining = startTime - Timer::Now();
+        if (remaining > s_SpinSeconds)
+            std::this_thread::sleep_for(std::chrono::duration<double>(remaining - s_SpinSeconds));
+        while (Timer::Now() < startTime)
+            std::this_thread::yield();
+    }
+
+    void VulkanPresentTracker::WaitLoop()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        while (true)
+        {
+            m_Wake.wait(lock, [this] { return !m_Running || !m_Pending.empty(); });
+            if (!m_Running)
+                break;
+
+            const PendingPresent present = m_Pending.front();
+            m_Pending.pop_front();
+            m_Waiting = present.Swapchain;
+
+            // The swapchain stays alive while m_Waiting names it: RetireSwapchain waits for
+            // this loop to let go before the context may destroy it
+            const double waitStart = Timer::Now();
+            VkResult result = VK_TIMEOUT;
+            while (result == VK_TIMEOUT && m_Running && !m_CancelWait && Timer::Now() - waitStart < s_GiveUpSeconds)
+            {
+                lock.unlock();
+                result = vkWaitForPresentKHR(m_Device, present.Swapchain, present.Id, s_WaitSliceNs);
+                lock.lock();
+            }
+
+            if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR)
+                OnDisplayed(present, Timer::Now());
+            m_Waiting = VK_NULL_HANDLE;
+            m_Progress.notify_all();
+        }
+    }
+
+    void VulkanPresentTracker::OnDisplayed(const PendingPresent& present, double presentTime)
+    {
+        m_Measured.push_back({ present.FrameStartTime, present.InputTime, presentTime });
+
+        // Idle gaps and missed refreshes only produce longer intervals, so the shortest
+        // recent one is the refresh period
+        if (m_LastPresentTime > 0.0)
+        {
+            m_Intervals[m_IntervalIndex] = presentTime - m_LastPresentTime;
+            m_IntervalIndex = (m_IntervalIndex + 1) % s_IntervalCount;
+            m_RefreshPeriod = 0.0;
+            for (double interval : m_Intervals)
+            {
+                if (interval > 0.0 && (m_RefreshPeriod == 0.0 || interval < m_RefreshPeriod))
+                    m_RefreshPeriod = interval;
+            }
+        }
+        m_LastPresentTime = presentTime;
+
+        // A paced frame was due on the refresh after the present it was scheduled from
+        if (present.PacedAfter > 0.0 && m_RefreshPeriod > 0.0)
+        {
+            const bool late = presentTime > present.PacedAfter + 1.5 * m_RefreshPeriod;
+            if (late)
+                m_Delay = std::max(0.0, m_Delay - s_DelayBackoff);
+            else
+                m_Delay = std::min(m_Delay + s_DelayStep, std::max(0.0, m_RefreshPeriod - s_DelayMargin));
+        }
+    }
+
+}
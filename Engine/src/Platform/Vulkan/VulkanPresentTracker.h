@@ -0,0 +1,88 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+namespace GGEngine {
+
+    // Measures when presented frames actually reach the display. Presents of the main
+    // swapchain carry a VK_KHR_present_id, and a waiter thread blocks in
+    // vkWaitForPresentKHR on each one in turn, stamping the engine clock (Timer::Now) as
+    // it returns. Results reach FrameStats as frame-start-to-present and input-to-present
+    // latencies.
+    //
+    // With pacing enabled, WaitForFrameStart holds the next frame back until the previous
+    // one is on screen plus a learned delay, so input is sampled as late as the frame can
+    // afford while still making the next refresh. The delay grows while frames land on
+    // their refresh and backs off sharply when one is late. Meant for FIFO presentation
+    // at a fixed refresh rate.
+    class VulkanPresentTracker
+    {
+    public:
+        // enabled: VK_KHR_present_id and VK_KHR_present_wait are on; otherwise every call is a no-op
+        void Init(VkDevice device, bool enabled);
+        void Shutdown();
+
+        bool IsEnabled() const { return m_Enabled; }
+        void SetPacing(bool enabled);
+
+        // Id for the main swapchain's next vkQueuePresentKHR, 0 when not tracking
+        uint64_t NextPresentId();
+        // After vkQueuePresentKHR with that id. Engine clock times; inputTime 0 without input.
+        void OnPresented(VkSwapchainKHR swapchain, uint64_t presentId, VkResult result, double frameStartTime, double inputTime);
+        // Before a swapchain is destroyed: drops its pending presents and waits out a wait on it
+        void RetireSwapchain(VkSwapchainKHR swapchain);
+
+        // Frame boundary, main thread: hands measured presents to FrameStats
+        void Update();
+
+        // Main thread, before input is polled for a new frame. Returns at once unless pacing.
+        void WaitForFrameStart();
+
+    private:
+        struct PendingPresent
+        {
+            VkSwapchainKHR Swapchain = VK_NULL_HANDLE;
+            uint64_t Id = 0;
+            double FrameStartTime = 0.0;
+            double InputTime = 0.0;
+            double PacedAfter = 0.0; // Present time the frame's start was scheduled from, 0 when not paced
+        };
+
+        struct MeasuredPresent
+        {
+            double FrameStartTime;
+            double InputTime;
+            double PresentTime;
+        };
+
+        void WaitLoop();
+        // Under m_Mutex
+        void OnDisplayed(const PendingPresent& present, double presentTime);
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        bool m_Enabled = false;
+        bool m_Pacing = false;
+        uint64_t m_NextPresentId = 1;
+        double m_PacedAfter = 0.0; // From WaitForFrameStart to the next OnPresented
+
+        std::thread m_Waiter;
+        std::mutex m_Mutex;
+        std::condition_variable m_Wake;      // New presents, shutdown
+        std::condition_variable m_Progress;  // A wait finished
+        bool m_Running = false;
+        std::deque<PendingPresent> m_Pending;
+        VkSwapchainKHR m_Waiting = VK_NULL_HANDLE; // Swapchain of the wait in progress
+        bool m_CancelWait = false;
+        std::vector<MeasuredPresent> m_Measured;
+
+        // Refresh estimate and pacing state, under m_Mutex
+        static const uint32_t s_IntervalCount = 32;
+        double m_Intervals[s_IntervalCount] = {};
+        uint32_t m_IntervalIndex = 0;
+        double m_LastPresentTime = 0.0;
+        double m_RefreshPeriod = 0.0; // Shortest recent interval between presents; 0 until known
+        double m_Delay = 0.0;         // After the previous present, before the next frame starts
+    };
+
+}
@@ -0,0 +1,262 @@
+#include "VulkanReadback.h"
+
+#include "VulkanContext.h"
+
+namespace GGEngine {
+
+    // Staging buffers kept around for reuse once their request resolves
+    static constexpr size_t s_MaxFreeBuffers = 8;
+
+    void VulkanReadback::Init(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator)
+    {
+        m_Device = device;
+        m_PhysicalDevice = physicalDevice;
+        m_Allocator = allocator;
+    }
+
+    void VulkanReadback::Shutdown()
+    {
+        // Anything never submitted resolves empty; submitted work is complete on an idle device
+        for (Request& request : m_Requests)
+        {
+            if (request.TimelineValue != 0)
+                continue;
+            if (request.IsImage)
+                request.ImagePromise.set_value(ReadbackImage());
+            else
+                request.BufferPromise.set_value(std::vector<uint8_t>());
+            DestroyStaging(request.Staging);
+        }
+        m_Requests.erase(std::remove_if(m_Requests.begin(), m_Requests.end(),
+            [](const Request& request) { return request.TimelineValue == 0; }), m_Requests.end());
+        Resolve(UINT64_MAX);
+
+        for (const StagingBuffer& staging : m_FreeBuffers)
+            DestroyStaging(staging);
+        m_FreeBuffers.clear();
+    }
+
+    std::future<std::vector<uint8_t>> VulkanReadback::ReadBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size)
+    {
+        Request request;
+        request.CommandBuffer = commandBuffer;
+        request.Size = size;
+        request.Staging = AcquireStaging(size);
+        std::future<std::vector<uint8_t>> future = request.BufferPromise.get_future();
+
+        VkBufferCopy region = {};
+        region.srcOffset = offset;
+        region.size = size;
+        vkCmdCopyBuffer(commandBuffer, buffer, request.Staging.Buffer, 1, &region);
+        RecordHostBarrier(commandBuffer, request.Staging.Buffer);
+
+        m_Requests.push_back(std::move(request));
+        return future;
+    }
+
+    std::future<ReadbackImage> VulkanReadback::ReadImage(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout layout, VkFormat format, VkExtent2D extent)
+    {
+        std::promise<ReadbackImage> promise;
+        std::future<ReadbackImage> future = promise.get_future();
+        ReadImage(commandBuffer, image, layout, format, extent, std::move(promise));
+        return future;
+    }
+
+    void VulkanReadback::ReadImage(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout layout, VkFormat format, VkExtent2D extent, std::promise<ReadbackImage> promise)
+    {
+        const uint32_t texelSize = GetFormatSize(format);
+        if (texelSize == 0)
+        {
+            GG_CORE_ERROR("[Vulkan] Readback does not support image format {0}", (int)format);
+            promise.set_value(ReadbackImage());
+            return;
+        }
+
+        Request request;
+        request.CommandBuffer = commandBuffer;
+        request.IsImage = true;
+        request.ImagePromise = std::move(promise);
+        request.Width = extent.width;
+        request.Height = extent.height;
+        request.Format = format;
+        request.Size = (VkDeviceSize)extent.width * extent.height * texelSize;
+        request.Staging = AcquireStaging(request.Size);
+
+        VkBufferImageCopy region = {};
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = { extent.width, extent.height, 1 };
+        vkCmdCopyImageToBuffer(commandBuffer, image, layout, request.Staging.Buffer, 1, &region);
+        RecordHostBarrier(commandBuffer, request.Staging.Buffer);
+
+        m_Requests.push_back(std::move(request));
+    }
+
+    void VulkanReadback::OnSubmit(VkCommandBuffer commandBuffer, uint64_t timelineValue)
+    {
+        for (Request& request : m_Requests)
+        {
+            if (request.TimelineValue == 0 && request.CommandBuffer == commandBuffer)
+                request.TimelineValue = timelineValue;
+        }
+    }
+
+    void VulkanReadback::Resolve(uint64_t completedValue)
+    {
+        if (m_Requests.empty())
+            return;
+
+        auto it = std::stable_partition(m_Requests.begin(), m_Requests.end(),
+            [completedValue](const Request& request) { return request.TimelineValue == 0 || request.TimelineValue > completedValue; });
+        for (auto ready = it; ready != m_Requests.end(); ++ready)
+            Fulfill(*ready);
+        m_Requests.erase(it, m_Requests.end());
+    }
+
+    void VulkanReadback::Fulfill(Request& request)
+    {
+        const StagingBuffer& staging = request.Staging;
+        if (!staging.Coherent)
+        {
+            VkMappedMemoryRange range = {};
+            range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+            range.memory = staging.Memory;
+            range.size = VK_WHOLE_SIZE;
+            VkResult err = vkInvalidateMappedMemoryRanges(m_Device, 1, &range);
+            VulkanContext::CheckVkResult(err);
+        }
+
+        const uint8_t* data = static_cast<const uint8_t*>(staging.Mapped);
+        if (request.IsImage)
+        {
+            ReadbackImage image;
+            image.Width = request.Width;
+            image.Height = request.Height;
+            image.Format = request.Format;
+            image.Pixels.assign(data, data + request.Size);
+            request.ImagePromise.set_value(std::move(image));
+        }
+        else
+        {
+            request.BufferPromise.set_value(std::vector<uint8_t>(data, data + request.Size));
+        }
+
+        ReleaseStaging(staging);
+    }
+
+    VulkanReadback::StagingBuffer VulkanReadback::AcquireStaging(VkDeviceSize size)
+    {
+        // Smallest free buffer that fits
+        auto best = m_FreeBuffers.end();
+        for (auto it = m_FreeBuffers.begin(); it != m_FreeBuffers.end(); ++it)
+        {
+            if (it->Size >= size && (best == m_FreeBuffers.end() || it->Size < best->Size))
+                best = it;
+        }
+        if (best != m_FreeBuffers.end())
+        {
+            StagingBuffer staging = *best;
+            m_FreeBuffers.erase(best);
+            return staging;
+        }
+
+        StagingBuffer staging;
+        staging.Size = size;
+
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        VkResult err = vkCreateBuffer(m_Device, &bufferInfo, m_Allocator, &staging.Buffer);
+        VulkanContext::CheckVkResult(err);
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(m_Device, staging.Buffer, &requirements);
+
+        // Cached memory makes the CPU-side copy fast; it may need an explicit invalidate
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &memoryProperties);
+        const VkMemoryPropertyFlags preferred[] =
+        {
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        };
+        uint32_t memoryType = UINT32_MAX;
+        for (VkMemoryPropertyFlags flags : preferred)
+        {
+            for (uint32_t i = 0; i < memoryProperties.memoryTypeCount && memoryType == UINT32_MAX; i++)
+            {
+                if ((requirements.memoryTypeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & flags) == flags)
+                    memoryType = i;
+            }
+            if (memoryType != UINT32_MAX)
+                break;
+        }
+        GG_CORE_ASSERT(memoryType != UINT32_MAX, "No host-visible memory for readback");
+        staging.Coherent = (memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+
+        VkMemoryAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = requirements.size;
+        allocInfo.memoryTypeIndex = memoryType;
+        err = vkAllocateMemory(m_Device, &allocInfo, m_Allocator, &staging.Memory);
+        VulkanContext::CheckVkResult(err);
+        err = vkBindBufferMemory(m_Device, staging.Buffer, staging.Memory, 0);
+        VulkanContext::CheckVkResult(err);
+        err = vkMapMemory(m_Device, staging.Memory, 0, VK_WHOLE_SIZE, 0, &staging.Mapped);
+        VulkanContext::CheckVkResult(err);
+
+        return staging;
+    }
+
+    void VulkanReadback::ReleaseStaging(const StagingBuffer& staging)
+    {
+        if (m_FreeBuffers.size() < s_MaxFreeBuffers)
+            m_FreeBuffers.push_back(staging);
+        else
+            DestroyStaging(staging);
+    }
+
+    void VulkanReadback::DestroyStaging(const StagingBuffer& staging)
+    {
+        vkUnmapMemory(m_Device, staging.Memory);
+        vkDestroyBuffer(m_Device, staging.Buffer, m_Allocator);
+        vkFreeMemory(m_Device, staging.Memory, m_Allocator);
+    }
+
+    void VulkanReadback::RecordHostBarrier(VkCommandBuffer commandBuffer, VkBuffer buffer)
+    {
+        VkBufferMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = buffer;
+        barrier.size = VK_WHOLE_SIZE;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+    }
+
+    uint32_t VulkanReadback::GetFormatSize(VkFormat format)
+    {
+        switch (format)
+        {
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+            case VK_FORMAT_B8G8R8A8_UNORM:
+            case VK_FORMAT_B8G8R8A8_SRGB:
+            case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+            case VK_FORMAT_R32_SFLOAT:
+            case VK_FORMAT_R32_UINT:
+                return 4;
+            case VK_FORMAT_R16G16B16A16_SFLOAT:
+                return 8;
+            case VK_FORMAT_R32G32B32A32_SFLOAT:
+                return 16;
+            default:
+                return 0;
+        }
+    }
+
+}
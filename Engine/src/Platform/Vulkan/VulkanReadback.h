@@ -0,0 +1,85 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+#include <future>
+
+namespace GGEngine {
+
+    struct ReadbackImage
+    {
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        VkFormat Format = VK_FORMAT_UNDEFINED;
+        std::vector<uint8_t> Pixels; // Tightly packed rows; empty when the readback failed
+    };
+
+    // Copies GPU data into host-visible staging buffers from inside an already recording
+    // command buffer and hands the bytes back once the timeline shows that submission has
+    // executed. Nothing ever waits on the GPU: futures resolve in a later BeginFrame,
+    // usually as many frames afterwards as there are frames in flight. Main thread only.
+    class VulkanReadback
+    {
+    public:
+        void Init(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator);
+        // Resolves everything still pending; the device must be idle
+        void Shutdown();
+
+        // The copy is recorded into commandBuffer and becomes readable once that command
+        // buffer's submission is reported through OnSubmit and completes.
+        std::future<std::vector<uint8_t>> ReadBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size);
+
+        // image must be in layout (TRANSFER_SRC_OPTIMAL or GENERAL) when the copy executes
+        std::future<ReadbackImage> ReadImage(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout layout, VkFormat format, VkExtent2D extent);
+        void ReadImage(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout layout, VkFormat format, VkExtent2D extent, std::promise<ReadbackImage> promise);
+
+        // Tags requests recorded into commandBuffer with the timeline value its submission signals
+        void OnSubmit(VkCommandBuffer commandBuffer, uint64_t timelineValue);
+        // Fulfills every submitted request at or below completedValue
+        void Resolve(uint64_t completedValue);
+
+        uint32_t GetPendingCount() const { return (uint32_t)m_Requests.size(); }
+
+        // Bytes per texel for the uncompressed color formats readback supports, 0 otherwise
+        static uint32_t GetFormatSize(VkFormat format);
+
+    private:
+        struct StagingBuffer
+        {
+            VkBuffer Buffer = VK_NULL_HANDLE;
+            VkDeviceMemory Memory = VK_NULL_HANDLE;
+            VkDeviceSize Size = 0;
+            void* Mapped = nullptr;
+            bool Coherent = true;
+        };
+
+        struct Request
+        {
+            VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+            uint64_t TimelineValue = 0; // 0 until the command buffer was submitted
+            StagingBuffer Staging;
+            VkDeviceSize Size = 0;
+
+            bool IsImage = false;
+            std::promise<std::vector<uint8_t>> BufferPromise;
+            std::promise<ReadbackImage> ImagePromise;
+            uint32_t Width = 0, Height = 0;
+            VkFormat Format = VK_FORMAT_UNDEFINED;
+        };
+
+        StagingBuffer AcquireStaging(VkDeviceSize size);
+        void ReleaseStaging(const StagingBuffer& staging);
+        void DestroyStaging(const StagingBuffer& staging);
+        void RecordHostBarrier(VkCommandBuffer commandBuffer, VkBuffer buffer);
+        void Fulfill(Request& request);
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* m_Allocator = nullptr;
+
+        std::vector<Request> m_Requests;
+        std::vector<StagingBuffer> m_FreeBuffers;
+    };
+
+}
@@ -0,0 +1,824 @@
+#include "VulkanRenderGraph.h"
+
+#include "VulkanContext.h"
+#include "GGEngine/Hash.h"
+
+namespace GGEngine {
+
+    namespace {
+
+        struct UsageInfo
+        {
+            VkPipelineStageFlags Stages;
+            VkAccessFlags Access;
+            VkImageLayout Layout;
+            VkImageUsageFlags ImageUsage;
+            VkBufferUsageFlags BufferUsage;
+        };
+
+        const VkAccessFlags WriteAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+            | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+        UsageInfo GetUsageInfo(RenderGraphUsage usage)
+        {
+            const VkPipelineStageFlags depthStages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            const VkPipelineStageFlags graphicsShaders = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            switch (usage)
+            {
+            case RenderGraphUsage::ColorAttachment:
+                return { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, 0 };
+            case RenderGraphUsage::DepthAttachment:
+                return { depthStages, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 0 };
+            case RenderGraphUsage::DepthRead:
+                return { depthStages, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 0 };
+            case RenderGraphUsage::SampledFragment:
+                return { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, 0 };
+            case RenderGraphUsage::SampledCompute:
+                return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, 0 };
+            case RenderGraphUsage::StorageReadGraphics:
+                return { graphicsShaders, VK_ACCESS_SHADER_READ_BIT,
+                    VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT };
+            case RenderGraphUsage::StorageReadCompute:
+                return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                    VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT };
+            case RenderGraphUsage::StorageWriteCompute:
+                return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT };
+            case RenderGraphUsage::TransferSrc:
+                return { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_BUFFER_USAGE_TRANSFER_SRC_BIT };
+            case RenderGraphUsage::TransferDst:
+                return { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT, VK_BUFFER_USAGE_TRANSFER_DST_BIT };
+            case RenderGraphUsage::VertexBuffer:
+                return { VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+                    VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT };
+            case RenderGraphUsage::IndexBuffer:
+                return { VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT,
+                    VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_INDEX_BUFFER_BIT };
+            case RenderGraphUsage::IndirectBuffer:
+                return { VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+                    VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT };
+            case RenderGraphUsage::UniformBuffer:
+                return { graphicsShaders | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_UNIFORM_READ_BIT,
+                    VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT };
+            }
+            return {};
+        }
+
+        VkImageAspectFlags GetAspect(VkFormat format)
+        {
+            switch (format)
+            {
+            case VK_FORMAT_D16_UNORM:
+            case VK_FORMAT_X8_D24_UNORM_PACK32:
+            case VK_FORMAT_D32_SFLOAT:
+                return VK_IMAGE_ASPECT_DEPTH_BIT;
+            case VK_FORMAT_D16_UNORM_S8_UINT:
+            case VK_FORMAT_D24_UNORM_S8_UINT:
+            case VK_FORMAT_D32_SFLOAT_S8_UINT:
+                return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+            case VK_FORMAT_S8_UINT:
+                return VK_IMAGE_ASPECT_STENCIL_BIT;
+            default:
+                return VK_IMAGE_ASPECT_COLOR_BIT;
+            }
+        }
+
+        VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        // Synchronization state of one resource while barriers are planned
+        struct ResourceState
+        {
+            VkImageLayout Layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            VkPipelineStageFlags WriteStages = 0;   // Last write (or layout transition)
+            VkAccessFlags WriteAccess = 0;
+            VkPipelineStageFlags ReadStages = 0;    // Reads since the last write
+            VkPipelineStageFlags VisibleStages = 0; // Stages the last write was made visible to
+            VkAccessFlags VisibleAccess = 0;
+            bool Used = false;
+        };
+
+    }
+
+    // ---- Declaration --------------------------------------------------------------------
+
+    RenderGraphResource RenderGraphBuilder::CreateImage(const std::string& name, const RenderGraphImageDesc& desc)
+    {
+        VulkanRenderGraph::Resource resource;
+        resource.Name = name;
+        resource.IsImage = true;
+        resource.ImageDesc = desc;
+        const RenderGraphResource handle = (RenderGraphResource)m_Graph.m_Resources.size();
+        m_Graph.m_Resources.push_back(std::move(resource));
+        m_Graph.m_ResourceNames[name] = handle;
+        return handle;
+    }
+
+    RenderGraphResource RenderGraphBuilder::CreateBuffer(const std::string& name, const RenderGraphBufferDesc& desc)
+    {
+        VulkanRenderGraph::Resource resource;
+        resource.Name = name;
+        resource.IsImage = false;
+        resource.BufferDesc = desc;
+        const RenderGraphResource handle = (RenderGraphResource)m_Graph.m_Resources.size();
+        m_Graph.m_Resources.push_back(std::move(resource));
+        m_Graph.m_ResourceNames[name] = handle;
+        return handle;
+    }
+
+    void RenderGraphBuilder::Read(RenderGraphResource resource, RenderGraphUsage usage)
+    {
+        GG_CORE_ASSERT(resource < m_Graph.m_Resources.size(), "Render graph: invalid resource");
+        m_Graph.m_Passes[m_Pass].Uses.push_back({ resource, usage, false, VK_IMAGE_LAYOUT_UNDEFINED });
+    }
+
+    void RenderGraphBuilder::Write(RenderGraphResource resource, RenderGraphUsage usage, VkImageLayout finalLayout)
+    {
+        GG_CORE_ASSERT(resource < m_Graph.m_Resources.size(), "Render graph: invalid resource");
+        m_Graph.m_Passes[m_Pass].Uses.push_back({ resource, usage, true, finalLayout });
+    }
+
+    void RenderGraphBuilder::SetSideEffects()
+    {
+        m_Graph.m_Passes[m_Pass].SideEffects = true;
+    }
+
+    const RenderGraphImage& RenderGraphPassContext::GetImage(RenderGraphResource resource) const
+    {
+        return m_Graph.m_Resources[resource].Image;
+    }
+
+    const RenderGraphBuffer& RenderGraphPassContext::GetBuffer(RenderGraphResource resource) const
+    {
+        return m_Graph.m_Resources[resource].Buffer;
+    }
+
+    VkExtent2D RenderGraphPassContext::GetFrameExtent() const
+    {
+        return m_Graph.m_Extent;
+    }
+
+    void VulkanRenderGraph::Init(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator)
+    {
+        m_Device = device;
+        m_PhysicalDevice = physicalDevice;
+        m_Allocator = allocator;
+    }
+
+    void VulkanRenderGraph::Shutdown()
+    {
+        DestroyCompiled(m_Compiled, false);
+        m_Compiled = CompiledGraph();
+        m_HasCompiled = false;
+        m_Passes.clear();
+        m_Resources.clear();
+        m_ResourceNames.clear();
+    }
+
+    void VulkanRenderGraph::BeginFrame(VkExtent2D extent)
+    {
+        m_Extent = extent;
+        m_Passes.clear();
+        m_Resources.clear();
+        m_ResourceNames.clear();
+    }
+
+    RenderGraphResource VulkanRenderGraph::ImportImage(const std::string& name, const RenderGraphImage& image,
+        VkImageLayout initialLayout, VkPipelineStageFlags initialStages, VkImageLayout finalLayout)
+    {
+        Resource resource;
+        resource.Name = name;
+        resource.IsImage = true;
+        resource.Imported = true;
+        resource.ImageDesc.Width = image.Extent.width;
+        resource.ImageDesc.Height = image.Extent.height;
+        resource.ImageDesc.Format = image.Format;
+        resource.InitialLayout = initialLayout;
+        resource.InitialStages = initialStages;
+        resource.FinalLayout = finalLayout;
+        resource.Image = image;
+        const RenderGraphResource handle = (RenderGraphResource)m_Resources.size();
+        m_Resources.push_back(std::move(resource));
+        m_ResourceNames[name] = handle;
+        return handle;
+    }
+
+    RenderGraphResource VulkanRenderGraph::ImportBuffer(const std::string& name, const RenderGraphBuffer& buffer, VkPipelineStageFlags initialStages)
+    {
+        Resource resource;
+        resource.Name = name;
+        resource.IsImage = false;
+        resource.Imported = true;
+        resource.BufferDesc.Size = buffer.Size;
+        resource.InitialStages = initialStages;
+        resource.Buffer = buffer;
+        const RenderGraphResource handle = (RenderGraphResource)m_Resources.size();
+        m_Resources.push_back(std::move(resource));
+        m_ResourceNames[name] = handle;
+        return handle;
+    }
+
+    void VulkanRenderGraph::AddPass(const std::string& name, const SetupFn& setup, const ExecuteFn& execute)
+    {
+        const uint32_t index = (uint32_t)m_Passes.size();
+        m_Passes.emplace_back();
+        m_Passes.back().Name = name;
+        m_Passes.back().Execute = execute;
+        RenderGraphBuilder builder(*this, index);
+        setup(builder);
+    }
+
+    RenderGraphResource VulkanRenderGraph::Find(const std::string& name) const
+    {
+        auto it = m_ResourceNames.find(name);
+        return it != m_ResourceNames.end() ? it->second : RenderGraphNullResource;
+    }
+
+    // ---- Compilation --------------------------------------------------------------------
+
+    uint64_t VulkanRenderGraph::HashTopology() const
+    {
+        // Everything the plan depends on; imported handles are rebound every frame instead
+        uint64_t hash = Hash::FNV1aBasis;
+        for (const Resource& resource : m_Resources)
+        {
+            hash = Hash::FNV1a64(resource.Name, hash);
+            hash = Hash::Value(resource.IsImage, hash);
+            hash = Hash::Value(resource.Imported, hash);
+            if (resource.IsImage)
+            {
+                hash = Hash::Value(resource.ImageDesc.Width != 0 ? resource.ImageDesc.Width : m_Extent.width, hash);
+                hash = Hash::Value(resource.ImageDesc.Height != 0 ? resource.ImageDesc.Height : m_Extent.height, hash);
+                hash = Hash::Value(resource.ImageDesc.Format, hash);
+                hash = Hash::Value(resource.ImageDesc.Samples, hash);
+                hash = Hash::Value(resource.ImageDesc.ExtraUsage, hash);
+                hash = Hash::Value(resource.InitialLayout, hash);
+                hash = Hash::Value(resource.InitialStages, hash);
+                hash = Hash::Value(resource.FinalLayout, hash);
+            }
+            else
+            {
+                hash = Hash::Value(resource.BufferDesc.Size, hash);
+                hash = Hash::Value(resource.BufferDesc.ExtraUsage, hash);
+                hash = Hash::Value(resource.InitialStages, hash);
+            }
+        }
+        for (const Pass& pass : m_Passes)
+        {
+            hash = Hash::FNV1a64(pass.Name, hash);
+            hash = Hash::Value(pass.SideEffects, hash);
+            for (const ResourceUse& use : pass.Uses)
+            {
+                hash = Hash::Value(use.Resource, hash);
+                hash = Hash::Value(use.Usage, hash);
+                hash = Hash::Value(use.Write, hash);
+                hash = Hash::Value(use.FinalLayout, hash);
+            }
+        }
+        return hash;
+    }
+
+    void VulkanRenderGraph::Compile()
+    {
+        const uint64_t topology = HashTopology();
+        if (!m_HasCompiled || topology != m_Compiled.Topology)
+        {
+            CompiledGraph compiled;
+            compiled.Topology = topology;
+            CullPasses(compiled.Order);
+
+            // Lifetimes (first and last kept pass) and accumulated usage flags of transients
+            const uint32_t noPass = UINT32_MAX;
+            std::vector<std::pair<uint32_t, uint32_t>> lifetimes(m_Resources.size(), { noPass, 0 });
+            std::vector<uint32_t> usageFlags(m_Resources.size(), 0);
+            for (uint32_t i = 0; i < (uint32_t)compiled.Order.size(); i++)
+            {
+                for (const ResourceUse& use : m_Passes[compiled.Order[i]].Uses)
+                {
+                    std::pair<uint32_t, uint32_t>& lifetime = lifetimes[use.Resource];
+                    if (lifetime.first == noPass)
+                        lifetime.first = i;
+                    lifetime.second = i;
+                    const UsageInfo info = GetUsageInfo(use.Usage);
+                    usageFlags[use.Resource] |= m_Resources[use.Resource].IsImage ? info.ImageUsage : info.BufferUsage;
+                }
+            }
+
+            uint64_t allocation = Hash::Value(m_Extent.width);
+            allocation = Hash::Value(m_Extent.height, allocation);
+            for (RenderGraphResource r = 0; r < (RenderGraphResource)m_Resources.size(); r++)
+            {
+                if (m_Resources[r].Imported || lifetimes[r].first == noPass)
+                    continue;
+                allocation = Hash::Value(r, allocation);
+                allocation = Hash::Value(lifetimes[r].first, allocation);
+                allocation = Hash::Value(lifetimes[r].second, allocation);
+                allocation = Hash::Value(usageFlags[r], allocation);
+                allocation = Hash::Value(m_Resources[r].IsImage ? m_Resources[r].ImageDesc.Format : VK_FORMAT_UNDEFINED, allocation);
+                allocation = Hash::Value(m_Resources[r].ImageDesc.Width, allocation);
+                allocation = Hash::Value(m_Resources[r].ImageDesc.Height, allocation);
+                allocation = Hash::Value(m_Resources[r].ImageDesc.Samples, allocation);
+                allocation = Hash::Value(m_Resources[r].ImageDesc.ExtraUsage, allocation);
+                allocation = Hash::Value(m_Resources[r].BufferDesc.Size, allocation);
+                allocation = Hash::Value(m_Resources[r].BufferDesc.ExtraUsage, allocation);
+            }
+            compiled.Allocation = allocation;
+
+            // Passes that come and go without touching transients (a readback, say) only
+            // need new barriers; the memory layout stays
+            if (m_HasCompiled && allocation == m_Compiled.Allocation)
+            {
+                compiled.TransientIndex = std::move(m_Compiled.TransientIndex);
+                compiled.TransientIndex.resize(m_Resources.size(), -1);
+                compiled.Transients = std::move(m_Compiled.Transients);
+                compiled.Aliases = std::move(m_Compiled.Aliases);
+                compiled.Memory = std::move(m_Compiled.Memory);
+            }
+            else
+            {
+                // Passes from earlier frames may still be using the old transients
+                DestroyCompiled(m_Compiled, true);
+                AllocateTransients(compiled, lifetimes, usageFlags);
+            }
+            m_Compiled = std::move(compiled);
+            PlanBarriers(m_Compiled);
+
+            m_HasCompiled = true;
+            m_Stats.Compiles++;
+            m_Stats.DeclaredPasses = (uint32_t)m_Passes.size();
+            m_Stats.ExecutedPasses = (uint32_t)m_Compiled.Order.size();
+            m_Stats.Barriers = 0;
+            m_Stats.ImageBarriers = 0;
+            for (const BarrierBatch& batch : m_Compiled.PassBarriers)
+            {
+                m_Stats.Barriers += batch.IsEmpty() ? 0 : 1;
+                m_Stats.ImageBarriers += (uint32_t)batch.Images.size();
+            }
+            m_Stats.Barriers += m_Compiled.FinalBarriers.IsEmpty() ? 0 : 1;
+            m_Stats.ImageBarriers += (uint32_t)m_Compiled.FinalBarriers.Images.size();
+            GG_CORE_TRACE("Render graph compiled: {0}/{1} passes, {2} barriers, transients {3} KiB in {4} KiB",
+                m_Stats.ExecutedPasses, m_Stats.DeclaredPasses, m_Stats.Barriers, m_Stats.TransientBytes / 1024, m_Stats.TransientMemory / 1024);
+        }
+
+        // Bind this frame's declarations to the compiled transients
+        for (RenderGraphResource r = 0; r < (RenderGraphResource)m_Resources.size(); r++)
+        {
+            const int32_t index = m_Compiled.TransientIndex[r];
+            if (index < 0)
+                continue;
+            const Transient& transient = m_Compiled.Transients[index];
+            if (transient.IsImage)
+                m_Resources[r].Image = { transient.Image, transient.View, transient.Format, transient.Extent };
+            else
+                m_Resources[r].Buffer = { transient.Buffer, transient.Size };
+        }
+    }
+
+    void VulkanRenderGraph::CullPasses(std::vector<uint32_t>& order) const
+    {
+        // Walk back from the outputs: a pass is kept when it has side effects or writes an
+        // imported resource or one a kept pass reads. Writers keep resources needed, so
+        // every earlier writer of a needed resource (e.g. a clear before a load) stays.
+        std::vector<bool> needed(m_Resources.size(), false);
+        std::vector<bool> kept(m_Passes.size(), false);
+        for (uint32_t p = (uint32_t)m_Passes.size(); p-- > 0; )
+        {
+            const Pass& pass = m_Passes[p];
+            bool keep = pass.SideEffects;
+            for (const ResourceUse& use : pass.Uses)
+                keep |= use.Write && (m_Resources[use.Resource].Imported || needed[use.Resource]);
+            if (!keep)
+                continue;
+            kept[p] = true;
+            for (const ResourceUse& use : pass.Uses)
+                needed[use.Resource] = true;
+        }
+
+        for (uint32_t p = 0; p < (uint32_t)m_Passes.size(); p++)
+        {
+            if (kept[p])
+                order.push_back(p);
+        }
+    }
+
+    void VulkanRenderGraph::AllocateTransients(CompiledGraph& compiled, const std::vector<std::pair<uint32_t, uint32_t>>& lifetimes, const std::vector<uint32_t>& usageFlags)
+    {
+        struct Placement
+        {
+            uint32_t Transient;
+            VkMemoryRequirements Requirements;
+            uint32_t MemoryType;
+            uint32_t First, Last;
+            VkDeviceSize Offset = 0;
+            uint32_t Heap = 0;
+        };
+
+        VulkanContext& context = VulkanContext::Get();
+        compiled.TransientIndex.assign(m_Resources.size(), -1);
+        std::vector<Placement> placements;
+        m_Stats.TransientImages = 0;
+        m_Stats.TransientBuffers = 0;
+        m_Stats.TransientBytes = 0;
+        m_Stats.TransientMemory = 0;
+
+        for (RenderGraphResource r = 0; r < (RenderGraphResource)m_Resources.size(); r++)
+        {
+            const Resource& resource = m_Resources[r];
+            if (resource.Imported || lifetimes[r].first == UINT32_MAX)
+                continue;
+
+            Transient transient;
+            transient.IsImage = resource.IsImage;
+            VkMemoryRequirements requirements;
+            if (resource.IsImage)
+            {
+                transient.Format = resource.ImageDesc.Format;
+                transient.Extent.width = resource.ImageDesc.Width != 0 ? resource.ImageDesc.Width : m_Extent.width;
+                transient.Extent.height = resource.ImageDesc.Height != 0 ? resource.ImageDesc.Height : m_Extent.height;
+
+                VkImageCreateInfo imageInfo = {};
+                imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+                imageInfo.imageType = VK_IMAGE_TYPE_2D;
+                imageInfo.format = transient.Format;
+                imageInfo.extent = { transient.Extent.width, transient.Extent.height, 1 };
+                imageInfo.mipLevels = 1;
+                imageInfo.arrayLayers = 1;
+                imageInfo.samples = resource.ImageDesc.Samples;
+                imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+                imageInfo.usage = usageFlags[r] | resource.ImageDesc.ExtraUsage;
+                imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+                imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                VkResult err = vkCreateImage(m_Device, &imageInfo, m_Allocator, &transient.Image);
+                VulkanContext::CheckVkResult(err);
+                vkGetImageMemoryRequirements(m_Device, transient.Image, &requirements);
+                m_Stats.TransientImages++;
+            }
+            else
+            {
+                transient.Size = resource.BufferDesc.Size;
+
+                VkBufferCreateInfo bufferInfo = {};
+                bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+                bufferInfo.size = transient.Size;
+                bufferInfo.usage = usageFlags[r] | resource.BufferDesc.ExtraUsage;
+                bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+                VkResult err = vkCreateBuffer(m_Device, &bufferInfo, m_Allocator, &transient.Buffer);
+                VulkanContext::CheckVkResult(err);
+                vkGetBufferMemoryRequirements(m_Device, transient.Buffer, &requirements);
+                m_Stats.TransientBuffers++;
+            }
+
+            compiled.TransientIndex[r] = (int32_t)compiled.Transients.size();
+            Placement placement;
+            placement.Transient = (uint32_t)compiled.Transients.size();
+            placement.Requirements = requirements;
+            placement.MemoryType = context.FindMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            placement.First = lifetimes[r].first;
+            placement.Last = lifetimes[r].second;
+            placements.push_back(placement);
+            compiled.Transients.push_back(transient);
+            m_Stats.TransientBytes += requirements.size;
+        }
+
+        // Greedy placement, largest first: each transient goes to the lowest offset that does
+        // not collide with an already placed transient whose lifetime overlaps its own. Images
+        // and buffers use separate heaps so bufferImageGranularity never comes into play.
+        std::vector<uint32_t> bySize(placements.size());
+        for (uint32_t i = 0; i < (uint32_t)placements.size(); i++)
+            bySize[i] = i;
+        std::stable_sort(bySize.begin(), bySize.end(),
+            [&placements](uint32_t a, uint32_t b) { return placements[a].Requirements.size > placements[b].Requirements.size; });
+
+        struct Heap
+        {
+            uint32_t MemoryType;
+            bool Images;
+            VkDeviceSize Size = 0;
+            std::vector<uint32_t> Placed;
+        };
+        std::vector<Heap> heaps;
+
+        for (uint32_t index : bySize)
+        {
+            Placement& placement = placements[index];
+            const bool isImage = compiled.Transients[placement.Transient].IsImage;
+            auto heapIt = std::find_if(heaps.begin(), heaps.end(),
+                [&](const Heap& heap) { return heap.MemoryType == placement.MemoryType && heap.Images == isImage; });
+            if (heapIt == heaps.end())
+            {
+                heaps.push_back({ placement.MemoryType, isImage });
+                heapIt = heaps.end() - 1;
+            }
+            Heap& heap = *heapIt;
+            placement.Heap = (uint32_t)(heapIt - heaps.begin());
+
+            const VkDeviceSize size = placement.Requirements.size;
+            const VkDeviceSize alignment = placement.Requirements.alignment;
+            std::vector<VkDeviceSize> candidates = { 0 };
+            for (uint32_t other : heap.Placed)
+            {
+                const Placement& placed = placements[other];
+                if (placed.First <= placement.Last && placement.First <= placed.Last)
+                    candidates.push_back(AlignUp(placed.Offset + placed.Requirements.size, alignment));
+            }
+            std::sort(candidates.begin(), candidates.end());
+            for (VkDeviceSize offset : candidates)
+            {
+                bool fits = true;
+                for (uint32_t other : heap.Placed)
+                {
+                    const Placement& placed = placements[other];
+                    const bool livesTogether = placed.First <= placement.Last && placement.First <= placed.Last;
+                    const bool overlaps = offset < placed.Offset + placed.Requirements.size && placed.Offset < offset + size;
+                    if (livesTogether && overlaps)
+                    {
+                        fits = false;
+                        break;
+                    }
+                }
+                if (fits)
+                {
+                    placement.Offset = offset;
+                    break;
+                }
+            }
+            heap.Placed.push_back(index);
+            heap.Size = std::max(heap.Size, placement.Offset + size);
+        }
+
+        for (Heap& heap : heaps)
+        {
+            VkMemoryAllocateInfo allocInfo = {};
+            allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocInfo.allocationSize = heap.Size;
+            allocInfo.memoryTypeIndex = heap.MemoryType;
+            VkDeviceMemory memory;
+            VkResult err = vkAllocateMemory(m_Device, &allocInfo, m_Allocator, &memory);
+            VulkanContext::CheckVkResult(err);
+            compiled.Memory.push_back(memory);
+            m_Stats.TransientMemory += heap.Size;
+        }
+
+        compiled.Aliases.assign(compiled.Transients.size(), {});
+        for (const Placement& placement : placements)
+        {
+            Transient& transient = compiled.Transients[placement.Transient];
+            VkDeviceMemory memory = compiled.Memory[placement.Heap];
+            if (transient.IsImage)
+            {
+                VkResult err = vkBindImageMemory(m_Device, transient.Image, memory, placement.Offset);
+                VulkanContext::CheckVkResult(err);
+
+                VkImageViewCreateInfo viewInfo = {};
+                viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+                viewInfo.image = transient.Image;
+                viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+                viewInfo.format = transient.Format;
+                viewInfo.subresourceRange.aspectMask = GetAspect(transient.Format);
+                // Sampling a combined depth/stencil image needs a single aspect
+                if (viewInfo.subresourceRange.aspectMask == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT))
+                    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+                viewInfo.subresourceRange.levelCount = 1;
+                viewInfo.subresourceRange.layerCount = 1;
+                err = vkCreateImageView(m_Device, &viewInfo, m_Allocator, &transient.View);
+                VulkanContext::CheckVkResult(err);
+            }
+            else
+            {
+                VkResult err = vkBindBufferMemory(m_Device, transient.Buffer, memory, placement.Offset);
+                VulkanContext::CheckVkResult(err);
+            }
+
+            // Transients sharing bytes, whatever their lifetimes: the first use of one has
+            // to wait for the last uses of the others, in this frame or the previous one
+            for (const Placement& other : placements)
+            {
+                if (other.Transient != placement.Transient && other.Heap == placement.Heap
+                    && placement.Offset < other.Offset + other.Requirements.size && other.Offset < placement.Offset + placement.Requirements.size)
+                    compiled.Aliases[placement.Transient].push_back(other.Transient);
+            }
+        }
+    }
+
+    void VulkanRenderGraph::PlanBarriers(CompiledGraph& compiled)
+    {
+        // Everything a transient is used for in a frame; the next frame's first use (of it or
+        // of anything aliasing it) has to wait for all of it
+        std::vector<VkPipelineStageFlags> transientStages(compiled.Transients.size(), 0);
+        std::vector<VkAccessFlags> transientWrites(compiled.Transients.size(), 0);
+        for (uint32_t passIndex : compiled.Order)
+        {
+            for (const ResourceUse& use : m_Passes[passIndex].Uses)
+            {
+                const int32_t transient = compiled.TransientIndex[use.Resource];
+                if (transient < 0)
+                    continue;
+                const UsageInfo info = GetUsageInfo(use.Usage);
+                transientStages[transient] |= info.Stages;
+                if (use.Write)
+                    transientWrites[transient] |= info.Access & WriteAccessMask;
+            }
+        }
+
+        std::vector<ResourceState> states(m_Resources.size());
+        for (RenderGraphResource r = 0; r < (RenderGraphResource)m_Resources.size(); r++)
+        {
+            ResourceState& state = states[r];
+            const int32_t transient = compiled.TransientIndex[r];
+            if (m_Resources[r].Imported)
+            {
+                state.Layout = m_Resources[r].InitialLayout;
+                state.WriteStages = m_Resources[r].InitialStages;
+            }
+            else if (transient >= 0)
+            {
+                state.WriteStages = transientStages[transient];
+                state.WriteAccess = transientWrites[transient];
+                for (uint32_t other : compiled.Aliases[transient])
+                {
+                    state.WriteStages |= transientStages[other];
+                    state.WriteAccess |= transientWrites[other];
+                }
+            }
+        }
+
+        compiled.PassBarriers.resize(compiled.Order.size());
+        for (uint32_t i = 0; i < (uint32_t)compiled.Order.size(); i++)
+        {
+            BarrierBatch& batch = compiled.PassBarriers[i];
+            for (const ResourceUse& use : m_Passes[compiled.Order[i]].Uses)
+            {
+                const UsageInfo info = GetUsageInfo(use.Usage);
+                ResourceState& state = states[use.Resource];
+                const bool isImage = m_Resources[use.Resource].IsImage;
+                state.Used = true;
+
+                if (isImage && info.Layout != state.Layout)
+                {
+                    // Layout transitions count as writes: later readers wait on them
+                    batch.Images.push_back({ use.Resource, state.Layout, info.Layout, state.WriteAccess, info.Access });
+                    batch.SrcStages |= state.WriteStages | state.ReadStages;
+                    batch.DstStages |= info.Stages;
+                    state.Layout = info.Layout;
+                    state.WriteStages = info.Stages;
+                    state.WriteAccess = use.Write ? info.Access & WriteAccessMask : 0;
+                    state.ReadStages = use.Write ? 0 : info.Stages;
+                    state.VisibleStages = use.Write ? 0 : info.Stages;
+                    state.VisibleAccess = use.Write ? 0 : info.Access;
+                }
+                else if (use.Write)
+                {
+                    // Write after write needs the earlier writes made available; write after
+                    // read only needs the reads to have executed
+                    if (state.WriteStages != 0 || state.ReadStages != 0)
+                    {
+                        batch.SrcStages |= state.WriteStages | state.ReadStages;
+                        batch.DstStages |= info.Stages;
+                        if (state.WriteAccess != 0)
+                        {
+                            batch.MemorySrcAccess |= state.WriteAccess;
+                            batch.MemoryDstAccess |= info.Access;
+                        }
+                    }
+                    state.WriteStages = info.Stages;
+                    state.WriteAccess = info.Access & WriteAccessMask;
+                    state.ReadStages = 0;
+                    state.VisibleStages = 0;
+                    state.VisibleAccess = 0;
+                }
+                else
+                {
+                    // Read after read needs nothing; read after write once per stage and access
+                    const bool visible = (state.VisibleStages & info.Stages) == info.Stages && (state.VisibleAccess & info.Access) == info.Access;
+                    if (state.WriteStages != 0 && !visible)
+                    {
+                        batch.SrcStages |= state.WriteStages;
+                        batch.DstStages |= info.Stages;
+                        if (state.WriteAccess != 0)
+                        {
+                            batch.MemorySrcAccess |= state.WriteAccess;
+                            batch.MemoryDstAccess |= info.Access;
+                        }
+                        state.VisibleStages |= info.Stages;
+                        state.VisibleAccess |= info.Access;
+                    }
+                    state.ReadStages |= info.Stages;
+                }
+
+                if (use.FinalLayout != VK_IMAGE_LAYOUT_UNDEFINED)
+                    state.Layout = use.FinalLayout;
+            }
+        }
+
+        // Imported images leave in the layout their owner expects
+        for (RenderGraphResource r = 0; r < (RenderGraphResource)m_Resources.size(); r++)
+        {
+            const Resource& resource = m_Resources[r];
+            const ResourceState& state = states[r];
+            if (!resource.Imported || !resource.IsImage || !state.Used
+                || resource.FinalLayout == VK_IMAGE_LAYOUT_UNDEFINED || resource.FinalLayout == state.Layout)
+                continue;
+            const bool present = resource.FinalLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+            compiled.FinalBarriers.Images.push_back({ r, state.Layout, resource.FinalLayout, state.WriteAccess, present ? 0u : (VkAccessFlags)VK_ACCESS_MEMORY_READ_BIT });
+            compiled.FinalBarriers.SrcStages |= state.WriteStages | state.ReadStages;
+            compiled.FinalBarriers.DstStages |= present ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        }
+    }
+
+    void VulkanRenderGraph::DestroyCompiled(CompiledGraph& compiled, bool deferred)
+    {
+        if (compiled.Transients.empty() && compiled.Memory.empty())
+            return;
+
+        auto destroy = [device = m_Device, allocator = m_Allocator, transients = std::move(compiled.Transients), memory = std::move(compiled.Memory)]()
+        {
+            for (const Transient& transient : transients)
+            {
+                if (transient.IsImage)
+                {
+                    vkDestroyImageView(device, transient.View, allocator);
+                    vkDestroyImage(device, transient.Image, allocator);
+                }
+                else
+                {
+                    vkDestroyBuffer(device, transient.Buffer, allocator);
+                }
+            }
+            for (VkDeviceMemory allocation : memory)
+                vkFreeMemory(device, allocation, allocator);
+        };
+        if (deferred)
+            VulkanContext::Get().DeferDestroy(destroy);
+        else
+            destroy();
+        compiled.Transients.clear();
+        compiled.Memory.clear();
+    }
+
+    // ---- Execution ----------------------------------------------------------------------
+
+    void VulkanRenderGraph::Execute(VkCommandBuffer commandBuffer)
+    {
+        RenderGraphPassContext context(*this, commandBuffer);
+        for (uint32_t i = 0; i < (uint32_t)m_Compiled.Order.size(); i++)
+        {
+            RecordBarriers(commandBuffer, m_Compiled.PassBarriers[i]);
+            m_Passes[m_Compiled.Order[i]].Execute(context);
+        }
+        RecordBarriers(commandBuffer, m_Compiled.FinalBarriers);
+    }
+
+    void VulkanRenderGraph::RecordBarriers(VkCommandBuffer commandBuffer, const BarrierBatch& batch)
+    {
+        if (batch.IsEmpty())
+            return;
+
+        VkImageMemoryBarrier imageBarriers[16];
+        std::vector<VkImageMemoryBarrier> overflow;
+        VkImageMemoryBarrier* barriers = imageBarriers;
+        if (batch.Images.size() > sizeof(imageBarriers) / sizeof(imageBarriers[0]))
+        {
+            overflow.resize(batch.Images.size());
+            barriers = overflow.data();
+        }
+        for (size_t i = 0; i < batch.Images.size(); i++)
+        {
+            const ImageBarrier& plan = batch.Images[i];
+            const RenderGraphImage& image = m_Resources[plan.Resource].Image;
+            VkImageMemoryBarrier& barrier = barriers[i];
+            barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = plan.SrcAccess;
+            barrier.dstAccessMask = plan.DstAccess;
+            barrier.oldLayout = plan.OldLayout;
+            barrier.newLayout = plan.NewLayout;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = image.Image;
+            barrier.subresourceRange.aspectMask = GetAspect(image.Format);
+            barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+            barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+        }
+
+        VkMemoryBarrier memoryBarrier = {};
+        memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memoryBarrier.srcAccessMask = batch.MemorySrcAccess;
+        memoryBarrier.dstAccessMask = batch.MemoryDstAccess;
+        const bool hasMemoryBarrier = batch.MemorySrcAccess != 0 || batch.MemoryDstAccess != 0;
+
+        vkCmdPipelineBarrier(commandBuffer,
+            batch.SrcStages != 0 ? batch.SrcStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            batch.DstStages != 0 ? batch.DstStages : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0, hasMemoryBarrier ? 1 : 0, &memoryBarrier, 0, nullptr, (uint32_t)batch.Images.size(), barriers);
+    }
+
+}
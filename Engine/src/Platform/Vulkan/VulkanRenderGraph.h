@@ -0,0 +1,262 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+namespace GGEngine {
+
+    // Handle to a resource declared this frame
+    using RenderGraphResource = uint32_t;
+    constexpr RenderGraphResource RenderGraphNullResource = UINT32_MAX;
+
+    // How a pass touches a resource. Decides the image layout, the pipeline stages and
+    // accesses that barriers are built from, and the usage flags of transient resources.
+    enum class RenderGraphUsage
+    {
+        ColorAttachment,     // Read-write (load/blend)
+        DepthAttachment,     // Read-write depth test
+        DepthRead,           // Depth test without writes
+        SampledFragment,
+        SampledCompute,
+        StorageReadGraphics, // Storage image/buffer read by vertex or fragment shaders
+        StorageReadCompute,
+        StorageWriteCompute, // Read-write
+        TransferSrc,
+        TransferDst,
+        VertexBuffer,
+        IndexBuffer,
+        IndirectBuffer,
+        UniformBuffer
+    };
+
+    // Width/Height of 0 follow the frame extent
+    struct RenderGraphImageDesc
+    {
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        VkFormat Format = VK_FORMAT_R8G8B8A8_UNORM;
+        VkSampleCountFlagBits Samples = VK_SAMPLE_COUNT_1_BIT;
+        VkImageUsageFlags ExtraUsage = 0; // Added to what the declared usages need
+    };
+
+    struct RenderGraphBufferDesc
+    {
+        VkDeviceSize Size = 0;
+        VkBufferUsageFlags ExtraUsage = 0;
+    };
+
+    // Physical resources as pass callbacks see them
+    struct RenderGraphImage
+    {
+        VkImage Image = VK_NULL_HANDLE;
+        VkImageView View = VK_NULL_HANDLE;
+        VkFormat Format = VK_FORMAT_UNDEFINED;
+        VkExtent2D Extent = {};
+    };
+
+    struct RenderGraphBuffer
+    {
+        VkBuffer Buffer = VK_NULL_HANDLE;
+        VkDeviceSize Size = 0;
+    };
+
+    struct RenderGraphStats
+    {
+        uint32_t DeclaredPasses = 0;
+        uint32_t ExecutedPasses = 0;  // After culling
+        uint32_t Barriers = 0;        // vkCmdPipelineBarrier calls per frame
+        uint32_t ImageBarriers = 0;
+        uint32_t TransientImages = 0;
+        uint32_t TransientBuffers = 0;
+        uint64_t TransientBytes = 0;  // Sum of every transient's size
+        uint64_t TransientMemory = 0; // Actually allocated, after aliasing
+        uint32_t Compiles = 0;
+    };
+
+    class VulkanRenderGraph;
+
+    // Handed to a pass's setup callback to declare what it reads and writes
+    class RenderGraphBuilder
+    {
+    public:
+        // Transient resources live only within the frame. Their memory is shared with other
+        // transients whose lifetimes do not overlap, and contents never survive a frame.
+        RenderGraphResource CreateImage(const std::string& name, const RenderGraphImageDesc& desc);
+        RenderGraphResource CreateBuffer(const std::string& name, const RenderGraphBufferDesc& desc);
+
+        void Read(RenderGraphResource resource, RenderGraphUsage usage);
+        // finalLayout: layout the pass leaves the image in when it is not the usage's layout,
+        // e.g. a VkRenderPass with its own finalLayout
+        void Write(RenderGraphResource resource, RenderGraphUsage usage, VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED);
+
+        // Keeps the pass even when nothing reads what it writes (readbacks, queries)
+        void SetSideEffects();
+
+    private:
+        friend class VulkanRenderGraph;
+        RenderGraphBuilder(VulkanRenderGraph& graph, uint32_t pass) : m_Graph(graph), m_Pass(pass) {}
+
+        VulkanRenderGraph& m_Graph;
+        uint32_t m_Pass;
+    };
+
+    // Handed to a pass's execute callback. Barriers for everything the pass declared have
+    // been recorded; the pass records its own rendering/dispatch commands.
+    class RenderGraphPassContext
+    {
+    public:
+        VkCommandBuffer GetCommandBuffer() const { return m_CommandBuffer; }
+        const RenderGraphImage& GetImage(RenderGraphResource resource) const;
+        const RenderGraphBuffer& GetBuffer(RenderGraphResource resource) const;
+        VkExtent2D GetFrameExtent() const;
+
+    private:
+        friend class VulkanRenderGraph;
+        RenderGraphPassContext(const VulkanRenderGraph& graph, VkCommandBuffer commandBuffer) : m_Graph(graph), m_CommandBuffer(commandBuffer) {}
+
+        const VulkanRenderGraph& m_Graph;
+        VkCommandBuffer m_CommandBuffer;
+    };
+
+    // Frame render graph. Passes are declared every frame, in execution order, with the
+    // resources they read and write; Compile culls passes that contribute to no imported
+    // resource or side effect, plans the barriers between passes and places transient
+    // resources in shared memory. The plan is only rebuilt when the declared topology
+    // changes, so steady-state frames pay for declaration and the recorded barriers only.
+    class VulkanRenderGraph
+    {
+    public:
+        using SetupFn = std::function<void(RenderGraphBuilder& builder)>;
+        using ExecuteFn = std::function<void(RenderGraphPassContext& context)>;
+
+        void Init(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator);
+        // Destroys transient resources immediately; the device must be idle
+        void Shutdown();
+
+        // Drops last frame's declarations
+        void BeginFrame(VkExtent2D extent);
+
+        // External images enter the graph in initialLayout, with earlier writes covered by
+        // initialStages, and are transitioned to finalLayout after the last pass using them
+        RenderGraphResource ImportImage(const std::string& name, const RenderGraphImage& image,
+            VkImageLayout initialLayout, VkPipelineStageFlags initialStages, VkImageLayout finalLayout);
+        // Writes to imported buffers from before the graph must already be visible; the first
+        // use waits for initialStages, e.g. reads by the previous frame before overwriting
+        RenderGraphResource ImportBuffer(const std::string& name, const RenderGraphBuffer& buffer, VkPipelineStageFlags initialStages = 0);
+
+        void AddPass(const std::string& name, const SetupFn& setup, const ExecuteFn& execute);
+
+        // Resource declared earlier this frame, or RenderGraphNullResource
+        RenderGraphResource Find(const std::string& name) const;
+
+        void Compile();
+        // Records barriers and the kept passes into commandBuffer
+        void Execute(VkCommandBuffer commandBuffer);
+
+        const RenderGraphStats& GetStats() const { return m_Stats; }
+
+    private:
+        friend class RenderGraphBuilder;
+        friend class RenderGraphPassContext;
+
+        struct ResourceUse
+        {
+            RenderGraphResource Resource;
+            RenderGraphUsage Usage;
+            bool Write;
+            VkImageLayout FinalLayout;
+        };
+
+        struct Pass
+        {
+            std::string Name;
+            std::vector<ResourceUse> Uses;
+            ExecuteFn Execute;
+            bool SideEffects = false;
+        };
+
+        struct Resource
+        {
+            std::string Name;
+            bool IsImage = true;
+            bool Imported = false;
+            RenderGraphImageDesc ImageDesc;
+            RenderGraphBufferDesc BufferDesc;
+            // Imported resources
+            VkImageLayout InitialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            VkPipelineStageFlags InitialStages = 0;
+            VkImageLayout FinalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            // Bound physical resource: imported, or a compiled transient's
+            RenderGraphImage Image;
+            RenderGraphBuffer Buffer;
+        };
+
+        struct ImageBarrier
+        {
+            RenderGraphResource Resource;
+            VkImageLayout OldLayout;
+            VkImageLayout NewLayout;
+            VkAccessFlags SrcAccess;
+            VkAccessFlags DstAccess;
+        };
+
+        // One vkCmdPipelineBarrier: image barriers for layout changes, a global memory
+        // barrier for every other hazard
+        struct BarrierBatch
+        {
+            VkPipelineStageFlags SrcStages = 0;
+            VkPipelineStageFlags DstStages = 0;
+            VkAccessFlags MemorySrcAccess = 0;
+            VkAccessFlags MemoryDstAccess = 0;
+            std::vector<ImageBarrier> Images;
+
+            bool IsEmpty() const { return SrcStages == 0 && DstStages == 0 && Images.empty(); }
+        };
+
+        // Physical transients and the memory they alias into, kept while the topology holds
+        struct Transient
+        {
+            bool IsImage = true;
+            VkImage Image = VK_NULL_HANDLE;
+            VkImageView View = VK_NULL_HANDLE;
+            VkBuffer Buffer = VK_NULL_HANDLE;
+            VkExtent2D Extent = {};
+            VkFormat Format = VK_FORMAT_UNDEFINED;
+            VkDeviceSize Size = 0;
+        };
+
+        struct CompiledGraph
+        {
+            uint64_t Topology = 0;
+            uint64_t Allocation = 0;                // Transient descriptions, usages and lifetimes
+            std::vector<uint32_t> Order;            // Kept passes
+            std::vector<BarrierBatch> PassBarriers; // Before each pass in Order
+            BarrierBatch FinalBarriers;             // Imported images to their final layouts
+            std::vector<int32_t> TransientIndex;    // Per resource, into Transients or -1
+            std::vector<Transient> Transients;
+            std::vector<std::vector<uint32_t>> Aliases; // Per transient, others sharing its memory
+            std::vector<VkDeviceMemory> Memory;
+        };
+
+        uint64_t HashTopology() const;
+        void CullPasses(std::vector<uint32_t>& order) const;
+        void AllocateTransients(CompiledGraph& compiled, const std::vector<std::pair<uint32_t, uint32_t>>& lifetimes, const std::vector<uint32_t>& usageFlags);
+        void PlanBarriers(CompiledGraph& compiled);
+        void DestroyCompiled(CompiledGraph& compiled, bool deferred);
+        void RecordBarriers(VkCommandBuffer commandBuffer, const BarrierBatch& batch);
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* m_Allocator = nullptr;
+
+        VkExtent2D m_Extent = {};
+        std::vector<Pass> m_Passes;
+        std::vector<Resource> m_Resources;
+        std::unordered_map<std::string, RenderGraphResource> m_ResourceNames;
+
+        CompiledGraph m_Compiled;
+        bool m_HasCompiled = false;
+        RenderGraphStats m_Stats;
+    };
+
+}
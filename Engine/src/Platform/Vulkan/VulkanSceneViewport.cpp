@@ -0,0 +1,367 @@
+#include "VulkanSceneViewport.h"
+
+#include "VulkanContext.h"
+
+#include "imgui.h"
+
+namespace GGEngine {
+
+    std::shared_ptr<SceneViewport> SceneViewport::Create(const SceneViewportSpecification& specification)
+    {
+        return VulkanContext::Get().GetSceneRenderer().CreateViewport(specification);
+    }
+
+    VulkanSceneViewport::VulkanSceneViewport(VulkanSceneRenderer& renderer, const SceneViewportSpecification& specification)
+        : m_Renderer(renderer), m_Specification(specification)
+    {
+        m_Renderer.Register(this);
+    }
+
+    VulkanSceneViewport::~VulkanSceneViewport()
+    {
+        m_Renderer.Unregister(this);
+        RetireTarget();
+    }
+
+    void VulkanSceneViewport::Draw()
+    {
+        const ImVec2 size = ImGui::GetContentRegionAvail();
+        const ImVec2 scale = ImGui::GetIO().DisplayFramebufferScale;
+        if (size.x < 1.0f || size.y < 1.0f)
+            return;
+
+        Resize((uint32_t)(size.x * scale.x), (uint32_t)(size.y * scale.y));
+        const uint64_t textureID = GetImGuiTextureID();
+        if (textureID != 0)
+            ImGui::Image((ImTextureID)textureID, size);
+    }
+
+    void VulkanSceneViewport::Resize(uint32_t width, uint32_t height)
+    {
+        if (width == m_RequestedExtent.width && height == m_RequestedExtent.height)
+            return;
+        m_RequestedExtent = { width, height };
+        m_RequestTimer.Reset();
+    }
+
+    bool VulkanSceneViewport::IsResizePending() const
+    {
+        return m_RequestedExtent.width != m_Extent.width || m_RequestedExtent.height != m_Extent.height;
+    }
+
+    uint64_t VulkanSceneViewport::GetImGuiTextureID()
+    {
+        // The first target is created right away; later ones wait for the size to settle
+        if (IsResizePending() && m_RequestedExtent.width > 0 && m_RequestedExtent.height > 0
+            && (!m_Color || m_RequestTimer.Elapsed() >= m_Specification.ResizeDelaySeconds))
+        {
+            CreateTarget(m_RequestedExtent.width, m_RequestedExtent.height);
+        }
+
+        m_DisplayedFrame = ImGui::GetFrameCount();
+        return (uint64_t)m_ImGuiDescriptor;
+    }
+
+    void VulkanSceneViewport::CreateTarget(uint32_t width, uint32_t height)
+    {
+        RetireTarget();
+
+        VulkanContext& context = VulkanContext::Get();
+        VkDevice device = context.GetDevice();
+
+        VulkanImageSpec colorSpec;
+        colorSpec.Width = width;
+        colorSpec.Height = height;
+        colorSpec.Format = m_Renderer.GetColorFormat();
+        colorSpec.Usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        m_Color = std::make_unique<VulkanImage>();
+        m_Color->Create(colorSpec);
+
+        VulkanImageSpec depthSpec = colorSpec;
+        depthSpec.Format = m_Renderer.GetDepthFormat();
+        depthSpec.Usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        depthSpec.Aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+        m_Depth = std::make_unique<VulkanImage>();
+        m_Depth->Create(depthSpec);
+
+        if (!m_Renderer.UsesDynamicRendering())
+        {
+            const VkImageView attachments[2] = { m_Color->GetView(), m_Depth->GetView() };
+            VkFramebufferCreateInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            info.renderPass = m_Renderer.GetRenderPass();
+            info.attachmentCount = 2;
+            info.pAttachments = attachments;
+            info.width = width;
+            info.height = height;
+            info.layers = 1;
+            VkResult err = vkCreateFramebuffer(device, &info, context.GetAllocator(), &m_Framebuffer);
+            VulkanContext::CheckVkResult(err);
+        }
+
+        // The scene pass of every frame that displays the target leaves it in SHADER_READ_ONLY_OPTIMAL
+        m_ImGuiDescriptor = ImGui_ImplVulkan_AddTexture(m_Renderer.GetSampler(), m_Color->GetView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        m_Extent = { width, height };
+    }
+
+    void VulkanSceneViewport::RetireTarget()
+    {
+        if (!m_Color)
+            return;
+
+        // Frames in flight may still render into or sample the old target. The descriptor set
+        // came from the context's pool through ImGui_ImplVulkan_AddTexture, as for textures.
+        VulkanContext& context = VulkanContext::Get();
+        VkDevice device = context.GetDevice();
+        VkDescriptorPool pool = context.GetDescriptorPool();
+        const VkAllocationCallbacks* allocator = context.GetAllocator();
+        VkDescriptorSet descriptor = m_ImGuiDescriptor;
+        VkFramebuffer framebuffer = m_Framebuffer;
+        std::shared_ptr<VulkanImage> color(std::move(m_Color));
+        std::shared_ptr<VulkanImage> depth(std::move(m_Depth));
+        context.DeferDestroy([device, pool, allocator, descriptor, framebuffer, color, depth]() mutable
+        {
+            if (descriptor != VK_NULL_HANDLE)
+                vkFreeDescriptorSets(device, pool, 1, &descriptor);
+            if (framebuffer != VK_NULL_HANDLE)
+                vkDestroyFramebuffer(device, framebuffer, allocator);
+            color.reset();
+            depth.reset();
+        });
+
+        m_ImGuiDescriptor = VK_NULL_HANDLE;
+        m_Framebuffer = VK_NULL_HANDLE;
+        m_Extent = {};
+    }
+
+    void VulkanSceneRenderer::Init(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator, VkFormat colorFormat, bool useDynamicRendering)
+    {
+        m_Device = device;
+        m_Allocator = allocator;
+        m_ColorFormat = colorFormat;
+        m_UseDynamicRendering = useDynamicRendering;
+
+        // D32_SFLOAT is nearly universal; the spec only guarantees one of the last two
+        const VkFormat depthFormats[] = { VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT };
+        for (VkFormat format : depthFormats)
+        {
+            VkFormatProperties properties;
+            vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+            if (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT)
+            {
+                m_DepthFormat = format;
+                break;
+            }
+        }
+
+        VkSamplerCreateInfo samplerInfo = {};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        VkResult err = vkCreateSampler(m_Device, &samplerInfo, m_Allocator, &m_Sampler);
+        VulkanContext::CheckVkResult(err);
+
+        if (!m_UseDynamicRendering)
+            CreateRenderPass();
+    }
+
+    void VulkanSceneRenderer::Shutdown()
+    {
+        if (m_RenderPass != VK_NULL_HANDLE)
+            vkDestroyRenderPass(m_Device, m_RenderPass, m_Allocator);
+        m_RenderPass = VK_NULL_HANDLE;
+        if (m_Sampler != VK_NULL_HANDLE)
+            vkDestroySampler(m_Device, m_Sampler, m_Allocator);
+        m_Sampler = VK_NULL_HANDLE;
+        m_RenderCallbacks.clear();
+    }
+
+    std::shared_ptr<VulkanSceneViewport> VulkanSceneRenderer::CreateViewport(const SceneViewportSpecification& specification)
+    {
+        return std::make_shared<VulkanSceneViewport>(*this, specification);
+    }
+
+    uint32_t VulkanSceneRenderer::AddRenderCallback(const RenderCallbackFn& callback)
+    {
+        const uint32_t id = m_NextRenderCallbackId++;
+        m_RenderCallbacks.emplace_back(id, callback);
+        return id;
+    }
+
+    void VulkanSceneRenderer::RemoveRenderCallback(uint32_t id)
+    {
+        m_RenderCallbacks.erase(std::remove_if(m_RenderCallbacks.begin(), m_RenderCallbacks.end(),
+            [id](const auto& entry) { return entry.first == id; }), m_RenderCallbacks.end());
+    }
+
+    void VulkanSceneRenderer::Unregister(VulkanSceneViewport* viewport)
+    {
+        m_Viewports.erase(std::remove(m_Viewports.begin(), m_Viewports.end(), viewport), m_Viewports.end());
+    }
+
+    bool VulkanSceneRenderer::HasPendingResize() const
+    {
+        // A panel hidden mid-resize never applies it; only the ones still on screen (this
+        // ImGui frame or the last, depending on when this is asked) keep the loop awake
+        const int frame = ImGui::GetFrameCount();
+        for (const VulkanSceneViewport* viewport : m_Viewports)
+        {
+            if (viewport->m_DisplayedFrame >= frame - 1 && viewport->IsResizePending())
+                return true;
+        }
+        return false;
+    }
+
+    void VulkanSceneRenderer::AddPasses(VulkanRenderGraph& graph, std::vector<RenderGraphResource>& colorTargets)
+    {
+        const int frame = ImGui::GetFrameCount();
+        for (size_t i = 0; i < m_Viewports.size(); i++)
+        {
+            // Hidden panels did not ask for their texture this frame
+            const VulkanSceneViewport* viewport = m_Viewports[i];
+            if (viewport->m_DisplayedFrame != frame || !viewport->m_Color)
+                continue;
+
+            // Contents are cleared every frame, so both enter as UNDEFINED, after the previous
+            // frame's ImGui sampling and depth writes. The color target leaves ready for ImGui.
+            const std::string index = std::to_string(i);
+            const VkExtent2D extent = viewport->GetExtent();
+            const RenderGraphResource color = graph.ImportImage("SceneColor" + index,
+                { viewport->m_Color->GetImage(), viewport->m_Color->GetView(), m_ColorFormat, extent },
+                VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            const RenderGraphResource depth = graph.ImportImage("SceneDepth" + index,
+                { viewport->m_Depth->GetImage(), viewport->m_Depth->GetView(), m_DepthFormat, extent },
+                VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_IMAGE_LAYOUT_UNDEFINED);
+
+            graph.AddPass("Scene" + index,
+                [color, depth](RenderGraphBuilder& builder)
+                {
+                    builder.Write(color, RenderGraphUsage::ColorAttachment);
+                    builder.Write(depth, RenderGraphUsage::DepthAttachment);
+                },
+                [this, viewport](RenderGraphPassContext& context)
+                {
+                    RecordScene(context.GetCommandBuffer(), *viewport);
+                });
+            colorTargets.push_back(color);
+        }
+    }
+
+    void VulkanSceneRenderer::RecordScene(VkCommandBuffer commandBuffer, const VulkanSceneViewport& viewport) const
+    {
+        const VkExtent2D extent = viewport.GetExtent();
+        const float* clearColor = viewport.GetSpecification().ClearColor;
+        VkClearValue clearValues[2] = {};
+        memcpy(clearValues[0].color.float32, clearColor, sizeof(float) * 4);
+        clearValues[1].depthStencil = { 1.0f, 0 };
+
+        // The graph has moved both attachments to their attachment layouts
+        VulkanContext& context = VulkanContext::Get();
+        if (m_UseDynamicRendering)
+        {
+            VkRenderingAttachmentInfo colorAttachment = {};
+            colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            colorAttachment.imageView = viewport.m_Color->GetView();
+            colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+            colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            colorAttachment.clearValue = clearValues[0];
+
+            VkRenderingAttachmentInfo depthAttachment = {};
+            depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            depthAttachment.imageView = viewport.m_Depth->GetView();
+            depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+            depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            depthAttachment.clearValue = clearValues[1];
+
+            VkRenderingInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+            info.renderArea.extent = extent;
+            info.layerCount = 1;
+            info.colorAttachmentCount = 1;
+            info.pColorAttachments = &colorAttachment;
+            info.pDepthAttachment = &depthAttachment;
+            context.CmdBeginRendering(commandBuffer, &info);
+        }
+        else
+        {
+            VkRenderPassBeginInfo info = {};
+            info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            info.renderPass = m_RenderPass;
+            info.framebuffer = viewport.m_Framebuffer;
+            info.renderArea.extent = extent;
+            info.clearValueCount = 2;
+            info.pClearValues = clearValues;
+            vkCmdBeginRenderPass(commandBuffer, &info, VK_SUBPASS_CONTENTS_INLINE);
+        }
+
+        VkViewport vkViewport = {};
+        vkViewport.width = (float)extent.width;
+        vkViewport.height = (float)extent.height;
+        vkViewport.maxDepth = 1.0f;
+        vkCmdSetViewport(commandBuffer, 0, 1, &vkViewport);
+        VkRect2D scissor = {};
+        scissor.extent = extent;
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+        for (const auto& entry : m_RenderCallbacks)
+            entry.second(commandBuffer, viewport);
+
+        if (m_UseDynamicRendering)
+            context.CmdEndRendering(commandBuffer);
+        else
+            vkCmdEndRenderPass(commandBuffer);
+    }
+
+    void VulkanSceneRenderer::CreateRenderPass()
+    {
+        // Layouts match what the graph tracks for the attachment usages, so it needs no
+        // knowledge of this pass: it transitions before and after as for dynamic rendering
+        VkAttachmentDescription attachments[2] = {};
+        attachments[0].format = m_ColorFormat;
+        attachments[0].samples = VK_SAMPLE_COUNT_1_BIT;
+        attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachments[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        attachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachments[0].initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        attachments[0].finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        attachments[1].format = m_DepthFormat;
+        attachments[1].samples = VK_SAMPLE_COUNT_1_BIT;
+        attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachments[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachments[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachments[1].initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        attachments[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentReference colorAttachment = {};
+        colorAttachment.attachment = 0;
+        colorAttachment.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        VkAttachmentReference depthAttachment = {};
+        depthAttachment.attachment = 1;
+        depthAttachment.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subpass = {};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = 1;
+        subpass.pColorAttachments = &colorAttachment;
+        subpass.pDepthStencilAttachment = &depthAttachment;
+
+        VkRenderPassCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        info.attachmentCount = 2;
+        info.pAttachments = attachments;
+        info.subpassCount = 1;
+        info.pSubpasses = &subpass;
+        VkResult err = vkCreateRenderPass(m_Device, &info, m_Allocator, &m_RenderPass);
+        VulkanContext::CheckVkResult(err);
+    }
+
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+#include "VulkanImage.h"
+#include "VulkanRenderGraph.h"
+#include "GGEngine/SceneViewport.h"
+#include "GGEngine/Timer.h"
+
+namespace GGEngine {
+
+    class VulkanSceneRenderer;
+
+    class VulkanSceneViewport : public SceneViewport
+    {
+    public:
+        VulkanSceneViewport(VulkanSceneRenderer& renderer, const SceneViewportSpecification& specification);
+        ~VulkanSceneViewport() override;
+
+        void Draw() override;
+        void Resize(uint32_t width, uint32_t height) override;
+        uint32_t GetWidth() const override { return m_Extent.width; }
+        uint32_t GetHeight() const override { return m_Extent.height; }
+        uint64_t GetImGuiTextureID() override;
+
+        const SceneViewportSpecification& GetSpecification() const { return m_Specification; }
+        VkExtent2D GetExtent() const { return m_Extent; }
+        // A requested size is waiting for its delay to pass
+        bool IsResizePending() const;
+
+    private:
+        friend class VulkanSceneRenderer;
+
+        void CreateTarget(uint32_t width, uint32_t height);
+        // Hands the images, framebuffer and ImGui descriptor to the deferred destruction queue
+        void RetireTarget();
+
+    private:
+        VulkanSceneRenderer& m_Renderer;
+        SceneViewportSpecification m_Specification;
+
+        std::unique_ptr<VulkanImage> m_Color;
+        std::unique_ptr<VulkanImage> m_Depth;
+        VkFramebuffer m_Framebuffer = VK_NULL_HANDLE; // Without dynamic rendering
+        VkDescriptorSet m_ImGuiDescriptor = VK_NULL_HANDLE;
+        VkExtent2D m_Extent = {};
+
+        VkExtent2D m_RequestedExtent = {};
+        Timer m_RequestTimer;      // Since the requested size last changed
+        int m_DisplayedFrame = -1; // ImGui frame that last asked for the texture
+    };
+
+    // Draws the scene into every displayed VulkanSceneViewport, one graph pass each ahead of
+    // the main pass, which reads their color targets as sampled images for ImGui. Targets
+    // use the context's color format, so only depth sets scene pipelines apart from main
+    // pass ones. Main thread only.
+    class VulkanSceneRenderer
+    {
+    public:
+        // Called inside each scene pass with the viewport's color and depth attachments bound
+        // and cleared, and viewport and scissor set to the whole target
+        using RenderCallbackFn = std::function<void(VkCommandBuffer commandBuffer, const VulkanSceneViewport& viewport)>;
+
+        void Init(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator, VkFormat colorFormat, bool useDynamicRendering);
+        // The device must be idle; viewports that are still alive keep their targets until destroyed
+        void Shutdown();
+
+        std::shared_ptr<VulkanSceneViewport> CreateViewport(const SceneViewportSpecification& specification);
+
+        uint32_t AddRenderCallback(const RenderCallbackFn& callback);
+        void RemoveRenderCallback(uint32_t id);
+
+        // Declares the scene passes of this frame's displayed viewports and appends their
+        // color targets, which the main pass must read
+        void AddPasses(VulkanRenderGraph& graph, std::vector<RenderGraphResource>& colorTargets);
+
+        // A displayed viewport is waiting for its size to settle
+        bool HasPendingResize() const;
+
+        // Stable addresses, so they can be handed to pipeline rendering create infos
+        const VkFormat& GetColorFormat() const { return m_ColorFormat; }
+        const VkFormat& GetDepthFormat() const { return m_DepthFormat; }
+        // VK_NULL_HANDLE with dynamic rendering
+        VkRenderPass GetRenderPass() const { return m_RenderPass; }
+        VkSampler GetSampler() const { return m_Sampler; }
+        bool UsesDynamicRendering() const { return m_UseDynamicRendering; }
+
+    private:
+        friend class VulkanSceneViewport;
+
+        void Register(VulkanSceneViewport* viewport) { m_Viewports.push_back(viewport); }
+        void Unregister(VulkanSceneViewport* viewport);
+        void CreateRenderPass();
+        void RecordScene(VkCommandBuffer commandBuffer, const VulkanSceneViewport& viewport) const;
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* m_Allocator = nullptr;
+        VkFormat m_ColorFormat = VK_FORMAT_UNDEFINED;
+        VkFormat m_DepthFormat = VK_FORMAT_UNDEFINED;
+        bool m_UseDynamicRendering = false;
+        VkRenderPass m_RenderPass = VK_NULL_HANDLE;
+        VkSampler m_Sampler = VK_NULL_HANDLE;
+
+        std::vector<VulkanSceneViewport*> m_Viewports;
+        std::vector<std::pair<uint32_t, RenderCallbackFn>> m_RenderCallbacks;
+        uint32_t m_NextRenderCallbackId = 1;
+    };
+
+}
@@ -0,0 +1,281 @@
+#include "VulkanShader.h"
+
+#include "VulkanContext.h"
+
+namespace GGEngine {
+
+    VkShaderStageFlagBits VulkanShader::GetVkStage() const
+    {
+        switch (m_Stage)
+        {
+            case ShaderStage::Vertex:         return VK_SHADER_STAGE_VERTEX_BIT;
+            case ShaderStage::Fragment:       return VK_SHADER_STAGE_FRAGMENT_BIT;
+            case ShaderStage::Compute:        return VK_SHADER_STAGE_COMPUTE_BIT;
+            case ShaderStage::Geometry:       return VK_SHADER_STAGE_GEOMETRY_BIT;
+            case ShaderStage::TessControl:    return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+            case ShaderStage::TessEvaluation: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+        }
+        return VK_SHADER_STAGE_ALL;
+    }
+
+    static std::filesystem::file_time_type GetWriteTime(const std::string& path)
+    {
+        std::error_code error;
+        std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+        return error ? std::filesystem::file_time_type::min() : time;
+    }
+
+    // Pipeline compiles started before a reload may still read the replaced module
+    static void RetireModule(VkDevice device, const VkAllocationCallbacks* allocator, VkShaderModule module)
+    {
+        VulkanContext::Get().DeferDestroy([device, allocator, module]()
+        {
+            if (VulkanContext::Get().GetPipelineCache().IsCompilingWith(module))
+                RetireModule(device, allocator, module);
+            else
+                vkDestroyShaderModule(device, module, allocator);
+        });
+    }
+
+    void VulkanShaderLibrary::Init(VkDevice device, const VkAllocationCallbacks* allocator, const std::string& cacheDirectory)
+    {
+        m_Device = device;
+        m_Allocator = allocator;
+        m_CacheDirectory = cacheDirectory;
+
+        if (!ShaderCompiler::IsAvailable())
+            GG_CORE_WARN("Built without a shader compiler: shaders load from {0} and precompiled SPIR-V only", cacheDirectory);
+    }
+
+    void VulkanShaderLibrary::Shutdown()
+    {
+        StopWatcher();
+        JobSystem::Wait(m_CompileJobs);
+
+        // The device is idle by now, so modules can go immediately
+        for (CompileResult& result : m_Completed)
+        {
+            if (result.Module != VK_NULL_HANDLE)
+                vkDestroyShaderModule(m_Device, result.Module, m_Allocator);
+        }
+        m_Completed.clear();
+
+        for (const std::shared_ptr<VulkanShader>& shader : m_Shaders)
+        {
+            if (shader->m_Module != VK_NULL_HANDLE)
+                vkDestroyShaderModule(m_Device, shader->m_Module, m_Allocator);
+            shader->m_Module = VK_NULL_HANDLE;
+        }
+        m_Shaders.clear();
+        m_ReloadListeners.clear();
+    }
+
+    std::shared_ptr<VulkanShader> VulkanShaderLibrary::Load(const ShaderSource& source)
+    {
+        ShaderStage stage;
+        ShaderLanguage language;
+        if (!ShaderCompiler::ParsePath(source.Path, stage, language))
+        {
+            GG_CORE_ERROR("Cannot infer shader stage from {0}", source.Path);
+            return nullptr;
+        }
+
+        auto shader = std::make_shared<VulkanShader>();
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            for (const std::shared_ptr<VulkanShader>& existing : m_Shaders)
+            {
+                const ShaderSource& other = existing->m_Source;
+                if (other.Path == source.Path && other.Defines == source.Defines && other.EntryPoint == source.EntryPoint)
+                    return existing;
+            }
+
+            shader->m_Source = source;
+            shader->m_Stage = stage;
+            shader->m_CompileInFlight = true;
+            m_Shaders.push_back(shader);
+        }
+        QueueCompile(shader);
+        return shader;
+    }
+
+    void VulkanShaderLibrary::QueueCompile(const std::shared_ptr<VulkanShader>& shader)
+    {
+        // The caller has marked the shader in flight; m_Mutex must not be held since the
+        // job system runs jobs inline when it has no workers
+        ShaderSource source = shader->m_Source;
+        std::vector<std::string> knownFiles;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            for (const auto& file : shader->m_WatchedFiles)
+                knownFiles.push_back(file.first);
+        }
+        JobSystem::Execute(m_CompileJobs, [this, shader, source, knownFiles]()
+        {
+            // Write times are taken before the sources are read, so an edit saved while the
+            // compile runs still differs from the recorded time and triggers another reload
+            std::vector<std::pair<std::string, std::filesystem::file_time_type>> writeTimes;
+            writeTimes.emplace_back(source.Path, GetWriteTime(source.Path));
+            for (const std::string& file : knownFiles)
+            {
+                if (file != source.Path)
+                    writeTimes.emplace_back(file, GetWriteTime(file));
+            }
+
+            CompileResult result;
+            result.Shader = shader;
+            result.Binary = ShaderCompiler::Compile(source, m_CacheDirectory);
+
+            // Includes this compile found for the first time can only be stamped now
+            for (const std::string& dependency : result.Binary.Dependencies)
+            {
+                auto it = std::find_if(writeTimes.begin(), writeTimes.end(),
+                    [&dependency](const std::pair<std::string, std::filesystem::file_time_type>& file) { return file.first == dependency; });
+                result.WatchedFiles.emplace_back(dependency, it != writeTimes.end() ? it->second : GetWriteTime(dependency));
+            }
+
+            // Module creation is thread-safe, so it stays off the main thread as well
+            if (result.Binary.IsValid())
+            {
+                VkShaderModuleCreateInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+                info.codeSize = result.Binary.SpirV.size() * sizeof(uint32_t);
+                info.pCode = result.Binary.SpirV.data();
+                VkResult err = vkCreateShaderModule(m_Device, &info, m_Allocator, &result.Module);
+                VulkanContext::CheckVkResult(err);
+            }
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Completed.push_back(std::move(result));
+        });
+    }
+
+    void VulkanShaderLibrary::WaitForCompiles()
+    {
+        JobSystem::Wait(m_CompileJobs);
+    }
+
+    void VulkanShaderLibrary::Update()
+    {
+        std::vector<CompileResult> completed;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_Completed.empty())
+                return;
+            completed.swap(m_Completed);
+
+            // Watch whatever the compile actually read, even when it failed,
+            // so fixing the error triggers the next attempt
+            for (CompileResult& result : completed)
+            {
+                VulkanShader& shader = *result.Shader;
+                shader.m_CompileInFlight = false;
+                shader.m_WatchedFiles = std::move(result.WatchedFiles);
+            }
+        }
+
+        for (CompileResult& result : completed)
+        {
+            VulkanShader& shader = *result.Shader;
+            if (result.Module == VK_NULL_HANDLE)
+            {
+                // A failed reload keeps the previous module running
+                GG_CORE_ERROR("Shader {0} failed to compile:\n{1}", shader.m_Source.Path, result.Binary.Error);
+                continue;
+            }
+
+            // Pipelines recorded in frames still in flight may reference the old module
+            if (shader.m_Module != VK_NULL_HANDLE)
+                RetireModule(m_Device, m_Allocator, shader.m_Module);
+
+            shader.m_Module = result.Module;
+            shader.m_Version++;
+            if (shader.m_Version == 1)
+            {
+                GG_CORE_TRACE("Shader {0} ready{1}", shader.m_Source.Path, result.Binary.FromCache ? " (cached)" : "");
+                continue;
+            }
+
+            GG_CORE_INFO("Shader {0} reloaded", shader.m_Source.Path);
+            for (auto& listener : m_ReloadListeners)
+                listener.second(shader);
+        }
+    }
+
+    void VulkanShaderLibrary::SetHotReload(bool enabled, uint32_t pollIntervalMs)
+    {
+        StopWatcher();
+        if (!enabled)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Watching = true;
+        }
+        m_Watcher = std::thread(&VulkanShaderLibrary::WatchLoop, this, pollIntervalMs);
+    }
+
+    void VulkanShaderLibrary::StopWatcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Watching = false;
+        }
+        m_WatcherWake.notify_all();
+        if (m_Watcher.joinable())
+            m_Watcher.join();
+    }
+
+    void VulkanShaderLibrary::WatchLoop(uint32_t pollIntervalMs)
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        while (m_Watching)
+        {
+            m_WatcherWake.wait_for(lock, std::chrono::milliseconds(pollIntervalMs), [this] { return !m_Watching; });
+            if (!m_Watching)
+                break;
+
+            // Stat calls happen on a snapshot so loads are not blocked by the file system
+            std::vector<std::shared_ptr<VulkanShader>> shaders = m_Shaders;
+            std::vector<std::shared_ptr<VulkanShader>> changed;
+            for (const std::shared_ptr<VulkanShader>& shader : shaders)
+            {
+                if (shader->m_CompileInFlight)
+                    continue;
+                auto watched = shader->m_WatchedFiles;
+                lock.unlock();
+                bool modified = false;
+                for (const auto& file : watched)
+                    modified |= GetWriteTime(file.first) != file.second;
+                lock.lock();
+                if (modified && !shader->m_CompileInFlight)
+                {
+                    shader->m_CompileInFlight = true;
+                    changed.push_back(shader);
+                }
+            }
+
+            lock.unlock();
+            for (const std::shared_ptr<VulkanShader>& shader : changed)
+            {
+                GG_CORE_INFO("Shader {0} changed, recompiling", shader->m_Source.Path);
+                QueueCompile(shader);
+            }
+            lock.lock();
+        }
+    }
+
+    uint32_t VulkanShaderLibrary::AddReloadListener(const ReloadFn& listener)
+    {
+        uint32_t id = m_NextListenerId++;
+        m_ReloadListeners.emplace_back(id, listener);
+        return id;
+    }
+
+    void VulkanShaderLibrary::RemoveReloadListener(uint32_t id)
+    {
+        m_ReloadListeners.erase(std::remove_if(m_ReloadListeners.begin(), m_ReloadListeners.end(),
+            [id](const std::pair<uint32_t, ReloadFn>& entry) { return entry.first == id; }), m_ReloadListeners.end());
+    }
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+#include "ShaderCompiler.h"
+#include "GGEngine/JobSystem.h"
+
+namespace GGEngine {
+
+    class VulkanShader
+    {
+    public:
+        const ShaderSource& GetSource() const { return m_Source; }
+        ShaderStage GetStage() const { return m_Stage; }
+        VkShaderStageFlagBits GetVkStage() const;
+
+        // VK_NULL_HANDLE until the first compile has finished. Only changes inside
+        // VulkanShaderLibrary::Update, i.e. at a frame boundary.
+        VkShaderModule GetModule() const { return m_Module; }
+        bool IsReady() const { return m_Module != VK_NULL_HANDLE; }
+        // Incremented each time a new module is swapped in
+        uint32_t GetVersion() const { return m_Version; }
+
+    private:
+        friend class VulkanShaderLibrary;
+
+        ShaderSource m_Source;
+        ShaderStage m_Stage = ShaderStage::Vertex;
+        VkShaderModule m_Module = VK_NULL_HANDLE;
+        uint32_t m_Version = 0;
+
+        // Watcher state, guarded by the library mutex
+        std::vector<std::pair<std::string, std::filesystem::file_time_type>> m_WatchedFiles;
+        bool m_CompileInFlight = false;
+    };
+
+    // Owns every shader module. Compilation runs on the job system; finished modules are
+    // swapped in at the next frame boundary, and reload listeners (pipeline owners) are
+    // notified there so pipelines never see a half-updated set of shaders.
+    class VulkanShaderLibrary
+    {
+    public:
+        using ReloadFn = std::function<void(const VulkanShader& shader)>;
+
+        void Init(VkDevice device, const VkAllocationCallbacks* allocator, const std::string& cacheDirectory);
+        void Shutdown();
+
+        // Returns immediately; the shader becomes ready once its compile job finishes.
+        // Loading the same path with the same defines returns the existing shader.
+        std::shared_ptr<VulkanShader> Load(const ShaderSource& source);
+
+        // Blocks until every queued compile has finished (loading screens, tools)
+        void WaitForCompiles();
+
+        // Polls the sources and their includes on a background thread and recompiles edited shaders
+        void SetHotReload(bool enabled, uint32_t pollIntervalMs = 250);
+
+        uint32_t AddReloadListener(const ReloadFn& listener);
+        void RemoveReloadListener(uint32_t id);
+
+        // Frame boundary, main thread: swaps in finished modules and notifies listeners
+        void Update();
+
+        const std::string& GetCacheDirectory() const { return m_CacheDirectory; }
+
+    private:
+        struct CompileResult
+        {
+            std::shared_ptr<VulkanShader> Shader;
+            VkShaderModule Module = VK_NULL_HANDLE;
+            ShaderBinary Binary;
+            // The binary's dependencies with their write times from before the compile read them
+            std::vector<std::pair<std::string, std::filesystem::file_time_type>> WatchedFiles;
+        };
+
+        void QueueCompile(const std::shared_ptr<VulkanShader>& shader);
+        void WatchLoop(uint32_t pollIntervalMs);
+        void StopWatcher();
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* m_Allocator = nullptr;
+        std::string m_CacheDirectory;
+
+        std::mutex m_Mutex;
+        std::vector<std::shared_ptr<VulkanShader>> m_Shaders;
+        std::vector<CompileResult> m_Completed;
+        JobCounter m_CompileJobs{ 0 };
+
+        std::thread m_Watcher;
+        std::condition_variable m_WatcherWake;
+        bool m_Watching = false;
+
+        std::vector<std::pair<uint32_t, ReloadFn>> m_ReloadListeners;
+        uint32_t m_NextListenerId = 1;
+    };
+
+}
@@ -0,0 +1,236 @@
+#include "VulkanSwapchain.h"
+
+#include "VulkanContext.h"
+
+namespace GGEngine {
+
+    void VulkanSwapchain::Init(VkPhysicalDevice physicalDevice, VkDevice device, VkSurfaceKHR surface, VkSurfaceFormatKHR surfaceFormat,
+        VkPresentModeKHR presentMode, uint32_t minImageCount, bool useDynamicRendering, const VkAllocationCallbacks* allocator)
+    {
+        m_PhysicalDevice = physicalDevice;
+        m_Device = device;
+        m_Surface = surface;
+        m_SurfaceFormat = surfaceFormat;
+        m_PresentMode = presentMode;
+        m_MinImageCount = minImageCount;
+        m_UseDynamicRendering = useDynamicRendering;
+        m_Allocator = allocator;
+
+        if (!m_UseDynamicRendering)
+            CreateRenderPass();
+    }
+
+    void VulkanSwapchain::Shutdown(VkInstance instance)
+    {
+        for (const RetiredSwapchain& retired : m_Retired)
+        {
+            DestroyImages(m_Device, m_Allocator, retired.Images);
+            vkDestroySwapchainKHR(m_Device, retired.Swapchain, m_Allocator);
+        }
+        m_Retired.clear();
+
+        DestroyImages(m_Device, m_Allocator, m_Images);
+        m_Images.clear();
+
+        if (m_Swapchain != VK_NULL_HANDLE)
+            vkDestroySwapchainKHR(m_Device, m_Swapchain, m_Allocator);
+        m_Swapchain = VK_NULL_HANDLE;
+        if (m_RenderPass != VK_NULL_HANDLE)
+            vkDestroyRenderPass(m_Device, m_RenderPass, m_Allocator);
+        m_RenderPass = VK_NULL_HANDLE;
+        if (m_Surface != VK_NULL_HANDLE)
+            vkDestroySurfaceKHR(instance, m_Surface, m_Allocator);
+        m_Surface = VK_NULL_HANDLE;
+    }
+
+    bool VulkanSwapchain::Create(uint32_t width, uint32_t height)
+    {
+        VkSurfaceCapabilitiesKHR capabilities;
+        VkResult err = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_PhysicalDevice, m_Surface, &capabilities);
+        VulkanContext::CheckVkResult(err);
+
+        // UINT32_MAX means the surface takes whatever size the swapchain has
+        VkExtent2D extent = capabilities.currentExtent;
+        if (extent.width == UINT32_MAX)
+        {
+            extent.width = std::clamp(width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
+            extent.height = std::clamp(height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
+        }
+        if (extent.width == 0 || extent.height == 0)
+            return false;
+
+        uint32_t imageCount = std::max(m_MinImageCount, capabilities.minImageCount);
+        if (capabilities.maxImageCount != 0)
+            imageCount = std::min(imageCount, capabilities.maxImageCount);
+
+        // Transfer source lets frame readbacks copy straight out of the presented image
+        m_TransferSrc = (capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) != 0;
+
+        VkSwapchainCreateInfoKHR info = {};
+        info.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+        info.surface = m_Surface;
+        info.minImageCount = imageCount;
+        info.imageFormat = m_SurfaceFormat.format;
+        info.imageColorSpace = m_SurfaceFormat.colorSpace;
+        info.imageExtent = extent;
+        info.imageArrayLayers = 1;
+        info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | (m_TransferSrc ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0);
+        info.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        info.preTransform = (capabilities.supportedTransforms & VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR) ? VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR : capabilities.currentTransform;
+        info.compositeAlpha = (capabilities.supportedCompositeAlpha & VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR) ? VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR
+            : (VkCompositeAlphaFlagBitsKHR)(capabilities.supportedCompositeAlpha & (~capabilities.supportedCompositeAlpha + 1));
+        info.presentMode = m_PresentMode;
+        info.clipped = VK_TRUE;
+        // The presentation engine may keep showing old images while the new chain fills up
+        info.oldSwapchain = m_Swapchain;
+
+        VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+        err = vkCreateSwapchainKHR(m_Device, &info, m_Allocator, &swapchain);
+        VulkanContext::CheckVkResult(err);
+
+        // Frames already submitted may still render into the old images and presents may
+        // still read them; they are destroyed once the new swapchain has cycled its images
+        Retire(m_Swapchain, std::move(m_Images));
+        m_Swapchain = swapchain;
+        m_Extent = extent;
+
+        uint32_t count = 0;
+        err = vkGetSwapchainImagesKHR(m_Device, m_Swapchain, &count, nullptr);
+        VulkanContext::CheckVkResult(err);
+        std::vector<VkImage> images(count);
+        err = vkGetSwapchainImagesKHR(m_Device, m_Swapchain, &count, images.data());
+        VulkanContext::CheckVkResult(err);
+
+        m_Images.assign(count, Image());
+        m_Reacquired.assign(count, false);
+        m_ReacquiredCount = 0;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            Image& image = m_Images[i];
+            image.Image = images[i];
+
+            VkImageViewCreateInfo viewInfo = {};
+            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInfo.image = image.Image;
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = m_SurfaceFormat.format;
+            viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            viewInfo.subresourceRange.levelCount = 1;
+            viewInfo.subresourceRange.layerCount = 1;
+            err = vkCreateImageView(m_Device, &viewInfo, m_Allocator, &image.View);
+            VulkanContext::CheckVkResult(err);
+
+            VkSemaphoreCreateInfo semaphoreInfo = {};
+            semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            err = vkCreateSemaphore(m_Device, &semaphoreInfo, m_Allocator, &image.RenderComplete);
+            VulkanContext::CheckVkResult(err);
+
+            if (m_RenderPass != VK_NULL_HANDLE)
+            {
+                VkFramebufferCreateInfo framebufferInfo = {};
+                framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+                framebufferInfo.renderPass = m_RenderPass;
+                framebufferInfo.attachmentCount = 1;
+                framebufferInfo.pAttachments = &image.View;
+                framebufferInfo.width = extent.width;
+                framebufferInfo.height = extent.height;
+                framebufferInfo.layers = 1;
+                err = vkCreateFramebuffer(m_Device, &framebufferInfo, m_Allocator, &image.Framebuffer);
+                VulkanContext::CheckVkResult(err);
+            }
+        }
+        return true;
+    }
+
+    VkResult VulkanSwapchain::AcquireNextImage(VkSemaphore imageAcquired, uint32_t& imageIndex)
+    {
+        VkResult err = vkAcquireNextImageKHR(m_Device, m_Swapchain, UINT64_MAX, imageAcquired, VK_NULL_HANDLE, &imageIndex);
+        if ((err == VK_SUCCESS || err == VK_SUBOPTIMAL_KHR) && !m_Retired.empty() && !m_Reacquired[imageIndex])
+        {
+            m_Reacquired[imageIndex] = true;
+            if (++m_ReacquiredCount == m_Reacquired.size())
+                ReleaseRetired();
+        }
+        return err;
+    }
+
+    void VulkanSwapchain::CreateRenderPass()
+    {
+        // The frame graph has already moved the image to COLOR_ATTACHMENT_OPTIMAL; the
+        // contents are cleared, so the pass starts from UNDEFINED and ends ready to present
+        VkAttachmentDescription attachment = {};
+        attachment.format = m_SurfaceFormat.format;
+        attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        attachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+        VkAttachmentReference colorAttachment = {};
+        colorAttachment.attachment = 0;
+        colorAttachment.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subpass = {};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = 1;
+        subpass.pColorAttachments = &colorAttachment;
+
+        VkSubpassDependency dependency = {};
+        dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependency.dstSubpass = 0;
+        dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependency.srcAccessMask = 0;
+        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+        VkRenderPassCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        info.attachmentCount = 1;
+        info.pAttachments = &attachment;
+        info.subpassCount = 1;
+        info.pSubpasses = &subpass;
+        info.dependencyCount = 1;
+        info.pDependencies = &dependency;
+        VkResult err = vkCreateRenderPass(m_Device, &info, m_Allocator, &m_RenderPass);
+        VulkanContext::CheckVkResult(err);
+    }
+
+    void VulkanSwapchain::Retire(VkSwapchainKHR swapchain, std::vector<Image> images)
+    {
+        if (swapchain == VK_NULL_HANDLE)
+            return;
+
+        RetiredSwapchain& retired = m_Retired.emplace_back();
+        retired.Swapchain = swapchain;
+        retired.Images = std::move(images);
+    }
+
+    void VulkanSwapchain::ReleaseRetired()
+    {
+        VkDevice device = m_Device;
+        const VkAllocationCallbacks* allocator = m_Allocator;
+        VulkanContext::Get().DeferDestroy([device, allocator, retired = std::move(m_Retired)]()
+        {
+            for (const RetiredSwapchain& swapchain : retired)
+            {
+                DestroyImages(device, allocator, swapchain.Images);
+                vkDestroySwapchainKHR(device, swapchain.Swapchain, allocator);
+            }
+        });
+        m_Retired.clear();
+    }
+
+    void VulkanSwapchain::DestroyImages(VkDevice device, const VkAllocationCallbacks* allocator, const std::vector<Image>& images)
+    {
+        for (const Image& image : images)
+        {
+            if (image.Framebuffer != VK_NULL_HANDLE)
+                vkDestroyFramebuffer(device, image.Framebuffer, allocator);
+            vkDestroyImageView(device, image.View, allocator);
+            vkDestroySemaphore(device, image.RenderComplete, allocator);
+        }
+    }
+
+}
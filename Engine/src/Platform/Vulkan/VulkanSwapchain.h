@@ -0,0 +1,88 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+namespace GGEngine {
+
+    // Window swapchain with its image views and render-complete semaphores, plus the render
+    // pass and framebuffers when dynamic rendering is unavailable. Recreation hands the
+    // current swapchain to the new one as oldSwapchain, so a resize never waits for the
+    // device to go idle. Finished GPU work does not mean finished presents, so the old
+    // swapchain is only destroyed once the new one has handed out every image: by then the
+    // presentation engine has let go of the old images and their semaphores.
+    // Main thread only.
+    class VulkanSwapchain
+    {
+    public:
+        void Init(VkPhysicalDevice physicalDevice, VkDevice device, VkSurfaceKHR surface, VkSurfaceFormatKHR surfaceFormat,
+            VkPresentModeKHR presentMode, uint32_t minImageCount, bool useDynamicRendering, const VkAllocationCallbacks* allocator);
+        // Destroys everything including the surface; the device must be idle
+        void Shutdown(VkInstance instance);
+
+        // (Re)creates the swapchain for the framebuffer size. Returns false when the surface
+        // has no area (minimized), keeping the current swapchain.
+        bool Create(uint32_t width, uint32_t height);
+
+        // VK_SUBOPTIMAL_KHR still returns an image; VK_ERROR_OUT_OF_DATE_KHR does not.
+        // Presentation is batched with other swapchains by the context.
+        VkResult AcquireNextImage(VkSemaphore imageAcquired, uint32_t& imageIndex);
+
+        VkSwapchainKHR GetSwapchain() const { return m_Swapchain; }
+        VkRenderPass GetRenderPass() const { return m_RenderPass; }
+        VkFormat GetFormat() const { return m_SurfaceFormat.format; }
+        VkExtent2D GetExtent() const { return m_Extent; }
+        uint32_t GetImageCount() const { return (uint32_t)m_Images.size(); }
+        VkImage GetImage(uint32_t index) const { return m_Images[index].Image; }
+        VkImageView GetView(uint32_t index) const { return m_Images[index].View; }
+        VkFramebuffer GetFramebuffer(uint32_t index) const { return m_Images[index].Framebuffer; }
+        // Signalled by the frame rendering into the image and waited on by its present. Per
+        // image, since a present may still hold it after the frame's submission completed.
+        VkSemaphore GetRenderComplete(uint32_t index) const { return m_Images[index].RenderComplete; }
+        // The surface allowed transfer source usage, so presented frames can be read back
+        bool SupportsTransferSrc() const { return m_TransferSrc; }
+
+    private:
+        struct Image
+        {
+            VkImage Image = VK_NULL_HANDLE;
+            VkImageView View = VK_NULL_HANDLE;
+            VkFramebuffer Framebuffer = VK_NULL_HANDLE;
+            VkSemaphore RenderComplete = VK_NULL_HANDLE;
+        };
+
+        struct RetiredSwapchain
+        {
+            VkSwapchainKHR Swapchain = VK_NULL_HANDLE;
+            std::vector<Image> Images;
+        };
+
+        void CreateRenderPass();
+        // Holds the swapchain and its views until the current swapchain has cycled its images
+        void Retire(VkSwapchainKHR swapchain, std::vector<Image> images);
+        // Hands retired swapchains to the deferred destruction queue, behind the frame that
+        // waits on the latest acquire
+        void ReleaseRetired();
+        static void DestroyImages(VkDevice device, const VkAllocationCallbacks* allocator, const std::vector<Image>& images);
+
+    private:
+        VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
+        VkDevice m_Device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* m_Allocator = nullptr;
+        VkSurfaceKHR m_Surface = VK_NULL_HANDLE;
+        VkSurfaceFormatKHR m_SurfaceFormat = {};
+        VkPresentModeKHR m_PresentMode = VK_PRESENT_MODE_FIFO_KHR;
+        uint32_t m_MinImageCount = 2;
+        bool m_UseDynamicRendering = false;
+        bool m_TransferSrc = false;
+
+        VkSwapchainKHR m_Swapchain = VK_NULL_HANDLE;
+        VkRenderPass m_RenderPass = VK_NULL_HANDLE; // Outlives recreation: the format never changes
+        VkExtent2D m_Extent = {};
+        std::vector<Image> m_Images;
+
+        std::vector<RetiredSwapchain> m_Retired;
+        std::vector<bool> m_Reacquired; // Per current image, acquired since the last retire
+        uint32_t m_ReacquiredCount = 0;
+    };
+
+}
@@ -0,0 +1,571 @@
+#include "VulkanTexture.h"
+
+#include "VulkanContext.h"
+#include "GGEngine/MappedFile.h"
+#include "GGEngine/Image/ImageDecoder.h"
+#include "GGEngine/Image/KTX2.h"
+
+namespace GGEngine {
+
+    static const size_t s_MaxFreeStaging = 8;
+
+    static VkFormat GetTextureFormat(const TextureSpecification& specification)
+    {
+        return specification.SRGB ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    }
+
+    static void RecordMipBarrier(VkCommandBuffer commandBuffer, VkImage image, uint32_t mipLevel,
+        VkImageLayout oldLayout, VkImageLayout newLayout,
+        VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+        VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+    {
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = mipLevel;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.layerCount = 1;
+        vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    std::shared_ptr<Texture2D> Texture2D::Create(const std::string& path, const TextureSpecification& specification)
+    {
+        return VulkanContext::Get().GetTextureStreamer().Load(path, specification);
+    }
+
+    VulkanTexture::VulkanTexture(const std::string& path, const TextureSpecification& specification)
+        : m_Path(path), m_Specification(specification)
+    {
+    }
+
+    VulkanTexture::~VulkanTexture()
+    {
+        if (!m_Image && m_ImGuiDescriptor == VK_NULL_HANDLE)
+            return;
+
+        // The set came from the context's pool through ImGui_ImplVulkan_AddTexture. Freeing it
+        // directly keeps this valid even after the ImGui backend has shut down.
+        VulkanContext& context = VulkanContext::Get();
+        VkDevice device = context.GetDevice();
+        VkDescriptorPool pool = context.GetDescriptorPool();
+        VkDescriptorSet descriptor = m_ImGuiDescriptor;
+        std::shared_ptr<VulkanImage> image(std::move(m_Image));
+        context.DeferDestroy([device, pool, descriptor, image]() mutable
+        {
+            if (descriptor != VK_NULL_HANDLE)
+                vkFreeDescriptorSets(device, pool, 1, &descriptor);
+            image.reset();
+        });
+    }
+
+    uint64_t VulkanTexture::GetImGuiTextureID()
+    {
+        if (GetState() != TextureState::Ready)
+            return VulkanContext::Get().GetTextureStreamer().GetPlaceholder().GetImGuiTextureID();
+
+        if (m_ImGuiDescriptor == VK_NULL_HANDLE)
+            m_ImGuiDescriptor = ImGui_ImplVulkan_AddTexture(m_Sampler, m_Image->GetView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        return (uint64_t)m_ImGuiDescriptor;
+    }
+
+    void VulkanTextureStreamer::Init(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator)
+    {
+        m_Device = device;
+        m_PhysicalDevice = physicalDevice;
+        m_Allocator = allocator;
+
+        // Linear blits need filterable, blittable formats; without them textures get a single mip
+        for (int srgb = 0; srgb < 2; srgb++)
+        {
+            TextureSpecification specification;
+            specification.SRGB = srgb != 0;
+            VkFormatProperties properties;
+            vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, GetTextureFormat(specification), &properties);
+            const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+            m_BlitSupported[srgb] = (properties.optimalTilingFeatures & required) == required;
+        }
+        m_CompressedSupported = VulkanContext::Get().SupportsTextureCompressionBC();
+
+        VkSamplerCreateInfo samplerInfo = {};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+        VkResult err = vkCreateSampler(m_Device, &samplerInfo, m_Allocator, &m_LinearSampler);
+        VulkanContext::CheckVkResult(err);
+
+        samplerInfo.magFilter = VK_FILTER_NEAREST;
+        samplerInfo.minFilter = VK_FILTER_NEAREST;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        err = vkCreateSampler(m_Device, &samplerInfo, m_Allocator, &m_NearestSampler);
+        VulkanContext::CheckVkResult(err);
+
+        // The placeholder goes through the regular upload path, just without a decode
+        TextureSpecification placeholderSpec;
+        placeholderSpec.GenerateMips = false;
+        m_Placeholder = std::make_shared<VulkanTexture>("<placeholder>", placeholderSpec);
+        m_Placeholder->m_Sampler = m_LinearSampler;
+        m_Placeholder->m_Width = 1;
+        m_Placeholder->m_Height = 1;
+        Upload upload;
+        upload.Texture = m_Placeholder;
+        upload.Staging = AcquireStaging(4);
+        upload.Format = GetTextureFormat(placeholderSpec);
+        upload.Levels.push_back({ 0, 1, 1 });
+        memset(upload.Staging.Mapped, 0xFF, 4);
+        m_StagedBytes += upload.Staging.Size;
+        m_Uploads.push_back(std::move(upload));
+        SubmitUploads();
+    }
+
+    void VulkanTextureStreamer::Shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_DecodeQueue.clear();
+        }
+        JobSystem::Wait(m_DecodeJobs);
+
+        for (Upload& upload : m_Decoded)
+            DestroyStaging(upload.Staging);
+        m_Decoded.clear();
+        for (Upload& upload : m_Uploads)
+            DestroyStaging(upload.Staging);
+        m_Uploads.clear();
+        for (RetiredStaging& retired : m_Retired)
+            DestroyStaging(retired.Staging);
+        m_Retired.clear();
+        for (StagingBuffer& staging : m_FreeStaging)
+            DestroyStaging(staging);
+        m_FreeStaging.clear();
+        m_StagedBytes = 0;
+
+        m_Placeholder.reset();
+        m_Textures.clear();
+
+        vkDestroySampler(m_Device, m_LinearSampler, m_Allocator);
+        vkDestroySampler(m_Device, m_NearestSampler, m_Allocator);
+        m_LinearSampler = VK_NULL_HANDLE;
+        m_NearestSampler = VK_NULL_HANDLE;
+    }
+
+    std::shared_ptr<VulkanTexture> VulkanTextureStreamer::Load(const std::string& path, const TextureSpecification& specification)
+    {
+        std::string key = path;
+        key += specification.SRGB ? "|srgb" : "|linear";
+        key += specification.GenerateMips ? "|mips" : "";
+        key += specification.LinearFilter ? "|filter" : "";
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        std::weak_ptr<VulkanTexture>& slot = m_Textures[key];
+        if (std::shared_ptr<VulkanTexture> existing = slot.lock())
+            return existing;
+
+        auto texture = std::make_shared<VulkanTexture>(path, specification);
+        texture->m_Sampler = specification.LinearFilter ? m_LinearSampler : m_NearestSampler;
+        slot = texture;
+        m_DecodeQueue.push_back(texture);
+        return texture;
+    }
+
+    uint32_t VulkanTextureStreamer::GetPendingCount()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return (uint32_t)(m_DecodeQueue.size() + m_Decoded.size() + m_Uploads.size()) + m_DecodeJobs.load();
+    }
+
+    void VulkanTextureStreamer::Update()
+    {
+        const uint64_t completed = VulkanContext::Get().GetTimeline().GetCompletedValue();
+        auto retiredEnd = std::partition(m_Retired.begin(), m_Retired.end(),
+            [completed](const RetiredStaging& retired) { return retired.TimelineValue > completed; });
+        for (auto it = retiredEnd; it != m_Retired.end(); ++it)
+        {
+            m_StagedBytes -= it->Staging.Size;
+            ReleaseStaging(it->Staging);
+        }
+        m_Retired.erase(retiredEnd, m_Retired.end());
+
+        // Jobs are queued outside the lock: without workers they run inline and take it themselves
+        std::vector<std::shared_ptr<VulkanTexture>> toDecode;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            const uint32_t maxInFlight = JobSystem::GetThreadCount();
+            while (!m_DecodeQueue.empty() && m_StagedBytes.load() < m_MaxStagedBytes
+                && m_DecodeJobs.load() + toDecode.size() < maxInFlight)
+            {
+                // Nobody holds the texture anymore, so there is no point in loading it
+                if (m_DecodeQueue.front().use_count() > 1)
+                    toDecode.push_back(std::move(m_DecodeQueue.front()));
+                m_DecodeQueue.pop_front();
+            }
+        }
+        for (std::shared_ptr<VulkanTexture>& texture : toDecode)
+            JobSystem::Execute(m_DecodeJobs, [this, texture]() { Decode(texture); });
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            while (!m_Decoded.empty())
+            {
+                m_Uploads.push_back(std::move(m_Decoded.front()));
+                m_Decoded.pop_front();
+            }
+        }
+        SubmitUploads();
+    }
+
+    void VulkanTextureStreamer::Decode(const std::shared_ptr<VulkanTexture>& texture)
+    {
+        MappedFile file(texture->m_Path);
+        if (!file.IsOpen())
+        {
+            GG_CORE_ERROR("Texture {0} could not be opened", texture->m_Path);
+            texture->m_State = TextureState::Failed;
+            return;
+        }
+
+        Upload upload;
+        const bool staged = KTX2::IsKTX2(file.GetData(), file.GetSize())
+            ? StageKTX2(*texture, file.GetData(), file.GetSize(), upload)
+            : StageImage(*texture, file.GetData(), file.GetSize(), upload);
+        if (!staged)
+        {
+            texture->m_State = TextureState::Failed;
+            return;
+        }
+
+        if (!upload.Staging.Coherent)
+        {
+            VkMappedMemoryRange range = {};
+            range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+            range.memory = upload.Staging.Memory;
+            range.size = VK_WHOLE_SIZE;
+            VkResult err = vkFlushMappedMemoryRanges(m_Device, 1, &range);
+            VulkanContext::CheckVkResult(err);
+        }
+
+        texture->m_Width = upload.Levels[0].Width;
+        texture->m_Height = upload.Levels[0].Height;
+
+        upload.Texture = texture;
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Decoded.push_back(std::move(upload));
+    }
+
+    bool VulkanTextureStreamer::StageImage(VulkanTexture& texture, const uint8_t* data, size_t size, Upload& upload)
+    {
+        ImageInfo info;
+        if (!ImageDecoder::GetInfo(data, size, info))
+        {
+            GG_CORE_ERROR("Texture {0} is not a supported PNG, QOI or KTX2 image", texture.m_Path);
+            return false;
+        }
+
+        StagingBuffer staging = AcquireStaging(info.GetRGBASize());
+        m_StagedBytes += staging.Size;
+
+        std::string error;
+        if (!ImageDecoder::Decode(data, size, static_cast<uint8_t*>(staging.Mapped), &error))
+        {
+            GG_CORE_ERROR("Texture {0} failed to decode: {1}", texture.m_Path, error);
+            m_StagedBytes -= staging.Size;
+            ReleaseStaging(staging);
+            return false;
+        }
+
+        upload.Staging = staging;
+        upload.Format = GetTextureFormat(texture.m_Specification);
+        upload.Levels.push_back({ 0, info.Width, info.Height });
+        upload.GenerateMips = texture.m_Specification.GenerateMips && m_BlitSupported[texture.m_Specification.SRGB ? 1 : 0];
+        return true;
+    }
+
+    bool VulkanTextureStreamer::StageKTX2(VulkanTexture& texture, const uint8_t* data, size_t size, Upload& upload)
+    {
+        KTX2Image image;
+        std::string error;
+        if (!KTX2::Parse(data, size, image, &error))
+        {
+            GG_CORE_ERROR("Texture {0}: {1}", texture.m_Path, error);
+            return false;
+        }
+
+        const VkFormat format = (VkFormat)image.Format;
+        const bool compressed = KTX2::GetBlockDimension(image.Format) > 1;
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, format, &properties);
+        if ((compressed && !m_CompressedSupported) || !(properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT))
+        {
+            GG_CORE_ERROR("Texture {0}: format {1} is not supported by this device", texture.m_Path, image.Format);
+            return false;
+        }
+
+        // Levels go into staging back to back; copy offsets must be multiples of the block size
+        const uint32_t levelCount = texture.m_Specification.GenerateMips ? (uint32_t)image.Levels.size() : 1;
+        VkDeviceSize stagingSize = 0;
+        for (uint32_t i = 0; i < levelCount; i++)
+        {
+            const KTX2Level& level = image.Levels[i];
+            upload.Levels.push_back({ stagingSize, level.Width, level.Height });
+            stagingSize += (KTX2::GetLevelSize(image.Format, level.Width, level.Height) + 15) & ~15ull;
+        }
+
+        upload.Staging = AcquireStaging(stagingSize);
+        m_StagedBytes += upload.Staging.Size;
+        for (uint32_t i = 0; i < levelCount; i++)
+        {
+            const KTX2Level& level = image.Levels[i];
+            memcpy(static_cast<uint8_t*>(upload.Staging.Mapped) + upload.Levels[i].Offset, data + level.Offset,
+                (size_t)KTX2::GetLevelSize(image.Format, level.Width, level.Height));
+        }
+        upload.Format = format;
+        return true;
+    }
+
+    void VulkanTextureStreamer::SubmitUploads()
+    {
+        if (m_Uploads.empty())
+            return;
+
+        std::vector<Upload> finished;
+        VulkanContext& context = VulkanContext::Get();
+        const uint64_t timelineValue = context.SubmitOneTime([this, &finished](VkCommandBuffer commandBuffer)
+        {
+            uint64_t budget = m_UploadBudget != 0 ? m_UploadBudget : UINT64_MAX;
+            bool first = true;
+            while (!m_Uploads.empty() && (budget > 0 || first))
+            {
+                first = false;
+                if (!RecordUpload(commandBuffer, m_Uploads.front(), budget))
+                    break;
+                finished.push_back(std::move(m_Uploads.front()));
+                m_Uploads.pop_front();
+            }
+        });
+
+        // Later submissions on the queue are ordered after the upload barriers,
+        // so the texture can be sampled from this frame on
+        for (Upload& upload : finished)
+        {
+            upload.Texture->m_State.store(TextureState::Ready, std::memory_order_release);
+            m_Retired.push_back({ upload.Staging, timelineValue });
+        }
+    }
+
+    bool VulkanTextureStreamer::RecordUpload(VkCommandBuffer commandBuffer, Upload& upload, uint64_t& budget)
+    {
+        VulkanTexture& texture = *upload.Texture;
+
+        if (!texture.m_Image)
+        {
+            uint32_t mipLevels = (uint32_t)upload.Levels.size();
+            if (upload.GenerateMips)
+            {
+                mipLevels = 1;
+                for (uint32_t size = std::max(upload.Levels[0].Width, upload.Levels[0].Height); size > 1; size >>= 1)
+                    mipLevels++;
+            }
+            texture.m_MipLevels = mipLevels;
+
+            VulkanImageSpec spec;
+            spec.Width = upload.Levels[0].Width;
+            spec.Height = upload.Levels[0].Height;
+            spec.Format = upload.Format;
+            spec.Usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | (upload.GenerateMips ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0);
+            spec.MipLevels = mipLevels;
+            texture.m_Image = std::make_unique<VulkanImage>();
+            texture.m_Image->Create(spec);
+            texture.m_Image->TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+        }
+
+        // Copy as many whole rows of blocks (pixels for RGBA8) as the budget allows, at least one
+        const uint32_t blockDimension = KTX2::GetBlockDimension(upload.Format);
+        const uint32_t blockSize = KTX2::GetBlockSize(upload.Format);
+        while (upload.Level < upload.Levels.size())
+        {
+            const UploadLevel& level = upload.Levels[upload.Level];
+            const uint64_t rowBytes = (uint64_t)((level.Width + blockDimension - 1) / blockDimension) * blockSize;
+            const uint32_t blockRows = (level.Height + blockDimension - 1) / blockDimension;
+            const uint32_t rows = (uint32_t)std::min<uint64_t>(blockRows - upload.RowsCopied, std::max<uint64_t>(1, budget / rowBytes));
+            const uint32_t y = upload.RowsCopied * blockDimension;
+
+            VkBufferImageCopy region = {};
+            region.bufferOffset = level.Offset + upload.RowsCopied * rowBytes;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = upload.Level;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = { 0, (int32_t)y, 0 };
+            region.imageExtent = { level.Width, std::min(rows * blockDimension, level.Height - y), 1 };
+            vkCmdCopyBufferToImage(commandBuffer, upload.Staging.Buffer, texture.m_Image->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+            upload.RowsCopied += rows;
+            budget -= std::min<uint64_t>(budget, rows * rowBytes);
+            if (upload.RowsCopied < blockRows)
+                return false;
+
+            upload.Level++;
+            upload.RowsCopied = 0;
+            if (budget == 0 && upload.Level < upload.Levels.size())
+                return false;
+        }
+
+        if (upload.GenerateMips && texture.m_MipLevels > 1)
+        {
+            RecordMips(commandBuffer, texture);
+        }
+        else
+        {
+            texture.m_Image->TransitionLayout(commandBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+        }
+        return true;
+    }
+
+    void VulkanTextureStreamer::RecordMips(VkCommandBuffer commandBuffer, VulkanTexture& texture)
+    {
+        VkImage image = texture.m_Image->GetImage();
+        const VkPipelineStageFlags shaderStages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        int32_t width = (int32_t)texture.GetWidth();
+        int32_t height = (int32_t)texture.GetHeight();
+
+        // Each level is blitted from the one above it, which is then done and handed to shaders
+        for (uint32_t mip = 1; mip < texture.m_MipLevels; mip++)
+        {
+            RecordMipBarrier(commandBuffer, image, mip - 1,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+
+            const int32_t mipWidth = std::max(1, width / 2);
+            const int32_t mipHeight = std::max(1, height / 2);
+            VkImageBlit blit = {};
+            blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.srcSubresource.mipLevel = mip - 1;
+            blit.srcSubresource.layerCount = 1;
+            blit.srcOffsets[1] = { width, height, 1 };
+            blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.dstSubresource.mipLevel = mip;
+            blit.dstSubresource.layerCount = 1;
+            blit.dstOffsets[1] = { mipWidth, mipHeight, 1 };
+            vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+            RecordMipBarrier(commandBuffer, image, mip - 1,
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+                shaderStages, VK_ACCESS_SHADER_READ_BIT);
+
+            width = mipWidth;
+            height = mipHeight;
+        }
+
+        RecordMipBarrier(commandBuffer, image, texture.m_MipLevels - 1,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+            shaderStages, VK_ACCESS_SHADER_READ_BIT);
+        texture.m_Image->SetLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    VulkanTextureStreamer::StagingBuffer VulkanTextureStreamer::AcquireStaging(VkDeviceSize size)
+    {
+        {
+            // Reuse a pooled buffer unless it would waste more than half of itself
+            std::lock_guard<std::mutex> lock(m_StagingMutex);
+            auto best = m_FreeStaging.end();
+            for (auto it = m_FreeStaging.begin(); it != m_FreeStaging.end(); ++it)
+            {
+                if (it->Size >= size && it->Size / 2 <= size && (best == m_FreeStaging.end() || it->Size < best->Size))
+                    best = it;
+            }
+            if (best != m_FreeStaging.end())
+            {
+                StagingBuffer staging = *best;
+                m_FreeStaging.erase(best);
+                return staging;
+            }
+        }
+
+        StagingBuffer staging;
+        staging.Size = size;
+
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        VkResult err = vkCreateBuffer(m_Device, &bufferInfo, m_Allocator, &staging.Buffer);
+        VulkanContext::CheckVkResult(err);
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(m_Device, staging.Buffer, &requirements);
+
+        // Decoders only write sequentially, so uncached (write-combined) memory is fine here
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &memoryProperties);
+        const VkMemoryPropertyFlags preferred[] =
+        {
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+        };
+        uint32_t memoryType = UINT32_MAX;
+        for (VkMemoryPropertyFlags flags : preferred)
+        {
+            for (uint32_t i = 0; i < memoryProperties.memoryTypeCount && memoryType == UINT32_MAX; i++)
+            {
+                if ((requirements.memoryTypeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & flags) == flags)
+                    memoryType = i;
+            }
+            if (memoryType != UINT32_MAX)
+                break;
+        }
+        GG_CORE_ASSERT(memoryType != UINT32_MAX, "No host-visible memory for texture staging");
+        staging.Coherent = (memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+
+        VkMemoryAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = requirements.size;
+        allocInfo.memoryTypeIndex = memoryType;
+        err = vkAllocateMemory(m_Device, &allocInfo, m_Allocator, &staging.Memory);
+        VulkanContext::CheckVkResult(err);
+        err = vkBindBufferMemory(m_Device, staging.Buffer, staging.Memory, 0);
+        VulkanContext::CheckVkResult(err);
+        err = vkMapMemory(m_Device, staging.Memory, 0, VK_WHOLE_SIZE, 0, &staging.Mapped);
+        VulkanContext::CheckVkResult(err);
+
+        return staging;
+    }
+
+    void VulkanTextureStreamer::ReleaseStaging(const StagingBuffer& staging)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_StagingMutex);
+            if (m_FreeStaging.size() < s_MaxFreeStaging)
+            {
+                m_FreeStaging.push_back(staging);
+                return;
+            }
+        }
+        DestroyStaging(staging);
+    }
+
+    void VulkanTextureStreamer::DestroyStaging(const StagingBuffer& staging)
+    {
+        vkUnmapMemory(m_Device, staging.Memory);
+        vkDestroyBuffer(m_Device, staging.Buffer, m_Allocator);
+        vkFreeMemory(m_Device, staging.Memory, m_Allocator);
+    }
+
+}
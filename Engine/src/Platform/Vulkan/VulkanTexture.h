@@ -0,0 +1,150 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+#include "VulkanImage.h"
+#include "GGEngine/JobSystem.h"
+#include "GGEngine/Texture.h"
+
+namespace GGEngine {
+
+    class VulkanTexture : public Texture2D
+    {
+    public:
+        VulkanTexture(const std::string& path, const TextureSpecification& specification);
+        ~VulkanTexture() override;
+
+        uint32_t GetWidth() const override { return m_Width.load(); }
+        uint32_t GetHeight() const override { return m_Height.load(); }
+        uint32_t GetMipLevels() const override { return m_MipLevels; }
+        TextureState GetState() const override { return m_State.load(std::memory_order_acquire); }
+        const std::string& GetPath() const override { return m_Path; }
+        uint64_t GetImGuiTextureID() override;
+
+        const TextureSpecification& GetSpecification() const { return m_Specification; }
+
+        // Valid once the texture is ready; the image is then in SHADER_READ_ONLY_OPTIMAL
+        VkImage GetImage() const { return m_Image ? m_Image->GetImage() : VK_NULL_HANDLE; }
+        VkImageView GetView() const { return m_Image ? m_Image->GetView() : VK_NULL_HANDLE; }
+        VkSampler GetSampler() const { return m_Sampler; }
+
+    private:
+        friend class VulkanTextureStreamer;
+
+        std::string m_Path;
+        TextureSpecification m_Specification;
+
+        std::unique_ptr<VulkanImage> m_Image;
+        VkSampler m_Sampler = VK_NULL_HANDLE; // Owned by the streamer
+        VkDescriptorSet m_ImGuiDescriptor = VK_NULL_HANDLE; // Created on first ImGui use, main thread
+        uint32_t m_MipLevels = 0;
+
+        std::atomic<uint32_t> m_Width{ 0 };
+        std::atomic<uint32_t> m_Height{ 0 };
+        std::atomic<TextureState> m_State{ TextureState::Loading };
+    };
+
+    // Loads textures without touching frame time: files are decoded on the job system
+    // straight into pooled host-visible staging buffers, and the main thread copies at
+    // most UploadBudget bytes per frame into device images (large images are split into
+    // row bands), then builds the mip chain with vkCmdBlitImage. Decoding stalls while
+    // too much decoded data is waiting for upload, which bounds staging memory.
+    // Cooked KTX2 files skip decoding: their block-compressed levels are copied from the
+    // mapped file as they are, and the file's format and mips replace the specification's.
+    class VulkanTextureStreamer
+    {
+    public:
+        void Init(VkDevice device, VkPhysicalDevice physicalDevice, const VkAllocationCallbacks* allocator);
+        // Releases staging memory and the placeholder; the device must be idle
+        void Shutdown();
+
+        std::shared_ptr<VulkanTexture> Load(const std::string& path, const TextureSpecification& specification);
+
+        // Frame boundary, main thread: recycles staging memory, starts decodes and
+        // records this frame's share of uploads
+        void Update();
+
+        // Bytes copied to the GPU per frame, 0 for no limit. At least one row always moves.
+        void SetUploadBudget(uint64_t bytesPerFrame) { m_UploadBudget = bytesPerFrame; }
+        uint64_t GetUploadBudget() const { return m_UploadBudget; }
+        // Textures that are queued, decoding or partially uploaded
+        uint32_t GetPendingCount();
+
+        // 1x1 white texture to bind while a texture is still loading or failed to load
+        VulkanTexture& GetPlaceholder() { return *m_Placeholder; }
+
+    private:
+        struct StagingBuffer
+        {
+            VkBuffer Buffer = VK_NULL_HANDLE;
+            VkDeviceMemory Memory = VK_NULL_HANDLE;
+            VkDeviceSize Size = 0;
+            void* Mapped = nullptr;
+            bool Coherent = true;
+        };
+
+        struct UploadLevel
+        {
+            VkDeviceSize Offset = 0; // Into the staging buffer
+            uint32_t Width = 0;
+            uint32_t Height = 0;
+        };
+
+        struct Upload
+        {
+            std::shared_ptr<VulkanTexture> Texture;
+            StagingBuffer Staging;
+            VkFormat Format = VK_FORMAT_UNDEFINED;
+            std::vector<UploadLevel> Levels; // Staged levels; further mips are blitted when GenerateMips
+            bool GenerateMips = false;
+            uint32_t Level = 0;
+            uint32_t RowsCopied = 0; // Of the current level, in rows of blocks
+        };
+
+        struct RetiredStaging
+        {
+            StagingBuffer Staging;
+            uint64_t TimelineValue = 0;
+        };
+
+        void Decode(const std::shared_ptr<VulkanTexture>& texture);
+        bool StageImage(VulkanTexture& texture, const uint8_t* data, size_t size, Upload& upload);
+        bool StageKTX2(VulkanTexture& texture, const uint8_t* data, size_t size, Upload& upload);
+        void SubmitUploads();
+        bool RecordUpload(VkCommandBuffer commandBuffer, Upload& upload, uint64_t& budget);
+        void RecordMips(VkCommandBuffer commandBuffer, VulkanTexture& texture);
+
+        StagingBuffer AcquireStaging(VkDeviceSize size);
+        void ReleaseStaging(const StagingBuffer& staging);
+        void DestroyStaging(const StagingBuffer& staging);
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* m_Allocator = nullptr;
+
+        VkSampler m_LinearSampler = VK_NULL_HANDLE;
+        VkSampler m_NearestSampler = VK_NULL_HANDLE;
+        bool m_BlitSupported[2] = {}; // Indexed by TextureSpecification::SRGB
+        bool m_CompressedSupported = false;
+
+        uint64_t m_UploadBudget = 8ull << 20;
+        uint64_t m_MaxStagedBytes = 64ull << 20;
+        std::atomic<uint64_t> m_StagedBytes{ 0 };
+
+        std::mutex m_Mutex;
+        std::deque<std::shared_ptr<VulkanTexture>> m_DecodeQueue;
+        std::deque<Upload> m_Decoded;
+        std::unordered_map<std::string, std::weak_ptr<VulkanTexture>> m_Textures;
+        JobCounter m_DecodeJobs{ 0 };
+
+        // Main thread only
+        std::deque<Upload> m_Uploads;
+        std::vector<RetiredStaging> m_Retired;
+        std::shared_ptr<VulkanTexture> m_Placeholder;
+
+        std::mutex m_StagingMutex;
+        std::vector<StagingBuffer> m_FreeStaging;
+    };
+
+}
@@ -0,0 +1,79 @@
+#include "VulkanTimeline.h"
+
+#include "VulkanContext.h"
+
+namespace GGEngine {
+
+    void VulkanTimeline::Init(VkDevice device, uint32_t apiVersion, const VkAllocationCallbacks* allocator)
+    {
+        m_Device = device;
+        m_Allocator = allocator;
+
+        // Core in 1.2, VK_KHR_timeline_semaphore before that
+        const bool core = apiVersion >= VK_API_VERSION_1_2;
+        m_GetCounterValue = core ? vkGetSemaphoreCounterValue : vkGetSemaphoreCounterValueKHR;
+        m_WaitSemaphores = core ? vkWaitSemaphores : vkWaitSemaphoresKHR;
+
+        VkSemaphoreTypeCreateInfo typeInfo = {};
+        typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        info.pNext = &typeInfo;
+        VkResult err = vkCreateSemaphore(m_Device, &info, m_Allocator, &m_Semaphore);
+        VulkanContext::CheckVkResult(err);
+
+        m_LastSubmitted = 0;
+        m_Completed = 0;
+    }
+
+    void VulkanTimeline::Shutdown()
+    {
+        if (m_Semaphore == VK_NULL_HANDLE)
+            return;
+        vkDestroySemaphore(m_Device, m_Semaphore, m_Allocator);
+        m_Semaphore = VK_NULL_HANDLE;
+    }
+
+    uint64_t VulkanTimeline::GetCompletedValue()
+    {
+        uint64_t value = 0;
+        VkResult err = m_GetCounterValue(m_Device, m_Semaphore, &value);
+        VulkanContext::CheckVkResult(err);
+
+        // Keep the cached value monotonic when several threads query concurrently
+        uint64_t cached = m_Completed.load();
+        while (value > cached && !m_Completed.compare_exchange_weak(cached, value)) {}
+        return std::max(value, cached);
+    }
+
+    bool VulkanTimeline::IsComplete(uint64_t value)
+    {
+        if (value <= m_Completed.load())
+            return true;
+        return value <= GetCompletedValue();
+    }
+
+    bool VulkanTimeline::WaitFor(uint64_t value, uint64_t timeoutNs)
+    {
+        if (value <= m_Completed.load())
+            return true;
+
+        VkSemaphoreWaitInfo waitInfo = {};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_Semaphore;
+        waitInfo.pValues = &value;
+        VkResult err = m_WaitSemaphores(m_Device, &waitInfo, timeoutNs);
+        if (err == VK_TIMEOUT)
+            return false;
+        VulkanContext::CheckVkResult(err);
+
+        uint64_t cached = m_Completed.load();
+        while (value > cached && !m_Completed.compare_exchange_weak(cached, value)) {}
+        return true;
+    }
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+namespace GGEngine {
+
+    // Monotonic GPU timeline for one queue, backed by a timeline semaphore.
+    // Every submission to the queue signals the next value, so "work N has finished"
+    // is a single integer comparison for frame pacing, uploads and resource lifetimes.
+    class VulkanTimeline
+    {
+    public:
+        void Init(VkDevice device, uint32_t apiVersion, const VkAllocationCallbacks* allocator);
+        void Shutdown();
+
+        VkSemaphore GetSemaphore() const { return m_Semaphore; }
+
+        // Reserves the value the next submission must signal. Submissions to the queue have
+        // to happen in the same order the values were reserved in.
+        uint64_t AdvanceSubmitValue() { return ++m_LastSubmitted; }
+        uint64_t GetLastSubmittedValue() const { return m_LastSubmitted.load(); }
+
+        // Latest value the GPU has reached (queries the driver)
+        uint64_t GetCompletedValue();
+        // Cheap when the value is already known to be complete; otherwise queries the driver
+        bool IsComplete(uint64_t value);
+        // Blocks the calling thread until the GPU reaches value. Returns false on timeout.
+        bool WaitFor(uint64_t value, uint64_t timeoutNs = UINT64_MAX);
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* m_Allocator = nullptr;
+        VkSemaphore m_Semaphore = VK_NULL_HANDLE;
+
+        PFN_vkGetSemaphoreCounterValue m_GetCounterValue = nullptr;
+        PFN_vkWaitSemaphores m_WaitSemaphores = nullptr;
+
+        std::atomic<uint64_t> m_LastSubmitted{ 0 };
+        std::atomic<uint64_t> m_Completed{ 0 };
+    };
+
+}
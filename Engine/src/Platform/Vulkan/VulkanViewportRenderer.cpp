@@ -0,0 +1,245 @@
+#include "VulkanViewportRenderer.h"
+
+#include "VulkanContext.h"
+#include "GGEngine/FrameStats.h"
+#include "GGEngine/Timer.h"
+
+#include "imgui.h"
+#include "imgui_impl_vulkan.h"
+
+namespace GGEngine {
+
+    void VulkanViewportRenderer::Init(VkDevice device)
+    {
+        m_Device = device;
+    }
+
+    void VulkanViewportRenderer::Shutdown()
+    {
+        m_States.clear();
+        m_Rendered.clear();
+    }
+
+    void VulkanViewportRenderer::Render()
+    {
+        VulkanContext& context = VulkanContext::Get();
+        VulkanTimeline& timeline = context.GetTimeline();
+        ImGuiPlatformIO& platformIO = ImGui::GetPlatformIO();
+        m_Rendered.clear();
+
+        for (auto& entry : m_States)
+            entry.second.Seen = false;
+
+        // Viewport 0 is the main window, which the context renders itself
+        for (int i = 1; i < platformIO.Viewports.Size; i++)
+        {
+            ImGuiViewport* viewport = platformIO.Viewports[i];
+            ViewportState& state = m_States[viewport->ID];
+            state.Seen = true;
+            if ((viewport->Flags & ImGuiViewportFlags_IsMinimized) || viewport->DrawData == nullptr)
+                continue;
+
+            ImGui_ImplVulkanH_Window* window = ImGui_ImplVulkanH_GetWindowDataFromViewport(viewport);
+            if (window == nullptr || window->Swapchain == VK_NULL_HANDLE)
+                continue;
+
+            // The backend rebuilds through its own resize hook, which waits for the device
+            if (state.NeedsRebuild)
+            {
+                platformIO.Renderer_SetWindowSize(viewport, viewport->Size);
+                state.NeedsRebuild = false;
+                state.ImageTimelineValues.clear();
+            }
+
+            VkSemaphore imageAcquired = window->FrameSemaphores[window->SemaphoreIndex].ImageAcquiredSemaphore;
+            VkResult err = vkAcquireNextImageKHR(m_Device, window->Swapchain, UINT64_MAX, imageAcquired, VK_NULL_HANDLE, &window->FrameIndex);
+            if (err == VK_ERROR_OUT_OF_DATE_KHR)
+            {
+                state.NeedsRebuild = true;
+                continue;
+            }
+            if (err == VK_SUBOPTIMAL_KHR)
+                state.NeedsRebuild = true;
+            else
+                VulkanContext::CheckVkResult(err);
+
+            // The image's command buffer is reused once its previous submission has finished
+            state.ImageTimelineValues.resize(window->ImageCount, 0);
+            timeline.WaitFor(state.ImageTimelineValues[window->FrameIndex]);
+            m_Rendered.push_back({ viewport, window, &state });
+        }
+
+        // Windows that were closed have already been torn down by the backend
+        for (auto it = m_States.begin(); it != m_States.end(); )
+        {
+            if (it->second.Seen)
+                ++it;
+            else
+                it = m_States.erase(it);
+        }
+
+        if (m_Rendered.empty())
+            return;
+
+        // ImGui_ImplVulkan_RenderDrawData writes backend-wide state on every call, so the
+        // viewports are recorded one after the other
+        for (const RenderedViewport& rendered : m_Rendered)
+            Record(rendered);
+
+        // One batch for every viewport: each waits on its own acquire and signals its own
+        // render-complete semaphore, and the batch signals a single timeline value
+        const uint64_t signalValue = timeline.AdvanceSubmitValue();
+        m_CommandBuffers.clear();
+        m_WaitSemaphores.clear();
+        m_WaitStages.clear();
+        m_SignalSemaphores.clear();
+        m_SignalValues.clear();
+        for (const RenderedViewport& rendered : m_Rendered)
+        {
+            const ImGui_ImplVulkanH_Window* window = rendered.Window;
+            const ImGui_ImplVulkanH_FrameSemaphores& semaphores = window->FrameSemaphores[window->SemaphoreIndex];
+            m_CommandBuffers.push_back(window->Frames[window->FrameIndex].CommandBuffer);
+            m_WaitSemaphores.push_back(semaphores.ImageAcquiredSemaphore);
+            m_WaitStages.push_back(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+            m_SignalSemaphores.push_back(semaphores.RenderCompleteSemaphore);
+            m_SignalValues.push_back(0);
+            rendered.State->ImageTimelineValues[window->FrameIndex] = signalValue;
+        }
+        m_SignalSemaphores.push_back(timeline.GetSemaphore());
+        m_SignalValues.push_back(signalValue);
+
+        VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.signalSemaphoreValueCount = (uint32_t)m_SignalValues.size();
+        timelineInfo.pSignalSemaphoreValues = m_SignalValues.data();
+
+        VkSubmitInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        info.pNext = &timelineInfo;
+        info.waitSemaphoreCount = (uint32_t)m_WaitSemaphores.size();
+        info.pWaitSemaphores = m_WaitSemaphores.data();
+        info.pWaitDstStageMask = m_WaitStages.data();
+        info.commandBufferCount = (uint32_t)m_CommandBuffers.size();
+        info.pCommandBuffers = m_CommandBuffers.data();
+        info.signalSemaphoreCount = (uint32_t)m_SignalSemaphores.size();
+        info.pSignalSemaphores = m_SignalSemaphores.data();
+
+        Timer submitTimer;
+        VkResult err = vkQueueSubmit(context.GetQueue(), 1, &info, VK_NULL_HANDLE);
+        FrameStats::AddSubmitTime(submitTimer.ElapsedMillis());
+        VulkanContext::CheckVkResult(err);
+    }
+
+    void VulkanViewportRenderer::Record(const RenderedViewport& rendered) const
+    {
+        const VulkanContext& context = VulkanContext::Get();
+        const ImGuiViewport* viewport = rendered.Viewport;
+        const ImGui_ImplVulkanH_Window* window = rendered.Window;
+        const ImGui_ImplVulkanH_Frame& frame = window->Frames[window->FrameIndex];
+
+        VkResult err = vkResetCommandPool(m_Device, frame.CommandPool, 0);
+        VulkanContext::CheckVkResult(err);
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        err = vkBeginCommandBuffer(frame.CommandBuffer, &beginInfo);
+        VulkanContext::CheckVkResult(err);
+
+        VkClearValue clearValue = {};
+        if (!(viewport->Flags & ImGuiViewportFlags_NoRendererClear))
+            clearValue = window->ClearValue;
+        const VkExtent2D extent = { (uint32_t)window->Width, (uint32_t)window->Height };
+
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = frame.Backbuffer;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.layerCount = 1;
+
+        if (window->UseDynamicRendering)
+        {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            vkCmdPipelineBarrier(frame.CommandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+            VkRenderingAttachmentInfo colorAttachment = {};
+            colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            colorAttachment.imageView = frame.BackbufferView;
+            colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            colorAttachment.loadOp = window->ClearEnable ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            colorAttachment.clearValue = clearValue;
+
+            VkRenderingInfo renderingInfo = {};
+            renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+            renderingInfo.renderArea.extent = extent;
+            renderingInfo.layerCount = 1;
+            renderingInfo.colorAttachmentCount = 1;
+            renderingInfo.pColorAttachments = &colorAttachment;
+            context.CmdBeginRendering(frame.CommandBuffer, &renderingInfo);
+        }
+        else
+        {
+            VkRenderPassBeginInfo renderPassInfo = {};
+            renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            renderPassInfo.renderPass = window->RenderPass;
+            renderPassInfo.framebuffer = frame.Framebuffer;
+            renderPassInfo.renderArea.extent = extent;
+            renderPassInfo.clearValueCount = window->ClearEnable ? 1 : 0;
+            renderPassInfo.pClearValues = window->ClearEnable ? &clearValue : nullptr;
+            vkCmdBeginRenderPass(frame.CommandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        }
+
+        ImGui_ImplVulkan_RenderDrawData(viewport->DrawData, frame.CommandBuffer);
+
+        if (window->UseDynamicRendering)
+        {
+            context.CmdEndRendering(frame.CommandBuffer);
+            barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            barrier.dstAccessMask = 0;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+            vkCmdPipelineBarrier(frame.CommandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                0, 0, nullptr, 0, nullptr, 1, &barrier);
+        }
+        else
+        {
+            vkCmdEndRenderPass(frame.CommandBuffer);
+        }
+
+        err = vkEndCommandBuffer(frame.CommandBuffer);
+        VulkanContext::CheckVkResult(err);
+    }
+
+    void VulkanViewportRenderer::AppendPresents(std::vector<VkSwapchainKHR>& swapchains, std::vector<uint32_t>& imageIndices, std::vector<VkSemaphore>& waitSemaphores) const
+    {
+        for (const RenderedViewport& rendered : m_Rendered)
+        {
+            const ImGui_ImplVulkanH_Window* window = rendered.Window;
+            swapchains.push_back(window->Swapchain);
+            imageIndices.push_back(window->FrameIndex);
+            waitSemaphores.push_back(window->FrameSemaphores[window->SemaphoreIndex].RenderCompleteSemaphore);
+        }
+    }
+
+    void VulkanViewportRenderer::OnPresented(const VkResult* results)
+    {
+        for (size_t i = 0; i < m_Rendered.size(); i++)
+        {
+            const RenderedViewport& rendered = m_Rendered[i];
+            if (results[i] == VK_ERROR_OUT_OF_DATE_KHR || results[i] == VK_SUBOPTIMAL_KHR)
+                rendered.State->NeedsRebuild = true;
+            else
+                VulkanContext::CheckVkResult(results[i]);
+            rendered.Window->SemaphoreIndex = (rendered.Window->SemaphoreIndex + 1) % rendered.Window->SemaphoreCount;
+        }
+        m_Rendered.clear();
+    }
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <glad/vulkan.h>
+
+struct ImGuiViewport;
+struct ImGui_ImplVulkanH_Window;
+
+namespace GGEngine {
+
+    // Renders ImGui's secondary platform windows (multi-viewport) in place of
+    // ImGui::RenderPlatformWindowsDefault, which records, submits and presents each window
+    // one after the other and blocks on a fence per window. Here the visible viewports are
+    // still recorded serially, since the backend's RenderDrawData is not thread safe, but
+    // they go to the queue in one vkQueueSubmit paced by the context timeline, and their
+    // swapchains join the main window's present.
+    // The ImGui Vulkan backend still owns the viewport swapchains. Main thread only.
+    class VulkanViewportRenderer
+    {
+    public:
+        void Init(VkDevice device);
+        // The device must be idle
+        void Shutdown();
+
+        // After ImGui::UpdatePlatformWindows
+        void Render();
+
+        // Swapchains rendered this frame, to be presented together with the main window
+        void AppendPresents(std::vector<VkSwapchainKHR>& swapchains, std::vector<uint32_t>& imageIndices, std::vector<VkSemaphore>& waitSemaphores) const;
+        // results holds one entry per swapchain AppendPresents added, in the same order
+        void OnPresented(const VkResult* results);
+
+        uint32_t GetRenderedCount() const { return (uint32_t)m_Rendered.size(); }
+
+    private:
+        struct ViewportState
+        {
+            std::vector<uint64_t> ImageTimelineValues; // Last submission per swapchain image
+            bool NeedsRebuild = false;
+            bool Seen = false;
+        };
+
+        struct RenderedViewport
+        {
+            ImGuiViewport* Viewport;
+            ImGui_ImplVulkanH_Window* Window;
+            ViewportState* State;
+        };
+
+        void Record(const RenderedViewport& rendered) const;
+
+    private:
+        VkDevice m_Device = VK_NULL_HANDLE;
+        std::unordered_map<uint32_t, ViewportState> m_States; // By ImGuiViewport::ID
+        std::vector<RenderedViewport> m_Rendered;
+
+        std::vector<VkCommandBuffer> m_CommandBuffers;
+        std::vector<VkSemaphore> m_WaitSemaphores;
+        std::vector<VkPipelineStageFlags> m_WaitStages;
+        std::vector<VkSemaphore> m_SignalSemaphores;
+        std::vector<uint64_t> m_SignalValues;
+    };
+
+}
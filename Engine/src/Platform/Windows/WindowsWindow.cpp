@@ -1,4 +1,5 @@
 #include "WindowsWindow.h"
+#include "Platform/Headless/HeadlessWindow.h"
 
 #include "GGEngine/Events/ApplicationEvent.h"
 #include "GGEngine/Events/KeyEvent.h"
@@ -16,6 +17,8 @@ namespace GGEngine {
 
     Window* Window::Create(const WindowProps& props)
     {
+        if (props.Headless)
+            return new HeadlessWindow(props);
         return new WindowsWindow(props);
     }
 
@@ -52,6 +55,12 @@ namespace GGEngine {
         GG_CORE_ASSERT(m_Window, "Failed to create GLFW window");
         glfwSetWindowUserPointer(m_Window, &m_Data);
 
+        int framebufferWidth, framebufferHeight;
+        glfwGetFramebufferSize(m_Window, &framebufferWidth, &framebufferHeight);
+        m_Data.FramebufferWidth = framebufferWidth;
+        m_Data.FramebufferHeight = framebufferHeight;
+        m_Data.Iconified = glfwGetWindowAttrib(m_Window, GLFW_ICONIFIED) != 0;
+
 
         // GLFW CALLBACKS SETUP
 
@@ -64,6 +73,23 @@ namespace GGEngine {
             data.EventCallback(event);
         });
         
+        glfwSetFramebufferSizeCallback(m_Window, [](GLFWwindow* window, int width, int height)
+        {
+            WindowData& data = *(WindowData*)glfwGetWindowUserPointer(window);
+            data.FramebufferWidth = width;
+            data.FramebufferHeight = height;
+            FramebufferResizeEvent event(width, height);
+            data.EventCallback(event);
+        });
+
+        glfwSetWindowIconifyCallback(m_Window, [](GLFWwindow* window, int iconified)
+        {
+            WindowData& data = *(WindowData*)glfwGetWindowUserPointer(window);
+            data.Iconified = iconified != 0;
+            WindowIconifyEvent event(data.Iconified);
+            data.EventCallback(event);
+        });
+
         glfwSetWindowCloseCallback(m_Window, [](GLFWwindow* window)
         {
             WindowData& data = *(WindowData*)glfwGetWindowUserPointer(window);
@@ -148,6 +174,16 @@ namespace GGEngine {
         // Vulkan: swapchain presentation handled by renderer
     }
 
+    void WindowsWindow::WaitEvents(double timeoutSeconds)
+    {
+        glfwWaitEventsTimeout(timeoutSeconds);
+    }
+
+    void WindowsWindow::PostEmptyEvent()
+    {
+        glfwPostEmptyEvent();
+    }
+
     void WindowsWindow::SetVSync(bool enabled)
     {
         // Vulkan: VSync controlled via present mode in swapchain
@@ -15,9 +15,14 @@ namespace GGEngine {
         virtual ~WindowsWindow();
 
         void OnUpdate() override;
+        void WaitEvents(double timeoutSeconds) override;
+        void PostEmptyEvent() override;
 
         inline unsigned int GetWidth() const override { return m_Data.Width; }
         inline unsigned int GetHeight() const override { return m_Data.Height; }
+        inline unsigned int GetFramebufferWidth() const override { return m_Data.FramebufferWidth; }
+        inline unsigned int GetFramebufferHeight() const override { return m_Data.FramebufferHeight; }
+        bool IsIconified() const override { return m_Data.Iconified; }
 
         inline void SetEventCallback(const EventCallbackFn& callback) override { m_Data.EventCallback = callback; }
         void SetVSync(bool enabled) override;
@@ -32,6 +37,8 @@ namespace GGEngine {
         {
             std::string Title;
             unsigned int Width, Height;
+            unsigned int FramebufferWidth, FramebufferHeight;
+            bool Iconified;
             bool VSync;
 
             EventCallbackFn EventCallback;
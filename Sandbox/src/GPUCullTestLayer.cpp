@@ -0,0 +1,111 @@
+#include "GPUCullTestLayer.h"
+
+#include "GGEngine/Application.h"
+#include "GGEngine/Log.h"
+#include "GGEngine/GPUCulling.h"
+#include "GGEngine/Math/Geometry.h"
+
+using namespace GGEngine;
+
+namespace {
+
+    const float s_Radius = 0.5f;
+    // Spheres closer than this to a frustum plane are left out, so float differences
+    // between the CPU and the GPU cannot flip a result
+    const float s_PlaneMargin = 0.05f;
+    // Long enough for the cull shader to compile on a software rasterizer
+    const uint32_t s_TimeoutFrames = 1000;
+
+    // -1 clearly outside, 1 clearly inside, 0 too close to call
+    int Classify(const Frustum& frustum, const Vec3& center, float radius)
+    {
+        bool inside = true;
+        for (const Plane& plane : frustum.Planes)
+        {
+            const float distance = plane.SignedDistance(center) + radius;
+            if (std::fabs(distance) < s_PlaneMargin)
+                return 0;
+            inside = inside && distance >= 0.0f;
+        }
+        return inside ? 1 : -1;
+    }
+
+}
+
+void GPUCullTestLayer::OnAttach()
+{
+    const Mat4 view = Mat4::LookAt(Vec3(0.0f, 0.0f, 0.0f), Vec3(0.0f, 0.0f, -1.0f), Vec3(0.0f, 1.0f, 0.0f));
+    const Mat4 viewProjection = Mat4::Perspective(1.0f, 16.0f / 9.0f, 0.1f, 100.0f) * view;
+    const Frustum frustum = Frustum::FromMatrix(viewProjection);
+    GPUCulling::SetViewProjection(viewProjection);
+
+    // Depths before the near plane, inside the range and past the far plane
+    const float depths[] = { 5.0f, -5.0f, -20.0f, -50.0f, -90.0f, -150.0f };
+    uint32_t added = 0;
+    for (float z : depths)
+    {
+        for (float y = -40.0f; y <= 40.0f; y += 4.0f)
+        {
+            for (float x = -80.0f; x <= 80.0f; x += 4.0f)
+            {
+                GPUCullObject object;
+                object.Center = Vec3(x, y, z);
+                object.Radius = s_Radius;
+                object.IndexCount = 36;
+
+                const int classification = Classify(frustum, object.Center, object.Radius);
+                if (classification == 0)
+                    continue;
+                if (GPUCulling::AddObject(object) == UINT32_MAX)
+                {
+                    GG_ERROR("GPU cull test: could not add objects");
+                    Application::Get().Close(1);
+                    m_Done = true;
+                    return;
+                }
+                added++;
+                if (classification > 0)
+                    m_Expected++;
+            }
+        }
+    }
+
+    // Removed objects stay in the buffer, disabled
+    GPUCullObject removed;
+    removed.Center = Vec3(0.0f, 0.0f, -10.0f);
+    removed.Radius = s_Radius;
+    removed.IndexCount = 36;
+    GPUCulling::RemoveObject(GPUCulling::AddObject(removed));
+
+    GG_INFO("GPU cull test: {0} objects, {1} inside the frustum", added, m_Expected);
+}
+
+void GPUCullTestLayer::OnUpdate()
+{
+    if (m_Done)
+        return;
+    m_Frames++;
+
+    // Objects never change after OnAttach, so the first count that comes back is final
+    uint32_t visible = 0;
+    if (GPUCulling::GetVisibleCount(visible))
+    {
+        m_Done = true;
+        if (visible == m_Expected)
+        {
+            GG_INFO("GPU cull test passed: {0} visible after {1} frames", visible, m_Frames);
+            Application::Get().Close(0);
+        }
+        else
+        {
+            GG_ERROR("GPU cull test failed: the GPU counted {0} visible objects, expected {1}", visible, m_Expected);
+            Application::Get().Close(1);
+        }
+    }
+    else if (m_Frames >= s_TimeoutFrames)
+    {
+        m_Done = true;
+        GG_ERROR("GPU cull test failed: no visible count after {0} frames (needs draw indirect count)", m_Frames);
+        Application::Get().Close(1);
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "GGEngine/Layer.h"
+
+// Headless check of GPU-driven culling (--gpu-cull-test): registers a grid of objects
+// in and around the camera frustum, waits for the GPU's visible count and compares it
+// with a CPU frustum test. The application exits with 1 on a mismatch or when no count
+// comes back.
+class GPUCullTestLayer : public GGEngine::Layer
+{
+public:
+    GPUCullTestLayer() : Layer("GPUCullTestLayer") {}
+
+    void OnAttach() override;
+    void OnUpdate() override;
+
+private:
+    uint32_t m_Expected = 0;
+    uint32_t m_Frames = 0;
+    bool m_Done = false;
+};
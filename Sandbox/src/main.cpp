@@ -1,5 +1,7 @@
 #include "GGEngine.h"
 
+#include "GPUCullTestLayer.h"
+
 class ExampleLayer : public GGEngine::Layer
 {
 public:
@@ -24,15 +26,25 @@ public:
 class Sandbox : public GGEngine::Application 
 {
 public:
-    Sandbox() 
+    Sandbox(const GGEngine::ApplicationSpecification& specification)
+        : GGEngine::Application(specification)
     {
-        PushLayer(new ExampleLayer());
+        if (specification.CommandLineArgs.Find("--gpu-cull-test"))
+            PushLayer(new GPUCullTestLayer());
+        else
+            PushLayer(new ExampleLayer());
     }
     ~Sandbox() 
     {
     }
 };
 
-GGEngine::Application* GGEngine::CreateApplication() {
-    return new Sandbox();
+GGEngine::Application* GGEngine::CreateApplication(GGEngine::ApplicationCommandLineArgs args) {
+    GGEngine::ApplicationSpecification spec;
+    spec.Name = "Sandbox";
+    spec.CommandLineArgs = args;
+    // The culling check runs without a window
+    if (args.Find("--gpu-cull-test"))
+        spec.Headless = true;
+    return new Sandbox(spec);
 }
\ No newline at end of file
@@ -0,0 +1,483 @@
+#include "BlockEncoder.h"
+#include "IndexSearch.h"
+
+#include "GGEngine/CpuFeatures.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace Cooker {
+
+    namespace {
+
+        void LoadBlock(const uint8_t* rgba, Block& block)
+        {
+            for (int i = 0; i < 16; i++)
+                for (int c = 0; c < 4; c++)
+                    block.Channels[c][i] = (float)rgba[i * 4 + c];
+        }
+
+        // ---- Index search -------------------------------------------------------------
+
+        template<int Channels>
+        float FindIndices(const Block& block, const float (*palette)[4], int paletteSize, uint8_t* indices)
+        {
+            return GetIndexSearch().FindIndices[Channels - 1](block, palette, paletteSize, indices);
+        }
+
+        // ---- Endpoint fitting ---------------------------------------------------------
+
+        // Endpoints at the extremes of the block along its principal axis
+        template<int Channels>
+        void PrincipalEndpoints(const Block& block, float* low, float* high)
+        {
+            float mean[4] = {};
+            for (int c = 0; c < Channels; c++)
+            {
+                for (int i = 0; i < 16; i++)
+                    mean[c] += block.Channels[c][i];
+                mean[c] /= 16.0f;
+            }
+
+            float covariance[4][4] = {};
+            for (int i = 0; i < 16; i++)
+            {
+                float d[4];
+                for (int c = 0; c < Channels; c++)
+                    d[c] = block.Channels[c][i] - mean[c];
+                for (int a = 0; a < Channels; a++)
+                    for (int b = 0; b < Channels; b++)
+                        covariance[a][b] += d[a] * d[b];
+            }
+
+            // Power iteration, seeded with the bounding box diagonal
+            float axis[4] = {};
+            for (int c = 0; c < Channels; c++)
+            {
+                const float* values = block.Channels[c];
+                axis[c] = *std::max_element(values, values + 16) - *std::min_element(values, values + 16);
+            }
+            for (int iteration = 0; iteration < 8; iteration++)
+            {
+                float next[4] = {};
+                for (int a = 0; a < Channels; a++)
+                    for (int b = 0; b < Channels; b++)
+                        next[a] += covariance[a][b] * axis[b];
+                float length = 0.0f;
+                for (int c = 0; c < Channels; c++)
+                    length += next[c] * next[c];
+                if (length < 1e-12f)
+                    break;
+                length = 1.0f / std::sqrt(length);
+                for (int c = 0; c < Channels; c++)
+                    axis[c] = next[c] * length;
+            }
+
+            float minT = FLT_MAX, maxT = -FLT_MAX;
+            for (int i = 0; i < 16; i++)
+            {
+                float t = 0.0f;
+                for (int c = 0; c < Channels; c++)
+                    t += (block.Channels[c][i] - mean[c]) * axis[c];
+                minT = std::min(minT, t);
+                maxT = std::max(maxT, t);
+            }
+            for (int c = 0; c < Channels; c++)
+            {
+                low[c] = std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+                high[c] = std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+            }
+        }
+
+        // Least-squares endpoints for fixed indices, where pixel i is reconstructed as
+        // (1 - w) * a + w * b with w = weights[indices[i]]. False when the system is degenerate.
+        template<int Channels>
+        bool RefineEndpoints(const Block& block, const uint8_t* indices, const float* weights, float* a, float* b)
+        {
+            float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+            float ra[4] = {}, rb[4] = {};
+            for (int i = 0; i < 16; i++)
+            {
+                const float w = weights[indices[i]];
+                const float iw = 1.0f - w;
+                aa += iw * iw;
+                ab += iw * w;
+                bb += w * w;
+                for (int c = 0; c < Channels; c++)
+                {
+                    ra[c] += iw * block.Channels[c][i];
+                    rb[c] += w * block.Channels[c][i];
+                }
+            }
+
+            const float det = aa * bb - ab * ab;
+            if (std::fabs(det) < 1e-6f)
+                return false;
+            const float inverse = 1.0f / det;
+            for (int c = 0; c < Channels; c++)
+            {
+                a[c] = std::clamp((bb * ra[c] - ab * rb[c]) * inverse, 0.0f, 255.0f);
+                b[c] = std::clamp((aa * rb[c] - ab * ra[c]) * inverse, 0.0f, 255.0f);
+            }
+            return true;
+        }
+
+        // ---- BC1 ----------------------------------------------------------------------
+
+        uint16_t Quantize565(const float* color)
+        {
+            const uint32_t r = (uint32_t)std::lround(color[0] * 31.0f / 255.0f);
+            const uint32_t g = (uint32_t)std::lround(color[1] * 63.0f / 255.0f);
+            const uint32_t b = (uint32_t)std::lround(color[2] * 31.0f / 255.0f);
+            return (uint16_t)((r << 11) | (g << 5) | b);
+        }
+
+        void Expand565(uint16_t packed, float* color)
+        {
+            const uint32_t r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+            color[0] = (float)((r << 3) | (r >> 2));
+            color[1] = (float)((g << 2) | (g >> 4));
+            color[2] = (float)((b << 3) | (b >> 2));
+            color[3] = 255.0f;
+        }
+
+        // Palette weights towards the second endpoint, by index
+        const float BC1Weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+        struct BC1Candidate
+        {
+            uint16_t Color0 = 0, Color1 = 0;
+            uint8_t Indices[16] = {};
+            float Error = FLT_MAX;
+        };
+
+        void EvaluateBC1(const Block& block, uint16_t color0, uint16_t color1, BC1Candidate& best)
+        {
+            // Four-color mode requires color0 > color1; equal endpoints can only reproduce one color
+            if (color0 < color1)
+                std::swap(color0, color1);
+
+            BC1Candidate candidate;
+            candidate.Color0 = color0;
+            candidate.Color1 = color1;
+
+            float palette[4][4];
+            Expand565(color0, palette[0]);
+            Expand565(color1, palette[1]);
+            for (int c = 0; c < 3; c++)
+            {
+                palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+                palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+            }
+            candidate.Error = FindIndices<3>(block, palette, color0 == color1 ? 1 : 4, candidate.Indices);
+
+            if (candidate.Error < best.Error)
+                best = candidate;
+        }
+
+        void EncodeColorBlock(const Block& block, uint8_t* dst)
+        {
+            float low[4], high[4];
+            PrincipalEndpoints<3>(block, low, high);
+
+            BC1Candidate best;
+            EvaluateBC1(block, Quantize565(high), Quantize565(low), best);
+
+            // Alternate between index search and least-squares endpoints while it keeps helping
+            for (int iteration = 0; iteration < 2; iteration++)
+            {
+                const float previousError = best.Error;
+                float a[4], b[4];
+                if (best.Color0 == best.Color1 || !RefineEndpoints<3>(block, best.Indices, BC1Weights, a, b))
+                    break;
+                EvaluateBC1(block, Quantize565(a), Quantize565(b), best);
+                if (best.Error >= previousError)
+                    break;
+            }
+
+            dst[0] = (uint8_t)(best.Color0 & 0xFF);
+            dst[1] = (uint8_t)(best.Color0 >> 8);
+            dst[2] = (uint8_t)(best.Color1 & 0xFF);
+            dst[3] = (uint8_t)(best.Color1 >> 8);
+            uint32_t bits = 0;
+            for (int i = 0; i < 16; i++)
+                bits |= (uint32_t)best.Indices[i] << (i * 2);
+            memcpy(dst + 4, &bits, 4);
+        }
+
+        // ---- BC4 ----------------------------------------------------------------------
+
+        // Index 0 and 1 are the endpoints, 2..7 interpolate from the first towards the second
+        const float BC4Weights[8] = { 0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f };
+
+        struct BC4Candidate
+        {
+            uint8_t Value0 = 0, Value1 = 0;
+            uint8_t Indices[16] = {};
+            float Error = FLT_MAX;
+        };
+
+        void EvaluateBC4(const Block& block, int value0, int value1, BC4Candidate& best)
+        {
+            // Eight-value mode requires value0 > value1
+            if (value0 < value1)
+                std::swap(value0, value1);
+
+            BC4Candidate candidate;
+            candidate.Value0 = (uint8_t)value0;
+            candidate.Value1 = (uint8_t)value1;
+
+            float palette[8][4] = {};
+            for (int i = 0; i < 8; i++)
+                palette[i][0] = (1.0f - BC4Weights[i]) * value0 + BC4Weights[i] * value1;
+            candidate.Error = FindIndices<1>(block, palette, value0 == value1 ? 1 : 8, candidate.Indices);
+
+            if (candidate.Error < best.Error)
+                best = candidate;
+        }
+
+        void EncodeChannelBlock(const uint8_t* rgba, uint32_t channel, uint8_t* dst)
+        {
+            Block block;
+            uint8_t minValue = 255, maxValue = 0;
+            for (int i = 0; i < 16; i++)
+            {
+                const uint8_t value = rgba[i * 4 + channel];
+                block.Channels[0][i] = (float)value;
+                minValue = std::min(minValue, value);
+                maxValue = std::max(maxValue, value);
+            }
+
+            BC4Candidate best;
+            EvaluateBC4(block, maxValue, minValue, best);
+            for (int iteration = 0; iteration < 2 && best.Value0 != best.Value1; iteration++)
+            {
+                const float previousError = best.Error;
+                float a, b;
+                if (!RefineEndpoints<1>(block, best.Indices, BC4Weights, &a, &b))
+                    break;
+                EvaluateBC4(block, (int)std::lround(a), (int)std::lround(b), best);
+                if (best.Error >= previousError)
+                    break;
+            }
+
+            dst[0] = best.Value0;
+            dst[1] = best.Value1;
+            uint64_t bits = 0;
+            for (int i = 0; i < 16; i++)
+                bits |= (uint64_t)best.Indices[i] << (i * 3);
+            for (int i = 0; i < 6; i++)
+                dst[2 + i] = (uint8_t)(bits >> (i * 8));
+        }
+
+        // ---- BC7 mode 6 ---------------------------------------------------------------
+        // One subset, RGBA endpoints with 7 bits per channel plus a shared-per-endpoint
+        // p-bit, and 4-bit indices. Handles opaque and translucent blocks alike and is the
+        // usual choice for fast BC7 encoding.
+
+        const int BC7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        struct BC7Endpoint
+        {
+            uint8_t Value[4]; // 7-bit
+            uint8_t PBit;
+        };
+
+        // Picks the p-bit that reproduces color best after 7-bit quantization
+        BC7Endpoint QuantizeBC7(const float* color, bool opaque)
+        {
+            BC7Endpoint best = {};
+            float bestError = FLT_MAX;
+            for (uint8_t pbit = opaque ? 1 : 0; pbit < 2; pbit++)
+            {
+                BC7Endpoint endpoint;
+                endpoint.PBit = pbit;
+                float error = 0.0f;
+                for (int c = 0; c < 4; c++)
+                {
+                    const int q = std::clamp((int)std::lround((color[c] - pbit) / 2.0f), 0, 127);
+                    endpoint.Value[c] = (uint8_t)q;
+                    const float diff = (float)((q << 1) | pbit) - color[c];
+                    error += diff * diff;
+                }
+                if (opaque)
+                    endpoint.Value[3] = 127;
+                if (error < bestError)
+                {
+                    bestError = error;
+                    best = endpoint;
+                }
+            }
+            return best;
+        }
+
+        struct BC7Candidate
+        {
+            BC7Endpoint Endpoints[2] = {};
+            uint8_t Indices[16] = {};
+            float Error = FLT_MAX;
+        };
+
+        void EvaluateBC7(const Block& block, const BC7Endpoint& e0, const BC7Endpoint& e1, BC7Candidate& best)
+        {
+            BC7Candidate candidate;
+            candidate.Endpoints[0] = e0;
+            candidate.Endpoints[1] = e1;
+
+            float palette[16][4];
+            for (int c = 0; c < 4; c++)
+            {
+                const int a = (e0.Value[c] << 1) | e0.PBit;
+                const int b = (e1.Value[c] << 1) | e1.PBit;
+                for (int i = 0; i < 16; i++)
+                    palette[i][c] = (float)(((64 - BC7Weights4[i]) * a + BC7Weights4[i] * b + 32) >> 6);
+            }
+            candidate.Error = FindIndices<4>(block, palette, 16, candidate.Indices);
+
+            if (candidate.Error < best.Error)
+                best = candidate;
+        }
+
+        class BitWriter128
+        {
+        public:
+            void Write(uint32_t value, int bits)
+            {
+                for (int i = 0; i < bits; i++, m_Position++)
+                {
+                    if ((value >> i) & 1)
+                        m_Bytes[m_Position >> 3] |= (uint8_t)(1u << (m_Position & 7));
+                }
+            }
+            const uint8_t* GetBytes() const { return m_Bytes; }
+
+        private:
+            uint8_t m_Bytes[16] = {};
+            int m_Position = 0;
+        };
+
+    }
+
+    void EncodeBC1(const uint8_t* rgba, uint8_t* dst)
+    {
+        Block block;
+        LoadBlock(rgba, block);
+        EncodeColorBlock(block, dst);
+    }
+
+    void EncodeBC3(const uint8_t* rgba, uint8_t* dst)
+    {
+        EncodeChannelBlock(rgba, 3, dst);
+        Block block;
+        LoadBlock(rgba, block);
+        EncodeColorBlock(block, dst + 8);
+    }
+
+    void EncodeBC4(const uint8_t* rgba, uint8_t* dst, uint32_t channel)
+    {
+        EncodeChannelBlock(rgba, channel, dst);
+    }
+
+    void EncodeBC5(const uint8_t* rgba, uint8_t* dst)
+    {
+        EncodeChannelBlock(rgba, 0, dst);
+        EncodeChannelBlock(rgba, 1, dst + 8);
+    }
+
+    void EncodeBC7(const uint8_t* rgba, uint8_t* dst)
+    {
+        Block block;
+        LoadBlock(rgba, block);
+
+        bool opaque = true;
+        for (int i = 0; i < 16; i++)
+            opaque &= rgba[i * 4 + 3] == 255;
+
+        float low[4], high[4];
+        PrincipalEndpoints<4>(block, low, high);
+
+        BC7Candidate best;
+        EvaluateBC7(block, QuantizeBC7(low, opaque), QuantizeBC7(high, opaque), best);
+
+        float weights[16];
+        for (int i = 0; i < 16; i++)
+            weights[i] = BC7Weights4[i] / 64.0f;
+        for (int iteration = 0; iteration < 2; iteration++)
+        {
+            const float previousError = best.Error;
+            float a[4], b[4];
+            if (!RefineEndpoints<4>(block, best.Indices, weights, a, b))
+                break;
+            EvaluateBC7(block, QuantizeBC7(a, opaque), QuantizeBC7(b, opaque), best);
+            if (best.Error >= previousError)
+                break;
+        }
+
+        // The anchor (first) index is stored without its top bit, so it has to be < 8
+        if (best.Indices[0] >= 8)
+        {
+            std::swap(best.Endpoints[0], best.Endpoints[1]);
+            for (uint8_t& index : best.Indices)
+                index = (uint8_t)(15 - index);
+        }
+
+        BitWriter128 writer;
+        writer.Write(1u << 6, 7); // Mode 6
+        for (int c = 0; c < 4; c++)
+        {
+            writer.Write(best.Endpoints[0].Value[c], 7);
+            writer.Write(best.Endpoints[1].Value[c], 7);
+        }
+        writer.Write(best.Endpoints[0].PBit, 1);
+        writer.Write(best.Endpoints[1].PBit, 1);
+        writer.Write(best.Indices[0], 3);
+        for (int i = 1; i < 16; i++)
+            writer.Write(best.Indices[i], 4);
+        memcpy(dst, writer.GetBytes(), 16);
+    }
+
+    void EncodeBlock(BlockFormat format, const uint8_t* rgba, uint8_t* dst)
+    {
+        switch (format)
+        {
+        case BlockFormat::BC1: EncodeBC1(rgba, dst); break;
+        case BlockFormat::BC3: EncodeBC3(rgba, dst); break;
+        case BlockFormat::BC4: EncodeBC4(rgba, dst); break;
+        case BlockFormat::BC5: EncodeBC5(rgba, dst); break;
+        case BlockFormat::BC7: EncodeBC7(rgba, dst); break;
+        }
+    }
+
+    uint32_t GetBlockBytes(BlockFormat format)
+    {
+        return (format == BlockFormat::BC1 || format == BlockFormat::BC4) ? 8 : 16;
+    }
+
+    const IndexSearch& GetIndexSearch()
+    {
+        static const IndexSearch* s_Best = []()
+        {
+            const GGEngine::CpuFeatures& cpu = GGEngine::CpuFeatures::Get();
+            if (cpu.AVX2)
+            {
+                if (const IndexSearch* search = GetAVX2IndexSearch())
+                    return search;
+            }
+            if (cpu.SSE41)
+            {
+                if (const IndexSearch* search = GetSSE4IndexSearch())
+                    return search;
+            }
+            return GetScalarIndexSearch();
+        }();
+        return *s_Best;
+    }
+
+    const char* GetSimdLevel()
+    {
+        return GetIndexSearch().Name;
+    }
+
+}
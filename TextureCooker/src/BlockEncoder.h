@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Cooker {
+
+    enum class BlockFormat
+    {
+        BC1, // RGB, 4 bpp
+        BC3, // RGBA with separate alpha, 8 bpp
+        BC4, // Single channel (red), 4 bpp
+        BC5, // Two channels (red, green), 8 bpp; normal maps
+        BC7  // RGBA, 8 bpp; mode 6 only
+    };
+
+    // Encoders take one 4x4 block of RGBA8 pixels, row-major (64 bytes), and write
+    // GetBlockBytes(format) bytes. Thread-safe; no shared state.
+    void EncodeBC1(const uint8_t* rgba, uint8_t* dst);
+    void EncodeBC3(const uint8_t* rgba, uint8_t* dst);
+    void EncodeBC4(const uint8_t* rgba, uint8_t* dst, uint32_t channel = 0);
+    void EncodeBC5(const uint8_t* rgba, uint8_t* dst);
+    void EncodeBC7(const uint8_t* rgba, uint8_t* dst);
+
+    void EncodeBlock(BlockFormat format, const uint8_t* rgba, uint8_t* dst);
+    uint32_t GetBlockBytes(BlockFormat format);
+
+    // Instruction set the index search runs with, picked from the CPU at startup:
+    // "AVX2", "SSE4.1" or "scalar"
+    const char* GetSimdLevel();
+
+}
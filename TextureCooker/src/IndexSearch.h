@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Cooker {
+
+    // 16 pixels stored channel by channel, so the index search can load 4 or 8 at once
+    struct Block
+    {
+        alignas(32) float Channels[4][16];
+    };
+
+    // For every pixel, the palette entry with the smallest squared error over the first
+    // channels. Returns the summed error of the block. This is where encoding spends its
+    // time, so it is the part that is vectorized.
+    using FindIndicesFn = float (*)(const Block& block, const float (*palette)[4], int paletteSize, uint8_t* indices);
+
+    // One implementation per instruction set, each in its own translation unit built for
+    // that set (see CMakeLists.txt)
+    struct IndexSearch
+    {
+        const char* Name;
+        FindIndicesFn FindIndices[4]; // By channel count - 1
+    };
+
+    // nullptr when the level is not compiled for this target
+    const IndexSearch* GetScalarIndexSearch();
+    const IndexSearch* GetSSE4IndexSearch();
+    const IndexSearch* GetAVX2IndexSearch();
+
+    // Fastest level the running CPU supports, chosen once
+    const IndexSearch& GetIndexSearch();
+
+}
@@ -0,0 +1,76 @@
+#include "IndexSearch.h"
+
+// Built with AVX2 enabled (see CMakeLists.txt) and without the precompiled header.
+// Only intrinsics and functions with internal linkage belong here: an inline function
+// from a shared header compiled in this file could be the copy the linker keeps for the
+// whole program, and fault on CPUs without AVX2.
+
+#include <cfloat>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+    #define GG_COOKER_AVX2
+    #include <immintrin.h>
+#endif
+
+namespace Cooker {
+
+#if defined(GG_COOKER_AVX2)
+
+    namespace {
+
+        template<int Channels>
+        float FindIndices(const Block& block, const float (*palette)[4], int paletteSize, uint8_t* indices)
+        {
+            float total = 0.0f;
+            for (int half = 0; half < 16; half += 8)
+            {
+                __m256 pixel[Channels];
+                for (int c = 0; c < Channels; c++)
+                    pixel[c] = _mm256_load_ps(&block.Channels[c][half]);
+
+                __m256 best = _mm256_set1_ps(FLT_MAX);
+                __m256 bestIndex = _mm256_setzero_ps();
+                for (int p = 0; p < paletteSize; p++)
+                {
+                    __m256 error = _mm256_setzero_ps();
+                    for (int c = 0; c < Channels; c++)
+                    {
+                        const __m256 diff = _mm256_sub_ps(pixel[c], _mm256_set1_ps(palette[p][c]));
+                        error = _mm256_add_ps(error, _mm256_mul_ps(diff, diff));
+                    }
+                    const __m256 closer = _mm256_cmp_ps(error, best, _CMP_LT_OQ);
+                    best = _mm256_min_ps(error, best);
+                    bestIndex = _mm256_blendv_ps(bestIndex, _mm256_set1_ps((float)p), closer);
+                }
+
+                alignas(32) int32_t lanes[8];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_cvtps_epi32(bestIndex));
+                alignas(32) float errors[8];
+                _mm256_store_ps(errors, best);
+                for (int i = 0; i < 8; i++)
+                {
+                    indices[half + i] = (uint8_t)lanes[i];
+                    total += errors[i];
+                }
+            }
+            return total;
+        }
+
+    }
+
+    const IndexSearch* GetAVX2IndexSearch()
+    {
+        static const IndexSearch s_Search = { "AVX2", { FindIndices<1>, FindIndices<2>, FindIndices<3>, FindIndices<4> } };
+        return &s_Search;
+    }
+
+#else
+
+    const IndexSearch* GetAVX2IndexSearch()
+    {
+        return nullptr;
+    }
+
+#endif
+
+}
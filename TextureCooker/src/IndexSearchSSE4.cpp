@@ -0,0 +1,76 @@
+#include "IndexSearch.h"
+
+// Built with SSE4.1 enabled (see CMakeLists.txt) and without the precompiled header.
+// Only intrinsics and functions with internal linkage belong here: an inline function
+// from a shared header compiled in this file could be the copy the linker keeps for the
+// whole program.
+
+#include <cfloat>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+    #define GG_COOKER_SSE4
+    #include <smmintrin.h>
+#endif
+
+namespace Cooker {
+
+#if defined(GG_COOKER_SSE4)
+
+    namespace {
+
+        template<int Channels>
+        float FindIndices(const Block& block, const float (*palette)[4], int paletteSize, uint8_t* indices)
+        {
+            float total = 0.0f;
+            for (int quarter = 0; quarter < 16; quarter += 4)
+            {
+                __m128 pixel[Channels];
+                for (int c = 0; c < Channels; c++)
+                    pixel[c] = _mm_load_ps(&block.Channels[c][quarter]);
+
+                __m128 best = _mm_set1_ps(FLT_MAX);
+                __m128 bestIndex = _mm_setzero_ps();
+                for (int p = 0; p < paletteSize; p++)
+                {
+                    __m128 error = _mm_setzero_ps();
+                    for (int c = 0; c < Channels; c++)
+                    {
+                        const __m128 diff = _mm_sub_ps(pixel[c], _mm_set1_ps(palette[p][c]));
+                        error = _mm_add_ps(error, _mm_mul_ps(diff, diff));
+                    }
+                    const __m128 closer = _mm_cmplt_ps(error, best);
+                    best = _mm_min_ps(error, best);
+                    bestIndex = _mm_blendv_ps(bestIndex, _mm_set1_ps((float)p), closer);
+                }
+
+                alignas(16) int32_t lanes[4];
+                _mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_cvtps_epi32(bestIndex));
+                alignas(16) float errors[4];
+                _mm_store_ps(errors, best);
+                for (int i = 0; i < 4; i++)
+                {
+                    indices[quarter + i] = (uint8_t)lanes[i];
+                    total += errors[i];
+                }
+            }
+            return total;
+        }
+
+    }
+
+    const IndexSearch* GetSSE4IndexSearch()
+    {
+        static const IndexSearch s_Search = { "SSE4.1", { FindIndices<1>, FindIndices<2>, FindIndices<3>, FindIndices<4> } };
+        return &s_Search;
+    }
+
+#else
+
+    const IndexSearch* GetSSE4IndexSearch()
+    {
+        return nullptr;
+    }
+
+#endif
+
+}
@@ -0,0 +1,45 @@
+#include "IndexSearch.h"
+
+#include <cfloat>
+
+namespace Cooker {
+
+    namespace {
+
+        template<int Channels>
+        float FindIndices(const Block& block, const float (*palette)[4], int paletteSize, uint8_t* indices)
+        {
+            float total = 0.0f;
+            for (int i = 0; i < 16; i++)
+            {
+                float best = FLT_MAX;
+                int bestIndex = 0;
+                for (int p = 0; p < paletteSize; p++)
+                {
+                    float error = 0.0f;
+                    for (int c = 0; c < Channels; c++)
+                    {
+                        const float diff = block.Channels[c][i] - palette[p][c];
+                        error += diff * diff;
+                    }
+                    if (error < best)
+                    {
+                        best = error;
+                        bestIndex = p;
+                    }
+                }
+                indices[i] = (uint8_t)bestIndex;
+                total += best;
+            }
+            return total;
+        }
+
+    }
+
+    const IndexSearch* GetScalarIndexSearch()
+    {
+        static const IndexSearch s_Search = { "scalar", { FindIndices<1>, FindIndices<2>, FindIndices<3>, FindIndices<4> } };
+        return &s_Search;
+    }
+
+}
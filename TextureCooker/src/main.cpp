@@ -0,0 +1,363 @@
+#include "GGEngine/Log.h"
+#include "GGEngine/Image/ImageDecoder.h"
+#include "GGEngine/Image/KTX2.h"
+#include "GGEngine/JobSystem.h"
+#include "GGEngine/Timer.h"
+
+#include "BlockEncoder.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+// Offline texture cooker: decodes PNG/QOI sources, builds the mip chain and writes
+// block-compressed KTX2 files the runtime uploads without touching the pixels.
+//
+//   TextureCooker <file|directory>... [-o <dir>] [--format=auto|bc1|bc3|bc4|bc5|bc7]
+//                 [--linear] [--no-mips] [--force]
+
+namespace fs = std::filesystem;
+using namespace GGEngine;
+
+namespace {
+
+    enum class FormatChoice { Auto, BC1, BC3, BC4, BC5, BC7 };
+
+    struct CookOptions
+    {
+        std::vector<std::string> Inputs;
+        std::string OutputDirectory; // Next to the source when empty
+        FormatChoice Format = FormatChoice::Auto;
+        bool SRGB = true;
+        bool Mips = true;
+        bool Force = false;
+    };
+
+    struct RGBAImage
+    {
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        std::vector<uint8_t> Pixels;
+    };
+
+    // sRGB <-> linear, so mips are averaged in light rather than in encoded values
+    struct SRGBTables
+    {
+        float ToLinear[256];
+        uint8_t FromLinear[4096];
+
+        SRGBTables()
+        {
+            for (int i = 0; i < 256; i++)
+            {
+                const float c = i / 255.0f;
+                ToLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (int i = 0; i < 4096; i++)
+            {
+                const float l = i / 4095.0f;
+                const float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+                FromLinear[i] = (uint8_t)std::lround(std::clamp(c, 0.0f, 1.0f) * 255.0f);
+            }
+        }
+    };
+
+    const SRGBTables& GetSRGBTables()
+    {
+        static const SRGBTables tables;
+        return tables;
+    }
+
+    // 2x2 box filter; odd dimensions clamp the last row/column
+    RGBAImage Downsample(const RGBAImage& src, bool srgb)
+    {
+        const SRGBTables& tables = GetSRGBTables();
+        RGBAImage dst;
+        dst.Width = std::max(1u, src.Width / 2);
+        dst.Height = std::max(1u, src.Height / 2);
+        dst.Pixels.resize((size_t)dst.Width * dst.Height * 4);
+
+        for (uint32_t y = 0; y < dst.Height; y++)
+        {
+            const uint32_t y0 = std::min(y * 2, src.Height - 1), y1 = std::min(y * 2 + 1, src.Height - 1);
+            for (uint32_t x = 0; x < dst.Width; x++)
+            {
+                const uint32_t x0 = std::min(x * 2, src.Width - 1), x1 = std::min(x * 2 + 1, src.Width - 1);
+                const uint8_t* taps[4] = {
+                    &src.Pixels[((size_t)y0 * src.Width + x0) * 4], &src.Pixels[((size_t)y0 * src.Width + x1) * 4],
+                    &src.Pixels[((size_t)y1 * src.Width + x0) * 4], &src.Pixels[((size_t)y1 * src.Width + x1) * 4]
+                };
+                uint8_t* out = &dst.Pixels[((size_t)y * dst.Width + x) * 4];
+                for (int c = 0; c < 4; c++)
+                {
+                    if (srgb && c < 3)
+                    {
+                        const float sum = tables.ToLinear[taps[0][c]] + tables.ToLinear[taps[1][c]] + tables.ToLinear[taps[2][c]] + tables.ToLinear[taps[3][c]];
+                        out[c] = tables.FromLinear[(int)std::lround(sum * 0.25f * 4095.0f)];
+                    }
+                    else
+                    {
+                        out[c] = (uint8_t)((taps[0][c] + taps[1][c] + taps[2][c] + taps[3][c] + 2) / 4);
+                    }
+                }
+            }
+        }
+        return dst;
+    }
+
+    // Encodes one level across all job threads, a row of blocks per job
+    std::vector<uint8_t> EncodeLevel(const RGBAImage& image, Cooker::BlockFormat format)
+    {
+        const uint32_t blocksX = (image.Width + 3) / 4;
+        const uint32_t blocksY = (image.Height + 3) / 4;
+        const uint32_t blockBytes = Cooker::GetBlockBytes(format);
+        std::vector<uint8_t> out((size_t)blocksX * blocksY * blockBytes);
+
+        JobCounter counter{ 0 };
+        JobSystem::Dispatch(counter, blocksY, 1, [&](JobDispatchArgs args)
+        {
+            const uint32_t by = args.JobIndex;
+            uint8_t block[64];
+            for (uint32_t bx = 0; bx < blocksX; bx++)
+            {
+                // Edge blocks replicate the border pixels, so padding never bleeds into the palette
+                for (uint32_t py = 0; py < 4; py++)
+                {
+                    const uint32_t y = std::min(by * 4 + py, image.Height - 1);
+                    for (uint32_t px = 0; px < 4; px++)
+                    {
+                        const uint32_t x = std::min(bx * 4 + px, image.Width - 1);
+                        memcpy(&block[(py * 4 + px) * 4], &image.Pixels[((size_t)y * image.Width + x) * 4], 4);
+                    }
+                }
+                Cooker::EncodeBlock(format, block, &out[((size_t)by * blocksX + bx) * blockBytes]);
+            }
+        });
+        JobSystem::Wait(counter);
+        return out;
+    }
+
+    bool HasAlpha(const RGBAImage& image)
+    {
+        for (size_t i = 3; i < image.Pixels.size(); i += 4)
+        {
+            if (image.Pixels[i] != 255)
+                return true;
+        }
+        return false;
+    }
+
+    Cooker::BlockFormat ResolveFormat(FormatChoice choice, const RGBAImage& image)
+    {
+        switch (choice)
+        {
+        case FormatChoice::BC1: return Cooker::BlockFormat::BC1;
+        case FormatChoice::BC3: return Cooker::BlockFormat::BC3;
+        case FormatChoice::BC4: return Cooker::BlockFormat::BC4;
+        case FormatChoice::BC5: return Cooker::BlockFormat::BC5;
+        case FormatChoice::BC7: return Cooker::BlockFormat::BC7;
+        default: return HasAlpha(image) ? Cooker::BlockFormat::BC7 : Cooker::BlockFormat::BC1;
+        }
+    }
+
+    // VkFormat values, spelled out so the tool does not need Vulkan headers
+    uint32_t GetVkFormat(Cooker::BlockFormat format, bool srgb)
+    {
+        switch (format)
+        {
+        case Cooker::BlockFormat::BC1: return srgb ? 132 : 131; // VK_FORMAT_BC1_RGB_{SRGB,UNORM}_BLOCK
+        case Cooker::BlockFormat::BC3: return srgb ? 138 : 137; // VK_FORMAT_BC3_{SRGB,UNORM}_BLOCK
+        case Cooker::BlockFormat::BC4: return 139;              // VK_FORMAT_BC4_UNORM_BLOCK
+        case Cooker::BlockFormat::BC5: return 141;              // VK_FORMAT_BC5_UNORM_BLOCK
+        case Cooker::BlockFormat::BC7: return srgb ? 146 : 145; // VK_FORMAT_BC7_{SRGB,UNORM}_BLOCK
+        }
+        return 0;
+    }
+
+    const char* GetFormatName(Cooker::BlockFormat format)
+    {
+        switch (format)
+        {
+        case Cooker::BlockFormat::BC1: return "BC1";
+        case Cooker::BlockFormat::BC3: return "BC3";
+        case Cooker::BlockFormat::BC4: return "BC4";
+        case Cooker::BlockFormat::BC5: return "BC5";
+        case Cooker::BlockFormat::BC7: return "BC7";
+        }
+        return "?";
+    }
+
+    bool ReadFile(const fs::path& path, std::vector<uint8_t>& data)
+    {
+        std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+        data.resize((size_t)file.tellg());
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(data.data()), (std::streamsize)data.size());
+        return (bool)file;
+    }
+
+    enum class CookResult { Cooked, UpToDate, Failed };
+
+    CookResult Cook(const fs::path& input, const CookOptions& options)
+    {
+        fs::path output = input;
+        output.replace_extension(".ktx2");
+        if (!options.OutputDirectory.empty())
+            output = fs::path(options.OutputDirectory) / output.filename();
+
+        std::error_code errorCode;
+        if (!options.Force && fs::exists(output, errorCode) && fs::last_write_time(output, errorCode) >= fs::last_write_time(input, errorCode))
+            return CookResult::UpToDate;
+
+        std::vector<uint8_t> file;
+        if (!ReadFile(input, file))
+        {
+            GG_ERROR("Could not read {0}", input.string());
+            return CookResult::Failed;
+        }
+
+        RGBAImage image;
+        ImageInfo info;
+        std::string error;
+        if (!ImageDecoder::Decode(file.data(), file.size(), info, image.Pixels, &error))
+        {
+            GG_ERROR("{0}: {1}", input.string(), error);
+            return CookResult::Failed;
+        }
+        image.Width = info.Width;
+        image.Height = info.Height;
+
+        const Cooker::BlockFormat format = ResolveFormat(options.Format, image);
+        // BC4/BC5 hold data (masks, normals), never color
+        const bool srgb = options.SRGB && format != Cooker::BlockFormat::BC4 && format != Cooker::BlockFormat::BC5;
+
+        Timer timer;
+        std::vector<std::vector<uint8_t>> levels;
+        levels.push_back(EncodeLevel(image, format));
+        if (options.Mips)
+        {
+            RGBAImage mip = std::move(image);
+            while (mip.Width > 1 || mip.Height > 1)
+            {
+                mip = Downsample(mip, srgb);
+                levels.push_back(EncodeLevel(mip, format));
+            }
+        }
+
+        if (!options.OutputDirectory.empty())
+            fs::create_directories(options.OutputDirectory, errorCode);
+        if (!KTX2::Write(output.string(), GetVkFormat(format, srgb), info.Width, info.Height, levels))
+            return CookResult::Failed;
+
+        size_t compressedSize = 0;
+        for (const std::vector<uint8_t>& level : levels)
+            compressedSize += level.size();
+        GG_INFO("{0} -> {1}: {2}x{3} {4}{5}, {6} levels, {7} KiB ({8:.1f}x smaller), {9:.0f} ms",
+            input.filename().string(), output.filename().string(), info.Width, info.Height, GetFormatName(format), srgb ? " sRGB" : "",
+            levels.size(), compressedSize / 1024, (double)info.GetRGBASize() * (options.Mips ? 4.0 / 3.0 : 1.0) / compressedSize, timer.ElapsedMillis());
+        return CookResult::Cooked;
+    }
+
+    bool IsSourceImage(const fs::path& path)
+    {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)std::tolower((unsigned char)c); });
+        return extension == ".png" || extension == ".qoi";
+    }
+
+    bool ParseArgs(int argc, char** argv, CookOptions& options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string arg = argv[i];
+            if (arg == "-o" && i + 1 < argc)
+                options.OutputDirectory = argv[++i];
+            else if (arg == "--linear")
+                options.SRGB = false;
+            else if (arg == "--no-mips")
+                options.Mips = false;
+            else if (arg == "--force")
+                options.Force = true;
+            else if (arg.rfind("--format=", 0) == 0)
+            {
+                const std::string name = arg.substr(9);
+                if (name == "auto") options.Format = FormatChoice::Auto;
+                else if (name == "bc1") options.Format = FormatChoice::BC1;
+                else if (name == "bc3") options.Format = FormatChoice::BC3;
+                else if (name == "bc4") options.Format = FormatChoice::BC4;
+                else if (name == "bc5") options.Format = FormatChoice::BC5;
+                else if (name == "bc7") options.Format = FormatChoice::BC7;
+                else
+                {
+                    GG_ERROR("Unknown format '{0}'", name);
+                    return false;
+                }
+            }
+            else if (!arg.empty() && arg[0] == '-')
+            {
+                GG_ERROR("Unknown option '{0}'", arg);
+                return false;
+            }
+            else
+                options.Inputs.push_back(arg);
+        }
+        return !options.Inputs.empty();
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    Log::Init();
+
+    CookOptions options;
+    if (!ParseArgs(argc, argv, options))
+    {
+        printf("Usage: TextureCooker <file|directory>... [-o <dir>] [--format=auto|bc1|bc3|bc4|bc5|bc7] [--linear] [--no-mips] [--force]\n");
+        return 1;
+    }
+
+    JobSystem::Init();
+    GG_INFO("TextureCooker: {0} threads, {1} encoders", JobSystem::GetThreadCount(), Cooker::GetSimdLevel());
+
+    std::vector<fs::path> sources;
+    for (const std::string& input : options.Inputs)
+    {
+        std::error_code errorCode;
+        if (fs::is_directory(input, errorCode))
+        {
+            for (const fs::directory_entry& entry : fs::recursive_directory_iterator(input, errorCode))
+            {
+                if (entry.is_regular_file() && IsSourceImage(entry.path()))
+                    sources.push_back(entry.path());
+            }
+        }
+        else
+        {
+            sources.push_back(input);
+        }
+    }
+
+    // Files are cooked one after another; the parallelism is across blocks within a level
+    Timer timer;
+    uint32_t cooked = 0, upToDate = 0, failed = 0;
+    for (const fs::path& source : sources)
+    {
+        switch (Cook(source, options))
+        {
+        case CookResult::Cooked: cooked++; break;
+        case CookResult::UpToDate: upToDate++; break;
+        case CookResult::Failed: failed++; break;
+        }
+    }
+    GG_INFO("Cooked {0}, up to date {1}, failed {2} in {3:.2f} s", cooked, upToDate, failed, timer.Elapsed());
+
+    JobSystem::Shutdown();
+    return failed ? 1 : 0;
+}